@@ -4,9 +4,25 @@
 
 #pragma once
 
+#include <memory>
+#include <bsoncxx/document/value.hpp>
+
 #include "rust/cxx.h"
+
+// Response from the service, exposed to Rust as a slice over the buffer the response was read into.
+class BsonDocument
+{
+public:
+  explicit BsonDocument( bsoncxx::document::value v ) : value{ std::move( v ) } {}
+
+  [[nodiscard]] rust::Slice<const uint8_t> data() const { return { value.data(), value.length() }; }
+
+private:
+  bsoncxx::document::value value;
+};
+
 #include "mongo-service/src/mongoservice.rs.h"
 
 void init_logger( Logger conf );
 void init( Configuration conf );
-rust::Vec<uint8_t> execute( rust::Vec<uint8_t> data );
+std::unique_ptr<BsonDocument> execute( rust::Slice<const uint8_t> data );
@@ -174,14 +174,24 @@ pub mod cpp
     /// initialisation fails due to system-level errors.
     pub fn init(conf: Configuration);
 
+    /// A BSON response document received from the *mongo-service*.
+    ///
+    /// The document is held in the buffer the C++ API read the response into.  Use
+    /// `data` to access the raw BSON bytes without copying them.
+    type BsonDocument;
+
+    /// The raw BSON bytes of the document.
+    pub fn data(self: &BsonDocument) -> &[u8];
+
     /// Executes the BSON request against the *mongo-service*.
     ///
     /// # Parameters
-    /// - `data`: A `Vec<u8>` containing the input BSON to process. This is the BSON
+    /// - `data`: A slice containing the input BSON to process. This is the BSON
     ///   data serialised to raw bytes.
     ///
     /// # Returns
-    /// - `Ok(Vec<u8>)`: A `Vec<u8>` containing the BSON response from the service.
+    /// - `Ok(UniquePtr<BsonDocument>)`: The BSON response from the service.  The raw
+    ///   bytes are available via `data`.
     /// - `Err(_)`: An error variant if the operation fails, with the specific error providing
     ///   details about what went wrong.
     ///
@@ -196,17 +206,17 @@ pub mod cpp
     /// use bson::doc;
     /// use mongo_service::client::cpp::execute;
     /// let input_data = doc!{}.to_vec().unwrap();
-    /// let result = execute(input_data);
+    /// let result = execute(&input_data);
     ///
     /// match result {
-    ///     Ok(output_data) => println!("Processed output: {:?}", output_data),
+    ///     Ok(output_data) => println!("Processed output: {:?}", output_data.data()),
     ///     Err(e) => eprintln!("An error occurred: {:?}", e),
     /// }
     /// ```
     ///
     /// # Safety
     /// This function does not perform unsafe operations.
-    pub fn execute(data: Vec<u8>) -> Result<Vec<u8>>;
+    pub fn execute(data: &[u8]) -> Result<UniquePtr<BsonDocument>>;
   }
 }
 
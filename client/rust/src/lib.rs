@@ -792,10 +792,10 @@ pub fn execute(request: Request) -> Result<Response, Box<dyn Error>>
   if request.correlationId.is_some() { data.insert("correlationId", request.correlationId.unwrap()); }
 
   let bytes = data.to_vec()?;
-  let response = exec(bytes);
+  let response = exec(&bytes);
   if response.is_err() { return Err(response.unwrap_err().into()); }
 
-  let d = Document::from_reader(response.unwrap().as_slice())?;
+  let d = Document::from_reader(response.unwrap().data())?;
   if d.contains_key("result") { Ok(Response::result(d.get("result").unwrap().as_document().unwrap().clone())) }
   else if d.contains_key("results") { Ok(Response::results(d.get("results").unwrap().as_array().unwrap().clone())) }
   else if d.contains_key("error") { Ok(Response::error(d.get("error").unwrap().as_str().unwrap().to_string())) }
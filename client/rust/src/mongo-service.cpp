@@ -37,7 +37,7 @@ void init( Configuration conf )
   spt::mongoservice::api::init( sh, sp, app, pool );
 }
 
-rust::Vec<uint8_t> execute( rust::Vec<uint8_t> data )
+std::unique_ptr<BsonDocument> execute( rust::Slice<const uint8_t> data )
 {
   const auto view = bsoncxx::validate( data.data(), data.size() );
   if ( !view )
@@ -46,14 +46,10 @@ rust::Vec<uint8_t> execute( rust::Vec<uint8_t> data )
     throw std::runtime_error( "Invalid BSON document" );
   }
 
-  const auto [type, response] = spt::mongoservice::api::execute( *view );
+  auto [type, response] = spt::mongoservice::api::execute( *view );
   if ( type == spt::mongoservice::api::ResultType::poolFailure ) throw std::runtime_error( "Pool exhausted" );
   if ( type == spt::mongoservice::api::ResultType::commandFailure ) throw std::runtime_error( "Command failed" );
   if ( !response ) throw std::runtime_error( "Empty response" );
 
-  auto resp = rust::Vec<uint8_t>{};
-  resp.reserve( response->length() );
-  auto buf = response->data();
-  for ( std::size_t i = 0; i < response->length(); ++i ) resp.push_back( buf[i] );
-  return resp;
+  return std::make_unique<BsonDocument>( std::move( *response ) );
 }
@@ -26,10 +26,10 @@ pub mod model;
 pub fn create<E: Serialize, M: Serialize>(request: model::create::Request<E, M>) -> Result<model::create::Response, Box<dyn Error>>
 {
   let bytes = request.serialise()?;
-  let response = crate::client::cpp::execute(bytes);
+  let response = crate::client::cpp::execute(&bytes);
   if response.is_err() { return Err(response.unwrap_err().into()); }
 
-  let d = Document::from_reader(response.unwrap().as_slice())?;
+  let d = Document::from_reader(response.unwrap().data())?;
   if d.contains_key("entity") { Ok(model::create::Response::WithHistory(deserialize_from_document::<model::History>(d)?)) }
   else if d.contains_key("_id") { Ok(model::create::Response::NoHistory(deserialize_from_document::<model::create::ResponseNoHistory>(d)?)) }
   else if d.contains_key("error") { Err(d.get("error").unwrap().as_str().unwrap().into()) }
@@ -88,10 +88,10 @@ pub fn by_id<E: for <'de> Deserialize<'de>>(id: ObjectId, application: &str, dat
   let request = doc!{"application": application, "database": database, "collection": collection,
     "action": format!("{:?}", crate::Action::retrieve), "document": doc!{"_id": id}};
   let bytes = request.to_vec()?;
-  let response = crate::client::cpp::execute(bytes);
+  let response = crate::client::cpp::execute(&bytes);
   if response.is_err() { return Err(response.unwrap_err().into()); }
 
-  let d = Document::from_reader(response.unwrap().as_slice())?;
+  let d = Document::from_reader(response.unwrap().data())?;
   if d.contains_key("result") { Ok(deserialize_from_document::<E>(d.get_document("result").unwrap().clone())?) }
   else if d.contains_key("error") { Err(d.get("error").unwrap().as_str().unwrap().into()) }
   else { Err("Invalid response from mongo-service".into()) }
@@ -171,10 +171,10 @@ pub fn filter<E: for <'de> Deserialize<'de>>(filter: Document, application: &str
     "options": doc!{"limit": limit, "sort": doc!{"_id": if descending { -1 } else { 1 }}},
     "action": format!("{:?}", crate::Action::retrieve)};
   let bytes = request.to_vec()?;
-  let response = crate::client::cpp::execute(bytes);
+  let response = crate::client::cpp::execute(&bytes);
   if response.is_err() { return Err(response.unwrap_err().into()); }
 
-  let d = Document::from_reader(response.unwrap().as_slice())?;
+  let d = Document::from_reader(response.unwrap().data())?;
   if d.contains_key("result")
   {
     warn!("Unique result returned for filter: {:?}", filter);
@@ -330,10 +330,10 @@ pub fn property<E: for <'de> Deserialize<'de>>(field: &str, value: Bson, applica
 pub fn update<E: for <'de> Deserialize<'de> + Serialize, M: Serialize>(request: model::update::Request<E, M>) -> Result<model::update::Response<E>, Box<dyn Error>>
 {
   let bytes = request.serialise()?;
-  let response = crate::client::cpp::execute(bytes);
+  let response = crate::client::cpp::execute(&bytes);
   if response.is_err() { return Err(response.unwrap_err().into()); }
 
-  let d = Document::from_reader(response.unwrap().as_slice())?;
+  let d = Document::from_reader(response.unwrap().data())?;
   if d.contains_key("document") { Ok(model::update::Response::WithHistory(deserialize_from_document::<model::update::ResponseWithHistory<E>>(d)?)) }
   else if d.contains_key("skipVersion") { Ok(model::update::Response::NoHistory(deserialize_from_document::<model::update::ResponseNoHistory>(d)?)) }
   else if d.contains_key("error") { Err(d.get("error").unwrap().as_str().unwrap().into()) }
@@ -382,10 +382,10 @@ pub fn update<E: for <'de> Deserialize<'de> + Serialize, M: Serialize>(request:
 pub fn delete<M: Serialize>(request: model::delete::Request<M>) -> Result<model::delete::Response, Box<dyn Error>>
 {
   let bytes = request.serialise()?;
-  let response = crate::client::cpp::execute(bytes);
+  let response = crate::client::cpp::execute(&bytes);
   if response.is_err() { return Err(response.unwrap_err().into()); }
 
-  let d = Document::from_reader(response.unwrap().as_slice())?;
+  let d = Document::from_reader(response.unwrap().data())?;
   if d.contains_key("success") { Ok(deserialize_from_document::<model::delete::Response>(d)?) }
   else if d.contains_key("error") { Err(d.get("error").unwrap().as_str().unwrap().into()) }
   else { Err("Invalid response from mongo-service".into()) }
@@ -505,10 +505,10 @@ pub fn version_history_document<E: for <'de> Deserialize<'de>>(id: ObjectId, app
   let request = doc!{"application": application, "database": database, "collection": collection,
     "action": format!("{:?}", crate::Action::retrieve), "document": doc!{"_id": id}};
   let bytes = request.to_vec()?;
-  let response = crate::client::cpp::execute(bytes);
+  let response = crate::client::cpp::execute(&bytes);
   if response.is_err() { return Err(response.unwrap_err().into()); }
 
-  let d = Document::from_reader(response.unwrap().as_slice())?;
+  let d = Document::from_reader(response.unwrap().data())?;
   if d.contains_key("result") { Ok(deserialize_from_document::<model::VersionHistory<E>>(d.get_document("result").unwrap().clone())?) }
   else if d.contains_key("error") { Err(d.get("error").unwrap().as_str().unwrap().into()) }
   else { Err("Invalid response from mongo-service".into()) }
@@ -584,10 +584,10 @@ pub fn version_history_for<E: for <'de> Deserialize<'de>>(id: ObjectId, applicat
     "action": format!("{:?}", crate::Action::retrieve), "document": doc!{"entity._id": id},
     "options": doc!{"sort": doc!{"_id": 1}}};
   let bytes = request.to_vec()?;
-  let response = crate::client::cpp::execute(bytes);
+  let response = crate::client::cpp::execute(&bytes);
   if response.is_err() { return Err(response.unwrap_err().into()); }
 
-  let d = Document::from_reader(response.unwrap().as_slice())?;
+  let d = Document::from_reader(response.unwrap().data())?;
   if d.contains_key("results")
   {
     let a = d.get_array("results").unwrap();
@@ -6,6 +6,7 @@
 #include "impl/asyncconnection.hpp"
 #include "impl/connection.hpp"
 #include "impl/settings.hpp"
+#include "pool/asyncpool.hpp"
 #include "pool/pool.hpp"
 
 #if defined __has_include
@@ -14,6 +15,11 @@
   #else
     #include <magic_enum/magic_enum.hpp>
   #endif
+  #if __has_include("../common/util/bson.hpp")
+    #include "../common/util/bson.hpp"
+  #else
+    #include <mongo-service/common/util/bson.hpp>
+  #endif
   #if __has_include("../common/util/defer.hpp")
     #include "../common/util/defer.hpp"
   #else
@@ -21,7 +27,6 @@
   #endif
 #endif
 
-#include <bsoncxx/json.hpp>
 #include <bsoncxx/builder/stream/document.hpp>
 
 namespace
@@ -62,17 +67,18 @@ namespace
       AsyncPoolHolder& operator=(const AsyncPoolHolder&) = delete;
 
       auto acquire() { return pool.acquire(); }
+      [[nodiscard]] pool::AcquireStats stats() const { return pool.stats(); }
 
     private:
       AsyncPoolHolder() = default;
-      pool::Pool<api::impl::AsyncConnection> pool{ spt::mongoservice::api::impl::createAsyncConnection, api::impl::ApiSettings::instance().configuration };
+      pool::AsyncPool<api::impl::AsyncConnection> pool{ spt::mongoservice::api::impl::createAsyncConnection, api::impl::ApiSettings::instance().configuration };
     };
   }
 }
 
 void spt::mongoservice::api::init( std::string_view server, std::string_view port,
     std::string_view application, const pool::Configuration& poolConfiguration,
-    boost::asio::io_context& ioc )
+    boost::asio::io_context& ioc, std::size_t maxResponseSize )
 {
   auto& s = const_cast<impl::ApiSettings&>( impl::ApiSettings::instance() );
   auto lock = std::unique_lock( s.mutex );
@@ -82,6 +88,7 @@ void spt::mongoservice::api::init( std::string_view server, std::string_view por
     s.port.append( port.data(), port.size() );
     s.application.append( application.data(), application.size() );
     s.configuration = poolConfiguration;
+    s.maxResponseSize = maxResponseSize;
     s.ioc = &ioc;
   }
   else
@@ -90,7 +97,7 @@ void spt::mongoservice::api::init( std::string_view server, std::string_view por
   }
 }
 
-auto spt::mongoservice::api::execute( bsoncxx::document::view document, std::size_t bufSize ) -> Response
+auto spt::mongoservice::api::execute( bsoncxx::document::view document, std::size_t ) -> Response
 {
   auto proxy = papi::PoolHolder::instance().acquire();
   if ( !proxy )
@@ -100,10 +107,10 @@ auto spt::mongoservice::api::execute( bsoncxx::document::view document, std::siz
   }
 
   auto& connection = proxy.value().operator*();
-  auto opt = connection.execute( document, bufSize );
+  auto opt = connection.execute( document );
   if ( !opt )
   {
-    LOG_WARN << "Error executing command " << bsoncxx::to_json( document );
+    LOG_WARN << "Error executing command " << spt::util::toJsonString( document );
     connection.setValid( false );
     return { ResultType::commandFailure, std::nullopt };
   }
@@ -111,7 +118,7 @@ auto spt::mongoservice::api::execute( bsoncxx::document::view document, std::siz
   return { ResultType::success, std::move( opt ) };
 }
 
-auto spt::mongoservice::api::execute( bsoncxx::document::view document, ilp::APMRecord& apm, std::size_t bufSize ) -> Response
+auto spt::mongoservice::api::execute( bsoncxx::document::view document, ilp::APMRecord& apm, std::size_t ) -> Response
 {
   auto& p = ilp::addProcess( apm, ilp::APMRecord::Process::Type::Function );
   DEFER( ilp::setDuration( p ) );
@@ -126,11 +133,11 @@ auto spt::mongoservice::api::execute( bsoncxx::document::view document, ilp::APM
 
   auto& connection = proxy.value().operator*();
   auto idx = apm.processes.size();
-  auto opt = connection.execute( document, apm, bufSize );
+  auto opt = connection.execute( document, apm );
   ilp::addCurrentFunction( apm.processes[idx] );
   if ( !opt )
   {
-    LOG_WARN << "Error executing command " << bsoncxx::to_json( document ) << ". APM id: " << apm.id;
+    LOG_WARN << "Error executing command " << spt::util::toJsonString( document ) << ". APM id: " << apm.id;
     p.values.try_emplace( "error", "Command failed" );
     connection.setValid( false );
     return { ResultType::commandFailure, std::nullopt };
@@ -201,7 +208,7 @@ auto spt::mongoservice::api::execute( const Request& req, ilp::APMRecord& apm, s
 
 auto spt::mongoservice::api::executeAsync( bsoncxx::document::view document ) -> AsyncResponse
 {
-  auto proxy = papi::AsyncPoolHolder::instance().acquire();
+  auto proxy = co_await papi::AsyncPoolHolder::instance().acquire();
   if ( !proxy )
   {
     LOG_CRIT << "Error acquiring connection from pool";
@@ -212,7 +219,7 @@ auto spt::mongoservice::api::executeAsync( bsoncxx::document::view document ) ->
   auto opt = co_await connection.execute( document );
   if ( !opt )
   {
-    LOG_WARN << "Error executing command " << bsoncxx::to_json( document );
+    LOG_WARN << "Error executing command " << spt::util::toJsonString( document );
     connection.setValid( false );
     co_return Response{ ResultType::commandFailure, std::nullopt };
   }
@@ -246,3 +253,8 @@ auto spt::mongoservice::api::executeAsync( Request req ) -> AsyncResponse
   auto q = query << finalize;
   co_return co_await executeAsync( q.view() );
 }
+
+auto spt::mongoservice::api::asyncPoolStats() -> pool::AcquireStats
+{
+  return papi::AsyncPoolHolder::instance().stats();
+}
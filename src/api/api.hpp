@@ -6,6 +6,8 @@
 
 #include "contextholder.hpp"
 #include "request.hpp"
+#include "impl/response.hpp"
+#include "pool/asyncpool.hpp"
 #include "pool/pool.hpp"
 
 #if defined __has_include
@@ -32,11 +34,14 @@ namespace spt::mongoservice::api
    *   command to service.
    * @param poolConfiguration Configuration for the connection pool.
    * @param ioc The optional io context to use for the connection.
+   * @param maxResponseSize The maximum size of a response document.  Larger responses are
+   *   treated as a command failure, and the connection is closed.
    */
   void init( std::string_view server, std::string_view port,
       std::string_view application = {},
       const pool::Configuration& poolConfiguration = pool::Configuration{},
-      boost::asio::io_context& ioc = ContextHolder::instance().ioc );
+      boost::asio::io_context& ioc = ContextHolder::instance().ioc,
+      std::size_t maxResponseSize = impl::defaultMaxResponseSize );
 
   enum class ResultType : std::uint_fast8_t {
     /**
@@ -59,7 +64,7 @@ namespace spt::mongoservice::api
   /**
    * Execute the command specified in the input document view against the service.
    * @param document The document with the command to execute.
-   * @param bufSize Optional initial size of the buffer to use to receive data.
+   * @param bufSize Unused.  Responses are read into a buffer sized from the length of the response document.
    * @return A tuple containing the result type and result document (std::nullopt
    *   if invalid data was received).
    *   Caller must check the document contents to ensure successful execution
@@ -71,7 +76,7 @@ namespace spt::mongoservice::api
    * Execute the command specified in the input document view against the service.
    * @param document The document with the command to execute.
    * @param apm The APM record to add trace information to.
-   * @param bufSize Optional initial size of buffer to use to receive data.
+   * @param bufSize Unused.  Responses are read into a buffer sized from the length of the response document.
    * @return The result document or std::nullopt if invalid data was received.
    *   Caller must check the document contents to ensure successful execution
    *   of the command.
@@ -81,7 +86,7 @@ namespace spt::mongoservice::api
   /**
    * Execute the command encapsulated in the request against the service.
    * @param req The request model to use to build the command.
-   * @param bufSize Optional initial size of buffer to use to receive data.
+   * @param bufSize Unused.  Responses are read into a buffer sized from the length of the response document.
    * @return The result document or std::nullopt if invalid data was received.
    *   Caller must check the document contents to ensure successful execution
    *   of the command.
@@ -92,7 +97,7 @@ namespace spt::mongoservice::api
    * Execute the command encapsulated in the request against the service.
    * @param req The request model to use to build the command.
    * @param apm The APM record to add trace information to.
-   * @param bufSize Optional initial size of buffer to use to receive data.
+   * @param bufSize Unused.  Responses are read into a buffer sized from the length of the response document.
    * @return The result document or std::nullopt if invalid data was received.
    *   Caller must check the document contents to ensure successful execution
    *   of the command.
@@ -118,4 +123,12 @@ namespace spt::mongoservice::api
    *   of the command.
    */
   AsyncResponse executeAsync( Request req );
+
+  /**
+   * Statistics for acquiring connections from the pool used by `executeAsync`.  When all
+   * `maxConnections` connections are in use, `executeAsync` waits up to `maxWaitTime` for a
+   * connection to be released before failing with `ResultType::poolFailure`.
+   * @return Number of acquisitions, waits and timeouts, and time spent waiting.
+   */
+  pool::AcquireStats asyncPoolStats();
 }
\ No newline at end of file
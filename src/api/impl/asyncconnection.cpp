@@ -13,19 +13,19 @@
 #endif
 
 #include <boost/asio/connect.hpp>
+#include <boost/asio/read.hpp>
 #include <boost/asio/redirect_error.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <boost/asio/write.hpp>
 
 #include <bsoncxx/json.hpp>
-#include <bsoncxx/validate.hpp>
 
 using spt::mongoservice::api::impl::AsyncConnection;
 
 AsyncConnection::AsyncConnection( boost::asio::io_context& ioc, std::string_view h,
-    std::string_view p ) :
+    std::string_view p, std::size_t limit ) :
     s{ ioc }, resolver( ioc ),
-    host{ h.data(), h.size() }, port{ p.data(), p.size() }
+    host{ h.data(), h.size() }, port{ p.data(), p.size() }, maxResponseSize{ limit }
 {
   boost::system::error_code ec;
   endpoints = resolver.resolve( h, p, ec );
@@ -45,8 +45,6 @@ AsyncConnection::~AsyncConnection()
 
 auto AsyncConnection::execute( bsoncxx::document::view view ) -> boost::asio::awaitable<Response>
 {
-  static constexpr int bufSize = 1024;
-
   try
   {
     boost::system::error_code ec;
@@ -72,65 +70,36 @@ auto AsyncConnection::execute( bsoncxx::document::view view ) -> boost::asio::aw
     }
     LOG_DEBUG << "Wrote " << int(isize) << " bytes to socket";
 
-    uint8_t data[bufSize];
-
-    const auto documentSize = [&data]( std::size_t length )
-    {
-      if ( length < 5 ) return length;
-
-      const auto d = reinterpret_cast<const uint8_t*>( data );
-      uint32_t len;
-      memcpy( &len, d, sizeof(len) );
-      return std::size_t( len );
-    };
-
-    std::size_t osize = co_await s.async_read_some( boost::asio::buffer( data ),
+    uint32_t length{ 0 };
+    co_await boost::asio::async_read( s, boost::asio::buffer( &length, sizeof(length) ),
         boost::asio::redirect_error( boost::asio::use_awaitable, ec ) );
     if ( ec )
     {
       LOG_WARN << "Error reading response from service " << ec.message();
       co_return std::nullopt;
     }
-    const auto docSize = documentSize( osize );
-
-    if ( docSize <= bufSize )
-    {
-      const auto option = bsoncxx::validate( reinterpret_cast<const uint8_t*>( data ), docSize );
-      if ( !option )
-      {
-        LOG_WARN << "Invalid BSON data in response to " << bsoncxx::to_json( view );
-        co_return std::nullopt;
-      }
-      co_return bsoncxx::document::value{ *option };
-    }
 
-    LOG_DEBUG << "Read " << int(osize) << " bytes of " << int(docSize) << " total";
-    auto read = osize;
-    std::vector<uint8_t> rbuf;
-    rbuf.reserve( docSize );
-    rbuf.insert( rbuf.end(), data, data + osize );
-
-    while ( read != docSize ) // flawfinder: ignore
+    auto buffer = responseBuffer( length, maxResponseSize );
+    if ( !buffer )
     {
-      osize = co_await s.async_read_some( boost::asio::buffer( data ),
-          boost::asio::redirect_error( boost::asio::use_awaitable, ec ) );
-      if ( ec )
-      {
-        LOG_WARN << "Error reading response from service " << ec.message();
-        co_return std::nullopt;
-      }
-      rbuf.insert( rbuf.end(), data, data + osize );
-      read += osize;
-      LOG_DEBUG << "Read " << int(read) << " bytes of " << int(docSize) << " total"; // flawfinder: ignore
+      LOG_WARN << "Invalid response size " << length << " (limit " << uint64_t( maxResponseSize ) <<
+        ") in response to " << bsoncxx::to_json( view );
+      s.close( ec );
+      co_return std::nullopt;
     }
 
-    const auto option = bsoncxx::validate( reinterpret_cast<const uint8_t*>( rbuf.data() ), docSize );
-    if ( !option )
+    co_await boost::asio::async_read( s, boost::asio::buffer( buffer.get() + sizeof(length), length - sizeof(length) ),
+        boost::asio::redirect_error( boost::asio::use_awaitable, ec ) );
+    if ( ec )
     {
-      LOG_WARN << "Invalid BSON data in response to " << bsoncxx::to_json( view );
+      LOG_WARN << "Error reading response from service " << ec.message();
       co_return std::nullopt;
     }
-    co_return bsoncxx::document::value{ *option };
+    LOG_DEBUG << "Read " << length << " bytes from socket";
+
+    auto value = responseDocument( std::move( buffer ), length );
+    if ( !value ) LOG_WARN << "Invalid BSON data in response to " << bsoncxx::to_json( view );
+    co_return value;
   }
   catch ( std::exception& ex )
   {
@@ -142,5 +111,5 @@ auto AsyncConnection::execute( bsoncxx::document::view view ) -> boost::asio::aw
 auto spt::mongoservice::api::impl::createAsyncConnection() -> std::unique_ptr<AsyncConnection>
 {
   auto& settings = ApiSettings::instance();
-  return std::make_unique<AsyncConnection>( *settings.ioc, settings.server, settings.port );
+  return std::make_unique<AsyncConnection>( *settings.ioc, settings.server, settings.port, settings.maxResponseSize );
 }
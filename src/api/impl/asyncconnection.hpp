@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "response.hpp"
+
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
@@ -18,7 +20,8 @@ namespace spt::mongoservice::api::impl
 {
   struct AsyncConnection
   {
-    AsyncConnection( boost::asio::io_context& ioc, std::string_view host, std::string_view port );
+    AsyncConnection( boost::asio::io_context& ioc, std::string_view host, std::string_view port,
+        std::size_t maxResponseSize = defaultMaxResponseSize );
     ~AsyncConnection();
 
     AsyncConnection( const AsyncConnection& ) = delete;
@@ -36,6 +39,7 @@ namespace spt::mongoservice::api::impl
     boost::asio::ip::tcp::resolver::results_type endpoints;
     std::string host;
     std::string port;
+    std::size_t maxResponseSize;
     bool v{ true };
   };
 
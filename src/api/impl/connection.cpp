@@ -13,14 +13,15 @@
 #endif
 
 #include <boost/asio/connect.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
 #include <bsoncxx/json.hpp>
-#include <bsoncxx/validate.hpp>
 
 using spt::mongoservice::api::impl::Connection;
 
 Connection::Connection( boost::asio::io_context& ioc, std::string_view h,
-    std::string_view p ) : s{ ioc }, resolver{ ioc },
-    host{ h.data(), h.size() }, port{ p.data(), p.size() }
+    std::string_view p, std::size_t limit ) : s{ ioc }, resolver{ ioc },
+    host{ h.data(), h.size() }, port{ p.data(), p.size() }, maxResponseSize{ limit }
 {
   boost::system::error_code ec;
   endpoints = resolver.resolve( host, port, ec );
@@ -40,129 +41,89 @@ Connection::Connection( boost::asio::io_context& ioc, std::string_view h,
   s.set_option( option );
 }
 
-std::optional<bsoncxx::document::value> Connection::execute( bsoncxx::document::view document, std::size_t bufSize )
+std::optional<bsoncxx::document::value> Connection::execute( bsoncxx::document::view document )
 {
-  std::ostream os{ &buffer };
-  os.write( reinterpret_cast<const char*>( document.data() ), document.length() );
-
-  boost::system::error_code ec;
-  auto isize = socket().send( buffer.data(), 0, ec );
-  if ( ec )
-  {
-    LOG_DEBUG << "Error sending data to socket " << ec.message();
-    s.close( ec );
-    isize = socket().send( buffer.data(), 0, ec );
-  }
-
-  buffer.consume( isize );
-
-  const auto documentSize = [this]( std::size_t length )
-  {
-    if ( length < 5 ) return length;
-
-    const auto data = reinterpret_cast<const uint8_t*>( buffer.data().data() );
-    uint32_t len;
-    memcpy( &len, data, sizeof(len) );
-    return std::size_t( len );
-  };
-
-  auto osize = socket().receive( buffer.prepare( bufSize ), 0, ec );
-  if ( ec )
-  {
-    LOG_DEBUG << "Error reading data from socket " << ec.message();
-    s.close( ec );
-    buffer.consume( buffer.size() );
-    return std::nullopt;
-  }
-
-  buffer.commit( osize );
-  std::size_t read = osize;
-
-  const auto docSize = documentSize( osize );
-  while ( read < docSize ) // flawfinder: ignore
-  {
-    osize = socket().receive( buffer.prepare( bufSize ) );
-    buffer.commit( osize );
-    read += osize;
-  }
-
-  const auto option = bsoncxx::validate( reinterpret_cast<const uint8_t*>( buffer.data().data() ), docSize );
-  buffer.consume( buffer.size() );
-  if ( option ) return bsoncxx::document::value{ option.value() };
-
-  LOG_INFO << "Invalid BSON with size " << int(osize) << " in response to " << bsoncxx::to_json( document );
-  return std::nullopt;
+  if ( !write( document ) ) return std::nullopt;
+  return read( document );
 }
 
 std::optional<bsoncxx::document::value> Connection::execute( bsoncxx::document::view document,
-  ilp::APMRecord& apm, std::size_t bufSize )
+  ilp::APMRecord& apm )
 {
   auto& p = ilp::addProcess( apm, ilp::APMRecord::Process::Type::Function );
   p.values.try_emplace( "process", "send request" );
   DEFER( ilp::setDuration( p ) );
 
-  std::ostream os{ &buffer };
-  os.write( reinterpret_cast<const char*>( document.data() ), static_cast<std::streamsize>( document.length() ) );
-
   auto& cp = ilp::addProcess( apm, ilp::APMRecord::Process::Type::Step );
   cp.values.try_emplace( "process", "send data" );
   ilp::addCurrentFunction( cp );
   DEFER( ilp::setDuration( cp ) );
 
-  boost::system::error_code ec;
-  auto isize = socket().send( buffer.data(), 0, ec );
-  if ( ec )
+  if ( !write( document ) )
   {
-    LOG_DEBUG << "Error sending data to socket " << ec.message() << ". APM id: " << apm.id;
-    s.close( ec );
-    isize = socket().send( buffer.data(), 0, ec );
+    LOG_WARN << "Error sending request. APM id: " << apm.id;
+    return std::nullopt;
   }
   ilp::setDuration( cp );
 
-  buffer.consume( isize );
-
-  const auto documentSize = [this]( std::size_t length )
-  {
-    if ( length < 5 ) return length;
-
-    const auto data = reinterpret_cast<const uint8_t*>( buffer.data().data() );
-    uint32_t len;
-    memcpy( &len, data, sizeof(len) );
-    return std::size_t( len );
-  };
-
   auto& rcp = ilp::addProcess( apm, ilp::APMRecord::Process::Type::Step );
   rcp.values.try_emplace( "process", "read response" );
   ilp::addCurrentFunction( rcp );
   DEFER( ilp::setDuration( rcp ) );
 
-  auto osize = socket().receive( buffer.prepare( bufSize ), 0, ec );
+  return read( document );
+}
+
+bool Connection::write( bsoncxx::document::view document )
+{
+  const auto buffer = boost::asio::buffer( document.data(), document.length() );
+
+  boost::system::error_code ec;
+  boost::asio::write( socket(), buffer, ec );
+  if ( !ec ) return true;
+
+  LOG_DEBUG << "Error sending data to socket " << ec.message();
+  s.close( ec );
+  boost::asio::write( socket(), buffer, ec );
+  if ( !ec ) return true;
+
+  LOG_WARN << "Error sending data to socket " << ec.message();
+  s.close( ec );
+  return false;
+}
+
+std::optional<bsoncxx::document::value> Connection::read( bsoncxx::document::view document )
+{
+  boost::system::error_code ec;
+  uint32_t length{ 0 };
+  boost::asio::read( s, boost::asio::buffer( &length, sizeof(length) ), ec );
   if ( ec )
   {
     LOG_DEBUG << "Error reading data from socket " << ec.message();
     s.close( ec );
-    buffer.consume( buffer.size() );
     return std::nullopt;
   }
 
-  buffer.commit( osize );
-  std::size_t read = osize;
-
-  const auto docSize = std::min( documentSize( osize ), 64 * 1024 * 1024ul );
-  while ( read < docSize ) // flawfinder: ignore
+  auto buffer = responseBuffer( length, maxResponseSize );
+  if ( !buffer )
   {
-    osize = socket().receive( buffer.prepare( bufSize ) );
-    buffer.commit( osize );
-    read += osize;
+    LOG_WARN << "Invalid response size " << length << " (limit " << uint64_t( maxResponseSize ) <<
+      ") in response to " << bsoncxx::to_json( document );
+    s.close( ec );
+    return std::nullopt;
   }
 
-  ilp::setDuration( rcp );
-  const auto option = bsoncxx::validate( reinterpret_cast<const uint8_t*>( buffer.data().data() ), docSize );
-  buffer.consume( buffer.size() );
-  if ( option ) return bsoncxx::document::value{ option.value() };
+  boost::asio::read( s, boost::asio::buffer( buffer.get() + sizeof(length), length - sizeof(length) ), ec );
+  if ( ec )
+  {
+    LOG_DEBUG << "Error reading data from socket " << ec.message();
+    s.close( ec );
+    return std::nullopt;
+  }
 
-  LOG_INFO << "Invalid BSON with size " << int(osize) << " in response to " << bsoncxx::to_json( document );
-  return std::nullopt;
+  auto value = responseDocument( std::move( buffer ), length );
+  if ( !value ) LOG_INFO << "Invalid BSON with size " << length << " in response to " << bsoncxx::to_json( document );
+  return value;
 }
 
 tcp::socket& Connection::socket()
@@ -202,5 +163,5 @@ tcp::socket& Connection::socket()
 std::unique_ptr<Connection> spt::mongoservice::api::impl::create()
 {
   auto& s = ApiSettings::instance();
-  return std::make_unique<Connection>( *s.ioc, s.server, s.port );
+  return std::make_unique<Connection>( *s.ioc, s.server, s.port, s.maxResponseSize );
 }
\ No newline at end of file
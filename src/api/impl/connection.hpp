@@ -17,11 +17,12 @@
   #endif
 #endif
 
+#include "response.hpp"
+
 #include <optional>
 #include <string_view>
 
 #include <boost/asio/io_context.hpp>
-#include <boost/asio/streambuf.hpp>
 #include <boost/asio/ip/tcp.hpp>
 
 #include <bsoncxx/document/value.hpp>
@@ -33,7 +34,8 @@ namespace spt::mongoservice::api::impl
 {
   struct Connection
   {
-    Connection( boost::asio::io_context& ioc, std::string_view host, std::string_view port );
+    Connection( boost::asio::io_context& ioc, std::string_view host, std::string_view port,
+        std::size_t maxResponseSize = defaultMaxResponseSize );
 
     Connection( const Connection& ) = delete;
     Connection& operator=( const Connection& ) = delete;
@@ -44,23 +46,25 @@ namespace spt::mongoservice::api::impl
     }
 
     [[nodiscard]] std::optional<bsoncxx::document::value> execute(
-        bsoncxx::document::view document, std::size_t bufSize = 4 * 1024 );
+        bsoncxx::document::view document );
 
     [[nodiscard]] std::optional<bsoncxx::document::value> execute(
-        bsoncxx::document::view document, ilp::APMRecord& apm, std::size_t bufSize = 4 * 1024 );
+        bsoncxx::document::view document, ilp::APMRecord& apm );
 
     [[nodiscard]] bool valid() const { return v; }
     void setValid( bool valid ) { this->v = valid; }
 
   private:
     tcp::socket& socket();
+    bool write( bsoncxx::document::view document );
+    std::optional<bsoncxx::document::value> read( bsoncxx::document::view document );
 
     tcp::socket s;
     tcp::resolver resolver;
     boost::asio::ip::tcp::resolver::results_type endpoints;
-    boost::asio::streambuf buffer;
     std::string host;
     std::string port;
+    std::size_t maxResponseSize;
     bool v{ true };
   };
 
@@ -0,0 +1,34 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "response.hpp"
+
+#include <cstring>
+#include <bsoncxx/validate.hpp>
+
+namespace
+{
+  namespace presponse
+  {
+    // Smallest valid BSON document - length prefix and trailing null.
+    constexpr uint32_t minLength = 5;
+
+    void release( uint8_t* data ) { delete [] data; }
+  }
+}
+
+auto spt::mongoservice::api::impl::responseBuffer( uint32_t length, std::size_t maxSize ) -> ResponseBuffer
+{
+  if ( length < presponse::minLength || length > maxSize ) return { nullptr, presponse::release };
+
+  auto buffer = ResponseBuffer{ new uint8_t[length], presponse::release };
+  std::memcpy( buffer.get(), &length, sizeof(length) );
+  return buffer;
+}
+
+auto spt::mongoservice::api::impl::responseDocument( ResponseBuffer buffer, uint32_t length ) -> std::optional<bsoncxx::document::value>
+{
+  if ( !buffer || !bsoncxx::validate( buffer.get(), length ) ) return std::nullopt;
+  return bsoncxx::document::value{ std::move( buffer ), length };
+}
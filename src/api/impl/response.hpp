@@ -0,0 +1,37 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <bsoncxx/document/value.hpp>
+
+namespace spt::mongoservice::api::impl
+{
+  /// Default limit for the size of a response document read from the service.
+  constexpr std::size_t defaultMaxResponseSize = 64 * 1024 * 1024;
+
+  using ResponseBuffer = bsoncxx::document::value::unique_ptr_type;
+
+  /**
+   * Allocate a buffer for a response document with the specified length prefix, and
+   * copy the prefix into the start of the buffer.  The rest of the document is read
+   * directly into the buffer from `sizeof(length)` onwards.
+   * @param length The length of the document as read from the first 4 bytes of the response.
+   * @param maxSize The maximum size of a response document.
+   * @return The buffer, or `nullptr` if the length is not a valid BSON document length or exceeds `maxSize`.
+   */
+  ResponseBuffer responseBuffer( uint32_t length, std::size_t maxSize );
+
+  /**
+   * Transfer ownership of a fully read response buffer to a document.
+   * @param buffer The buffer returned by `responseBuffer`, with the full document read into it.
+   * @param length The length of the document.
+   * @return The document, or `std::nullopt` if the buffer does not hold valid BSON.
+   */
+  std::optional<bsoncxx::document::value> responseDocument( ResponseBuffer buffer, uint32_t length );
+}
@@ -8,6 +8,7 @@
 #include <string>
 #include <boost/asio/io_context.hpp>
 
+#include "response.hpp"
 #include "../pool/pool.hpp"
 
 namespace spt::mongoservice::api::impl
@@ -25,6 +26,7 @@ namespace spt::mongoservice::api::impl
     std::string port{};
     std::string application{};
     pool::Configuration configuration;
+    std::size_t maxResponseSize{ defaultMaxResponseSize };
     boost::asio::io_context* ioc{ nullptr };
 
     ~ApiSettings() = default;
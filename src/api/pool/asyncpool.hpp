@@ -0,0 +1,239 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include "pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+namespace spt::mongoservice::pool
+{
+  /// Statistics for acquiring connections from an `AsyncPool`.
+  struct AcquireStats
+  {
+    /// Number of connections acquired.
+    uint64_t acquired;
+    /// Number of connections acquired after waiting for a connection to be released.
+    uint64_t waited;
+    /// Number of acquisitions that timed out (or failed immediately if `maxWaitTime` is `0`).
+    uint64_t timeouts;
+    /// Total time spent waiting by acquisitions that waited.
+    std::chrono::microseconds totalWait;
+    /// Longest time spent waiting for a connection.
+    std::chrono::microseconds maxWait;
+    /// Number of coroutines currently waiting for a connection.
+    uint32_t waiting;
+  };
+
+  /**
+   * Connection pool for use from coroutines.  Once `maxConnections` are in use, `acquire` suspends the
+   * coroutine until a connection is released (or `maxWaitTime` elapses), instead of failing immediately.
+   * Waiting coroutines are handed released connections in the order in which they started waiting.
+   *
+   * The pool must outlive all coroutines waiting on it.
+   */
+  template <typename Connection>
+  struct AsyncPool
+  {
+    using Proxy = typename Pool<Connection>::Proxy;
+    using Factory = typename Pool<Connection>::Factory;
+
+    explicit AsyncPool( Factory factory, Configuration conf = {} ) :
+        maxWaitTime{ conf.maxWaitTime }, pool{ std::move( factory ), std::move( conf ) }
+    {
+      pool.onRelease( [this] { notify(); } );
+    }
+
+    ~AsyncPool() = default;
+    AsyncPool( const AsyncPool& ) = delete;
+    AsyncPool& operator=( const AsyncPool& ) = delete;
+    AsyncPool( AsyncPool&& ) = delete;
+    AsyncPool& operator=( AsyncPool&& ) = delete;
+
+    /**
+     * Acquire a connection from the pool, waiting up to `maxWaitTime` for a connection if `maxConnections`
+     * are in use.
+     * @return The connection, or `std::nullopt` if no connection was released within `maxWaitTime`.
+     */
+    boost::asio::awaitable<std::optional<Proxy>> acquire()
+    {
+      if ( waiting.load() == 0 )
+      {
+        if ( auto proxy = pool.acquire() )
+        {
+          acquired.fetch_add( 1, std::memory_order_relaxed );
+          co_return proxy;
+        }
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      waiting.fetch_add( 1 );
+      auto executor = co_await boost::asio::this_coro::executor;
+      auto waiter = std::make_shared<Waiter>( std::move( executor ) );
+
+      {
+        auto lock = std::unique_lock( mutex );
+        if ( waiters.empty() )
+        {
+          if ( auto proxy = pool.acquire() )
+          {
+            waiting.fetch_sub( 1 );
+            acquired.fetch_add( 1, std::memory_order_relaxed );
+            co_return proxy;
+          }
+        }
+
+        if ( maxWaitTime.count() == 0 )
+        {
+          waiting.fetch_sub( 1 );
+          timeouts.fetch_add( 1, std::memory_order_relaxed );
+          co_return std::nullopt;
+        }
+
+        waiters.push_back( waiter );
+        waiter->timer.expires_after( maxWaitTime );
+        waiter->timer.async_wait( [this, waiter]( const boost::system::error_code& ec )
+        {
+          if ( ec != boost::asio::error::operation_aborted ) expire( waiter );
+        } );
+      }
+
+      co_await boost::asio::async_initiate<decltype( boost::asio::use_awaitable ), void()>(
+          [this, w = waiter.get()]( auto handler )
+          {
+            auto lock = std::unique_lock( mutex );
+            if ( w->done ) post( std::move( handler ) );
+            else w->completion = std::make_unique<Completion<decltype( handler )>>( std::move( handler ) );
+          }, boost::asio::use_awaitable );
+
+      waiting.fetch_sub( 1 );
+      if ( !waiter->proxy )
+      {
+        LOG_WARN << "Timed out waiting " << maxWaitTime.count() << "ms for connection from pool";
+        co_return std::nullopt;
+      }
+
+      const auto wait = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start );
+      acquired.fetch_add( 1, std::memory_order_relaxed );
+      waited.fetch_add( 1, std::memory_order_relaxed );
+      totalWait.fetch_add( wait.count(), std::memory_order_relaxed );
+      auto current = maxWait.load( std::memory_order_relaxed );
+      while ( current < wait.count() && !maxWait.compare_exchange_weak( current, wait.count(), std::memory_order_relaxed ) );
+
+      co_return std::move( waiter->proxy );
+    }
+
+    [[nodiscard]] AcquireStats stats() const
+    {
+      return AcquireStats{
+        .acquired = acquired.load( std::memory_order_relaxed ),
+        .waited = waited.load( std::memory_order_relaxed ),
+        .timeouts = timeouts.load( std::memory_order_relaxed ),
+        .totalWait = std::chrono::microseconds{ totalWait.load( std::memory_order_relaxed ) },
+        .maxWait = std::chrono::microseconds{ maxWait.load( std::memory_order_relaxed ) },
+        .waiting = waiting.load( std::memory_order_relaxed ) };
+    }
+
+    [[nodiscard]] uint32_t inactive() const { return pool.inactive(); }
+    [[nodiscard]] uint32_t active() const { return pool.active(); }
+    [[nodiscard]] uint32_t totalCreated() const { return pool.totalCreated(); }
+
+  private:
+    // Type erased completion handler for a suspended `acquire`.
+    struct CompletionBase
+    {
+      virtual ~CompletionBase() = default;
+      virtual void post() = 0;
+    };
+
+    template <typename Handler>
+    struct Completion final : CompletionBase
+    {
+      explicit Completion( Handler&& h ) : handler{ std::move( h ) } {}
+      void post() override { AsyncPool::post( std::move( handler ) ); }
+      Handler handler;
+    };
+
+    struct Waiter
+    {
+      explicit Waiter( boost::asio::any_io_executor executor ) : timer{ std::move( executor ) } {}
+
+      boost::asio::steady_timer timer;
+      std::optional<Proxy> proxy;
+      std::unique_ptr<CompletionBase> completion;
+      bool done{ false };
+    };
+
+    template <typename Handler>
+    static void post( Handler&& handler )
+    {
+      auto executor = boost::asio::get_associated_executor( handler );
+      boost::asio::post( executor, std::forward<Handler>( handler ) );
+    }
+
+    // Invoked with the mutex held.
+    static void complete( Waiter& waiter )
+    {
+      waiter.done = true;
+      if ( waiter.completion ) waiter.completion->post();
+      waiter.completion.reset();
+    }
+
+    void notify()
+    {
+      while ( waiting.load() > 0 )
+      {
+        // Declared before the lock, so a waiter that is no longer referenced elsewhere is destroyed after unlocking.
+        auto waiter = std::shared_ptr<Waiter>{};
+        auto lock = std::unique_lock( mutex );
+        if ( waiters.empty() ) return;
+
+        auto proxy = pool.acquire();
+        if ( !proxy ) return;
+
+        waiter = std::move( waiters.front() );
+        waiters.pop_front();
+        waiter->proxy = std::move( proxy );
+        waiter->timer.cancel();
+        complete( *waiter );
+      }
+    }
+
+    void expire( const std::shared_ptr<Waiter>& waiter )
+    {
+      auto lock = std::unique_lock( mutex );
+      if ( waiter->done ) return;
+
+      std::erase( waiters, waiter );
+      timeouts.fetch_add( 1, std::memory_order_relaxed );
+      complete( *waiter );
+    }
+
+    std::chrono::milliseconds maxWaitTime;
+    Pool<Connection> pool;
+    std::mutex mutex;
+    std::deque<std::shared_ptr<Waiter>> waiters;
+    std::atomic_uint64_t acquired{ 0 };
+    std::atomic_uint64_t waited{ 0 };
+    std::atomic_uint64_t timeouts{ 0 };
+    std::atomic_int64_t totalWait{ 0 };
+    std::atomic_int64_t maxWait{ 0 };
+    std::atomic_uint32_t waiting{ 0 };
+  };
+}
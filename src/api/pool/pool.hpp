@@ -10,17 +10,24 @@
   #else
     #include <log/NanoLog.hpp>
   #endif
+  #if __has_include("../../common/util/ringbuffer.hpp")
+    #include "../../common/util/ringbuffer.hpp"
+  #else
+    #include <mongo-service/common/util/ringbuffer.hpp>
+  #endif
 #endif
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <deque>
+#include <condition_variable>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <shared_mutex>
 #include <thread>
+#include <vector>
 
 namespace spt::mongoservice::pool
 {
@@ -38,8 +45,116 @@ namespace spt::mongoservice::pool
     uint32_t maxPoolSize{ 25 };
     uint32_t maxConnections{ 100 };
     std::chrono::seconds maxIdleTime{ 300 };
+    // Maximum time an `AsyncPool::acquire` waits for a connection once `maxConnections` are in use.
+    // A value of `0` fails immediately.
+    std::chrono::milliseconds maxWaitTime{ 1000 };
   };
 
+  namespace impl
+  {
+    /**
+     * Runs the idle connection expiry for all pools on a single thread, which sleeps until the earliest
+     * scheduled expiry instead of polling.  The thread is started when a pool first has an idle connection.
+     */
+    struct Expiry
+    {
+      using Clock = std::chrono::steady_clock;
+      using Task = std::function<void()>;
+
+      /**
+       * Run the task on the expiry thread at the specified time.  Ignored during static destruction, once
+       * the expiry thread has been stopped.
+       */
+      static void schedule( Clock::time_point when, Task task )
+      {
+        if ( alive().load( std::memory_order_acquire ) ) instance().add( when, std::move( task ) );
+      }
+
+      ~Expiry()
+      {
+        alive().store( false, std::memory_order_release );
+        {
+          auto lock = std::scoped_lock{ mutex };
+          stopped = true;
+          cv.notify_one();
+        }
+
+        if ( thread.joinable() ) thread.join();
+      }
+
+      Expiry(const Expiry&) = delete;
+      Expiry& operator=(const Expiry&) = delete;
+
+    private:
+      Expiry() = default;
+
+      static Expiry& instance()
+      {
+        static Expiry expiry;
+        return expiry;
+      }
+
+      static std::atomic_bool& alive()
+      {
+        static std::atomic_bool value{ true };
+        return value;
+      }
+
+      void add( Clock::time_point when, Task task )
+      {
+        auto lock = std::scoped_lock{ mutex };
+        if ( stopped ) return;
+
+        const auto earliest = tasks.empty() || when < tasks.begin()->first;
+        tasks.emplace( when, std::move( task ) );
+        if ( !thread.joinable() ) thread = std::thread{ &Expiry::run, this };
+        else if ( earliest ) cv.notify_one();
+      }
+
+      void run()
+      {
+        auto lock = std::unique_lock{ mutex };
+        while ( !stopped )
+        {
+          if ( tasks.empty() )
+          {
+            cv.wait( lock );
+            continue;
+          }
+
+          if ( const auto when = tasks.begin()->first; Clock::now() < when )
+          {
+            cv.wait_until( lock, when );
+            continue;
+          }
+
+          auto task = std::move( tasks.begin()->second );
+          tasks.erase( tasks.begin() );
+          lock.unlock();
+          task();
+          lock.lock();
+        }
+      }
+
+      std::mutex mutex;
+      std::condition_variable cv;
+      std::multimap<Clock::time_point, Task> tasks;
+      std::thread thread;
+      bool stopped{ false };
+    };
+  }
+
+  /**
+   * Connection pool.  Each thread caches the last connection it released to each pool, so a thread that
+   * repeatedly acquires and releases a connection does not touch any shared state other than the atomic
+   * counters and its own cache.  Other idle connections are held in a lock-free queue shared by all threads.
+   *
+   * Connections idle for longer than `maxIdleTime` are closed by a single expiry thread shared by all pools,
+   * which is woken when the oldest idle connection of a pool is due to expire.  Connections cached by threads
+   * are included, a cache is skipped only while its thread is using it.  A connection cached by a thread is
+   * returned to the shared queue when the thread exits, and all idle connections are closed when the pool
+   * is destroyed.
+   */
   template <typename Connection>
   struct Pool
   {
@@ -48,6 +163,7 @@ namespace spt::mongoservice::pool
 
     struct ConnectionWrapper
     {
+      ConnectionWrapper() = default;
       explicit ConnectionWrapper( Ptr con ) : con{ std::move( con ) } {}
 
       ConnectionWrapper( ConnectionWrapper&& c ) = default;
@@ -88,21 +204,21 @@ namespace spt::mongoservice::pool
     };
 
     explicit Pool( Factory c, Configuration conf = {} ) :
-        creator{ c }, configuration{ std::move( conf ) }
+        creator{ std::move( c ) }, state{ std::make_shared<State>( std::move( conf ) ) }
     {
-      for ( uint32_t i = 0; i < configuration.initialSize; ++i )
+      for ( uint32_t i = 0; i < state->configuration.initialSize; ++i )
       {
-        available.emplace_back( c() );
-        ++created;
+        if ( !state->available.push( ConnectionWrapper{ creator() } ) ) break;
+        state->idle.fetch_add( 1, std::memory_order_relaxed );
+        state->created.fetch_add( 1, std::memory_order_relaxed );
       }
-
-      thread = std::thread{ &Pool<Connection>::ttlMonitor, this };
     }
 
     ~Pool()
     {
-      stop.store( true );
-      thread.join();
+      state->closed.store( true, std::memory_order_release );
+      if ( Caches::alive() ) threadCaches().map.erase( state->id );
+      state->expire( std::chrono::system_clock::time_point::max() );
     }
 
     Pool( const Pool& ) = delete;
@@ -110,88 +226,316 @@ namespace spt::mongoservice::pool
 
     std::optional<Proxy> acquire()
     {
-      if ( total >= configuration.maxConnections ) return std::nullopt;
-
-      auto lock = std::unique_lock( mutex );
-      ++total;
+      auto current = state->total.load();
+      do
+      {
+        if ( current >= state->configuration.maxConnections ) return std::nullopt;
+      }
+      while ( !state->total.compare_exchange_weak( current, current + 1 ) );
 
-      if ( available.empty() )
+      if ( auto con = take() )
       {
-        ++created;
-        return Proxy{ ConnectionWrapper{ creator() }, this };
+        ++con->count;
+        return Proxy{ std::move( *con ), this };
       }
 
-      auto con = std::move( available.front() );
-      available.pop_front();
-      ++con.count;
-      return Proxy{ std::move( con ), this };
+      try
+      {
+        auto con = ConnectionWrapper{ creator() };
+        state->created.fetch_add( 1, std::memory_order_relaxed );
+        return Proxy{ std::move( con ), this };
+      }
+      catch ( ... )
+      {
+        state->total.fetch_sub( 1, std::memory_order_release );
+        throw;
+      }
     }
 
     void release( ConnectionWrapper c )
     {
-      auto lock = std::unique_lock( mutex );
-      --total;
-      if ( !c || !c.con->valid() ) return;
-      c.time = std::chrono::system_clock::now();
-      if ( available.size() < configuration.maxPoolSize ) available.emplace_back( std::move( c ) );
+      state->total.fetch_sub( 1 );
+      retain( std::move( c ) );
+      if ( listener ) listener();
     }
 
+    /**
+     * Set a function to be invoked after each connection is released (the active count has been decremented).
+     * Used by `AsyncPool` to hand connections to waiting coroutines.  Must be set before the pool is used.
+     */
+    void onRelease( std::function<void()> fn ) { listener = std::move( fn ); }
+
+    /**
+     * Number of idle connections, including those cached by threads.
+     */
     [[nodiscard]] uint32_t inactive() const
     {
-      auto lock = std::shared_lock( mutex );
-      return available.size();
+      return state->idle.load( std::memory_order_relaxed );
     }
 
     [[nodiscard]] uint32_t active() const
     {
-      auto lock = std::shared_lock( mutex );
-      return total;
+      return state->total.load( std::memory_order_relaxed );
     }
 
     [[nodiscard]] uint32_t totalCreated() const
     {
-      return created;
+      return state->created.load( std::memory_order_relaxed );
     }
 
   private:
-    void removeExpired()
+    using Time = std::chrono::time_point<std::chrono::system_clock>;
+
+    // Connection cached by a thread.  The expiry thread inspects the slot, so access is guarded by a flag
+    // that is only contended while the slot is being checked for expiry.
+    struct Slot
     {
-      auto end = false;
-      auto now = std::chrono::system_clock::now();
+      bool lock() { return !busy.exchange( true, std::memory_order_acquire ); }
+      void unlock() { busy.store( false, std::memory_order_release ); }
 
-      while ( !end )
+      ConnectionWrapper con;
+      std::atomic_bool busy{ false };
+    };
+
+    // Shared between the pool, the thread caches and the expiry thread, since they may outlive the pool.
+    struct State : std::enable_shared_from_this<State>
+    {
+      explicit State( Configuration conf ) :
+          id{ nextId.fetch_add( 1, std::memory_order_relaxed ) }, configuration{ std::move( conf ) },
+          available{ std::max( { configuration.maxPoolSize, configuration.initialSize, 1u } ) } {}
+
+      bool expired( const ConnectionWrapper& con, Time now ) const
       {
-        auto lock = std::unique_lock( mutex );
-        auto iter = std::begin( available );
-        if ( iter == std::end( available ) ) break;
+        if ( now - con.time < configuration.maxIdleTime ) return false;
 
-        const auto diff = std::chrono::duration_cast<std::chrono::seconds>( now - iter->time );
-        if ( diff < configuration.maxIdleTime ) end = true;
-        else
+        LOG_INFO << "Removing resource idling for " <<
+          static_cast<int64_t>( std::chrono::duration_cast<std::chrono::seconds>( now - con.time ).count() ) <<
+          " seconds and used " << con.count << " times";
+        return true;
+      }
+
+      void giveBack( ConnectionWrapper con )
+      {
+        const auto time = con.time;
+        if ( closed.load( std::memory_order_acquire ) || !available.push( std::move( con ) ) )
         {
-          LOG_INFO << "Removing resource idling for " << diff.count() <<
-            " seconds and used " << iter->count << " times";
-          available.erase( iter );
+          idle.fetch_sub( 1, std::memory_order_relaxed );
         }
+        else schedule( time );
       }
+
+      // Ensure an expiry is scheduled for a connection that became idle at the specified time.  Checked with a
+      // load first, so that releasing a connection does not write to shared state when an expiry is scheduled.
+      void schedule( Time time )
+      {
+        if ( closed.load( std::memory_order_acquire ) || scheduled.load( std::memory_order_acquire ) ||
+          scheduled.exchange( true, std::memory_order_acq_rel ) ) return;
+
+        const auto delay = std::chrono::duration_cast<impl::Expiry::Clock::duration>(
+          time + configuration.maxIdleTime - std::chrono::system_clock::now() );
+        impl::Expiry::schedule( impl::Expiry::Clock::now() + std::max( delay, impl::Expiry::Clock::duration::zero() ),
+          [weak = this->weak_from_this()]
+          {
+            if ( auto self = weak.lock() ) self->expire( std::chrono::system_clock::now() );
+          } );
+      }
+
+      // Discard connections idle since before `now` less `maxIdleTime`, and schedule the next expiry for
+      // the oldest remaining idle connection.  Invoked on the expiry thread, and with `Time::max()` to discard
+      // all idle connections when the pool is destroyed.
+      void expire( Time now )
+      {
+        // Cleared first, so that a connection released during the sweep schedules a new expiry if needed.
+        scheduled.store( false, std::memory_order_release );
+        auto oldest = std::optional<Time>{};
+        const auto keep = [this, now, &oldest]( const ConnectionWrapper& con )
+        {
+          if ( now != Time::max() && !expired( con, now ) )
+          {
+            oldest = std::min( oldest.value_or( con.time ), con.time );
+            return true;
+          }
+
+          idle.fetch_sub( 1, std::memory_order_relaxed );
+          return false;
+        };
+
+        // Popped and pushed back in the same order, other than interleaving with concurrent releases.
+        const auto size = available.approximateSize();
+        for ( std::size_t i = 0; i < size; ++i )
+        {
+          auto con = available.pop();
+          if ( !con ) break;
+          if ( keep( *con ) && !available.push( std::move( *con ) ) ) idle.fetch_sub( 1, std::memory_order_relaxed );
+        }
+
+        {
+          auto lock = std::scoped_lock{ mutex };
+          for ( const auto& slot : slots )
+          {
+            // In use by its thread, so the cached connection (if any) is not idle.
+            if ( !slot->lock() ) continue;
+            if ( slot->con && !keep( slot->con ) ) slot->con = ConnectionWrapper{};
+            slot->unlock();
+          }
+        }
+
+        if ( oldest ) schedule( *oldest );
+      }
+
+      std::shared_ptr<Slot> attach()
+      {
+        auto slot = std::make_shared<Slot>();
+        auto lock = std::scoped_lock{ mutex };
+        slots.push_back( slot );
+        return slot;
+      }
+
+      void detach( const std::shared_ptr<Slot>& slot )
+      {
+        auto lock = std::scoped_lock{ mutex };
+        std::erase( slots, slot );
+      }
+
+      static inline std::atomic_uint64_t nextId{ 0 };
+
+      const uint64_t id;
+      Configuration configuration;
+      util::RingBuffer<ConnectionWrapper> available;
+      alignas(64) std::atomic_uint32_t total{ 0 };
+      alignas(64) std::atomic_uint32_t idle{ 0 };
+      std::atomic_uint32_t created{ 0 };
+      std::atomic_bool closed{ false };
+      std::atomic_bool scheduled{ false };
+      // Caches of the threads that have used the pool.  Only locked when a thread first uses the pool,
+      // when it exits, and during expiry.
+      std::mutex mutex;
+      std::vector<std::shared_ptr<Slot>> slots;
+    };
+
+    struct Cache
+    {
+      Cache() = default;
+      ~Cache() { reset(); }
+
+      Cache(const Cache&) = delete;
+      Cache& operator=(const Cache&) = delete;
+      Cache(Cache&&) = delete;
+      Cache& operator=(Cache&&) = delete;
+
+      void reset()
+      {
+        if ( !state ) return;
+
+        // Wait for the expiry thread if it is inspecting the slot.
+        while ( !slot->lock() ) std::this_thread::yield();
+        auto con = std::move( slot->con );
+        slot->con = ConnectionWrapper{};
+        slot->unlock();
+
+        state->detach( slot );
+        if ( con ) state->giveBack( std::move( con ) );
+        slot.reset();
+        state.reset();
+      }
+
+      std::shared_ptr<State> state;
+      std::shared_ptr<Slot> slot;
+    };
+
+    // Caches for each pool used by a thread, keyed by pool identifier.
+    struct Caches
+    {
+      Caches() = default;
+      ~Caches() { alive() = false; }
+
+      Caches(const Caches&) = delete;
+      Caches& operator=(const Caches&) = delete;
+
+      // Pools destroyed during static destruction may outlive the caches of the main thread.
+      static bool& alive()
+      {
+        static thread_local bool value{ true };
+        return value;
+      }
+
+      std::map<uint64_t, Cache> map;
+    };
+
+    static Caches& threadCaches()
+    {
+      static thread_local Caches caches;
+      return caches;
     }
 
-    void ttlMonitor()
+    // Cache for this pool in the calling thread.  Connections cached for pools that have been destroyed
+    // are discarded, the map is typically tiny since few pools of each type exist.
+    Cache& threadCache()
     {
-      while ( !stop.load() )
+      auto& caches = threadCaches().map;
+      if ( caches.size() > 1 ) [[unlikely]]
       {
-        removeExpired();
-        std::this_thread::sleep_for( std::chrono::seconds{ 1 } );
+        std::erase_if( caches, []( const auto& entry ) { return entry.second.state->closed.load( std::memory_order_acquire ); } );
       }
+
+      if ( auto iter = caches.find( state->id ); iter != caches.end() ) [[likely]] return iter->second;
+
+      auto& cache = caches.try_emplace( state->id ).first->second;
+      cache.state = state;
+      cache.slot = state->attach();
+      return cache;
+    }
+
+    void retain( ConnectionWrapper c )
+    {
+      if ( !c || !c.con->valid() ) return;
+
+      auto idle = state->idle.load( std::memory_order_relaxed );
+      do
+      {
+        if ( idle >= state->configuration.maxPoolSize ) return;
+      }
+      while ( !state->idle.compare_exchange_weak( idle, idle + 1, std::memory_order_relaxed ) );
+
+      c.time = std::chrono::system_clock::now();
+      const auto time = c.time;
+      if ( auto& slot = *threadCache().slot; slot.lock() )
+      {
+        if ( !slot.con ) slot.con = std::move( c );
+        slot.unlock();
+      }
+
+      if ( c && !state->available.push( std::move( c ) ) ) state->idle.fetch_sub( 1, std::memory_order_relaxed );
+      state->schedule( time );
+    }
+
+    std::optional<ConnectionWrapper> take()
+    {
+      const auto now = std::chrono::system_clock::now();
+      if ( auto& slot = *threadCache().slot; slot.lock() )
+      {
+        auto con = std::move( slot.con );
+        slot.con = ConnectionWrapper{};
+        slot.unlock();
+
+        if ( con )
+        {
+          state->idle.fetch_sub( 1, std::memory_order_relaxed );
+          if ( !state->expired( con, now ) ) return con;
+        }
+      }
+
+      while ( auto con = state->available.pop() )
+      {
+        state->idle.fetch_sub( 1, std::memory_order_relaxed );
+        if ( !state->expired( *con, now ) ) return con;
+      }
+
+      return std::nullopt;
     }
 
     Factory creator;
-    Configuration configuration;
-    std::deque<ConnectionWrapper> available;
-    std::thread thread;
-    mutable std::shared_mutex mutex;
-    std::atomic_bool stop{ false };
-    uint32_t total = 0;
-    uint32_t created = 0;
+    std::function<void()> listener;
+    std::shared_ptr<State> state;
   };
 }
@@ -4,6 +4,7 @@
 
 #include "bson.hpp"
 #include "date.hpp"
+#include "parser.hpp"
 #if defined __has_include
   #if __has_include("../../log/NanoLog.hpp")
     #include "../../log/NanoLog.hpp"
@@ -19,9 +20,22 @@
 #include <bsoncxx/builder/stream/array.hpp>
 #include <bsoncxx/builder/stream/document.hpp>
 #include <bsoncxx/exception/exception.hpp>
-
+#include <bsoncxx/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
 #include <format>
 #include <iomanip>
+#include <limits>
+#include <unordered_set>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace spt::util
 {
@@ -406,6 +420,831 @@ namespace spt::util
 
       return O{ std::string{ v } };
     }
+
+    /**
+     * Writes BSON into a single buffer, which is handed over to the document when done.  The type of each
+     * element is written as a placeholder and set once the value has been written, since the type of a
+     * JSON object (sub-document or extended JSON value) is only known after its first key has been read.
+     */
+    struct Writer
+    {
+      explicit Writer( std::size_t capacity ) :
+        buffer{ new uint8_t[capacity], deallocate }, capacity{ capacity } {}
+
+      ~Writer() = default;
+      Writer(Writer&&) = default;
+      Writer& operator=(Writer&&) = default;
+
+      Writer(const Writer&) = delete;
+      Writer& operator=(const Writer&) = delete;
+
+      // Start a document or array.  Returns the offset to pass to close.
+      std::size_t open()
+      {
+        const auto start = size;
+        append( int32_t{ 0 } );
+        return start;
+      }
+
+      void close( std::size_t start )
+      {
+        append( uint8_t{ 0 } );
+        write( start, static_cast<int32_t>( size - start ) );
+      }
+
+      // Write the element header with a placeholder type.  Returns the offset of the type.
+      std::size_t element( std::string_view key )
+      {
+        if ( std::memchr( key.data(), 0, key.size() ) != nullptr )
+        {
+          LOG_WARN << "Key with embedded null character cannot be written to BSON";
+          throw simdjson::simdjson_error{ simdjson::error_code::INCORRECT_TYPE };
+        }
+
+        const auto offset = size;
+        reserve( key.size() + 2 );
+        buffer[size++] = 0;
+        std::memcpy( buffer.get() + size, key.data(), key.size() );
+        size += key.size();
+        buffer[size++] = 0;
+        return offset;
+      }
+
+      void type( std::size_t offset, bsoncxx::type type ) { buffer[offset] = static_cast<uint8_t>( type ); }
+      void truncate( std::size_t offset ) { size = offset; }
+
+      template <typename T>
+      void append( T value )
+      {
+        reserve( sizeof(T) );
+        write( size, value );
+        size += sizeof(T);
+      }
+
+      void append( std::string_view value )
+      {
+        append( static_cast<int32_t>( value.size() + 1 ) );
+        reserve( value.size() + 1 );
+        std::memcpy( buffer.get() + size, value.data(), value.size() );
+        size += value.size();
+        buffer[size++] = 0;
+      }
+
+      void append( const bsoncxx::oid& value )
+      {
+        reserve( bsoncxx::oid::k_oid_length );
+        std::memcpy( buffer.get() + size, value.bytes(), bsoncxx::oid::k_oid_length );
+        size += bsoncxx::oid::k_oid_length;
+      }
+
+      bsoncxx::document::value document() &&
+      {
+        return bsoncxx::document::value{ std::move( buffer ), size };
+      }
+
+    private:
+      static void deallocate( uint8_t* data ) { delete [] data; }
+
+      void reserve( std::size_t bytes )
+      {
+        if ( size + bytes <= capacity ) return;
+
+        capacity = std::max( 2 * capacity, size + bytes );
+        auto grown = bsoncxx::document::value::unique_ptr_type{ new uint8_t[capacity], deallocate };
+        std::memcpy( grown.get(), buffer.get(), size );
+        buffer = std::move( grown );
+      }
+
+      // BSON is little-endian
+      template <typename T>
+      void write( std::size_t offset, T value )
+      {
+        auto bytes = std::bit_cast<std::array<uint8_t, sizeof(T)>>( value );
+        if constexpr ( std::endian::native == std::endian::big ) std::ranges::reverse( bytes );
+        std::memcpy( buffer.get() + offset, bytes.data(), bytes.size() );
+      }
+
+      bsoncxx::document::value::unique_ptr_type buffer;
+      std::size_t capacity;
+      std::size_t size{ 0 };
+    };
+
+    // Thrown by the transcoder for extended JSON types that are not transcoded directly.
+    struct UnsupportedType
+    {
+      std::string_view key;
+    };
+
+    /**
+     * Walks the simdjson on-demand parser and writes each value as it is encountered.
+     */
+    struct Transcoder
+    {
+      // Write the value as an element of the current document or array.  Returns false if the value was skipped.
+      bool element( std::string_view key, simdjson::ondemand::value value )
+      {
+        const auto offset = writer.element( key );
+        if ( const auto t = write( value ); t )
+        {
+          writer.type( offset, *t );
+          return true;
+        }
+
+        writer.truncate( offset );
+        return false;
+      }
+
+      std::optional<bsoncxx::type> write( simdjson::ondemand::value& value )
+      {
+        using simdjson::ondemand::json_type;
+        switch ( json_type( value.type() ) )
+        {
+        case json_type::object:
+          return object( value.get_object() );
+        case json_type::array:
+          array( value.get_array() );
+          return bsoncxx::type::k_array;
+        case json_type::number:
+          return number( value );
+        case json_type::string:
+          return string( value.get_string() );
+        case json_type::boolean:
+          writer.append( static_cast<uint8_t>( bool( value.get_bool() ) ) );
+          return bsoncxx::type::k_bool;
+        case json_type::null:
+          if ( !value.is_null() ) throw simdjson::simdjson_error{ simdjson::error_code::N_ATOM_ERROR };
+          if ( types == JsonTypes::Inferred ) return std::nullopt;
+          return bsoncxx::type::k_null;
+        default:
+          throw simdjson::simdjson_error{ simdjson::error_code::INCORRECT_TYPE };
+        }
+      }
+
+      // Sub-document, or the value of an extended JSON object such as {"$oid": "..."}
+      bsoncxx::type object( simdjson::ondemand::object object )
+      {
+        auto start = std::optional<std::size_t>{};
+        auto wrapped = std::optional<bsoncxx::type>{};
+
+        for ( auto field : object )
+        {
+          const std::string_view key = field.unescaped_key();
+          if ( wrapped ) invalid( key );
+
+          if ( !start )
+          {
+            if ( key.starts_with( '$' ) ) wrapped = extended( key, field.value() );
+            if ( wrapped ) continue;
+            start = writer.open();
+          }
+
+          element( key, field.value() );
+        }
+
+        if ( wrapped ) return *wrapped;
+        if ( !start ) start = writer.open();
+        writer.close( *start );
+        return bsoncxx::type::k_document;
+      }
+
+      void array( simdjson::ondemand::array array )
+      {
+        const auto start = writer.open();
+        auto key = std::array<char, 24>{};
+        std::size_t index = 0;
+
+        for ( simdjson::ondemand::value item : array )
+        {
+          const auto [end, ec] = std::to_chars( key.data(), key.data() + key.size(), index );
+          if ( element( std::string_view{ key.data(), end }, item ) ) ++index;
+        }
+
+        writer.close( start );
+      }
+
+      bsoncxx::type number( simdjson::ondemand::value& value )
+      {
+        using simdjson::ondemand::number_type;
+        switch ( number_type( value.get_number_type() ) )
+        {
+        case number_type::signed_integer:
+        {
+          const int64_t v = value.get_int64();
+          if ( types == JsonTypes::Extended &&
+            v >= std::numeric_limits<int32_t>::min() && v <= std::numeric_limits<int32_t>::max() )
+          {
+            writer.append( static_cast<int32_t>( v ) );
+            return bsoncxx::type::k_int32;
+          }
+
+          writer.append( v );
+          return bsoncxx::type::k_int64;
+        }
+        case number_type::unsigned_integer:
+          // Only used for values larger than int64 max
+          if ( types == JsonTypes::Inferred )
+          {
+            writer.append( static_cast<int64_t>( uint64_t( value.get_uint64() ) ) );
+            return bsoncxx::type::k_int64;
+          }
+          writer.append( double( value.get_double() ) );
+          return bsoncxx::type::k_double;
+        default:
+          writer.append( double( value.get_double() ) );
+          return bsoncxx::type::k_double;
+        }
+      }
+
+      std::optional<bsoncxx::type> string( std::string_view value )
+      {
+        if ( types == JsonTypes::Inferred )
+        {
+          if ( value.empty() ) return std::nullopt;
+
+          if ( const auto oid = objectId( value ); oid )
+          {
+            writer.append( *oid );
+            return bsoncxx::type::k_oid;
+          }
+
+          if ( value.front() > 47 && value.front() < 58 && value.find( '-' ) != std::string_view::npos )
+          {
+            if ( const auto dt = parseISO8601( value ); dt )
+            {
+              writer.append( std::chrono::duration_cast<std::chrono::milliseconds>( dt->time_since_epoch() ).count() );
+              return bsoncxx::type::k_date;
+            }
+          }
+        }
+
+        writer.append( value );
+        return bsoncxx::type::k_string;
+      }
+
+      // Returns std::nullopt if the key is not an extended JSON type, in which case the value is not consumed.
+      std::optional<bsoncxx::type> extended( std::string_view key, simdjson::ondemand::value value )
+      {
+        if ( key == "$oid" )
+        {
+          const auto oid = objectId( value.get_string() );
+          if ( !oid ) invalid( key );
+          writer.append( *oid );
+          return bsoncxx::type::k_oid;
+        }
+
+        if ( key == "$date" )
+        {
+          writer.append( date( value ) );
+          return bsoncxx::type::k_date;
+        }
+
+        if ( key == "$numberLong" )
+        {
+          writer.append( parse<int64_t>( key, value.get_string() ) );
+          return bsoncxx::type::k_int64;
+        }
+
+        if ( key == "$numberInt" )
+        {
+          writer.append( parse<int32_t>( key, value.get_string() ) );
+          return bsoncxx::type::k_int32;
+        }
+
+        if ( key == "$numberDouble" )
+        {
+          const std::string_view v = value.get_string();
+          if ( v == "Infinity" ) writer.append( std::numeric_limits<double>::infinity() );
+          else if ( v == "-Infinity" ) writer.append( -std::numeric_limits<double>::infinity() );
+          else if ( v == "NaN" ) writer.append( std::numeric_limits<double>::quiet_NaN() );
+          else writer.append( parse<double>( key, v ) );
+          return bsoncxx::type::k_double;
+        }
+
+        if ( unsupported( key ) ) throw UnsupportedType{ key };
+        return std::nullopt;
+      }
+
+      // Extended JSON types that are not transcoded directly.  Not query operators, so must not be
+      // written as regular fields.
+      static bool unsupported( std::string_view key )
+      {
+        using std::operator""sv;
+        static constexpr auto keys = std::array{ "$binary"sv, "$code"sv, "$dbPointer"sv, "$maxKey"sv, "$minKey"sv,
+          "$numberDecimal"sv, "$regularExpression"sv, "$symbol"sv, "$timestamp"sv, "$undefined"sv, "$uuid"sv };
+        return std::ranges::find( keys, key ) != keys.end();
+      }
+
+      // Milliseconds since epoch from an ISO8601 string, number, or {"$numberLong": "..."}
+      int64_t date( simdjson::ondemand::value& value )
+      {
+        using simdjson::ondemand::json_type;
+        switch ( json_type( value.type() ) )
+        {
+        case json_type::string:
+        {
+          const auto dt = parseISO8601( value.get_string() );
+          if ( !dt ) invalid( "$date" );
+          return std::chrono::duration_cast<std::chrono::milliseconds>( dt->time_since_epoch() ).count();
+        }
+        case json_type::number:
+          return value.get_int64();
+        case json_type::object:
+        {
+          auto result = std::optional<int64_t>{};
+          for ( auto field : value.get_object() )
+          {
+            const std::string_view key = field.unescaped_key();
+            if ( result || key != "$numberLong" ) invalid( "$date" );
+            result = parse<int64_t>( key, field.value().get_string() );
+          }
+          if ( !result ) invalid( "$date" );
+          return *result;
+        }
+        default:
+          invalid( "$date" );
+        }
+      }
+
+      template <typename T>
+      static T parse( std::string_view key, std::string_view value )
+      {
+        T result{};
+        const auto [ptr, ec] = std::from_chars( value.data(), value.data() + value.size(), result );
+        if ( ec != std::errc{} || ptr != value.data() + value.size() ) invalid( key );
+        return result;
+      }
+
+      static std::optional<bsoncxx::oid> objectId( std::string_view value )
+      {
+        if ( value.size() != 2 * bsoncxx::oid::k_oid_length ) return std::nullopt;
+
+        const auto nibble = []( char c ) -> int
+        {
+          if ( c >= '0' && c <= '9' ) return c - '0';
+          if ( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+          if ( c >= 'A' && c <= 'F' ) return c - 'A' + 10;
+          return -1;
+        };
+
+        auto bytes = std::array<char, bsoncxx::oid::k_oid_length>{};
+        for ( std::size_t i = 0; i < bytes.size(); ++i )
+        {
+          const auto high = nibble( value[2 * i] );
+          const auto low = nibble( value[2 * i + 1] );
+          if ( high < 0 || low < 0 ) return std::nullopt;
+          bytes[i] = static_cast<char>( ( high << 4 ) | low );
+        }
+
+        return bsoncxx::oid{ bytes.data(), bytes.size() };
+      }
+
+      [[noreturn]] static void invalid( std::string_view key )
+      {
+        LOG_WARN << "Invalid extended JSON value for " << key;
+        throw simdjson::simdjson_error{ simdjson::error_code::INCORRECT_TYPE };
+      }
+
+      Writer writer;
+      JsonTypes types;
+    };
+
+    struct StringSink
+    {
+      void append( std::string_view value ) { out.append( value ); }
+      void push( char c ) { out.push_back( c ); }
+
+      std::string& out;
+    };
+
+    // Buffers output to avoid a virtual call into the stream for each character.
+    struct StreamSink
+    {
+      explicit StreamSink( std::ostream& os ) : os{ os } {}
+      ~StreamSink() { flush(); }
+
+      StreamSink(const StreamSink&) = delete;
+      StreamSink& operator=(const StreamSink&) = delete;
+
+      void append( std::string_view value )
+      {
+        if ( value.size() > buffer.size() - size )
+        {
+          flush();
+          if ( value.size() > buffer.size() )
+          {
+            os.write( value.data(), static_cast<std::streamsize>( value.size() ) );
+            return;
+          }
+        }
+
+        std::memcpy( buffer.data() + size, value.data(), value.size() );
+        size += value.size();
+      }
+
+      void push( char c )
+      {
+        if ( size == buffer.size() ) flush();
+        buffer[size++] = c;
+      }
+
+      void flush()
+      {
+        os.write( buffer.data(), static_cast<std::streamsize>( size ) );
+        size = 0;
+      }
+
+      std::ostream& os;
+      std::array<char, 4096> buffer;
+      std::size_t size{ 0 };
+    };
+
+    // Discards output beyond the end of the buffer, but keeps count of the full length.
+    struct SpanSink
+    {
+      void append( std::string_view value )
+      {
+        if ( size < buffer.size() ) std::memcpy( buffer.data() + size, value.data(), std::min( value.size(), buffer.size() - size ) );
+        size += value.size();
+      }
+
+      void push( char c )
+      {
+        if ( size < buffer.size() ) buffer[size] = c;
+        ++size;
+      }
+
+      std::span<char> buffer;
+      std::size_t size{ 0 };
+    };
+
+    // Index of the first character in the value that must be escaped in a JSON string, or the size of the value.
+    std::size_t unescaped( std::string_view value )
+    {
+      std::size_t i = 0;
+#if defined(__SSE2__)
+      const auto quote = _mm_set1_epi8( '"' );
+      const auto backslash = _mm_set1_epi8( '\\' );
+      const auto control = _mm_set1_epi8( 0x1f );
+      for ( ; i + 16 <= value.size(); i += 16 )
+      {
+        const auto chunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>( value.data() + i ) );
+        const auto mask = _mm_or_si128(
+          _mm_or_si128( _mm_cmpeq_epi8( chunk, quote ), _mm_cmpeq_epi8( chunk, backslash ) ),
+          _mm_cmpeq_epi8( _mm_min_epu8( chunk, control ), chunk ) );
+        if ( const auto bits = _mm_movemask_epi8( mask ); bits ) return i + std::countr_zero( static_cast<uint32_t>( bits ) );
+      }
+#endif
+
+      // Eight characters at a time.  See https://graphics.stanford.edu/~seander/bithacks.html#ZeroInWord
+      constexpr uint64_t ones = 0x0101010101010101;
+      constexpr uint64_t high = 0x8080808080808080;
+      for ( ; i + 8 <= value.size(); i += 8 )
+      {
+        uint64_t word;
+        std::memcpy( &word, value.data() + i, sizeof(word) );
+        const auto q = word ^ ( ones * '"' );
+        const auto b = word ^ ( ones * '\\' );
+        if ( ( ( ( q - ones ) & ~q ) | ( ( b - ones ) & ~b ) | ( ( word - ones * 0x20 ) & ~word ) ) & high ) break;
+      }
+
+      for ( ; i < value.size(); ++i )
+      {
+        const auto c = static_cast<uint8_t>( value[i] );
+        if ( c < 0x20 || c == '"' || c == '\\' ) return i;
+      }
+
+      return value.size();
+    }
+
+    /**
+     * Writes JSON for BSON values directly into the sink.
+     */
+    template <typename Sink>
+    struct JsonWriter
+    {
+      template <typename View>
+      void elements( const View& view, bool array )
+      {
+        sink.push( array ? '[' : '{' );
+        auto first = true;
+        const auto unique = format == JsonFormat::Plain && !array;
+        const auto base = keys.size();
+        auto seen = std::unordered_set<std::string_view>{};
+
+        for ( const auto& e : view )
+        {
+          if ( format == JsonFormat::Plain && !plain( e.type() ) ) continue;
+          if ( unique && duplicate( e.key(), base, seen ) ) continue;
+
+          if ( !first ) sink.push( ',' );
+          first = false;
+
+          if ( !array )
+          {
+            string( e.key() );
+            sink.push( ':' );
+          }
+
+          value( e );
+        }
+
+        sink.push( array ? ']' : '}' );
+        keys.resize( base );
+      }
+
+      // The plain format matches toJson, which keeps the first of duplicate keys (as boost::json::object::emplace).
+      // Keys of small documents are checked linearly, larger documents switch to a hash set.
+      bool duplicate( std::string_view key, std::size_t base, std::unordered_set<std::string_view>& seen )
+      {
+        static constexpr std::size_t linear = 32;
+        if ( !seen.empty() ) return !seen.insert( key ).second;
+
+        if ( std::find( keys.begin() + static_cast<std::ptrdiff_t>( base ), keys.end(), key ) != keys.end() ) return true;
+        if ( keys.size() - base < linear )
+        {
+          keys.push_back( key );
+          return false;
+        }
+
+        seen.reserve( 2 * linear );
+        seen.insert( keys.begin() + static_cast<std::ptrdiff_t>( base ), keys.end() );
+        seen.insert( key );
+        return false;
+      }
+
+      void value( const bsoncxx::document::element& e )
+      {
+        using bsoncxx::type;
+        switch ( e.type() )
+        {
+        case type::k_double:
+          number( e.get_double().value );
+          break;
+        case type::k_string:
+          string( e.get_string().value );
+          break;
+        case type::k_document:
+          elements( e.get_document().value, false );
+          break;
+        case type::k_array:
+          elements( e.get_array().value, true );
+          break;
+        case type::k_binary:
+        {
+          const auto binary = e.get_binary();
+          sink.append( R"({"$binary":{"base64":")" );
+          base64( binary.bytes, binary.size );
+          sink.append( R"(","subType":")" );
+          hex( reinterpret_cast<const uint8_t*>( &binary.sub_type ), 1 );
+          sink.append( R"("}})" );
+          break;
+        }
+        case type::k_undefined:
+          sink.append( R"({"$undefined":true})" );
+          break;
+        case type::k_oid:
+        {
+          const auto oid = e.get_oid().value;
+          if ( format != JsonFormat::Plain ) sink.append( R"({"$oid":)" );
+          sink.push( '"' );
+          hex( reinterpret_cast<const uint8_t*>( oid.bytes() ), bsoncxx::oid::k_oid_length );
+          sink.push( '"' );
+          if ( format != JsonFormat::Plain ) sink.push( '}' );
+          break;
+        }
+        case type::k_bool:
+          sink.append( e.get_bool().value ? "true" : "false" );
+          break;
+        case type::k_date:
+          date( e.get_date().value.count() );
+          break;
+        case type::k_null:
+          sink.append( "null" );
+          break;
+        case type::k_regex:
+        {
+          const auto regex = e.get_regex();
+          sink.append( R"({"$regularExpression":{"pattern":)" );
+          string( regex.regex );
+          sink.append( R"(,"options":)" );
+          string( regex.options );
+          sink.append( "}}" );
+          break;
+        }
+        case type::k_dbpointer:
+        {
+          const auto pointer = e.get_dbpointer();
+          sink.append( R"({"$dbPointer":{"$ref":)" );
+          string( pointer.collection );
+          sink.append( R"(,"$id":{"$oid":")" );
+          hex( reinterpret_cast<const uint8_t*>( pointer.value.bytes() ), bsoncxx::oid::k_oid_length );
+          sink.append( R"("}}})" );
+          break;
+        }
+        case type::k_code:
+          sink.append( R"({"$code":)" );
+          string( e.get_code().code );
+          sink.push( '}' );
+          break;
+        case type::k_symbol:
+          sink.append( R"({"$symbol":)" );
+          string( e.get_symbol().symbol );
+          sink.push( '}' );
+          break;
+        case type::k_codewscope:
+        {
+          const auto code = e.get_codewscope();
+          sink.append( R"({"$code":)" );
+          string( code.code );
+          sink.append( R"(,"$scope":)" );
+          elements( code.scope, false );
+          sink.push( '}' );
+          break;
+        }
+        case type::k_int32:
+          integer( e.get_int32().value, R"({"$numberInt":")" );
+          break;
+        case type::k_timestamp:
+        {
+          const auto ts = e.get_timestamp();
+          sink.append( R"({"$timestamp":{"t":)" );
+          integer( ts.timestamp );
+          sink.append( R"(,"i":)" );
+          integer( ts.increment );
+          sink.append( "}}" );
+          break;
+        }
+        case type::k_int64:
+          integer( e.get_int64().value, R"({"$numberLong":")" );
+          break;
+        case type::k_decimal128:
+          sink.append( R"({"$numberDecimal":")" );
+          sink.append( e.get_decimal128().value.to_string() );
+          sink.append( R"("})" );
+          break;
+        case type::k_maxkey:
+          sink.append( R"({"$maxKey":1})" );
+          break;
+        case type::k_minkey:
+          sink.append( R"({"$minKey":1})" );
+          break;
+        }
+      }
+
+      // Types written in the plain format
+      static bool plain( bsoncxx::type t )
+      {
+        using bsoncxx::type;
+        switch ( t )
+        {
+        case type::k_array:
+        case type::k_document:
+        case type::k_bool:
+        case type::k_date:
+        case type::k_double:
+        case type::k_int32:
+        case type::k_int64:
+        case type::k_oid:
+        case type::k_string:
+          return true;
+        default:
+          return false;
+        }
+      }
+
+      void string( std::string_view value )
+      {
+        static constexpr auto digits = std::string_view{ "0123456789abcdef" };
+        sink.push( '"' );
+
+        while ( !value.empty() )
+        {
+          const auto n = unescaped( value );
+          sink.append( value.substr( 0, n ) );
+          if ( n == value.size() ) break;
+
+          switch ( const auto c = static_cast<uint8_t>( value[n] ) )
+          {
+          case '"': sink.append( R"(\")" ); break;
+          case '\\': sink.append( R"(\\)" ); break;
+          case '\b': sink.append( R"(\b)" ); break;
+          case '\f': sink.append( R"(\f)" ); break;
+          case '\n': sink.append( R"(\n)" ); break;
+          case '\r': sink.append( R"(\r)" ); break;
+          case '\t': sink.append( R"(\t)" ); break;
+          default:
+            sink.append( R"(\u00)" );
+            sink.push( digits[c >> 4] );
+            sink.push( digits[c & 0xf] );
+          }
+
+          value.remove_prefix( n + 1 );
+        }
+
+        sink.push( '"' );
+      }
+
+      template <typename T>
+      void integer( T value )
+      {
+        auto buffer = std::array<char, 24>{};
+        const auto [end, ec] = std::to_chars( buffer.data(), buffer.data() + buffer.size(), value );
+        sink.append( std::string_view{ buffer.data(), end } );
+      }
+
+      template <typename T>
+      void integer( T value, std::string_view wrapper )
+      {
+        if ( format != JsonFormat::Canonical ) return integer( value );
+
+        sink.append( wrapper );
+        integer( value );
+        sink.append( R"("})" );
+      }
+
+      void number( double value )
+      {
+        if ( !std::isfinite( value ) )
+        {
+          if ( format == JsonFormat::Plain ) sink.append( "null" );
+          else if ( std::isnan( value ) ) sink.append( R"({"$numberDouble":"NaN"})" );
+          else sink.append( value > 0 ? R"({"$numberDouble":"Infinity"})" : R"({"$numberDouble":"-Infinity"})" );
+          return;
+        }
+
+        // Shortest representation that round trips, with a fraction to indicate the type for integral values.
+        auto buffer = std::array<char, 32>{};
+        const auto [end, ec] = std::to_chars( buffer.data(), buffer.data() + buffer.size(), value );
+        const auto repr = std::string_view{ buffer.data(), end };
+
+        if ( format == JsonFormat::Canonical ) sink.append( R"({"$numberDouble":")" );
+        sink.append( repr );
+        if ( repr.find_first_of( ".e" ) == std::string_view::npos ) sink.append( ".0" );
+        if ( format == JsonFormat::Canonical ) sink.append( R"("})" );
+      }
+
+      void date( int64_t millis )
+      {
+        // 1970-01-01 to 9999-12-31
+        constexpr int64_t max = 253402300799999;
+        const auto iso = format == JsonFormat::Plain ? ( millis >= -62167219200000 && millis <= max ) :
+          ( format == JsonFormat::Relaxed && millis >= 0 && millis <= max );
+
+        auto buffer = std::array<char, 24>{};
+        if ( iso )
+        {
+          if ( format != JsonFormat::Plain ) sink.append( R"({"$date":)" );
+          sink.push( '"' );
+          sink.append( isoDateMillis( std::chrono::milliseconds{ millis }, buffer ) );
+          sink.push( '"' );
+          if ( format != JsonFormat::Plain ) sink.push( '}' );
+          return;
+        }
+
+        if ( format == JsonFormat::Plain ) return integer( millis );
+
+        sink.append( R"({"$date":{"$numberLong":")" );
+        integer( millis );
+        sink.append( R"("}})" );
+      }
+
+      void hex( const uint8_t* bytes, std::size_t size )
+      {
+        static constexpr auto digits = std::string_view{ "0123456789abcdef" };
+        auto buffer = std::array<char, 2 * bsoncxx::oid::k_oid_length>{};
+        for ( std::size_t i = 0; i < size; ++i )
+        {
+          buffer[2 * i] = digits[bytes[i] >> 4];
+          buffer[2 * i + 1] = digits[bytes[i] & 0xf];
+        }
+        sink.append( std::string_view{ buffer.data(), 2 * size } );
+      }
+
+      void base64( const uint8_t* bytes, std::size_t size )
+      {
+        static constexpr auto alphabet = std::string_view{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+        auto buffer = std::array<char, 4>{};
+
+        for ( std::size_t i = 0; i < size; i += 3 )
+        {
+          const auto remaining = size - i;
+          const uint32_t triple = ( uint32_t( bytes[i] ) << 16 ) |
+            ( remaining > 1 ? uint32_t( bytes[i + 1] ) << 8 : 0u ) |
+            ( remaining > 2 ? uint32_t( bytes[i + 2] ) : 0u );
+
+          buffer[0] = alphabet[( triple >> 18 ) & 0x3f];
+          buffer[1] = alphabet[( triple >> 12 ) & 0x3f];
+          buffer[2] = remaining > 1 ? alphabet[( triple >> 6 ) & 0x3f] : '=';
+          buffer[3] = remaining > 2 ? alphabet[triple & 0x3f] : '=';
+          sink.append( std::string_view{ buffer.data(), buffer.size() } );
+        }
+      }
+
+      Sink& sink;
+      JsonFormat format;
+      // Keys written so far in the plain format, for the documents currently being written (innermost last).
+      std::vector<std::string_view> keys{};
+    };
   }
 }
 
@@ -457,8 +1296,7 @@ boost::json::array spt::util::toJson( const bsoncxx::array::view& view )
 
 std::ostream& spt::util::toJson( std::ostream& os, const bsoncxx::array::view& view )
 {
-  os << boost::json::serialize( toJson( view ) );
-  return os;
+  return writeJson( os, view, JsonFormat::Plain );
 }
 
 boost::json::object spt::util::toJson( const bsoncxx::document::view& view )
@@ -512,8 +1350,7 @@ boost::json::object spt::util::toJson( const bsoncxx::document::view& view )
 
 std::ostream& spt::util::toJson( std::ostream& os, const bsoncxx::document::view& view )
 {
-  os << toJson( view );
-  return os;
+  return writeJson( os, view, JsonFormat::Plain );
 }
 
 bsoncxx::array::value spt::util::toBson( const boost::json::array& array )
@@ -610,6 +1447,102 @@ bsoncxx::document::value spt::util::toBson( const boost::json::object& object )
   return obj << bsoncxx::builder::stream::finalize;
 }
 
+bsoncxx::document::value spt::util::toBson( std::string_view json, JsonTypes types )
+{
+  auto& pool = spt::util::json::parser::Pool::instance();
+  auto proxy = pool.acquire();
+  auto& parser = proxy.value().operator*();
+  auto str = simdjson::padded_string{ json };
+  simdjson::ondemand::document doc = parser.parser().iterate( str );
+
+  // BSON is usually smaller than the equivalent JSON, other than for arrays of short values.
+  auto transcoder = pbson::Transcoder{ pbson::Writer{ json.size() + json.size() / 2 + 16 }, types };
+  try
+  {
+    const auto start = transcoder.writer.open();
+    for ( auto field : doc.get_object() ) transcoder.element( field.unescaped_key(), field.value() );
+    transcoder.writer.close( start );
+  }
+  catch ( const pbson::UnsupportedType& ex )
+  {
+    if ( types == JsonTypes::Extended )
+    {
+      LOG_DEBUG << "Transcoding JSON with extended JSON type " << ex.key << " using bsoncxx";
+      try
+      {
+        return bsoncxx::from_json( json );
+      }
+      catch ( const bsoncxx::exception& e )
+      {
+        LOG_WARN << "Invalid extended JSON value for " << ex.key << ". " << e.what();
+        throw simdjson::simdjson_error{ simdjson::error_code::INCORRECT_TYPE };
+      }
+    }
+
+    LOG_WARN << "Unsupported extended JSON type " << ex.key;
+    throw simdjson::simdjson_error{ simdjson::error_code::INCORRECT_TYPE };
+  }
+
+  if ( !doc.at_end() ) throw simdjson::simdjson_error{ simdjson::error_code::TRAILING_CONTENT };
+  return std::move( transcoder.writer ).document();
+}
+
+void spt::util::writeJson( std::string& out, bsoncxx::document::view view, JsonFormat format )
+{
+  auto sink = pbson::StringSink{ out };
+  pbson::JsonWriter<pbson::StringSink>{ sink, format }.elements( view, false );
+}
+
+void spt::util::writeJson( std::string& out, bsoncxx::array::view view, JsonFormat format )
+{
+  auto sink = pbson::StringSink{ out };
+  pbson::JsonWriter<pbson::StringSink>{ sink, format }.elements( view, true );
+}
+
+std::ostream& spt::util::writeJson( std::ostream& os, bsoncxx::document::view view, JsonFormat format )
+{
+  auto sink = pbson::StreamSink{ os };
+  pbson::JsonWriter<pbson::StreamSink>{ sink, format }.elements( view, false );
+  return os;
+}
+
+std::ostream& spt::util::writeJson( std::ostream& os, bsoncxx::array::view view, JsonFormat format )
+{
+  auto sink = pbson::StreamSink{ os };
+  pbson::JsonWriter<pbson::StreamSink>{ sink, format }.elements( view, true );
+  return os;
+}
+
+std::size_t spt::util::writeJson( std::span<char> buffer, bsoncxx::document::view view, JsonFormat format )
+{
+  auto sink = pbson::SpanSink{ buffer };
+  pbson::JsonWriter<pbson::SpanSink>{ sink, format }.elements( view, false );
+  return sink.size;
+}
+
+std::size_t spt::util::writeJson( std::span<char> buffer, bsoncxx::array::view view, JsonFormat format )
+{
+  auto sink = pbson::SpanSink{ buffer };
+  pbson::JsonWriter<pbson::SpanSink>{ sink, format }.elements( view, true );
+  return sink.size;
+}
+
+std::string spt::util::toJsonString( bsoncxx::document::view view, JsonFormat format )
+{
+  auto out = std::string{};
+  out.reserve( view.length() + view.length() / 2 );
+  writeJson( out, view, format );
+  return out;
+}
+
+std::string spt::util::toJsonString( bsoncxx::array::view view, JsonFormat format )
+{
+  auto out = std::string{};
+  out.reserve( view.length() + view.length() / 2 );
+  writeJson( out, view, format );
+  return out;
+}
+
 boost::json::array spt::util::fromBson( bsoncxx::array::view array )
 {
   using bsoncxx::type;
@@ -4,8 +4,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
 
 #include <boost/json/array.hpp>
 #include <boost/json/object.hpp>
@@ -98,6 +102,130 @@ namespace spt::util
    */
   bsoncxx::document::value toBson( const boost::json::object& object );
 
+  /**
+   * How JSON values that are not wrapped in an extended JSON type (`$oid`, `$date` etc.) are mapped to
+   * BSON types by {@xrefitem toBson(std::string_view, JsonTypes)}.
+   */
+  enum class JsonTypes : uint8_t
+  {
+    /// As `bsoncxx::from_json`.  Integers are written as int32 if they fit, and `null` values are retained.
+    Extended,
+    /// As {@xrefitem toBson(const boost::json::object&)}.  Strings that hold an object id or ISO8601 date-time
+    /// are converted, integers are written as int64, and `null` values and empty strings are skipped.
+    Inferred
+  };
+
+  /**
+   * Transcode a JSON object to BSON without building an intermediate DOM.  The JSON text is walked with
+   * the simdjson on-demand parser, and the BSON is written into a single buffer (sized from the length
+   * of the input) that is owned by the returned document.
+   *
+   * Extended JSON `$oid`, `$date` (ISO8601 string, milliseconds, or `$numberLong`), `$numberLong`,
+   * `$numberInt` and `$numberDouble` values are recognised in either mode.  Documents with other extended
+   * JSON types (`$numberDecimal`, `$binary`, `$timestamp`, `$regularExpression`, `$minKey` etc.) are
+   * parsed with `bsoncxx::from_json` in `Extended` mode, and rejected in `Inferred` mode.  Other `$`
+   * prefixed keys (query operators etc.) are written as regular fields.
+   *
+   * @param json The JSON object to transcode.
+   * @param types How values without an explicit extended JSON type are mapped to BSON types.
+   * @return The BSON document representation of the JSON object.
+   * @throw simdjson::simdjson_error If the input is not a valid JSON object, or holds an invalid extended JSON value.
+   */
+  bsoncxx::document::value toBson( std::string_view json, JsonTypes types = JsonTypes::Extended );
+
+  /**
+   * JSON output format for the streaming {@xrefitem writeJson} and {@xrefitem toJsonString} functions.
+   */
+  enum class JsonFormat : uint8_t
+  {
+    /// Extended JSON v2 canonical format.  Numbers and dates are wrapped to preserve their BSON type.
+    Canonical,
+    /// Extended JSON v2 relaxed format.  Numbers are written as JSON numbers, and dates in years 1970-9999 as ISO8601 strings.
+    Relaxed,
+    /// As {@xrefitem toJson(const bsoncxx::document::view&)}.  Object ids and dates are written as strings, and
+    /// values of other types without a JSON equivalent (including `null`) are skipped.  Only the first of
+    /// duplicate keys in a document is written.
+    Plain
+  };
+
+  /**
+   * Append the JSON representation of a BSON document to a string, without building an intermediate DOM.
+   *
+   * @param out The string to append the JSON to.
+   * @param view The BSON document to write as JSON.
+   * @param format The JSON format to write.
+   */
+  void writeJson( std::string& out, bsoncxx::document::view view, JsonFormat format = JsonFormat::Relaxed );
+
+  /**
+   * Append the JSON representation of a BSON array to a string, without building an intermediate DOM.
+   *
+   * @param out The string to append the JSON to.
+   * @param view The BSON array to write as JSON.
+   * @param format The JSON format to write.
+   */
+  void writeJson( std::string& out, bsoncxx::array::view view, JsonFormat format = JsonFormat::Relaxed );
+
+  /**
+   * Write the JSON representation of a BSON document to an output stream, without building an intermediate DOM.
+   *
+   * @param os The output stream to write the JSON to.
+   * @param view The BSON document to write as JSON.
+   * @param format The JSON format to write.
+   * @return The output stream for chaining.
+   */
+  std::ostream& writeJson( std::ostream& os, bsoncxx::document::view view, JsonFormat format = JsonFormat::Relaxed );
+
+  /**
+   * Write the JSON representation of a BSON array to an output stream, without building an intermediate DOM.
+   *
+   * @param os The output stream to write the JSON to.
+   * @param view The BSON array to write as JSON.
+   * @param format The JSON format to write.
+   * @return The output stream for chaining.
+   */
+  std::ostream& writeJson( std::ostream& os, bsoncxx::array::view view, JsonFormat format = JsonFormat::Relaxed );
+
+  /**
+   * Write the JSON representation of a BSON document into a fixed size buffer.  Output that does not fit
+   * in the buffer is discarded.  The output is not null terminated.
+   *
+   * @param buffer The buffer to write the JSON to.
+   * @param view The BSON document to write as JSON.
+   * @param format The JSON format to write.
+   * @return The length of the full JSON representation.  The output was truncated if larger than the buffer size.
+   */
+  std::size_t writeJson( std::span<char> buffer, bsoncxx::document::view view, JsonFormat format = JsonFormat::Relaxed );
+
+  /**
+   * Write the JSON representation of a BSON array into a fixed size buffer.  Output that does not fit
+   * in the buffer is discarded.  The output is not null terminated.
+   *
+   * @param buffer The buffer to write the JSON to.
+   * @param view The BSON array to write as JSON.
+   * @param format The JSON format to write.
+   * @return The length of the full JSON representation.  The output was truncated if larger than the buffer size.
+   */
+  std::size_t writeJson( std::span<char> buffer, bsoncxx::array::view view, JsonFormat format = JsonFormat::Relaxed );
+
+  /**
+   * Generate the JSON representation of a BSON document as a string, without building an intermediate DOM.
+   *
+   * @param view The BSON document to convert to JSON.
+   * @param format The JSON format to write.
+   * @return The JSON representation of the BSON document.
+   */
+  std::string toJsonString( bsoncxx::document::view view, JsonFormat format = JsonFormat::Relaxed );
+
+  /**
+   * Generate the JSON representation of a BSON array as a string, without building an intermediate DOM.
+   *
+   * @param view The BSON array to convert to JSON.
+   * @param format The JSON format to write.
+   * @return The JSON representation of the BSON array.
+   */
+  std::string toJsonString( bsoncxx::array::view view, JsonFormat format = JsonFormat::Relaxed );
+
   /**
    * Convert the BSON array into its equivalent JSON.
    *
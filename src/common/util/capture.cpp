@@ -0,0 +1,230 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#include "capture.hpp"
+#if defined __has_include
+  #if __has_include("../../log/NanoLog.hpp")
+    #include "../../log/NanoLog.hpp"
+  #else
+    #include <log/NanoLog.h>
+  #endif
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+
+using spt::util::capture::Reader;
+using spt::util::capture::Writer;
+
+std::vector<std::filesystem::path> spt::util::capture::files( const std::filesystem::path& path )
+{
+  auto ec = std::error_code{};
+  if ( !std::filesystem::is_directory( path, ec ) )
+  {
+    if ( std::filesystem::is_regular_file( path, ec ) ) return { path };
+    return {};
+  }
+
+  auto out = std::vector<std::filesystem::path>{};
+  for ( const auto& entry : std::filesystem::directory_iterator{ path, ec } )
+  {
+    if ( entry.is_regular_file() && entry.path().extension() == Extension ) out.push_back( entry.path() );
+  }
+
+  // File names are the writer creation time followed by a sequence number, both zero padded
+  std::ranges::sort( out );
+  return out;
+}
+
+auto Reader::next() -> std::optional<Record>
+{
+  for (;;)
+  {
+    if ( !file.is_open() && !open() ) return std::nullopt;
+
+    auto header = std::array<char, Header::Size>{};
+    if ( file.read( header.data(), static_cast<std::streamsize>( header.size() ) ) )
+    {
+      auto record = Record{ Header::decode( header.data() ), {} };
+      if ( record.header.size < 5 || record.header.size > MaxFrameSize )
+      {
+        LOG_WARN << "Invalid frame size " << record.header.size << " in capture file " << files[index - 1].string();
+        file.close();
+        continue;
+      }
+
+      record.frame.resize( record.header.size );
+      if ( file.read( reinterpret_cast<char*>( record.frame.data() ), static_cast<std::streamsize>( record.frame.size() ) ) ) return record;
+    }
+
+    if ( !file.eof() || file.gcount() > 0 ) LOG_WARN << "Truncated record in capture file " << files[index - 1].string();
+    file.close();
+  }
+}
+
+bool Reader::open()
+{
+  while ( index < files.size() )
+  {
+    const auto& path = files[index++];
+    file = std::ifstream{ path, std::ios::binary };
+    auto magic = std::array<char, Magic.size()>{};
+    if ( file && file.read( magic.data(), static_cast<std::streamsize>( magic.size() ) ) &&
+      std::string_view{ magic.data(), magic.size() } == Magic )
+    {
+      LOG_INFO << "Reading requests from " << path.string();
+      return true;
+    }
+
+    LOG_WARN << "Skipping invalid capture file " << path.string();
+    file.close();
+  }
+
+  return false;
+}
+
+Writer::Writer( Configuration configuration ) :
+  configuration{ std::move( configuration ) },
+  buffer{ std::max( this->configuration.bufferSize, 1u ) },
+  threshold{ std::max( this->configuration.bufferSize / 2, 1u ) },
+  created{ std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::system_clock::now().time_since_epoch() ).count() }
+{
+  this->configuration.fileSize = std::max( this->configuration.fileSize, uint64_t{ 1 } );
+  this->configuration.files = std::max( this->configuration.files, 1u );
+}
+
+Writer::~Writer()
+{
+  finish();
+}
+
+void Writer::start()
+{
+  if ( writer.joinable() || stopped.load( std::memory_order_acquire ) ) return;
+  writer = std::thread{ &Writer::run, this };
+}
+
+bool Writer::add( const Header& header, const uint8_t* data )
+{
+  const auto size = std::size_t{ header.size };
+  if ( stopped.load( std::memory_order_acquire ) )
+  {
+    droppedCount.fetch_add( 1, std::memory_order_relaxed );
+    return false;
+  }
+
+  if ( queuedBytes.fetch_add( size, std::memory_order_relaxed ) + size > configuration.fileSize )
+  {
+    queuedBytes.fetch_sub( size, std::memory_order_relaxed );
+    droppedCount.fetch_add( 1, std::memory_order_relaxed );
+    return false;
+  }
+
+  if ( !buffer.push( Frame{ header, std::vector<uint8_t>( data, data + size ) } ) )
+  {
+    queuedBytes.fetch_sub( size, std::memory_order_relaxed );
+    droppedCount.fetch_add( 1, std::memory_order_relaxed );
+    return false;
+  }
+
+  if ( queued.fetch_add( 1, std::memory_order_relaxed ) + 1 >= threshold &&
+    !signalled.exchange( true, std::memory_order_acq_rel ) )
+  {
+    // Notify while holding the mutex so that the signal cannot be raised between the writer
+    // evaluating the wait predicate and blocking, which would delay writing until the timeout.
+    auto lock = std::scoped_lock{ mutex };
+    cv.notify_one();
+  }
+
+  return true;
+}
+
+void Writer::rotate()
+{
+  if ( file.is_open() ) file.close();
+
+  while ( !written.empty() && written.size() >= configuration.files )
+  {
+    auto ec = std::error_code{};
+    std::filesystem::remove( written.front(), ec );
+    if ( ec ) LOG_WARN << "Error removing capture file " << written.front().string() << ". " << ec.message();
+    written.pop_front();
+  }
+
+  auto path = configuration.directory / std::format( "capture-{}-{:06}{}", created, sequence++, Extension );
+
+  file.open( path, std::ios::binary | std::ios::trunc );
+  if ( !file )
+  {
+    LOG_CRIT_RATE( 1 ) << "Error opening capture file " << path.string();
+    return;
+  }
+
+  file.write( Magic.data(), static_cast<std::streamsize>( Magic.size() ) );
+  fileBytes = Magic.size();
+  written.push_back( std::move( path ) );
+  LOG_INFO << "Capturing requests to " << written.back().string();
+}
+
+void Writer::write( const Frame& frame )
+{
+  if ( !file.is_open() || fileBytes + Header::Size + frame.data.size() > configuration.fileSize ) rotate();
+  if ( !file ) return;
+
+  const auto header = frame.header.encode();
+  file.write( header.data(), static_cast<std::streamsize>( header.size() ) );
+  file.write( reinterpret_cast<const char*>( frame.data.data() ), static_cast<std::streamsize>( frame.data.size() ) );
+  fileBytes += header.size() + frame.data.size();
+  capturedCount.fetch_add( 1, std::memory_order_relaxed );
+}
+
+void Writer::run()
+{
+  using namespace std::chrono_literals;
+  uint64_t reported = 0;
+
+  for (;;)
+  {
+    const auto stopping = stopped.load( std::memory_order_acquire );
+
+    std::size_t count = 0;
+    while ( auto frame = buffer.pop() )
+    {
+      write( *frame );
+      queuedBytes.fetch_sub( frame->data.size(), std::memory_order_relaxed );
+      ++count;
+    }
+    queued.fetch_sub( count, std::memory_order_relaxed );
+    if ( count > 0 && file.is_open() ) file.flush();
+
+    if ( const auto d = droppedCount.load( std::memory_order_relaxed ); d != reported )
+    {
+      LOG_WARN << "Dropped " << static_cast<int64_t>( d - reported ) << " captured requests. Total dropped " << static_cast<int64_t>( d );
+      reported = d;
+    }
+
+    if ( stopping ) break;
+
+    auto lock = std::unique_lock{ mutex };
+    cv.wait_for( lock, 100ms,
+      [this] { return signalled.load( std::memory_order_acquire ) || stopped.load( std::memory_order_acquire ); } );
+    signalled.store( false, std::memory_order_release );
+  }
+
+  if ( file.is_open() ) file.close();
+  LOG_INFO << "Captured " << static_cast<int64_t>( captured() ) << " requests to " << static_cast<int64_t>( sequence ) << " files";
+}
+
+void Writer::finish()
+{
+  if ( stopped.exchange( true, std::memory_order_acq_rel ) ) return;
+
+  {
+    auto lock = std::scoped_lock{ mutex };
+    cv.notify_one();
+  }
+
+  if ( writer.joinable() ) writer.join();
+}
@@ -0,0 +1,197 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#pragma once
+
+#include "ringbuffer.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace spt::util::capture
+{
+  /**
+   * Identifies a traffic capture file.  Capture files start with these bytes, followed by a sequence of
+   * records.  Each record is a `Header`, followed by the raw request BSON frame received by the service.
+   * Values are stored in native (little endian on all supported platforms) byte order.
+   */
+  constexpr std::string_view Magic{ "MSCAPT01" };
+
+  /// Extension used for capture files.
+  constexpr std::string_view Extension{ ".msc" };
+
+  /// Largest request frame that may be captured.  Same as the largest request read by the service.
+  constexpr uint32_t MaxFrameSize = 8 * 1024 * 1024;
+
+  /**
+   * Header preceding each captured request frame.
+   */
+  struct Header
+  {
+    static constexpr std::size_t Size = 32;
+
+    // Time at which the request was received, in nanoseconds since the UNIX epoch.
+    int64_t timestamp{ 0 };
+    // Time taken by the service to read, process and respond to the request, in nanoseconds.
+    int64_t duration{ 0 };
+    // Identifier of the connection on which the request was received.  Unique for the life of the service.
+    uint64_t connection{ 0 };
+    // Size of the request frame that follows the header.
+    uint32_t size{ 0 };
+
+    [[nodiscard]] std::array<char, Size> encode() const
+    {
+      auto out = std::array<char, Size>{};
+      std::memcpy( out.data(), &timestamp, sizeof(timestamp) );
+      std::memcpy( out.data() + 8, &duration, sizeof(duration) );
+      std::memcpy( out.data() + 16, &connection, sizeof(connection) );
+      std::memcpy( out.data() + 24, &size, sizeof(size) );
+      return out;
+    }
+
+    static Header decode( const char* data )
+    {
+      auto header = Header{};
+      std::memcpy( &header.timestamp, data, sizeof(header.timestamp) );
+      std::memcpy( &header.duration, data + 8, sizeof(header.duration) );
+      std::memcpy( &header.connection, data + 16, sizeof(header.connection) );
+      std::memcpy( &header.size, data + 24, sizeof(header.size) );
+      return header;
+    }
+  };
+
+  /**
+   * A captured request read from a capture file.
+   */
+  struct Record
+  {
+    Header header;
+    std::vector<uint8_t> frame;
+  };
+
+  /**
+   * Capture files at the specified path, in the order in which they were written.
+   * @param path A capture file, or a directory containing capture files.
+   * @return The capture files, or an empty vector if none were found.
+   */
+  std::vector<std::filesystem::path> files( const std::filesystem::path& path );
+
+  /**
+   * Reads records from a sequence of capture files.  Files that are not capture files are skipped.  Reading
+   * a file stops at a truncated record (service stopped while writing), or at a header with an invalid
+   * frame size (corrupt file), and continues with the next file.
+   */
+  struct Reader
+  {
+    explicit Reader( std::vector<std::filesystem::path> files ) : files{ std::move( files ) } {}
+
+    /**
+     * @return The next record, or `std::nullopt` once all the files have been read.
+     */
+    std::optional<Record> next();
+
+  private:
+    bool open();
+
+    std::vector<std::filesystem::path> files;
+    std::ifstream file;
+    std::size_t index{ 0 };
+  };
+
+  /**
+   * Writes request frames to rotating capture files.  Frames are staged in a bounded lock-free ring
+   * buffer, and written by a dedicated writer thread.  Frames are dropped (and counted) if the buffer is
+   * full, or if the staged frames exceed the size of a capture file.  Only the most recent `files` capture
+   * files are retained.
+   */
+  struct Writer
+  {
+    struct Configuration
+    {
+      // Directory to which capture files are written.  Must exist.
+      std::filesystem::path directory;
+      // Size in bytes after which a new capture file is started.
+      uint64_t fileSize{ 64 * 1024 * 1024 };
+      // Number of capture files to retain.
+      uint32_t files{ 16 };
+      // Number of frames that may be staged for writing.
+      uint32_t bufferSize{ 8192 };
+    };
+
+    explicit Writer( Configuration configuration );
+    ~Writer();
+
+    Writer( Writer&& ) = delete;
+    Writer& operator=( Writer&& ) = delete;
+    Writer( const Writer& ) = delete;
+    Writer& operator=( const Writer& ) = delete;
+
+    /**
+     * Start the writer thread.  Frames added before the thread is started are staged, and written once
+     * it starts.
+     */
+    void start();
+
+    /**
+     * Stage a frame for writing.  Safe to invoke from multiple threads.
+     * @param header The header for the frame.  `size` must be the size of the frame.
+     * @param data The request frame.
+     * @return `false` if the frame was dropped.
+     */
+    bool add( const Header& header, const uint8_t* data );
+
+    /**
+     * Stop the writer thread after it has written all the staged frames.  Safe to invoke multiple times.
+     */
+    void finish();
+
+    /// Number of frames written to capture files.
+    [[nodiscard]] uint64_t captured() const { return capturedCount.load( std::memory_order_relaxed ); }
+
+    /// Number of frames dropped.
+    [[nodiscard]] uint64_t dropped() const { return droppedCount.load( std::memory_order_relaxed ); }
+
+  private:
+    // No default member initialisers, which would make the type incomplete for `RingBuffer` constraints.
+    struct Frame
+    {
+      Header header;
+      std::vector<uint8_t> data;
+    };
+
+    void run();
+    void write( const Frame& frame );
+    void rotate();
+
+    Configuration configuration;
+    RingBuffer<Frame> buffer;
+    std::deque<std::filesystem::path> written{};
+    std::ofstream file{};
+    std::mutex mutex{};
+    std::condition_variable cv{};
+    std::atomic<std::size_t> queued{ 0 };
+    std::atomic<uint64_t> queuedBytes{ 0 };
+    std::atomic<uint64_t> droppedCount{ 0 };
+    std::atomic<uint64_t> capturedCount{ 0 };
+    std::atomic_bool signalled{ false };
+    std::atomic_bool stopped{ false };
+    std::size_t threshold;
+    // Time at which the writer was created, in milliseconds since the UNIX epoch.  Prefix for file names.
+    int64_t created;
+    uint64_t fileBytes{ 0 };
+    uint32_t sequence{ 0 };
+    std::thread writer{};
+  };
+}
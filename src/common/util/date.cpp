@@ -11,22 +11,171 @@
   #endif
 #endif
 
+#include <array>
+#include <bit>
 #include <charconv>
-#include <sstream>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <optional>
 
 namespace spt::util
 {
   namespace pdate
   {
-    bool isLeapYear( int16_t year )
+    // Days since 1970-01-01 in the proleptic Gregorian calendar.  See https://howardhinnant.github.io/date_algorithms.html
+    constexpr int64_t daysFromCivil( int64_t year, int64_t month, int64_t day )
     {
-      bool result = false;
+      year -= month <= 2;
+      const auto era = ( year >= 0 ? year : year - 399 ) / 400;
+      const auto yoe = year - era * 400;
+      const auto doy = ( 153 * ( month > 2 ? month - 3 : month + 9 ) + 2 ) / 5 + day - 1;
+      const auto doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+      return era * 146097 + doe - 719468;
+    }
+
+    struct Civil
+    {
+      int64_t year;
+      int64_t month;
+      int64_t day;
+    };
+
+    constexpr Civil civilFromDays( int64_t days )
+    {
+      days += 719468;
+      const auto era = ( days >= 0 ? days : days - 146096 ) / 146097;
+      const auto doe = days - era * 146097;
+      const auto yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+      const auto doy = doe - ( 365 * yoe + yoe / 4 - yoe / 100 );
+      const auto mp = ( 5 * doy + 2 ) / 153;
+      const auto month = mp < 10 ? mp + 3 : mp - 9;
+      return { yoe + era * 400 + ( month <= 2 ), month, doy - ( 153 * mp + 2 ) / 5 + 1 };
+    }
+
+    static_assert( daysFromCivil( 1970, 1, 1 ) == 0 );
+    static_assert( daysFromCivil( 2000, 3, 1 ) == 11017 );
+    static_assert( civilFromDays( -1 ).year == 1969 && civilFromDays( -1 ).month == 12 && civilFromDays( -1 ).day == 31 );
+
+    constexpr int64_t lastDay( int64_t year, int64_t month )
+    {
+      if ( month != 2 ) return month == 4 || month == 6 || month == 9 || month == 11 ? 30 : 31;
+      return ( year % 4 == 0 && year % 100 != 0 ) || year % 400 == 0 ? 29 : 28;
+    }
+
+    // Eight characters as a little-endian word
+    uint64_t load( const char* data )
+    {
+      uint64_t value;
+      std::memcpy( &value, data, sizeof(value) );
+      if constexpr ( std::endian::native == std::endian::big ) value = std::byteswap( value );
+      return value;
+    }
+
+    // Check that all eight characters in the word are ASCII digits.  See https://lemire.me/blog/2022/01/21/swar-explained-parsing-eight-digits/
+    bool digits( uint64_t value )
+    {
+      return ( ( value & 0xF0F0F0F0F0F0F0F0 ) | ( ( ( value + 0x0606060606060606 ) & 0xF0F0F0F0F0F0F0F0 ) >> 4 ) ) == 0x3333333333333333;
+    }
+
+    uint32_t parse8( uint64_t value )
+    {
+      constexpr uint64_t mask = 0x000000FF000000FF;
+      constexpr uint64_t mul1 = 100 + ( 1000000ULL << 32 );
+      constexpr uint64_t mul2 = 1 + ( 10000ULL << 32 );
+      value -= 0x3030303030303030;
+      value = ( value * 10 ) + ( value >> 8 );
+      return static_cast<uint32_t>( ( ( ( value & mask ) * mul1 ) + ( ( ( value >> 16 ) & mask ) * mul2 ) ) >> 32 );
+    }
+
+    // Fast path for the UTC shapes we generate: YYYY-MM-DDTHH:MM:SSZ, YYYY-MM-DDTHH:MM:SS.fffZ and YYYY-MM-DDTHH:MM:SS.ffffffZ.
+    // Returns std::nullopt for any other input, which is then handled by the general parser.
+    std::optional<DateTime> parse( std::string_view date )
+    {
+      const auto size = date.size();
+      if ( ( size != 20 && size != 24 && size != 27 ) || date.back() != 'Z' ) return std::nullopt;
+
+      const auto* p = date.data();
+      if ( p[4] != '-' || p[7] != '-' || p[10] != 'T' || p[13] != ':' || p[16] != ':' ) return std::nullopt;
+      if ( size > 20 && p[19] != '.' ) return std::nullopt;
+
+      // YYYYMMDD HHMMSS00 ffffff00
+      auto buffer = std::array<char, 24>{};
+      buffer.fill( '0' );
+      std::memcpy( buffer.data(), p, 4 );
+      std::memcpy( buffer.data() + 4, p + 5, 2 );
+      std::memcpy( buffer.data() + 6, p + 8, 2 );
+      std::memcpy( buffer.data() + 8, p + 11, 2 );
+      std::memcpy( buffer.data() + 10, p + 14, 2 );
+      std::memcpy( buffer.data() + 12, p + 17, 2 );
+      if ( size > 20 ) std::memcpy( buffer.data() + 16, p + 20, size - 21 );
+
+      const auto ymd = load( buffer.data() );
+      const auto hms = load( buffer.data() + 8 );
+      const auto fraction = load( buffer.data() + 16 );
+      if ( !digits( ymd ) || !digits( hms ) || !digits( fraction ) ) return std::nullopt;
+
+      const int64_t d = parse8( ymd );
+      const int64_t t = parse8( hms ) / 100;
+      const int64_t year = d / 10000;
+      const int64_t month = d / 100 % 100;
+      const int64_t day = d % 100;
+      const int64_t hour = t / 10000;
+      const int64_t minute = t / 100 % 100;
+      const int64_t second = t % 100;
+
+      if ( month < 1 || month > 12 || day < 1 || day > lastDay( year, month ) ) return std::nullopt;
+      if ( hour > 23 || minute > 59 || second > 59 ) return std::nullopt;
+
+      const auto seconds = ( ( daysFromCivil( year, month, day ) * 24 + hour ) * 60 + minute ) * 60 + second;
+      return DateTime{ std::chrono::microseconds{ seconds * 1'000'000 + parse8( fraction ) / 100 } };
+    }
+
+    void write( char* out, int64_t value, int width )
+    {
+      for ( auto i = width - 1; i >= 0; --i )
+      {
+        out[i] = static_cast<char>( '0' + value % 10 );
+        value /= 10;
+      }
+    }
 
-      if ( ( year % 400 ) == 0 ) result = true;
-      else if ( ( year % 100 ) == 0 ) result = false;
-      else if ( ( year % 4 ) == 0 ) result = true;
+    // Cached formatted YYYY-MM-DDTHH:MM:SS. prefix, since timestamps formatted by a thread are usually close together.
+    struct Prefix
+    {
+      int64_t day{ std::numeric_limits<int64_t>::min() };
+      int64_t second{ std::numeric_limits<int64_t>::min() };
+      std::array<char, 20> chars{ "0000-00-00T00:00:00" };
+    };
+
+    const std::array<char, 20>& prefix( int64_t seconds )
+    {
+      static thread_local auto cache = Prefix{};
+      if ( seconds == cache.second ) return cache.chars;
 
-      return result;
+      const auto day = seconds >= 0 ? seconds / 86400 : ( seconds - 86399 ) / 86400;
+      if ( day != cache.day )
+      {
+        const auto civil = civilFromDays( day );
+        write( cache.chars.data(), civil.year, 4 );
+        write( cache.chars.data() + 5, civil.month, 2 );
+        write( cache.chars.data() + 8, civil.day, 2 );
+        cache.day = day;
+      }
+
+      const auto time = seconds - day * 86400;
+      write( cache.chars.data() + 11, time / 3600, 2 );
+      write( cache.chars.data() + 14, time / 60 % 60, 2 );
+      write( cache.chars.data() + 17, time % 60, 2 );
+      cache.chars[19] = '.';
+      cache.second = seconds;
+      return cache.chars;
+    }
+
+    // 0000-01-01T00:00:00Z to 9999-12-31T23:59:59Z
+    constexpr bool inRange( int64_t seconds )
+    {
+      return seconds >= -62167219200 && seconds <= 253402300799;
     }
   }
 
@@ -38,6 +187,8 @@ namespace spt::util
   std::expected<DateTime, std::string> parseISO8601( std::string_view date )
   {
     using O = std::expected<DateTime, std::string>;
+    if ( const auto dt = pdate::parse( date ); dt ) return O{ std::in_place, *dt };
+
     // 2021-02-11
     // 2021-02-11T11:17:43Z
     // 2021-02-11T11:17:43-0600
@@ -446,6 +597,12 @@ namespace spt::util
       return O{ std::unexpect, "Invalid datetime zone" };
     }
 
+    if ( month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60 )
+    {
+      LOG_WARN << "Invalid date-time: " << date;
+      return O{ std::unexpect, "Invalid datetime range" };
+    }
+
     if ( millis > 0 && !std::isdigit( date[22] ) ) millis *= 10;
 
     int64_t epoch = micros;
@@ -453,33 +610,7 @@ namespace spt::util
     epoch += second * int64_t( 1000000 );
     epoch += minute * int64_t( 60000000 );
     epoch += hour * microSecondsPerHour;
-    epoch += ( day - 1 ) * 24 * microSecondsPerHour;
-
-    const int8_t isLeap = pdate::isLeapYear( year );
-
-    for ( int i = 1; i < month; ++i )
-    {
-      switch ( i )
-      {
-      case 2:
-        epoch += ( isLeap ? 29 : 28 ) * 24 * microSecondsPerHour;
-        break;
-      case 4:
-      case 6:
-      case 9:
-      case 11:
-        epoch += 30 * 24 * microSecondsPerHour;
-        break;
-      default:
-        epoch += 31 * 24 * microSecondsPerHour;
-      }
-    }
-
-    for ( int16_t i = 1970; i < year; ++i )
-    {
-      if ( pdate::isLeapYear( i ) ) epoch += 366 * 24 * microSecondsPerHour;
-      else epoch += 365 * 24 * microSecondsPerHour;
-    }
+    epoch += pdate::daysFromCivil( year, month, day ) * 24 * microSecondsPerHour;
 
     if ( dsth != 0 ) epoch += -1 * dsth * microSecondsPerHour;
     if ( dstm != 0 )
@@ -497,85 +628,22 @@ namespace spt::util
 
   std::string isoDateMicros( std::chrono::microseconds us )
   {
-    int64_t epoch = us.count();
-    const int micros = epoch % int64_t( 1000 );
-    epoch /= int64_t( 1000 );
-
-    const int millis = epoch % int64_t( 1000 );
-    epoch /= int64_t( 1000 );
-
-    const int second = epoch % 60;
-
-    epoch /= 60;
-    const int minute = epoch % 60;
-
-    epoch /= 60;
-    const int hour = epoch % 24;
-    epoch /= 24;
-    int year = 1970;
-
+    if ( !pdate::inRange( std::chrono::floor<std::chrono::seconds>( us ).count() ) )
     {
-      int32_t days = 0;
-      while ( ( days += ( pdate::isLeapYear( year ) ) ? 366 : 365 ) <= epoch ) ++year;
-
-      days -= ( pdate::isLeapYear( year ) ) ? 366 : 365;
-      epoch -= days;
+      return std::format( "{:%FT%T}Z", DateTime{ us } );
     }
 
-    uint8_t isLeap = pdate::isLeapYear( year );
-    int month = 1;
-
-    for ( ; month < 13; ++month )
-    {
-      int8_t length = 0;
-
-      switch ( month )
-      {
-      case 2:
-        length = isLeap ? 29 : 28;
-        break;
-      case 4:
-      case 6:
-      case 9:
-      case 11:
-        length = 30;
-        break;
-      default:
-        length = 31;
-      }
-
-      if ( epoch >= length ) epoch -= length;
-      else break;
-    }
-
-    const int day = epoch + 1;
-    std::stringstream ss;
-    ss << year << '-';
-
-    if ( month < 10 ) ss << 0;
-    ss << month << '-';
-
-    if ( day < 10 ) ss << 0;
-    ss << day << 'T';
-
-    if ( hour < 10 ) ss << 0;
-    ss << hour << ':';
-
-    if ( minute < 10 ) ss << 0;
-    ss << minute << ':';
-
-    if ( second < 10 ) ss << 0;
-    ss << second << '.';
-
-    if ( millis < 10 ) ss << "00";
-    else if ( millis < 100 ) ss << 0;
-    ss << millis;
-
-    if ( micros < 10 ) ss << "00";
-    else if ( micros < 100 ) ss << 0;
-    ss << micros << 'Z';
+    auto buffer = std::array<char, 27>{};
+    return std::string{ isoDateMicros( us, buffer ) };
+  }
 
-    return ss.str();
+  std::string_view isoDateMicros( std::chrono::microseconds epoch, std::span<char, 27> buffer )
+  {
+    const auto seconds = std::chrono::floor<std::chrono::seconds>( epoch );
+    std::memcpy( buffer.data(), pdate::prefix( seconds.count() ).data(), 20 );
+    pdate::write( buffer.data() + 20, ( epoch - seconds ).count(), 6 );
+    buffer[26] = 'Z';
+    return { buffer.data(), buffer.size() };
   }
 
   std::string isoDateMicros( std::chrono::milliseconds epoch )
@@ -605,85 +673,27 @@ namespace spt::util
 
   std::string isoDateMillis( std::chrono::microseconds us )
   {
-    int64_t epoch = us.count();
-    epoch /= int64_t( 1000 );
-
-    const int millis = epoch % int64_t( 1000 );
-    epoch /= int64_t( 1000 );
-
-    const int second = epoch % 60;
-
-    epoch /= 60;
-    const int minute = epoch % 60;
-
-    epoch /= 60;
-    const int hour = epoch % 24;
-    epoch /= 24;
-    int year = 1970;
-
-    {
-      int32_t days = 0;
-      while ( ( days += ( pdate::isLeapYear( year ) ) ? 366 : 365 ) <= epoch ) ++year;
-
-      days -= ( pdate::isLeapYear( year ) ) ? 366 : 365;
-      epoch -= days;
-    }
-
-    uint8_t isLeap = pdate::isLeapYear( year );
-    int month = 1;
+    return isoDateMillis( std::chrono::floor<std::chrono::milliseconds>( us ) );
+  }
 
-    for ( ; month < 13; ++month )
+  std::string isoDateMillis( std::chrono::milliseconds epoch )
+  {
+    if ( !pdate::inRange( std::chrono::floor<std::chrono::seconds>( epoch ).count() ) )
     {
-      int8_t length = 0;
-
-      switch ( month )
-      {
-      case 2:
-        length = isLeap ? 29 : 28;
-        break;
-      case 4:
-      case 6:
-      case 9:
-      case 11:
-        length = 30;
-        break;
-      default:
-        length = 31;
-      }
-
-      if ( epoch >= length ) epoch -= length;
-      else break;
+      return std::format( "{:%FT%T}Z", DateTimeMs{ epoch } );
     }
 
-    const int day = epoch + 1;
-    std::stringstream ss;
-    ss << year << '-';
-
-    if ( month < 10 ) ss << 0;
-    ss << month << '-';
-
-    if ( day < 10 ) ss << 0;
-    ss << day << 'T';
-
-    if ( hour < 10 ) ss << 0;
-    ss << hour << ':';
-
-    if ( minute < 10 ) ss << 0;
-    ss << minute << ':';
-
-    if ( second < 10 ) ss << 0;
-    ss << second << '.';
-
-    if ( millis < 10 ) ss << "00";
-    else if ( millis < 100 ) ss << 0;
-    ss << millis << 'Z';
-
-    return ss.str();
+    auto buffer = std::array<char, 24>{};
+    return std::string{ isoDateMillis( epoch, buffer ) };
   }
 
-  std::string isoDateMillis( std::chrono::milliseconds epoch )
+  std::string_view isoDateMillis( std::chrono::milliseconds epoch, std::span<char, 24> buffer )
   {
-    return isoDateMillis( std::chrono::duration_cast<std::chrono::microseconds>( epoch ) );
+    const auto seconds = std::chrono::floor<std::chrono::seconds>( epoch );
+    std::memcpy( buffer.data(), pdate::prefix( seconds.count() ).data(), 20 );
+    pdate::write( buffer.data() + 20, ( epoch - seconds ).count(), 3 );
+    buffer[23] = 'Z';
+    return { buffer.data(), buffer.size() };
   }
 
   std::string isoDateMillis( const DateTime& epoch )
@@ -6,6 +6,8 @@
 
 #include <chrono>
 #include <expected>
+#include <span>
+#include <string>
 #include <string_view>
 
 namespace spt::util
@@ -22,10 +24,14 @@ namespace spt::util
   std::string isoDateMicros( const DateTime& epoch );
   std::string isoDateMicros( const DateTimeMs& epoch );
   std::string isoDateMicros( const DateTimeNs& epoch );
+  // Format into the buffer without allocating.  Valid for years 0000 to 9999.
+  std::string_view isoDateMicros( std::chrono::microseconds epoch, std::span<char, 27> buffer );
   [[deprecated("Use the variants that take std::chrono")]] std::string isoDateMillis( int64_t epoch );
   std::string isoDateMillis( std::chrono::microseconds epoch );
   std::string isoDateMillis( std::chrono::milliseconds epoch );
   std::string isoDateMillis( const DateTime& epoch );
   std::string isoDateMillis( const DateTimeMs& epoch );
   std::string isoDateMillis( const DateTimeNs& epoch );
+  // Format into the buffer without allocating.  Valid for years 0000 to 9999.
+  std::string_view isoDateMillis( std::chrono::milliseconds epoch, std::span<char, 24> buffer );
 }
@@ -0,0 +1,61 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using spt::util::Histogram;
+
+void Histogram::record( int64_t v, uint64_t c )
+{
+  if ( c == 0 ) return;
+
+  const auto clamped = std::min( static_cast<uint64_t>( std::max( v, int64_t{ 0 } ) ), MaxValue );
+  counts[index( clamped )] += c;
+
+  const auto value = static_cast<int64_t>( clamped );
+  if ( total == 0 || value < minimum ) minimum = value;
+  if ( value > maximum ) maximum = value;
+  total += c;
+  sum += clamped * c;
+}
+
+void Histogram::merge( const Histogram& other )
+{
+  if ( other.total == 0 ) return;
+
+  for ( std::size_t i = 0; i < Buckets; ++i ) counts[i] += other.counts[i];
+  if ( total == 0 || other.minimum < minimum ) minimum = other.minimum;
+  if ( other.maximum > maximum ) maximum = other.maximum;
+  total += other.total;
+  sum += other.sum;
+}
+
+void Histogram::reset()
+{
+  counts.fill( 0 );
+  total = 0;
+  sum = 0;
+  minimum = 0;
+  maximum = 0;
+}
+
+int64_t Histogram::percentile( double p ) const
+{
+  if ( total == 0 ) return 0;
+
+  const auto rank = std::max( uint64_t{ 1 },
+    static_cast<uint64_t>( std::ceil( std::clamp( p, 0.0, 100.0 ) / 100.0 * static_cast<double>( total ) ) ) );
+
+  uint64_t cumulative = 0;
+  for ( std::size_t i = 0; i < Buckets; ++i )
+  {
+    cumulative += counts[i];
+    if ( cumulative >= rank ) return std::clamp( static_cast<int64_t>( value( i ) ), minimum, maximum );
+  }
+
+  return maximum;
+}
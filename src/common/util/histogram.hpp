@@ -0,0 +1,129 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace spt::util
+{
+  /**
+   * A fixed size, log-linear (HDR style) histogram for recording latencies.  Values are grouped into
+   * power of two ranges, each of which is split into 32 linear sub-buckets, giving a relative error of
+   * about 3% over the entire range.  Values larger than 2^40 (about 18 minutes when recording
+   * nanoseconds) are clamped.  Not thread safe, use one instance per thread and `merge` as needed.
+   */
+  struct Histogram
+  {
+    static constexpr std::size_t SubBucketBits = 5;
+    static constexpr std::size_t SubBuckets = std::size_t{ 1 } << SubBucketBits;
+    static constexpr std::size_t MaxBits = 40;
+    static constexpr std::size_t Buckets = SubBuckets * ( MaxBits - SubBucketBits + 1 );
+    static constexpr uint64_t MaxValue = ( uint64_t{ 1 } << MaxBits ) - 1;
+
+    /**
+     * Record a value in the histogram.  Negative values are recorded as `0`.
+     * @param value The value to record.
+     * @param count The number of times the value was observed.
+     */
+    void record( int64_t value, uint64_t count = 1 );
+
+    /**
+     * Add all the values recorded in the other histogram to this instance.
+     * @param other The histogram to merge into this instance.
+     */
+    void merge( const Histogram& other );
+
+    /**
+     * Clear all recorded values.
+     */
+    void reset();
+
+    /**
+     * Return the value at the specified percentile.
+     * @param percentile The percentile in the range `[0, 100]`.
+     * @return The (approximate) value at or below which the specified percentage of values fall.
+     */
+    [[nodiscard]] int64_t percentile( double percentile ) const;
+
+    [[nodiscard]] uint64_t count() const { return total; }
+    [[nodiscard]] int64_t min() const { return total ? minimum : 0; }
+    [[nodiscard]] int64_t max() const { return maximum; }
+    [[nodiscard]] double mean() const { return total ? static_cast<double>( sum ) / static_cast<double>( total ) : 0.0; }
+
+    /**
+     * Compute the bucket index for the specified value.
+     * @param value The (clamped) value to compute the index for.
+     * @return The index of the bucket that holds the value.
+     */
+    static constexpr std::size_t index( uint64_t value )
+    {
+      if ( value < 2 * SubBuckets ) return static_cast<std::size_t>( value );
+      const auto shift = static_cast<std::size_t>( std::bit_width( value ) ) - SubBucketBits - 1;
+      return SubBuckets * shift + static_cast<std::size_t>( value >> shift );
+    }
+
+    /**
+     * Compute a representative (mid-point) value for the bucket at the specified index.
+     * @param index The index of the bucket.
+     * @return The mid-point value of the range of values represented by the bucket.
+     */
+    static constexpr uint64_t value( std::size_t index )
+    {
+      if ( index < 2 * SubBuckets ) return index;
+      const auto shift = index / SubBuckets - 1;
+      const auto sub = static_cast<uint64_t>( index - SubBuckets * shift );
+      return ( sub << shift ) + ( ( uint64_t{ 1 } << shift ) >> 1 );
+    }
+
+  private:
+    std::array<uint64_t, Buckets> counts{};
+    uint64_t total{ 0 };
+    uint64_t sum{ 0 };
+    int64_t minimum{ 0 };
+    int64_t maximum{ 0 };
+  };
+
+  /**
+   * A histogram with the same layout as `Histogram` that may be recorded into from one thread
+   * while being drained by another without locks.  Counts are updated using relaxed atomic
+   * increments, which are uncontended when each thread records into its own instance.
+   */
+  struct AtomicHistogram
+  {
+    /**
+     * Record a value in the histogram.  Negative values are recorded as `0`.
+     * @param value The value to record.
+     */
+    void record( int64_t value )
+    {
+      const auto v = value < 0 ? uint64_t{ 0 } : static_cast<uint64_t>( value );
+      counts[Histogram::index( v < Histogram::MaxValue ? v : Histogram::MaxValue )].fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    /**
+     * Move all recorded values into the specified histogram, resetting this instance.
+     * Minimum and maximum values are approximated by their bucket mid-points.
+     * @param histogram The histogram to add the recorded values to.
+     */
+    void drain( Histogram& histogram )
+    {
+      for ( std::size_t i = 0; i < Histogram::Buckets; ++i )
+      {
+        if ( counts[i].load( std::memory_order_relaxed ) == 0 ) continue;
+        if ( const auto c = counts[i].exchange( 0, std::memory_order_relaxed ); c > 0 )
+        {
+          histogram.record( static_cast<int64_t>( Histogram::value( i ) ), c );
+        }
+      }
+    }
+
+  private:
+    std::array<std::atomic<uint64_t>, Histogram::Buckets> counts{};
+  };
+}
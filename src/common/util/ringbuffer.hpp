@@ -0,0 +1,125 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace spt::util
+{
+  /**
+   * A bounded, lock-free, multiple producer queue based on Dmitry Vyukov's bounded MPMC queue.
+   * Producers never block.  If the buffer is full, `push` returns `false` and the caller
+   * decides how to handle the overflow (generally by incrementing a drop counter).
+   * @tparam T The type of value stored in the buffer.  Must be default constructible and move assignable.
+   */
+  template <typename T>
+  requires std::is_default_constructible_v<T> && std::is_move_assignable_v<T>
+  struct RingBuffer
+  {
+    /**
+     * Create a ring buffer with at least the specified capacity.
+     * @param capacity The minimum number of items the buffer can hold.  Rounded up to the next power of two.
+     */
+    explicit RingBuffer( std::size_t capacity ) :
+      size{ std::bit_ceil( capacity < 2 ? std::size_t{ 2 } : capacity ) }, mask{ size - 1 },
+      buffer{ std::make_unique<Cell[]>( size ) }
+    {
+      for ( std::size_t i = 0; i < size; ++i ) buffer[i].sequence.store( i, std::memory_order_relaxed );
+    }
+
+    ~RingBuffer() = default;
+    RingBuffer(RingBuffer&&) = delete;
+    RingBuffer& operator=(RingBuffer&&) = delete;
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * Add a value to the buffer.  Safe to invoke from multiple threads.
+     * @param value The value to add to the buffer.
+     * @return `false` if the buffer is full and the value was not added.
+     */
+    bool push( T&& value )
+    {
+      auto pos = enqueuePos.load( std::memory_order_relaxed );
+      for (;;)
+      {
+        auto& cell = buffer[pos & mask];
+        const auto seq = cell.sequence.load( std::memory_order_acquire );
+        const auto diff = static_cast<std::intptr_t>( seq ) - static_cast<std::intptr_t>( pos );
+        if ( diff == 0 )
+        {
+          if ( enqueuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+          {
+            cell.data = std::move( value );
+            cell.sequence.store( pos + 1, std::memory_order_release );
+            return true;
+          }
+        }
+        else if ( diff < 0 ) return false;
+        else pos = enqueuePos.load( std::memory_order_relaxed );
+      }
+    }
+
+    /**
+     * Remove the oldest value from the buffer.  Safe to invoke from multiple threads, although
+     * typically used by a single consumer.
+     * @return The oldest value, or `std::nullopt` if the buffer is empty.
+     */
+    std::optional<T> pop()
+    {
+      auto pos = dequeuePos.load( std::memory_order_relaxed );
+      for (;;)
+      {
+        auto& cell = buffer[pos & mask];
+        const auto seq = cell.sequence.load( std::memory_order_acquire );
+        const auto diff = static_cast<std::intptr_t>( seq ) - static_cast<std::intptr_t>( pos + 1 );
+        if ( diff == 0 )
+        {
+          if ( dequeuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+          {
+            auto value = std::optional<T>{ std::move( cell.data ) };
+            cell.sequence.store( pos + mask + 1, std::memory_order_release );
+            return value;
+          }
+        }
+        else if ( diff < 0 ) return std::nullopt;
+        else pos = dequeuePos.load( std::memory_order_relaxed );
+      }
+    }
+
+    /**
+     * @return The capacity of the buffer.
+     */
+    [[nodiscard]] std::size_t capacity() const { return size; }
+
+    /**
+     * @return An approximation of the number of items in the buffer.
+     */
+    [[nodiscard]] std::size_t approximateSize() const
+    {
+      const auto e = enqueuePos.load( std::memory_order_relaxed );
+      const auto d = dequeuePos.load( std::memory_order_relaxed );
+      return e > d ? e - d : 0;
+    }
+
+  private:
+    struct Cell
+    {
+      std::atomic<std::size_t> sequence{ 0 };
+      T data{};
+    };
+
+    const std::size_t size;
+    const std::size_t mask;
+    std::unique_ptr<Cell[]> buffer;
+    alignas(64) std::atomic<std::size_t> enqueuePos{ 0 };
+    alignas(64) std::atomic<std::size_t> dequeuePos{ 0 };
+  };
+}
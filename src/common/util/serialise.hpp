@@ -21,12 +21,17 @@
 #endif
 #endif
 
+#include <array>
+#include <bit>
+#include <bitset>
 #include <functional>
 #include <iterator>
 #include <memory>
 #include <ranges>
 #include <set>
+#include <stdexcept>
 #include <string_view>
+#include <utility>
 #include <vector>
 #include <boost/json/object.hpp>
 #include <boost/numeric/conversion/cast.hpp>
@@ -34,6 +39,7 @@
 #include <bsoncxx/json.hpp>
 #include <bsoncxx/oid.hpp>
 #include <bsoncxx/types/bson_value/value.hpp>
+#include <bsoncxx/builder/core.hpp>
 #include <bsoncxx/builder/stream/array.hpp>
 #include <bsoncxx/builder/stream/document.hpp>
 
@@ -61,6 +67,32 @@ namespace spt::util
 {
   using std::operator""sv;
 
+  namespace impl
+  {
+    /**
+     * Argument used to detect a `bson` overload for a model.  Only converts to the model, hence is only
+     * accepted by non-template overloads.  See {@xrefitem CustomBson}.
+     * @tparam M The model type.
+     */
+    template <typename M>
+    struct Probe
+    {
+      operator const M&() const;
+    };
+
+    template <typename T>
+    inline constexpr bool isProbe = false;
+
+    template <typename M>
+    inline constexpr bool isProbe<Probe<M>> = true;
+  }
+
+  /**
+   * A concept that excludes the {@xrefitem impl::Probe} type from the general `bson` templates.
+   */
+  template <typename T>
+  concept NotProbe = not impl::isProbe<T>;
+
   /**
    * Add non-visitable fields in the model to the builder.  A callback function that library users can implement to
    * fully serialise partially visitable models.
@@ -80,7 +112,7 @@ namespace spt::util
    * @return A BSON value encapsulating the BSON document.
    */
   template <Visitable M>
-    requires NotEnumeration<M>
+    requires NotEnumeration<M> && NotProbe<M>
   bsoncxx::types::bson_value::value bson( const M& model );
 
   /**
@@ -90,7 +122,7 @@ namespace spt::util
    * @return The BSON value equivalent.
    */
   template <typename E>
-    requires std::is_enum_v<E>
+    requires std::is_enum_v<E> && NotProbe<E>
   bsoncxx::types::bson_value::value bson( const E& model )
   {
     auto name = magic_enum::enum_name( model );
@@ -207,6 +239,7 @@ namespace spt::util
    * @return The value variant that represents the BSON document.
    */
   template <typename Model>
+    requires NotProbe<Model>
   bsoncxx::types::bson_value::value bson( const Model& model );
 
   /**
@@ -222,9 +255,115 @@ namespace spt::util
     { bson( t ) } -> std::convertible_to<bsoncxx::types::bson_value::value>;
   };
 
+  /**
+   * Concept satisfied by models that have their own `bson` overload.  Such models are serialised using their
+   * overload when nested in another model, instead of having their visitable fields written in place.
+   * @tparam M The type of the model.
+   */
+  template <typename M>
+  concept CustomBson = requires( const impl::Probe<M>& probe )
+  {
+    bson( probe );
+  };
+
+  namespace impl
+  {
+    using Builder = bsoncxx::builder::core;
+
+    /**
+     * Append the visitable fields in the model to the document currently open in the builder.  Field names
+     * and the `id` to `_id` mapping are resolved at compile time.  Non-visitable fields in partially visitable
+     * models are added via {@xrefitem populate(const M&, bsoncxx::builder::stream::document&)}.
+     * @tparam M The visitable model type.
+     * @param builder The builder to append fields to.
+     * @param model The model whose fields are to be appended.
+     */
+    template <Visitable M>
+    void fields( Builder& builder, const M& model );
+
+    /**
+     * Append the visitable field at the specified index in the model.
+     * @tparam I The index of the field in the visitable model.
+     * @tparam M The visitable model type.
+     * @param builder The builder to append the field to.
+     * @param model The model whose field is to be appended.
+     */
+    template <std::size_t I, Visitable M>
+    void field( Builder& builder, const M& model );
+
+    /**
+     * Set the key for the next value appended to the builder.  An empty name is used for array elements.
+     * @param builder The builder to set the key in.
+     * @param name The key for the next value.
+     */
+    void key( Builder& builder, std::string_view name );
+
+    /**
+     * Append the value with the specified name (or as the next array element if `name` is empty).  Values that
+     * serialise to `null` are skipped.  Visitable models without a {@xrefitem CustomBson} overload are written
+     * as sub-documents in place.  Types without a dedicated overload are appended from their {@xrefitem bson(const M&)} value.
+     * @tparam T The type of the value.
+     * @param builder The builder to append the value to.
+     * @param name The name of the field, or empty for array elements.
+     * @param value The value to append.
+     */
+    template <typename T>
+    void write( Builder& builder, std::string_view name, const T& value );
+
+    /**
+     * Append the items in the container as an array in place.  Empty containers are skipped, as are items
+     * that serialise to `null`.
+     * @tparam C The set or vector type.
+     * @param builder The builder to append the array to.
+     * @param name The name of the field, or empty for array elements.
+     * @param items The items to append.
+     */
+    template <typename C>
+    void elements( Builder& builder, std::string_view name, const C& items );
+
+    template <typename T>
+    void write( Builder& builder, std::string_view name, const std::optional<T>& value );
+
+    template <typename T>
+    void write( Builder& builder, std::string_view name, const std::shared_ptr<T>& value );
+
+    template <typename T>
+    void write( Builder& builder, std::string_view name, const std::reference_wrapper<T>& value );
+
+    template <typename T>
+    void write( Builder& builder, std::string_view name, const std::set<T>& value );
+
+    template <typename T>
+    void write( Builder& builder, std::string_view name, const std::vector<T>& value );
+
+    void write( Builder& builder, std::string_view name, const bool& value );
+    void write( Builder& builder, std::string_view name, const int8_t& value );
+    void write( Builder& builder, std::string_view name, const uint8_t& value );
+    void write( Builder& builder, std::string_view name, const int16_t& value );
+    void write( Builder& builder, std::string_view name, const uint16_t& value );
+    void write( Builder& builder, std::string_view name, const int32_t& value );
+    void write( Builder& builder, std::string_view name, const uint32_t& value );
+    void write( Builder& builder, std::string_view name, const int64_t& value );
+    void write( Builder& builder, std::string_view name, const float& value );
+    void write( Builder& builder, std::string_view name, const double& value );
+    void write( Builder& builder, std::string_view name, const std::string& value );
+    void write( Builder& builder, std::string_view name, const bsoncxx::oid& value );
+    void write( Builder& builder, std::string_view name, const DateTime& value );
+    void write( Builder& builder, std::string_view name, const DateTimeMs& value );
+    void write( Builder& builder, std::string_view name, const DateTimeNs& value );
+    void write( Builder& builder, std::string_view name, const std::chrono::seconds& value );
+    void write( Builder& builder, std::string_view name, const std::chrono::milliseconds& value );
+    void write( Builder& builder, std::string_view name, const std::chrono::microseconds& value );
+    void write( Builder& builder, std::string_view name, const std::chrono::nanoseconds& value );
+    void write( Builder& builder, std::string_view name, const boost::uuids::uuid& value );
+    void write( Builder& builder, std::string_view name, const bsoncxx::array::value& value );
+    void write( Builder& builder, std::string_view name, const bsoncxx::document::value& value );
+  }
+
   /**
    * Serialise the visitable model into a BSON document.  Iterates over the visitable fields in the model and
-   * adds to the output BSON document.  For partially visitable models, implement the {@xrefitem populate(const M&, bsoncxx::builder::stream::document&)} function
+   * appends them to a single BSON builder, with nested models and arrays written in place.
+   * For partially visitable models, implement the {@xrefitem populate(const M&, bsoncxx::builder::stream::document&)} function
    * to add the non-visitable fields to the BSON stream builder as appropriate.
    * @tparam M The type of the model.
    * @param model The visitable and serialisable model.
@@ -233,18 +372,9 @@ namespace spt::util
   template <Model M>
   bsoncxx::document::value marshall( const M& model )
   {
-    auto root = bsoncxx::builder::stream::document{};
-    visit_struct::for_each( model,
-        [&root]( const char* name, const auto& value )
-        {
-          auto n = std::string_view{ name };
-          auto v = bson( value );
-          if ( n == "id" && v.view().type() == bsoncxx::type::k_oid ) root << "_id"sv << std::move( v );
-          else if ( v.view().type() != bsoncxx::type::k_null ) root << n << std::move( v );
-        } );
-
-    if constexpr ( visit_struct::traits::ext::is_fully_visitable<M>() == false ) populate( model, root );
-    return root << bsoncxx::builder::stream::finalize;
+    auto builder = impl::Builder{ false };
+    impl::fields( builder, model );
+    return builder.extract_document();
   }
 
   /**
@@ -371,9 +501,122 @@ namespace spt::util
   template <typename M>
   void set( M& field, bsoncxx::types::bson_value::view value );
 
+  namespace impl
+  {
+    /**
+     * Compile-time perfect hash of the visitable field names in a model.  Each name hashes to a distinct slot,
+     * so looking up a key costs one hash and at most one string comparison.
+     * @tparam N The number of visitable fields.
+     */
+    template <std::size_t N>
+    struct FieldIndex
+    {
+      static_assert( N < 255, "Too many visitable fields" );
+      static constexpr std::size_t capacity = std::bit_ceil( std::max<std::size_t>( N * N, 4 ) );
+      static constexpr uint8_t empty = 255;
+
+      constexpr explicit FieldIndex( const std::array<std::string_view, N>& fields ) : names{ fields }
+      {
+        while ( !place() )
+        {
+          if ( ++seed > 4096 ) throw std::logic_error{ "Unable to generate perfect hash for field names" };
+        }
+      }
+
+      /**
+       * Find the index of the field with the specified name.
+       * @param name The BSON element key.
+       * @return The index of the field, or `N` if the model has no such field.
+       */
+      [[nodiscard]] constexpr std::size_t find( std::string_view name ) const
+      {
+        const auto slot = slots[hash( name, seed ) & ( capacity - 1 )];
+        return slot != empty && names[slot] == name ? slot : N;
+      }
+
+      std::array<std::string_view, N> names;
+      std::array<uint8_t, capacity> slots{};
+      uint32_t seed{ 0 };
+
+    private:
+      // FNV-1a with the seed mixed into the offset basis, and a final shift to spread the high bits.
+      static constexpr uint32_t hash( std::string_view name, uint32_t seed )
+      {
+        auto h = 2166136261u ^ ( seed * 0x9e3779b9u );
+        for ( const auto c : name )
+        {
+          h ^= static_cast<uint8_t>( c );
+          h *= 16777619u;
+        }
+        return h ^ ( h >> 15 );
+      }
+
+      constexpr bool place()
+      {
+        slots.fill( empty );
+        for ( std::size_t i = 0; i < N; ++i )
+        {
+          auto& slot = slots[hash( names[i], seed ) & ( capacity - 1 )];
+          if ( slot != empty ) return false;
+          slot = static_cast<uint8_t>( i );
+        }
+        return true;
+      }
+    };
+
+    /**
+     * Set the field at the specified index in the model from the BSON value.
+     * @tparam I The index of the visitable field.
+     * @tparam M The visitable model type.
+     * @param model The model whose field is to be set.
+     * @param value The BSON value for the field.
+     */
+    template <std::size_t I, Visitable M>
+    void assign( M& model, bsoncxx::types::bson_value::view value )
+    {
+      set( visit_struct::get<I>( model ), value );
+    }
+
+    /**
+     * Compile-time metadata for unmarshalling a visitable model.
+     * @tparam M The visitable model type.
+     */
+    template <Visitable M>
+    struct Fields
+    {
+      using Setter = void (*)( M&, bsoncxx::types::bson_value::view );
+      static constexpr std::size_t count = visit_struct::field_count<M>();
+
+      static constexpr auto index = []<std::size_t... I>( std::index_sequence<I...> )
+      {
+        return FieldIndex<count>{ std::array<std::string_view, count>{ std::string_view{ visit_struct::get_name<I, M>() }... } };
+      }( std::make_index_sequence<count>{} );
+
+      static constexpr auto setters = []<std::size_t... I>( std::index_sequence<I...> )
+      {
+        return std::array<Setter, count>{ &assign<I, M>... };
+      }( std::make_index_sequence<count>{} );
+
+      // Index of the `id` field, which is also read from `_id` if the document has no `id` key.
+      static constexpr std::size_t id = index.find( "id"sv );
+    };
+
+    /**
+     * Set the visitable fields in the model in a single pass over the elements in the document.  Unknown keys
+     * are skipped, as are `null` values.  Only the first occurrence of a key is used.
+     * @tparam M The visitable model type.
+     * @param model The model whose fields are to be set.
+     * @param view The BSON document to read.
+     */
+    template <Visitable M>
+    void read( M& model, bsoncxx::document::view view );
+  }
+
   /**
    * Unmarshall the visitable fields in the specified model from the BSON document.  This is usually used for
-   * visitable structs which have already been created.
+   * visitable structs which have already been created.  The document is read in place, so `std::string_view`,
+   * `bsoncxx::document::view` and `bsoncxx::array::view` fields refer to the document, and are only valid
+   * as long as the document is.
    * @tparam M The type of the model.
    * @param model The model instance to unmarshall into.
    * @param view The BSON document to unmarshall struct fields from.
@@ -381,8 +624,7 @@ namespace spt::util
   template <Model M>
   void unmarshall( M& model, bsoncxx::document::view view )
   {
-    auto value = bsoncxx::types::bson_value::value{ view };
-    set( model, value.view() );
+    set( model, bsoncxx::types::bson_value::view{ bsoncxx::types::b_document{ view } } );
   }
 
   /**
@@ -446,6 +688,12 @@ inline bsoncxx::types::bson_value::value spt::util::bson( const std::string& mod
   return model.empty() ? bsoncxx::types::b_null{} : bsoncxx::types::bson_value::value{ model };
 }
 
+template <>
+inline bsoncxx::types::bson_value::value spt::util::bson( const std::string_view& model )
+{
+  return model.empty() ? bsoncxx::types::b_null{} : bsoncxx::types::bson_value::value{ model };
+}
+
 template <>
 inline bsoncxx::types::bson_value::value spt::util::bson( const bsoncxx::oid& model ) { return { model }; }
 
@@ -545,25 +793,264 @@ inline bsoncxx::types::bson_value::value spt::util::bson( const bsoncxx::documen
   return bsoncxx::types::b_document{ model };
 }
 
+template <>
+inline bsoncxx::types::bson_value::value spt::util::bson( const bsoncxx::array::view& model )
+{
+  return bsoncxx::types::b_array{ model };
+}
+
+template <>
+inline bsoncxx::types::bson_value::value spt::util::bson( const bsoncxx::document::view& model )
+{
+  return bsoncxx::types::b_document{ model };
+}
+
 template <spt::util::Visitable M>
-  requires spt::util::NotEnumeration<M>
+  requires spt::util::NotEnumeration<M> && spt::util::NotProbe<M>
 bsoncxx::types::bson_value::value spt::util::bson( const M& model )
 {
-  using std::operator ""sv;
-  auto root = bsoncxx::builder::stream::document{};
-  visit_struct::for_each( model,
-      [&root]( const char* name, const auto& value )
-      {
-        auto n = std::string_view{ name };
-        auto v = bson( value );
-        if ( n == "id"sv && v.view().type() == bsoncxx::type::k_oid )
-        {
-          root << "_id"sv << std::move( v );
-        } else if ( v.view().type() != bsoncxx::type::k_null ) root << n << std::move( v );
-      } );
+  auto builder = impl::Builder{ false };
+  impl::fields( builder, model );
+  return bsoncxx::types::b_document{ builder.view_document() };
+}
+
+template <spt::util::Visitable M>
+void spt::util::impl::fields( Builder& builder, const M& model )
+{
+  [&builder, &model]<std::size_t... I>( std::index_sequence<I...> )
+  {
+    ( field<I>( builder, model ), ... );
+  }( std::make_index_sequence<visit_struct::field_count<M>()>{} );
+
+  if constexpr ( visit_struct::traits::ext::is_fully_visitable<M>() == false )
+  {
+    auto root = bsoncxx::builder::stream::document{};
+    populate( model, root );
+    builder.concatenate( root.view() );
+  }
+}
+
+template <std::size_t I, spt::util::Visitable M>
+void spt::util::impl::field( Builder& builder, const M& model )
+{
+  constexpr auto name = std::string_view{ visit_struct::get_name<I, M>() };
+  const auto& value = visit_struct::get<I>( model );
+
+  if constexpr ( name != "id"sv ) write( builder, name, value );
+  else if constexpr ( std::is_same_v<std::remove_cvref_t<decltype( value )>, bsoncxx::oid> ) write( builder, "_id"sv, value );
+  else
+  {
+    auto v = bson( value );
+    if ( v.view().type() == bsoncxx::type::k_null ) return;
+    key( builder, v.view().type() == bsoncxx::type::k_oid ? "_id"sv : name );
+    builder.append( v.view() );
+  }
+}
+
+inline void spt::util::impl::key( Builder& builder, std::string_view name )
+{
+  if ( !name.empty() ) builder.key_view( name );
+}
+
+template <typename T>
+void spt::util::impl::write( Builder& builder, std::string_view name, const T& value )
+{
+  if constexpr ( visit_struct::traits::is_visitable<T>::value && !CustomBson<T> )
+  {
+    key( builder, name );
+    builder.open_document();
+    fields( builder, value );
+    builder.close_document();
+  }
+  else
+  {
+    auto v = bson( value );
+    if ( v.view().type() == bsoncxx::type::k_null ) return;
+    key( builder, name );
+    builder.append( v.view() );
+  }
+}
+
+template <typename C>
+void spt::util::impl::elements( Builder& builder, std::string_view name, const C& items )
+{
+  if ( items.empty() ) return;
+
+  key( builder, name );
+  builder.open_array();
+  for ( const auto& item : items )
+  {
+    if constexpr ( std::is_enum_v<typename C::value_type> )
+    {
+      auto n = magic_enum::enum_name( item );
+      if ( !n.empty() ) builder.append( bsoncxx::types::b_string{ n } );
+    }
+    else write( builder, {}, item );
+  }
+  builder.close_array();
+}
+
+template <typename T>
+void spt::util::impl::write( Builder& builder, std::string_view name, const std::optional<T>& value )
+{
+  if ( value ) write( builder, name, *value );
+}
+
+template <typename T>
+void spt::util::impl::write( Builder& builder, std::string_view name, const std::shared_ptr<T>& value )
+{
+  if ( value ) write( builder, name, *value );
+}
+
+template <typename T>
+void spt::util::impl::write( Builder& builder, std::string_view name, const std::reference_wrapper<T>& value )
+{
+  write( builder, name, value.get() );
+}
+
+template <typename T>
+void spt::util::impl::write( Builder& builder, std::string_view name, const std::set<T>& value )
+{
+  elements( builder, name, value );
+}
+
+template <typename T>
+void spt::util::impl::write( Builder& builder, std::string_view name, const std::vector<T>& value )
+{
+  elements( builder, name, value );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const bool& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_bool{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const int8_t& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_int32{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const uint8_t& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_int32{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const int16_t& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_int32{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const uint16_t& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_int32{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const int32_t& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_int32{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const uint32_t& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_int64{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const int64_t& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_int64{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const float& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_double{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const double& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_double{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const std::string& value )
+{
+  if ( value.empty() ) return;
+  key( builder, name );
+  builder.append( bsoncxx::types::b_string{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const bsoncxx::oid& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_oid{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const DateTime& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_date{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const DateTimeMs& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_date{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const DateTimeNs& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_date{ std::chrono::duration_cast<std::chrono::milliseconds>( value.time_since_epoch() ) } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const std::chrono::seconds& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_int64{ value.count() } );
+}
 
-  if constexpr ( visit_struct::traits::ext::is_fully_visitable<M>() == false ) populate( model, root );
-  return { root << bsoncxx::builder::stream::finalize };
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const std::chrono::milliseconds& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_int64{ value.count() } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const std::chrono::microseconds& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_int64{ value.count() } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const std::chrono::nanoseconds& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_int64{ value.count() } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const boost::uuids::uuid& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_binary{ bsoncxx::binary_sub_type::k_uuid, boost::uuids::uuid::static_size(), value.data } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const bsoncxx::array::value& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_array{ value } );
+}
+
+inline void spt::util::impl::write( Builder& builder, std::string_view name, const bsoncxx::document::value& value )
+{
+  key( builder, name );
+  builder.append( bsoncxx::types::b_document{ value } );
 }
 
 template<spt::util::Visitable Model>
@@ -646,26 +1133,39 @@ void spt::util::set( M& field, bsoncxx::types::bson_value::view value )
 {
   if ( value.type() != bsoncxx::type::k_document ) LOG_CRIT << "Value not document type but " << bsoncxx::to_string( value.type() );
   auto view = value.get_document().value;
-  visit_struct::for_each( field,
-      [&view]( const char* name, auto& member )
-      {
-        auto n = std::string_view{ name };
-        if ( auto it = view.find( n ); it != std::cend( view ) )
-        {
-          if ( it->type() != bsoncxx::type::k_null ) set( member, it->get_value() );
-        }
-        else if ( n == "id"sv )
-        {
-          if ( auto iter = view.find( "_id"sv ); iter != std::cend( view ) && iter->type() == bsoncxx::type::k_oid )
-          {
-            set( member, iter->get_value() );
-          }
-        }
-      } );
+  impl::read( field, view );
 
   if constexpr ( visit_struct::traits::ext::is_fully_visitable<M>() == false ) populate( field, view );
 }
 
+template <spt::util::Visitable M>
+void spt::util::impl::read( M& model, bsoncxx::document::view view )
+{
+  using F = Fields<M>;
+  auto seen = std::bitset<F::count>{};
+  auto oid = bsoncxx::document::element{};
+
+  for ( const auto& element : view )
+  {
+    const auto key = std::string_view{ element.key() };
+    if constexpr ( F::id < F::count )
+    {
+      if ( !oid && key == "_id"sv ) oid = element;
+    }
+
+    const auto i = F::index.find( key );
+    if ( i == F::count || seen.test( i ) ) continue;
+
+    seen.set( i );
+    if ( element.type() != bsoncxx::type::k_null ) F::setters[i]( model, element.get_value() );
+  }
+
+  if constexpr ( F::id < F::count )
+  {
+    if ( !seen.test( F::id ) && oid && oid.type() == bsoncxx::type::k_oid ) F::setters[F::id]( model, oid.get_value() );
+  }
+}
+
 template <>
 inline void spt::util::set( bool& field, bsoncxx::types::bson_value::view value ) { field = value.get_bool().value; }
 
@@ -815,6 +1315,9 @@ inline void spt::util::set( bsoncxx::oid& field, bsoncxx::types::bson_value::vie
 template <>
 inline void spt::util::set( std::string& field, bsoncxx::types::bson_value::view value ) { field = value.get_string().value; }
 
+template <>
+inline void spt::util::set( std::string_view& field, bsoncxx::types::bson_value::view value ) { field = value.get_string().value; }
+
 template <>
 inline void spt::util::set( DateTime& field, bsoncxx::types::bson_value::view value )
 {
@@ -937,6 +1440,18 @@ inline void spt::util::set( std::optional<bsoncxx::document::value>& field, bson
   if ( bsoncxx::type::k_document == value.type() ) field = bsoncxx::document::value{ value.get_document().value };
 }
 
+template <>
+inline void spt::util::set( bsoncxx::array::view& field, bsoncxx::types::bson_value::view value )
+{
+  if ( bsoncxx::type::k_array == value.type() ) field = value.get_array().value;
+}
+
+template <>
+inline void spt::util::set( bsoncxx::document::view& field, bsoncxx::types::bson_value::view value )
+{
+  if ( bsoncxx::type::k_document == value.type() ) field = value.get_document().value;
+}
+
 template <>
 inline void spt::util::set( std::set<bool>& field, bsoncxx::types::bson_value::view value )
 {
@@ -1075,7 +1590,7 @@ void spt::util::set( std::set<Model>& field, bsoncxx::types::bson_value::view va
     else
     {
       auto m = Model{};
-      set( m, bsoncxx::types::bson_value::value{ item.get_document().value } );
+      set( m, bsoncxx::types::bson_value::view{ item.get_document() } );
       field.insert( std::move( m ) );
     }
   }
@@ -1123,7 +1638,7 @@ void spt::util::set( std::vector<Model>& field, bsoncxx::types::bson_value::view
     else
     {
       field.emplace_back();
-      set( field.back(), bsoncxx::types::bson_value::value{ item.get_document().value } );
+      set( field.back(), bsoncxx::types::bson_value::view{ item.get_document() } );
     }
   }
 }
@@ -4,170 +4,379 @@
 
 #include "validate.hpp"
 
-#include <regex>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-using std::operator""s;
 using std::operator""sv;
 
-bool spt::util::json::hasDangerousContent( const std::string& field )
+namespace spt::util::json::pvalidate
 {
-  // "<[A-z0-9_/ \"']*>"s
-  // "<(\"[^\"]*\"|'[^']*'|[^'\">])*>"s
-  static const auto regex = std::regex{ "<[^<>]+>"s,
-      std::regex_constants::ECMAScript | std::regex_constants::icase |
-          std::regex::multiline | std::regex::optimize };
+#if defined(__AVX2__)
+  struct Simd
+  {
+    using Vector = __m256i;
+    static constexpr std::size_t width = 32;
 
-  if ( field.empty() ) return false;
-  const auto html = [&field]()
+    static Vector load( const char* data ) { return _mm256_loadu_si256( reinterpret_cast<const __m256i*>( data ) ); }
+    static Vector splat( char c ) { return _mm256_set1_epi8( c ); }
+    static Vector lower( Vector v ) { return _mm256_or_si256( v, splat( 0x20 ) ); }
+    static uint32_t eq( Vector a, Vector b ) { return static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( a, b ) ) ); }
+    // Signed comparison, same as char on x86
+    static uint32_t gt( Vector a, Vector b ) { return static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_cmpgt_epi8( a, b ) ) ); }
+    static constexpr uint32_t all = 0xFFFFFFFF;
+  };
+#elif defined(__SSE2__)
+  struct Simd
   {
-    if ( std::regex_search( field, regex ) )
-    {
-      LOG_WARN << "Potential HTML tag(s) in payload. " << field;
-      return true;
-    }
+    using Vector = __m128i;
+    static constexpr std::size_t width = 16;
 
-    return false;
+    static Vector load( const char* data ) { return _mm_loadu_si128( reinterpret_cast<const __m128i*>( data ) ); }
+    static Vector splat( char c ) { return _mm_set1_epi8( c ); }
+    static Vector lower( Vector v ) { return _mm_or_si128( v, splat( 0x20 ) ); }
+    static uint32_t eq( Vector a, Vector b ) { return static_cast<uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( a, b ) ) ); }
+    // Signed comparison, same as char on x86
+    static uint32_t gt( Vector a, Vector b ) { return static_cast<uint32_t>( _mm_movemask_epi8( _mm_cmpgt_epi8( a, b ) ) ); }
+    static constexpr uint32_t all = 0xFFFF;
   };
+#endif
 
-  const auto script = [&field]()
-  {
-    const auto var = field.find( "var "sv ) != std::string::npos;
-    const auto let = field.find( "let "sv ) != std::string::npos;
-    const auto cst = field.find( "const "sv ) != std::string::npos;
-    const auto eval = field.find( "eval"sv ) != std::string::npos;
-    const auto equals = field.find( "="sv ) != std::string::npos;
-    const auto fn = field.find( "function "sv ) != std::string::npos;
-    const auto async = field.find( "async "sv ) != std::string::npos;
-    const auto await = field.find( "await"sv ) != std::string::npos;
-    const auto alert = field.find( "alert("sv ) != std::string::npos;
-    const auto console = field.find( "console."sv ) != std::string::npos;
-    if ( ( var || let || cst || eval || async || alert ) && ( equals || fn || await || console ) )
-    {
-      LOG_WARN << "Potential JavaScript in payload. " << field;
-      return true;
-    }
+  enum Pattern : uint16_t
+  {
+    Var = 1, Let = 1 << 1, Const = 1 << 2, Eval = 1 << 3, Async = 1 << 4, Alert = 1 << 5,
+    Equals = 1 << 6, Function = 1 << 7, Await = 1 << 8, Console = 1 << 9
+  };
 
-    return false;
+  struct Keyword
+  {
+    std::string_view text;
+    Pattern pattern;
   };
 
-  if ( html() ) return true;
-  return script();
-}
+  // Script is reported when one of the declarations is present along with one of the usages (including `=`).
+  constexpr uint16_t declarations = Var | Let | Const | Eval | Async | Alert;
+  constexpr uint16_t usages = Equals | Function | Await | Console;
+  constexpr auto keywords = std::array{
+    Keyword{ "var "sv, Var }, Keyword{ "let "sv, Let }, Keyword{ "const "sv, Const }, Keyword{ "eval"sv, Eval },
+    Keyword{ "async "sv, Async }, Keyword{ "alert("sv, Alert }, Keyword{ "function "sv, Function },
+    Keyword{ "await"sv, Await }, Keyword{ "console."sv, Console } };
+  constexpr auto longest = std::ranges::max( keywords, {}, []( const Keyword& k ) { return k.text.size(); } ).text.size();
 
-bool spt::util::json::impl::validate( const char* name, std::string_view field )
-{
-  if ( field.size() < 2 ) return true;
-  using std::operator""sv;
-  auto str = std::string{ name };
-  boost::algorithm::to_lower( str );
-  const auto& helper = IgnoreList::instance();
-  for ( const auto& ignore : helper.names ) if ( str.contains( ignore ) ) return true;
+  struct Scan
+  {
+    [[nodiscard]] bool script() const { return ( patterns & declarations ) && ( patterns & usages ); }
 
-  std::size_t special{ 0 };
+    // Equivalent to matching the regular expression <[^<>]+>
+    void tag( std::size_t position, char c )
+    {
+      if ( c == '<' ) open = position;
+      else
+      {
+        if ( open != std::string_view::npos && position > open + 1 ) html = true;
+        open = std::string_view::npos;
+      }
+    }
 
-  for ( const char c : field )
-  {
-    if ( c < 32 || ( c >= 33 && c <= 47 ) || ( c >= 58 && c <= 64 ) || ( c >= 91 && c <= 96 ) || ( c >= 123 && c < 127 ) ) ++special;
-  }
+    std::size_t open{ std::string_view::npos };
+    uint16_t patterns{ 0 };
+    bool html{ false };
+  };
 
-  const auto valid = double(special) / double(field.size()) <= helper.ratio;
-  if ( !valid )
+  // Single pass over the value looking for tags and script patterns.  Blocks are scanned for the first and last
+  // characters of each keyword, and only candidate positions are compared.
+  Scan scan( std::string_view field )
   {
-    LOG_WARN << "Field " << name << " has too many special characters.  Limit is " << (helper.ratio * 100) << "% of value. Size: " <<
-        int(field.size()) << "; special characters: " << int(special) << ". " << field;
-  }
-  return valid;
-}
+    auto result = Scan{};
+    const auto* data = field.data();
+    std::size_t i = 0;
 
-bool spt::util::json::impl::validate( const char* name, bsoncxx::array::view field )
-{
-  for ( const auto& e : field )
-  {
-    switch ( e.type() )
+#if defined(__SSE2__)
+    const auto lt = Simd::splat( '<' );
+    const auto gt = Simd::splat( '>' );
+    const auto equals = Simd::splat( '=' );
+    Simd::Vector firsts[keywords.size()];
+    Simd::Vector lasts[keywords.size()];
+    for ( std::size_t k = 0; k < keywords.size(); ++k )
     {
-    case bsoncxx::type::k_array:
+      firsts[k] = Simd::splat( keywords[k].text.front() );
+      lasts[k] = Simd::splat( keywords[k].text.back() );
+    }
+
+    for ( ; i + Simd::width + longest - 1 <= field.size(); i += Simd::width )
     {
-      auto view = e.get_array().value;
-      if ( !validate( name, view ) )
+      const auto block = Simd::load( data + i );
+      for ( auto tags = Simd::eq( block, lt ) | Simd::eq( block, gt ); tags; tags &= tags - 1 )
       {
-        LOG_WARN << "Invalid data in array of array " << name;
-        return false;
+        const auto position = i + std::countr_zero( tags );
+        result.tag( position, data[position] );
+        if ( result.html ) return result;
       }
-      break;
+
+      if ( Simd::eq( block, equals ) ) result.patterns |= Equals;
+
+      for ( std::size_t k = 0; k < keywords.size(); ++k )
+      {
+        const auto& keyword = keywords[k];
+        if ( result.patterns & keyword.pattern ) continue;
+
+        auto candidates = Simd::eq( block, firsts[k] ) & Simd::eq( Simd::load( data + i + keyword.text.size() - 1 ), lasts[k] );
+        for ( ; candidates; candidates &= candidates - 1 )
+        {
+          if ( std::memcmp( data + i + std::countr_zero( candidates ), keyword.text.data(), keyword.text.size() ) == 0 )
+          {
+            result.patterns |= keyword.pattern;
+            break;
+          }
+        }
+      }
+
+      if ( result.script() ) return result;
     }
-    case bsoncxx::type::k_document:
+#endif
+
+    // Remainder, or the entire value when SIMD is not available.  Matches starting before i have been checked.
+    for ( auto j = i; j < field.size(); ++j )
     {
-      auto view = e.get_document().value;
-      if ( !validate( name, view ) )
+      if ( data[j] == '<' || data[j] == '>' )
       {
-        LOG_WARN << "Invalid data in object of array " << name;
-        return false;
+        result.tag( j, data[j] );
+        if ( result.html ) return result;
       }
-      break;
     }
-    case bsoncxx::type::k_string:
+
+    if ( field.find( '=', i ) != std::string_view::npos ) result.patterns |= Equals;
+    for ( const auto& keyword : keywords )
     {
-      auto view = e.get_string().value;
-      if ( !validate( name, view ) )
+      if ( !( result.patterns & keyword.pattern ) && field.find( keyword.text, i ) != std::string_view::npos )
       {
-        LOG_WARN << "Invalid data in string of array " << name;
-        return false;
+        result.patterns |= keyword.pattern;
       }
-      break;
-    }
-    default:
-      break;
     }
+
+    return result;
   }
 
-  return true;
-}
+  bool special( char c )
+  {
+    return c < 32 || ( c >= 33 && c <= 47 ) || ( c >= 58 && c <= 64 ) || ( c >= 91 && c <= 96 ) || ( c >= 123 && c < 127 );
+  }
 
-bool spt::util::json::impl::validate( const char* name, bsoncxx::document::view field )
-{
-  for ( const auto& e : field )
+  // Count characters that are not space, digits, letters or DEL.
+  std::size_t special( std::string_view field )
   {
-    auto k = e.key();
-    auto key = std::string{ k };
+    std::size_t count{ 0 };
+    std::size_t i = 0;
 
-    switch ( e.type() )
+#if defined(__SSE2__)
+    const auto space = Simd::splat( 32 );
+    const auto del = Simd::splat( 127 );
+    const auto beforeDigits = Simd::splat( '0' - 1 );
+    const auto afterDigits = Simd::splat( '9' + 1 );
+    const auto beforeLetters = Simd::splat( 'a' - 1 );
+    const auto afterLetters = Simd::splat( 'z' + 1 );
+    for ( ; i + Simd::width <= field.size(); i += Simd::width )
     {
-    case bsoncxx::type::k_array:
+      const auto block = Simd::load( field.data() + i );
+      const auto lower = Simd::lower( block );
+      const auto plain = Simd::eq( block, space ) | Simd::eq( block, del ) |
+        ( Simd::gt( block, beforeDigits ) & Simd::gt( afterDigits, block ) ) |
+        ( Simd::gt( lower, beforeLetters ) & Simd::gt( afterLetters, lower ) );
+      count += std::popcount( ~plain & Simd::all );
+    }
+#endif
+
+    for ( ; i < field.size(); ++i ) if ( special( field[i] ) ) ++count;
+    return count;
+  }
+
+  bool ignored( std::string_view name, const std::vector<std::string>& names )
+  {
+    const auto lower = []( char c ) { return c >= 'A' && c <= 'Z' ? static_cast<char>( c + 32 ) : c; };
+    return std::ranges::any_of( names, [name, &lower]( const std::string& ignore )
     {
-      auto view = e.get_array().value;
-      if ( !validate( key.c_str(), view ) )
+      return ignore.empty() || !std::ranges::search( name, ignore, {}, lower ).empty();
+    } );
+  }
+
+  int32_t length( const uint8_t* data )
+  {
+    int32_t value;
+    std::memcpy( &value, data, sizeof(value) );
+    if constexpr ( std::endian::native == std::endian::big ) value = std::byteswap( value );
+    return value;
+  }
+
+  bool malformed( const char* name )
+  {
+    LOG_WARN << "Malformed BSON in " << name;
+    return false;
+  }
+
+  // Walk the elements of the BSON document or array in place.  Strings are validated, and embedded documents and
+  // arrays are walked recursively.  Keys are used in place as they are NUL terminated in the buffer.
+  bool walk( const char* name, const uint8_t* data, std::size_t size, bool array )
+  {
+    if ( size < 5 ) return malformed( name );
+    const auto total = length( data );
+    if ( total < 5 || static_cast<std::size_t>( total ) > size || data[total - 1] != 0 ) return malformed( name );
+
+    const auto end = static_cast<std::size_t>( total ) - 1;
+    std::size_t pos = 4;
+    while ( pos < end )
+    {
+      const auto type = data[pos++];
+      const auto* key = reinterpret_cast<const char*>( data + pos );
+      const auto* nul = static_cast<const char*>( std::memchr( key, 0, end - pos ) );
+      if ( nul == nullptr ) return malformed( name );
+      pos += static_cast<std::size_t>( nul - key ) + 1;
+
+      const auto* child = array ? name : key;
+      const auto remaining = end - pos;
+      const auto sized = [data, pos, remaining]( std::size_t prefix ) -> std::size_t
+      {
+        if ( remaining < 4 ) return std::string_view::npos;
+        const auto value = length( data + pos );
+        if ( value < 0 ) return std::string_view::npos;
+        return prefix + static_cast<std::size_t>( value );
+      };
+
+      std::size_t skip{ 0 };
+      switch ( type )
+      {
+      case 0x06: // undefined
+      case 0x0A: // null
+      case 0x7F: // max key
+      case 0xFF: // min key
+        break;
+      case 0x08: // bool
+        skip = 1;
+        break;
+      case 0x10: // int32
+        skip = 4;
+        break;
+      case 0x01: // double
+      case 0x09: // date
+      case 0x11: // timestamp
+      case 0x12: // int64
+        skip = 8;
+        break;
+      case 0x07: // oid
+        skip = 12;
+        break;
+      case 0x13: // decimal128
+        skip = 16;
+        break;
+      case 0x02: // string
       {
-        LOG_WARN << "Invalid data in array " << k << " of " << name;
-        return false;
+        skip = sized( 4 );
+        if ( skip == std::string_view::npos || skip < 5 || skip > remaining || data[pos + skip - 1] != 0 ) return malformed( name );
+        if ( !impl::validate( child, std::string_view{ reinterpret_cast<const char*>( data + pos + 4 ), skip - 5 } ) )
+        {
+          LOG_WARN << "Invalid data in string " << key << " of " << name;
+          return false;
+        }
+        break;
       }
-      break;
-    }
-    case bsoncxx::type::k_document:
-    {
-      auto view = e.get_document().value;
-      if ( !validate( key.c_str(), view ) )
+      case 0x0D: // javascript
+      case 0x0E: // symbol
+      case 0x0F: // javascript with scope
+        skip = type == 0x0F ? sized( 0 ) : sized( 4 );
+        break;
+      case 0x05: // binary
+        skip = sized( 5 );
+        break;
+      case 0x0C: // db pointer
+        skip = sized( 16 );
+        break;
+      case 0x03: // document
+      case 0x04: // array
       {
-        LOG_WARN << "Invalid data in object " << k << " of " << name;
-        return false;
+        if ( !walk( child, data + pos, remaining, type == 0x04 ) )
+        {
+          LOG_WARN << "Invalid data in " << ( type == 0x04 ? "array " : "object " ) << key << " of " << name;
+          return false;
+        }
+        skip = static_cast<std::size_t>( length( data + pos ) );
+        break;
       }
-      break;
-    }
-    case bsoncxx::type::k_string:
-    {
-      auto view = e.get_string().value;
-      if ( !validate( key.c_str(), view ) )
+      case 0x0B: // regex
       {
-        LOG_WARN << "Invalid data in string " << k << " of " << name;
-        return false;
+        const auto* pattern = static_cast<const uint8_t*>( std::memchr( data + pos, 0, remaining ) );
+        if ( pattern == nullptr ) return malformed( name );
+        const auto* options = static_cast<const uint8_t*>( std::memchr( pattern + 1, 0, data + end - pattern - 1 ) );
+        if ( options == nullptr ) return malformed( name );
+        skip = static_cast<std::size_t>( options - ( data + pos ) ) + 1;
+        break;
       }
-      break;
-    }
-    default:
-      break;
+      default:
+        return malformed( name );
+      }
+
+      if ( skip > remaining ) return malformed( name );
+      pos += skip;
     }
+
+    return pos == end;
   }
+}
 
-  return true;
+bool spt::util::json::hasDangerousContent( std::string_view field )
+{
+  if ( field.empty() ) return false;
+
+  const auto result = pvalidate::scan( field );
+  if ( result.html )
+  {
+    LOG_WARN << "Potential HTML tag(s) in payload. " << field;
+    return true;
+  }
+
+  if ( result.script() )
+  {
+    LOG_WARN << "Potential JavaScript in payload. " << field;
+    return true;
+  }
+
+  return false;
+}
+
+bool spt::util::json::validateBson( const char* name, const uint8_t* data, std::size_t length )
+{
+  return pvalidate::walk( name, data, length, false );
+}
+
+bool spt::util::json::impl::validate( const char* name, std::string_view field )
+{
+  if ( field.size() < 2 ) return true;
+  const auto& helper = IgnoreList::instance();
+  if ( pvalidate::ignored( name, helper.names ) ) return true;
+
+  const auto special = pvalidate::special( field );
+  const auto valid = double(special) / double(field.size()) <= helper.ratio;
+  if ( !valid )
+  {
+    LOG_WARN << "Field " << name << " has too many special characters.  Limit is " << (helper.ratio * 100) << "% of value. Size: " <<
+        int(field.size()) << "; special characters: " << int(special) << ". " << field;
+  }
+  return valid;
+}
+
+bool spt::util::json::impl::validate( const char* name, bsoncxx::array::view field )
+{
+  return pvalidate::walk( name, field.data(), field.length(), true );
+}
+
+bool spt::util::json::impl::validate( const char* name, bsoncxx::document::view field )
+{
+  return pvalidate::walk( name, field.data(), field.length(), false );
 }
 
 bool spt::util::json::impl::validate( const char* name, const boost::json::array& array )
@@ -12,7 +12,9 @@
 #endif
 #endif
 
+#include <cstdint>
 #include <cstdlib>
+#include <string_view>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/json/array.hpp>
@@ -91,11 +93,22 @@ namespace spt::util::json
    * XML/HTML type tags, potential JavaScript code etc.
    *
    * This function is not used when parsing JSON.  This is a stand-alone utility function, which generally is used
-   * on the raw JSON data prior to parsing.
+   * on the raw JSON data prior to parsing.  The value is scanned in a single pass, using SIMD instructions where
+   * available.
    * @param field The string to check for potentially dangerous content.
    * @return true if potentially dangerous content is found.
    */
-  bool hasDangerousContent( const std::string& field );
+  bool hasDangerousContent( std::string_view field );
+
+  /**
+   * Validate the strings in a raw BSON document in a single walk over the buffer, without creating views for each
+   * element.  Applies the same rules as `validate` for `bsoncxx::document::view`, which also uses this function.
+   * @param name The name of the field (or entity) the document represents.
+   * @param data The buffer holding the BSON document.
+   * @param length The size of the buffer.
+   * @return true if all strings are acceptable.  false if validation fails or if the buffer is not a valid document.
+   */
+  bool validateBson( const char* name, const uint8_t* data, std::size_t length );
 }
 
 template <>
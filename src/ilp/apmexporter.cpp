@@ -0,0 +1,163 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "apmexporter.hpp"
+
+#if defined __has_include
+#if __has_include("../log/NanoLog.hpp")
+#include "../log/NanoLog.hpp"
+#else
+#include <log/NanoLog.h>
+#endif
+#if __has_include("../common/util/ringbuffer.hpp")
+#include "../common/util/ringbuffer.hpp"
+#else
+#include <mongo-service/common/util/ringbuffer.hpp>
+#endif
+#endif
+
+#include <optional>
+
+using spt::ilp::APMExporter;
+
+struct APMExporter::Queue
+{
+  explicit Queue( std::size_t size ) : buffer{ size } {}
+
+  util::RingBuffer<std::optional<APMRecord>> buffer;
+};
+
+APMExporter::APMExporter( Configuration conf ) :
+  configuration{ std::move( conf ) }, queue{ std::make_unique<Queue>( configuration.queueSize ) },
+  client{ ioc, configuration.host, configuration.port, configuration.client }
+{
+  if ( configuration.batchSize == 0 ) configuration.batchSize = 1;
+  io = std::thread{ [this] { ioc.run(); } };
+  flusher = std::thread{ &APMExporter::run, this };
+}
+
+APMExporter::~APMExporter()
+{
+  stop();
+}
+
+bool APMExporter::add( APMRecord&& record )
+{
+  if ( stopped.load( std::memory_order_acquire ) )
+  {
+    dropped.fetch_add( 1, std::memory_order_relaxed );
+    return false;
+  }
+
+  if ( configuration.sampleRate > 1 &&
+    counter.fetch_add( 1, std::memory_order_relaxed ) % configuration.sampleRate != 0 )
+  {
+    sampled.fetch_add( 1, std::memory_order_relaxed );
+    return false;
+  }
+
+  if ( !queue->buffer.push( std::optional<APMRecord>{ std::move( record ) } ) )
+  {
+    dropped.fetch_add( 1, std::memory_order_relaxed );
+    return false;
+  }
+
+  if ( queue->buffer.approximateSize() >= configuration.batchSize &&
+    !signalled.exchange( true, std::memory_order_acq_rel ) )
+  {
+    auto lock = std::scoped_lock{ mutex };
+    cv.notify_one();
+  }
+
+  return true;
+}
+
+void APMExporter::stop( std::chrono::milliseconds timeout )
+{
+  if ( stopped.exchange( true, std::memory_order_acq_rel ) ) return;
+
+  {
+    auto lock = std::scoped_lock{ mutex };
+    cv.notify_one();
+  }
+  if ( flusher.joinable() ) flusher.join();
+
+  // Records pushed concurrently with the final drain
+  while ( queue->buffer.pop() ) dropped.fetch_add( 1, std::memory_order_relaxed );
+
+  if ( !client.flush( timeout ) ) LOG_WARN << "Timed out flushing APM records to " << configuration.host;
+  guard.reset();
+  ioc.stop();
+  if ( io.joinable() ) io.join();
+
+  const auto st = stats();
+  LOG_INFO << "APM exporter stopped. Exported " << int64_t( st.exported ) << " records in " << int64_t( st.batches ) <<
+    " batches, sampled out " << int64_t( st.sampled ) << ", dropped " << int64_t( st.dropped ) << " records.";
+}
+
+APMExporter::Stats APMExporter::stats() const
+{
+  return Stats{
+    .exported = exported.load( std::memory_order_relaxed ),
+    .sampled = sampled.load( std::memory_order_relaxed ),
+    .dropped = dropped.load( std::memory_order_relaxed ),
+    .batches = batches.load( std::memory_order_relaxed ),
+    .client = client.stats()
+  };
+}
+
+void APMExporter::run()
+{
+  auto builder = Builder{};
+  auto last = std::chrono::steady_clock::now();
+  std::size_t held = 0;
+
+  const auto send = [this, &builder, &held, &last]
+  {
+    // Send a copy so that the builder retains its buffer for the next batch
+    client.write( builder.view() );
+    builder.clear();
+    exported.fetch_add( held, std::memory_order_relaxed );
+    batches.fetch_add( 1, std::memory_order_relaxed );
+    held = 0;
+    last = std::chrono::steady_clock::now();
+  };
+
+  for (;;)
+  {
+    const auto stopping = stopped.load( std::memory_order_acquire );
+
+    for (;;)
+    {
+      held += drain( builder, configuration.batchSize - held );
+      if ( held < configuration.batchSize ) break;
+      send();
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if ( held > 0 && ( stopping || now - last >= configuration.flushInterval ) ) send();
+    else if ( held == 0 ) last = now;
+
+    if ( stopping ) break;
+
+    auto lock = std::unique_lock{ mutex };
+    cv.wait_until( lock, last + configuration.flushInterval,
+      [this] { return signalled.load( std::memory_order_acquire ) || stopped.load( std::memory_order_acquire ); } );
+    signalled.store( false, std::memory_order_release );
+  }
+}
+
+std::size_t APMExporter::drain( Builder& builder, std::size_t limit )
+{
+  std::size_t count = 0;
+  while ( count < limit )
+  {
+    auto record = queue->buffer.pop();
+    if ( !record || !*record ) break;
+    builder.add( configuration.series, **record );
+    ++count;
+  }
+
+  return count;
+}
@@ -0,0 +1,128 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include "apmrecord.hpp"
+#include "asyncilp.hpp"
+#include "builder.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+
+namespace spt::ilp
+{
+  /**
+   * Background exporter for APM records.  Records handed to the exporter are queued in a bounded
+   * lock-free queue, serialised in batches via `Builder::add` on a dedicated thread, and sent to the
+   * TSDB over a non-blocking ILP connection.  Adding a record never blocks the caller.  When the queue
+   * is full the record is dropped and counted.
+   */
+  struct APMExporter
+  {
+    /// Configuration for the exporter.
+    struct Configuration
+    {
+      /// The hostname of the ILP server.
+      std::string host;
+      /// The port on which the ILP server listens.
+      std::string port{ "9009" };
+      /// The name of the series (measurement) to which records are written.
+      std::string series{ "apm" };
+      /// Maximum number of records queued for export.  Records are dropped once full.
+      std::size_t queueSize{ 8192 };
+      /// Number of records to serialise into a single ILP batch.
+      std::size_t batchSize{ 100 };
+      /// Maximum delay before queued records are sent, even if a full batch is not available.
+      std::chrono::milliseconds flushInterval{ 1000 };
+      /// Export one in `sampleRate` records.  A value of `0` or `1` exports all records.
+      uint32_t sampleRate{ 1 };
+      /// Buffering and reconnection options for the ILP connection.
+      AsyncILPClient::Options client{};
+    };
+
+    /// Snapshot of the counters maintained by the exporter.
+    struct Stats
+    {
+      /// Number of records serialised and handed to the ILP client.
+      uint64_t exported;
+      /// Number of records skipped due to sampling.
+      uint64_t sampled;
+      /// Number of records dropped since the queue was full, or the exporter was stopped.
+      uint64_t dropped;
+      /// Number of ILP batches sent.
+      uint64_t batches;
+      /// Counters from the underlying ILP client.
+      AsyncILPClient::Stats client;
+    };
+
+    /**
+     * Create an exporter and start the background threads.
+     * @param configuration The configuration for the exporter.
+     */
+    explicit APMExporter( Configuration configuration );
+
+    /// Stops the exporter (see `stop`) if not already stopped.
+    ~APMExporter();
+
+    APMExporter( const APMExporter& ) = delete;
+    APMExporter& operator=( const APMExporter& ) = delete;
+    APMExporter( APMExporter&& ) = delete;
+    APMExporter& operator=( APMExporter&& ) = delete;
+
+    /**
+     * Queue a record for export.  Never blocks, and is safe to invoke from any thread.
+     * @param record The APM record to export.  The `duration` should already have been set.
+     * @return `true` if the record was queued, `false` if it was sampled out or dropped.
+     */
+    bool add( APMRecord&& record );
+
+    /**
+     * Export all queued records and stop the background threads.  Records added after this are dropped.
+     * Idempotent.
+     * @param timeout The maximum duration to wait for buffered data to be sent to the TSDB.
+     */
+    void stop( std::chrono::milliseconds timeout = std::chrono::seconds{ 5 } );
+
+    /**
+     * @return A snapshot of the counters maintained by the exporter.
+     */
+    [[nodiscard]] Stats stats() const;
+
+  private:
+    struct Queue;
+
+    void run();
+    std::size_t drain( Builder& builder, std::size_t limit );
+
+    Configuration configuration;
+    std::unique_ptr<Queue> queue;
+
+    boost::asio::io_context ioc;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> guard{ boost::asio::make_work_guard( ioc ) };
+    AsyncILPClient client;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    std::atomic<uint64_t> counter{ 0 };
+    std::atomic<uint64_t> exported{ 0 };
+    std::atomic<uint64_t> sampled{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<uint64_t> batches{ 0 };
+    std::atomic_bool signalled{ false };
+    std::atomic_bool stopped{ false };
+
+    std::thread io;
+    std::thread flusher;
+  };
+}
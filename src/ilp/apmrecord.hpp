@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include "segmentedvector.hpp"
+
 #include <chrono>
-#include <deque>
 #include <format>
+#include <optional>
 #include <source_location>
 #include <string>
 #include <string_view>
@@ -68,10 +70,19 @@ namespace spt::ilp
       /// The duration for completing the process.  This is sent as a value over ILP.
       /// Note: Do not include a duration value in the `values` map.
       std::chrono::nanoseconds duration{ 0 };
+      /// The source location at which the process was created via `addProcess` or `addException`.
+      /// Sent as `file`, `line` and `function` values over ILP, unless the same keys are in `values`.
+      std::optional<std::source_location> location{ std::nullopt };
+      /// The calling function added via `addCurrentFunction`.  Sent as `caller_file`, `caller_line` and
+      /// `caller_function` values over ILP, unless the same keys are in `values`.
+      std::optional<std::source_location> caller{ std::nullopt };
       /// The type of the process.  Default `Other`
       Type type{ Type::Other };
     };
 
+    /// Type of container used to store processes.  References to processes remain valid as processes are added.
+    using Processes = SegmentedVector<Process>;
+
     /**
      * Create a new APM record that will be sent to a TSDB over ILP.
      * @param id The unique id assigned to each invocation of the business process.
@@ -84,7 +95,7 @@ namespace spt::ilp
     APMRecord( const APMRecord& ) = delete;
     APMRecord& operator=( const APMRecord& ) = delete;
 
-    std::deque<Process> processes;
+    Processes processes;
     /// Tags that will be sent via ILP.  Do not include application or id.
     TagMap tags;
     /// Values that will be sent via ILP.  Do not include duration.
@@ -100,6 +111,9 @@ namespace spt::ilp
     /// of all durations for child processes.  This is sent as a value via ILP.
     /// Note: Do not include a duration value in the `values` map.
     std::chrono::nanoseconds duration{ 0 };
+    /// The calling function added via `addCurrentFunction`.  Sent as `caller_file`, `caller_line` and
+    /// `caller_function` values over ILP, unless the same keys are in `values`.
+    std::optional<std::source_location> caller{ std::nullopt };
   };
 
   /// Concept that defines an APM record or process.  A structure that has a `timestamp` and `duration` of appropriate type.
@@ -155,7 +169,10 @@ namespace spt::ilp
   }
 
   /**
-   * Add the current function as the calling function for the specified record.
+   * Add the current function as the calling function for the specified record.  With the default `tagName`,
+   * only the source location is stored in the record, and the values are generated when serialised.  Values
+   * with the same names in the `values` map take precedence over the source location, whether set before
+   * or after this function is invoked.
    * @tparam T The type of record (APMRecord or Process).
    * @param record The record to which the calling function is to be added as a *value*.
    * @param loc The source location from which the caller is derived.
@@ -164,8 +181,23 @@ namespace spt::ilp
   template <Record T>
   void addCurrentFunction( T& record, const std::source_location loc = std::source_location::current(), std::string_view tagName = "caller" )
   {
-    record.values.try_emplace( std::format( "{}_file", tagName ), loc.file_name() );
-    record.values.try_emplace( std::format( "{}_line", tagName ), static_cast<uint64_t>( loc.line() ) );
-    if ( auto fn = std::string{ loc.function_name() }; !fn.empty() ) record.values.try_emplace( std::format( "{}_function", tagName ), std::move( fn ) );
+    using std::operator""sv;
+    if ( tagName == "caller"sv )
+    {
+      if ( !record.caller ) record.caller = loc;
+      return;
+    }
+
+    const auto key = [tagName]( std::string_view suffix )
+    {
+      auto k = std::string{};
+      k.reserve( tagName.size() + suffix.size() );
+      k.append( tagName ).append( suffix );
+      return k;
+    };
+
+    record.values.try_emplace( key( "_file"sv ), loc.file_name() );
+    record.values.try_emplace( key( "_line"sv ), static_cast<uint64_t>( loc.line() ) );
+    if ( auto fn = std::string_view{ loc.function_name() }; !fn.empty() ) record.values.try_emplace( key( "_function"sv ), std::string{ fn } );
   }
 }
\ No newline at end of file
@@ -0,0 +1,248 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "asyncilp.hpp"
+
+#if defined __has_include
+#if __has_include("../log/NanoLog.hpp")
+#include "../log/NanoLog.hpp"
+#else
+#include <log/NanoLog.h>
+#endif
+#endif
+
+#include <algorithm>
+#include <iterator>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/write.hpp>
+
+using spt::ilp::AsyncILPClient;
+
+AsyncILPClient::AsyncILPClient( boost::asio::io_context& ioc, std::string_view h, std::string_view p ) :
+  AsyncILPClient( ioc, h, p, Options{} ) {}
+
+AsyncILPClient::AsyncILPClient( boost::asio::io_context& ioc, std::string_view h, std::string_view p, Options o ) :
+  strand{ boost::asio::make_strand( ioc ) }, s{ strand }, resolver{ strand }, timer{ strand },
+  host{ h.data(), h.size() }, port{ p.data(), p.size() }, options{ o }, backoff{ o.initialBackoff } {}
+
+AsyncILPClient::~AsyncILPClient()
+{
+  close();
+}
+
+void AsyncILPClient::write( std::string&& data )
+{
+  if ( data.empty() ) return;
+  buffered.fetch_add( data.size(), std::memory_order_relaxed );
+  boost::asio::post( strand, [this, d = std::move( data )]() mutable { enqueue( std::move( d ) ); } );
+}
+
+void AsyncILPClient::write( std::string_view data )
+{
+  if ( data.empty() ) return;
+  write( std::string{ data } );
+}
+
+bool AsyncILPClient::flush( std::chrono::milliseconds timeout )
+{
+  auto lock = std::unique_lock{ mutex };
+  return drained.wait_for( lock, timeout, [this] { return buffered.load( std::memory_order_acquire ) == 0; } );
+}
+
+AsyncILPClient::Stats AsyncILPClient::stats() const
+{
+  return Stats{
+    .bytesSent = bytesSent.load( std::memory_order_relaxed ),
+    .batchesSent = batchesSent.load( std::memory_order_relaxed ),
+    .bytesDropped = bytesDropped.load( std::memory_order_relaxed ),
+    .batchesDropped = batchesDropped.load( std::memory_order_relaxed ),
+    .connects = connects.load( std::memory_order_relaxed ),
+    .errors = errors.load( std::memory_order_relaxed ),
+    .bytesBuffered = buffered.load( std::memory_order_relaxed )
+  };
+}
+
+void AsyncILPClient::enqueue( std::string&& data )
+{
+  const auto drop = [this]( std::size_t size )
+  {
+    bytesDropped.fetch_add( size, std::memory_order_relaxed );
+    batchesDropped.fetch_add( 1, std::memory_order_relaxed );
+    release( size );
+  };
+
+  if ( data.size() > options.maxBufferSize )
+  {
+    LOG_WARN << "Dropping ILP batch of " << int64_t( data.size() ) << " bytes larger than buffer limit";
+    drop( data.size() );
+    return;
+  }
+
+  pending.push_back( std::move( data ) );
+  pendingBytes += pending.back().size();
+
+  while ( pendingBytes > options.maxBufferSize )
+  {
+    const auto size = pending.front().size();
+    LOG_DEBUG << "Dropping oldest ILP batch of " << int64_t( size ) << " bytes";
+    pendingBytes -= size;
+    pending.pop_front();
+    drop( size );
+  }
+
+  if ( connected ) send();
+  else if ( !connecting ) connect();
+}
+
+void AsyncILPClient::connect()
+{
+  connecting = true;
+  resolver.async_resolve( host, port,
+    [this]( const boost::system::error_code& ec, boost::asio::ip::tcp::resolver::results_type results )
+    {
+      if ( ec )
+      {
+        LOG_WARN << "Error resolving ILP service " << host << ':' << port << ". " << ec.message();
+        errors.fetch_add( 1, std::memory_order_relaxed );
+        reconnect();
+        return;
+      }
+
+      boost::asio::async_connect( s, results,
+        [this]( const boost::system::error_code& ec, const boost::asio::ip::tcp::endpoint& )
+        {
+          if ( ec )
+          {
+            LOG_WARN << "Error connecting to ILP service " << host << ':' << port << ". " << ec.message();
+            errors.fetch_add( 1, std::memory_order_relaxed );
+            reconnect();
+            return;
+          }
+
+          boost::system::error_code oec;
+          s.set_option( boost::asio::socket_base::keep_alive{ true }, oec );
+          s.set_option( boost::asio::ip::tcp::no_delay{ true }, oec );
+
+          connecting = false;
+          connected = true;
+          backoff = options.initialBackoff;
+          last = std::chrono::steady_clock::now();
+          connects.fetch_add( 1, std::memory_order_relaxed );
+          LOG_DEBUG << "Connected to ILP service " << host << ':' << port;
+          send();
+        } );
+    } );
+}
+
+void AsyncILPClient::reconnect()
+{
+  close();
+  connecting = true;
+
+  const auto st = stats();
+  LOG_WARN << "Reconnecting to ILP service " << host << ':' << port << " in " << int64_t( backoff.count() ) <<
+    "ms. Buffered " << int64_t( st.bytesBuffered ) << " bytes, dropped " << int64_t( st.batchesDropped ) << " batches.";
+
+  timer.expires_after( backoff );
+  timer.async_wait( [this]( const boost::system::error_code& ec )
+  {
+    if ( ec ) return;
+    connect();
+  } );
+  backoff = std::min( backoff * 2, options.maxBackoff );
+}
+
+void AsyncILPClient::send()
+{
+  if ( writing || pending.empty() ) return;
+
+  if ( std::chrono::steady_clock::now() - last > options.idleTimeout )
+  {
+    LOG_DEBUG << "Re-opening idle connection to ILP service " << host << ':' << port;
+    close();
+    connect();
+    return;
+  }
+
+  inflight.clear();
+  inflight.reserve( pending.size() );
+  std::ranges::move( pending, std::back_inserter( inflight ) );
+  pending.clear();
+  pendingBytes = 0;
+
+  auto buffers = std::vector<boost::asio::const_buffer>{};
+  buffers.reserve( inflight.size() );
+  for ( const auto& d : inflight ) buffers.emplace_back( boost::asio::buffer( d ) );
+
+  writing = true;
+  boost::asio::async_write( s, buffers,
+    [this]( const boost::system::error_code& ec, std::size_t bytes )
+    {
+      writing = false;
+      if ( ec )
+      {
+        LOG_WARN << "Error writing to ILP service " << host << ':' << port << ". " << ec.message();
+        errors.fetch_add( 1, std::memory_order_relaxed );
+
+        if ( bytes == 0 )
+        {
+          // Nothing was written, retry the batches once reconnected.
+          for ( auto& d : inflight ) pendingBytes += d.size();
+          pending.insert( pending.begin(), std::make_move_iterator( inflight.begin() ), std::make_move_iterator( inflight.end() ) );
+          while ( pendingBytes > options.maxBufferSize )
+          {
+            const auto size = pending.front().size();
+            pendingBytes -= size;
+            pending.pop_front();
+            bytesDropped.fetch_add( size, std::memory_order_relaxed );
+            batchesDropped.fetch_add( 1, std::memory_order_relaxed );
+            release( size );
+          }
+        }
+        else
+        {
+          // A partially written batch cannot be safely resent, since the lines may be duplicated.
+          for ( const auto& d : inflight )
+          {
+            bytesDropped.fetch_add( d.size(), std::memory_order_relaxed );
+            batchesDropped.fetch_add( 1, std::memory_order_relaxed );
+            release( d.size() );
+          }
+        }
+
+        inflight.clear();
+        reconnect();
+        return;
+      }
+
+      bytesSent.fetch_add( bytes, std::memory_order_relaxed );
+      batchesSent.fetch_add( inflight.size(), std::memory_order_relaxed );
+      release( bytes );
+      inflight.clear();
+      last = std::chrono::steady_clock::now();
+      send();
+    } );
+}
+
+void AsyncILPClient::close()
+{
+  connected = false;
+  if ( !s.is_open() ) return;
+
+  boost::system::error_code ec;
+  s.shutdown( boost::asio::socket_base::shutdown_both, ec );
+  if ( ec ) LOG_DEBUG << "Error shutting down ILP socket. " << ec.message();
+  s.close( ec );
+  if ( ec ) LOG_DEBUG << "Error closing ILP socket. " << ec.message();
+}
+
+void AsyncILPClient::release( std::size_t size )
+{
+  if ( buffered.fetch_sub( size, std::memory_order_acq_rel ) != size ) return;
+
+  // Lock so that the notification cannot fall between a flushing thread checking the count and blocking.
+  auto lock = std::scoped_lock{ mutex };
+  drained.notify_all();
+}
@@ -0,0 +1,143 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+namespace spt::ilp
+{
+  /**
+   * A non-blocking TCP ILP client.  Data written to the client is buffered (up to a configured limit)
+   * and sent asynchronously on the `io_context` specified.  Buffered batches are coalesced into a single
+   * gather write.  When the TSDB is unavailable, the client reconnects with exponential backoff, and drops
+   * the oldest buffered data if the buffer limit is reached.  Errors are logged and counted, never thrown.
+   *
+   * The `io_context` must be run by the caller (typically on a dedicated thread), and must be stopped
+   * before the client is destroyed.
+   */
+  struct AsyncILPClient
+  {
+    struct Options
+    {
+      /// Maximum number of bytes to buffer while waiting to be sent.  The oldest data is dropped when exceeded.
+      std::size_t maxBufferSize{ 16 * 1024 * 1024 };
+      /// Initial delay before attempting to reconnect after a failure.
+      std::chrono::milliseconds initialBackoff{ 100 };
+      /// Maximum delay between reconnection attempts.
+      std::chrono::milliseconds maxBackoff{ 30'000 };
+      /// Connections idle for longer than this are re-established before writing.
+      std::chrono::seconds idleTimeout{ 240 };
+    };
+
+    /// Snapshot of the counters maintained by the client.
+    struct Stats
+    {
+      uint64_t bytesSent;
+      uint64_t batchesSent;
+      uint64_t bytesDropped;
+      uint64_t batchesDropped;
+      uint64_t connects;
+      uint64_t errors;
+      uint64_t bytesBuffered;
+    };
+
+    /**
+     * Create a client.  No connection is attempted until the first write.
+     * @param context The `io_context` instance to use to handle IO.
+     * @param host The hostname of the ILP server.
+     * @param port The port on which the ILP server listens.
+     */
+    AsyncILPClient( boost::asio::io_context& context, std::string_view host, std::string_view port );
+
+    /**
+     * Create a client with the specified options.
+     * @param context The `io_context` instance to use to handle IO.
+     * @param host The hostname of the ILP server.
+     * @param port The port on which the ILP server listens.
+     * @param options The buffering and reconnection options for the client.
+     */
+    AsyncILPClient( boost::asio::io_context& context, std::string_view host, std::string_view port, Options options );
+
+    ~AsyncILPClient();
+
+    AsyncILPClient( const AsyncILPClient& ) = delete;
+    AsyncILPClient& operator=( const AsyncILPClient& ) = delete;
+    AsyncILPClient( AsyncILPClient&& ) = delete;
+    AsyncILPClient& operator=( AsyncILPClient&& ) = delete;
+
+    /**
+     * Queue data to send over ILP.  Never blocks, and is safe to invoke from any thread.
+     * @param ilp The ILP lines to send.  Must end with a newline.
+     */
+    void write( std::string&& ilp );
+
+    /**
+     * Queue a copy of the data to send over ILP.  Allows callers to reuse the buffer they serialise into.
+     * Never blocks, and is safe to invoke from any thread.
+     * @param ilp The ILP lines to send.  Must end with a newline.
+     */
+    void write( std::string_view ilp );
+
+    /**
+     * Wait for all buffered data to be sent or dropped.  Blocks until the buffer drains, without polling.
+     * @param timeout The maximum duration to wait.
+     * @return `true` if all buffered data was sent before the timeout.
+     */
+    bool flush( std::chrono::milliseconds timeout );
+
+    /**
+     * @return A snapshot of the counters maintained by the client.
+     */
+    [[nodiscard]] Stats stats() const;
+
+  private:
+    void enqueue( std::string&& data );
+    void connect();
+    void reconnect();
+    void send();
+    void close();
+    void release( std::size_t size );
+
+    boost::asio::strand<boost::asio::io_context::executor_type> strand;
+    boost::asio::ip::tcp::socket s;
+    boost::asio::ip::tcp::resolver resolver;
+    boost::asio::steady_timer timer;
+    std::deque<std::string> pending;
+    std::vector<std::string> inflight;
+    std::string host;
+    std::string port;
+    Options options;
+    std::chrono::milliseconds backoff;
+    std::chrono::time_point<std::chrono::steady_clock> last{ std::chrono::steady_clock::now() };
+    std::size_t pendingBytes{ 0 };
+    bool connected{ false };
+    bool connecting{ false };
+    bool writing{ false };
+
+    std::atomic<uint64_t> bytesSent{ 0 };
+    std::atomic<uint64_t> batchesSent{ 0 };
+    std::atomic<uint64_t> bytesDropped{ 0 };
+    std::atomic<uint64_t> batchesDropped{ 0 };
+    std::atomic<uint64_t> connects{ 0 };
+    std::atomic<uint64_t> errors{ 0 };
+    std::atomic<uint64_t> buffered{ 0 };
+
+    // Signalled from the strand when `buffered` drops to zero.
+    std::mutex mutex;
+    std::condition_variable drained;
+  };
+}
@@ -5,7 +5,8 @@
 #include "builder.hpp"
 #include "../common/util/date.hpp"
 
-#include <format>
+#include <array>
+#include <charconv>
 #include <range/v3/algorithm/for_each.hpp>
 
 using spt::ilp::Builder;
@@ -18,57 +19,38 @@ namespace
   {
     using std::operator ""sv;
 
-    std::string clean( std::string_view view, bool space = false )
+    // Bit 1 - escaped in field and tag values, bit 2 - escaped only in tag values
+    constexpr auto escapes = []
     {
-      std::string value{};
-      value.reserve( view.size() + 16 );
+      auto table = std::array<uint8_t, 256>{};
+      for ( const auto c : { ',', '"', '=', '\n', '\r', '\\' } ) table[static_cast<uint8_t>( c )] = 1;
+      table[static_cast<uint8_t>( ' ' )] = 2;
+      return table;
+    }();
+
+    void clean( std::string& out, std::string_view view, bool space = false )
+    {
+      const uint8_t mask = space ? 3 : 1;
+      std::size_t start = 0;
 
       for ( std::size_t i = 0; i < view.size(); ++i )
       {
-        switch ( view[i] )
-        {
-        case ',':
-        {
-          value.append( "\\," );
-          break;
-        }
-        case '"':
-        {
-          value.append( "\\\"" );
-          break;
-        }
-        case '=':
-        {
-          value.append( "\\=" );
-          break;
-        }
-        case '\n':
-        {
-          value.append( "\\\n" );
-          break;
-        }
-        case '\r':
-        {
-          value.append( "\\\r" );
-          break;
-        }
-        case '\\':
-        {
-          value.append( 2, '\\' );
-          break;
-        }
-        case ' ':
-        {
-          if ( space ) value.append( "\\ " );
-          else value.append( 1, view[i] );
-          break;
-        }
-        default:
-          value.append( 1, view[i] );
-        }
+        if ( ( escapes[static_cast<uint8_t>( view[i] )] & mask ) == 0 ) [[likely]] continue;
+        out.append( view.data() + start, i - start );
+        out.push_back( '\\' );
+        out.push_back( view[i] );
+        start = i + 1;
       }
 
-      return value;
+      out.append( view.data() + start, view.size() - start );
+    }
+
+    template <typename T>
+    void number( std::string& out, T v )
+    {
+      std::array<char, 32> buf{};
+      const auto [ptr, ec] = std::to_chars( buf.data(), buf.data() + buf.size(), v );
+      out.append( buf.data(), ptr );
     }
 
     std::string_view typeName( spt::ilp::APMRecord::Process::Type type )
@@ -84,6 +66,60 @@ namespace
       }
     }
 
+    struct Location
+    {
+      std::string_view key;
+      std::variant<std::string_view, uint64_t> value;
+    };
+
+    // Values generated from source locations, in the same (lexicographic) order as the values map
+    std::size_t locations( std::array<Location, 6>& out, const std::optional<std::source_location>& caller,
+      const std::optional<std::source_location>& location )
+    {
+      std::size_t n = 0;
+      const auto add = [&out, &n]( const std::source_location& loc, std::string_view file, std::string_view function, std::string_view line )
+      {
+        out[n++] = Location{ file, std::string_view{ loc.file_name() } };
+        if ( auto fn = std::string_view{ loc.function_name() }; !fn.empty() ) out[n++] = Location{ function, fn };
+        out[n++] = Location{ line, static_cast<uint64_t>( loc.line() ) };
+      };
+
+      if ( caller ) add( *caller, "caller_file"sv, "caller_function"sv, "caller_line"sv );
+      if ( location ) add( *location, "file"sv, "function"sv, "line"sv );
+      return n;
+    }
+
+    void addValues( Builder& builder, const spt::ilp::APMRecord::ValueMap& values,
+      const std::optional<std::source_location>& caller, const std::optional<std::source_location>& location )
+    {
+      auto extra = std::array<Location, 6>{};
+      const auto count = locations( extra, caller, location );
+      std::size_t i = 0;
+
+      const auto addLocation = [&builder]( const Location& l )
+      {
+        std::visit( [&builder, &l]( auto v ){ builder.addValue( l.key, v ); }, l.value );
+      };
+
+      for ( const auto& [key, value] : values )
+      {
+        while ( i < count && extra[i].key < std::string_view{ key } ) addLocation( extra[i++] );
+        // Values explicitly set in the map take precedence over those generated from source locations
+        if ( i < count && extra[i].key == std::string_view{ key } ) ++i;
+
+        std::visit( overload
+          {
+            [&builder, &key]( bool v ){ builder.addValue( key, v ); },
+            [&builder, &key]( int64_t v ){ builder.addValue( key, v ); },
+            [&builder, &key]( uint64_t v ){ builder.addValue( key, v ); },
+            [&builder, &key]( double v ){ builder.addValue( key, v ); },
+            [&builder, &key]( const std::string& v ){ builder.addValue( key, v ); },
+          }, value );
+      }
+
+      for ( ; i < count; ++i ) addLocation( extra[i] );
+    }
+
     void addAPM( Builder& builder, const spt::ilp::APMRecord& apm )
     {
       auto end = spt::ilp::APMRecord::DateTime{ apm.timestamp + apm.duration };
@@ -95,17 +131,7 @@ namespace
         timestamp( std::chrono::duration_cast<std::chrono::nanoseconds>( apm.timestamp.time_since_epoch() ) );
 
       ranges::for_each( apm.tags, [&builder]( const auto& tag ) { builder.addTag( tag.first, tag.second ); } );
-      ranges::for_each( apm.values, [&builder]( const auto& pair )
-      {
-        std::visit( overload
-          {
-            [&builder, &pair]( bool v ){ builder.addValue( pair.first, v ); },
-            [&builder, &pair]( int64_t v ){ builder.addValue( pair.first, v ); },
-            [&builder, &pair]( uint64_t v ){ builder.addValue( pair.first, v ); },
-            [&builder, &pair]( double v ){ builder.addValue( pair.first, v ); },
-            [&builder, &pair]( const std::string& v ){ builder.addValue( pair.first, v ); },
-          }, pair.second );
-      } );
+      addValues( builder, apm.values, apm.caller, std::nullopt );
     }
 
     void addProcess( Builder& builder, const spt::ilp::APMRecord::Process& process )
@@ -118,111 +144,116 @@ namespace
         timestamp( std::chrono::duration_cast<std::chrono::nanoseconds>( process.timestamp.time_since_epoch() ) );
 
       ranges::for_each( process.tags, [&builder]( const auto& tag ) { builder.addTag( tag.first, tag.second ); } );
-      ranges::for_each( process.values, [&builder]( const auto& pair )
-      {
-        std::visit( overload
-          {
-            [&builder, &pair]( bool v ){ builder.addValue( pair.first, v ); },
-            [&builder, &pair]( int64_t v ){ builder.addValue( pair.first, v ); },
-            [&builder, &pair]( uint64_t v ){ builder.addValue( pair.first, v ); },
-            [&builder, &pair]( double v ){ builder.addValue( pair.first, v ); },
-            [&builder, &pair]( const std::string& v ){ builder.addValue( pair.first, v ); },
-          }, pair.second );
-      } );
+      addValues( builder, process.values, process.caller, process.location );
     }
   }
 }
 
+Builder::Builder( std::string&& buffer ) : value{ std::move( buffer ) }
+{
+  value.clear();
+}
+
 Builder& Builder::startRecord( std::string_view name )
 {
-  record = Record{ name };
+  fields.clear();
+  ts = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::system_clock::now().time_since_epoch() );
+  value.append( name );
   return *this;
 }
 
 Builder& Builder::addTag( std::string_view key, std::string_view v )
 {
-  if ( !record->tags.empty() ) record->tags.append( "," );
-  record->tags.append( std::format( "{}={}", key, pbuilder::clean( v, true ) ) );
+  value.push_back( ',' );
+  value.append( key );
+  value.push_back( '=' );
+  pbuilder::clean( value, v, true );
   return *this;
 }
 
 Builder& Builder::addValue( std::string_view key, bool v )
 {
-  if ( !record->value.empty() ) record->value.append( "," );
-  record->value.append( std::format( "{}={}", key, v ) );
-
+  field( key );
+  fields.append( v ? "true" : "false" );
   return *this;
 }
 
 Builder& Builder::addValue( std::string_view key, int32_t v )
 {
-  if ( !record->value.empty() ) record->value.append( "," );
-  record->value.append( std::format( "{}={}i", key, v ) );
+  field( key );
+  pbuilder::number( fields, v );
+  fields.push_back( 'i' );
   return *this;
 }
 
 Builder& Builder::addValue( std::string_view key, uint32_t v )
 {
-  if ( !record->value.empty() ) record->value.append( "," );
-  record->value.append( std::format( "{}={}u", key, v ) );
+  field( key );
+  pbuilder::number( fields, v );
+  fields.push_back( 'u' );
   return *this;
 }
 
 Builder& Builder::addValue( std::string_view key, int64_t v )
 {
-  if ( !record->value.empty() ) record->value.append( "," );
-  record->value.append( std::format( "{}={}i", key, v ) );
+  field( key );
+  pbuilder::number( fields, v );
+  fields.push_back( 'i' );
   return *this;
 }
 
 Builder& Builder::addValue( std::string_view key, uint64_t v )
 {
-  if ( !record->value.empty() ) record->value.append( "," );
-  record->value.append( std::format( "{}={}u", key, v ) );
+  field( key );
+  pbuilder::number( fields, v );
+  fields.push_back( 'u' );
   return *this;
 }
 
 Builder& Builder::addValue( std::string_view key, float v )
 {
-  if ( !record->value.empty() ) record->value.append( "," );
-  record->value.append( std::format( "{}={}", key, v ) );
-
+  field( key );
+  pbuilder::number( fields, v );
   return *this;
 }
 
 Builder& Builder::addValue( std::string_view key, double v )
 {
-  if ( !record->value.empty() ) record->value.append( "," );
-  record->value.append( std::format( "{}={}", key, v ) );
-
+  field( key );
+  pbuilder::number( fields, v );
   return *this;
 }
 
 Builder& Builder::addValue( std::string_view key, std::string_view v )
 {
-  if ( !record->value.empty() ) record->value.append( "," );
-  record->value.append( std::format( "{}=\"{}\"", key, pbuilder::clean( v, false ) ) );
+  field( key );
+  fields.push_back( '"' );
+  pbuilder::clean( fields, v, false );
+  fields.push_back( '"' );
   return *this;
 }
 
 Builder& Builder::addValue( std::string_view key, util::DateTime v )
 {
-  if ( !record->value.empty() ) record->value.append( "," );
-  record->value.append( std::format( "{}={}t", key, std::chrono::duration_cast<std::chrono::microseconds>( v.time_since_epoch() ).count() ) );
+  field( key );
+  pbuilder::number( fields, std::chrono::duration_cast<std::chrono::microseconds>( v.time_since_epoch() ).count() );
+  fields.push_back( 't' );
   return *this;
 }
 
 Builder& Builder::addValue( std::string_view key, util::DateTimeMs v )
 {
-  if ( !record->value.empty() ) record->value.append( "," );
-  record->value.append( std::format( "{}={}t", key, std::chrono::duration_cast<std::chrono::microseconds>( v.time_since_epoch() ).count() ) );
+  field( key );
+  pbuilder::number( fields, std::chrono::duration_cast<std::chrono::microseconds>( v.time_since_epoch() ).count() );
+  fields.push_back( 't' );
   return *this;
 }
 
 Builder& Builder::addValue( std::string_view key, util::DateTimeNs v )
 {
-  if ( !record->value.empty() ) record->value.append( "," );
-  record->value.append( std::format( "{}={}t", key, std::chrono::duration_cast<std::chrono::microseconds>( v.time_since_epoch() ).count() ) );
+  field( key );
+  pbuilder::number( fields, std::chrono::duration_cast<std::chrono::microseconds>( v.time_since_epoch() ).count() );
+  fields.push_back( 't' );
   return *this;
 }
 
@@ -248,14 +279,17 @@ Builder& Builder::add( std::string_view name, const APMRecord& apm )
 
 Builder& Builder::timestamp( std::chrono::nanoseconds v )
 {
-  record->timestamp = v;
+  ts = v;
   return *this;
 }
 
 Builder& Builder::endRecord()
 {
-  value.reserve( 128 );
-  value.append( std::format( "{},{} {} {}\n", record->name, record->tags, record->value, record->timestamp.count() ) );
+  value.push_back( ' ' );
+  value.append( fields );
+  value.push_back( ' ' );
+  pbuilder::number( value, ts.count() );
+  value.push_back( '\n' );
   return *this;
 }
 
@@ -263,3 +297,16 @@ std::string Builder::finish()
 {
   return std::move( value );
 }
+
+void Builder::clear()
+{
+  value.clear();
+  fields.clear();
+}
+
+void Builder::field( std::string_view key )
+{
+  if ( !fields.empty() ) fields.push_back( ',' );
+  fields.append( key );
+  fields.push_back( '=' );
+}
@@ -7,18 +7,27 @@
 #include "apmrecord.hpp"
 
 #include <chrono>
-#include <optional>
 #include <string>
 #include <string_view>
 
 namespace spt::ilp
 {
   /**
-   * Builder for composing a batch of records to transmit over ILP to a TSDB.
+   * Builder for composing a batch of records to transmit over ILP to a TSDB.  Records are serialised
+   * directly into a single growable buffer.  The buffer may be reused across batches via `clear`, or by
+   * constructing a builder with a buffer returned from a previous `finish`.
    */
   struct Builder
   {
     Builder() = default;
+
+    /**
+     * Create a builder that reuses the specified buffer.  Any existing content is cleared, but the
+     * capacity of the buffer is retained.
+     * @param buffer A buffer (typically returned by a previous `finish`) to serialise records into.
+     */
+    explicit Builder( std::string&& buffer );
+
     ~Builder() = default;
 
     Builder(Builder&&) = delete;
@@ -159,31 +168,35 @@ namespace spt::ilp
     Builder& add( std::string_view name, const APMRecord& record );
 
     /**
-     * Generate the message with lines representing the records in this batch.  The builder should not be reused.
+     * Generate the message with lines representing the records in this batch.  The buffer is moved out
+     * of the builder, and the builder should not be reused unless `clear` is invoked.
      * @return The string which contains lines for each record that was included in this batch.
      */
     [[nodiscard]] std::string finish();
 
-  private:
-    struct Record
-    {
-      explicit Record( std::string_view name ) : name{ name } {}
+    /**
+     * @return A view of the lines serialised so far.  Valid until the builder is modified.
+     */
+    [[nodiscard]] std::string_view view() const { return value; }
 
-      ~Record() = default;
-      Record(Record&&) = default;
-      Record& operator=(Record&&) = default;
+    /**
+     * @return The number of bytes serialised so far.
+     */
+    [[nodiscard]] std::size_t size() const { return value.size(); }
 
-      Record(const Record&) = delete;
-      Record& operator=(const Record&) = delete;
+    /**
+     * Discard all serialised records, retaining the allocated buffers for the next batch.
+     */
+    void clear();
 
-      std::string name;
-      std::string tags;
-      std::string value;
-      std::chrono::nanoseconds timestamp{ std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::system_clock::now().time_since_epoch() ) };
-    };
+  private:
+    void field( std::string_view key );
 
+    // Tags are written directly to value after the record name.  Fields may be interleaved with tags
+    // by callers, so they are staged in a reusable buffer until the record is ended.
     std::string value;
-    std::optional<Record> record{ std::nullopt };
+    std::string fields;
+    std::chrono::nanoseconds ts{ 0 };
   };
 }
 
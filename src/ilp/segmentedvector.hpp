@@ -0,0 +1,148 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace spt::ilp
+{
+  /**
+   * A sequence container that allocates storage in segments of geometrically increasing size
+   * (8, 16, 32, ...).  Unlike `std::vector`, references to elements remain valid as elements are
+   * appended, and unlike `std::deque`, no storage is allocated until the first element is added and
+   * no separate index (map) of blocks is allocated.  Element lookup by index is constant time.
+   *
+   * Only the operations required for building APM records are supported (append, index and iterate).
+   * @tparam T The type of element stored in the container.
+   */
+  template <typename T>
+  struct SegmentedVector
+  {
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    template <bool Const>
+    struct Iterator
+    {
+      using iterator_category = std::forward_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = T;
+      using pointer = std::conditional_t<Const, const T*, T*>;
+      using reference = std::conditional_t<Const, const T&, T&>;
+      using container = std::conditional_t<Const, const SegmentedVector, SegmentedVector>;
+
+      Iterator() = default;
+      Iterator( container* c, std::size_t index ) : c{ c }, index{ index } {}
+
+      reference operator*() const { return ( *c )[index]; }
+      pointer operator->() const { return &( *c )[index]; }
+      Iterator& operator++() { ++index; return *this; }
+      Iterator operator++( int ) { auto copy = *this; ++index; return copy; }
+      bool operator==( const Iterator& rhs ) const { return index == rhs.index; }
+
+    private:
+      container* c{ nullptr };
+      std::size_t index{ 0 };
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    SegmentedVector() = default;
+    ~SegmentedVector() { clear(); }
+
+    SegmentedVector( SegmentedVector&& rhs ) noexcept :
+      segments{ std::exchange( rhs.segments, {} ) }, count{ std::exchange( rhs.count, 0 ) } {}
+
+    SegmentedVector& operator=( SegmentedVector&& rhs ) noexcept
+    {
+      if ( this == &rhs ) return *this;
+      clear();
+      segments = std::exchange( rhs.segments, {} );
+      count = std::exchange( rhs.count, 0 );
+      return *this;
+    }
+
+    SegmentedVector( const SegmentedVector& ) = delete;
+    SegmentedVector& operator=( const SegmentedVector& ) = delete;
+
+    /**
+     * Construct a new element at the end of the container.  References to existing elements are not invalidated.
+     * @param args The arguments to forward to the constructor of the element.
+     * @return Reference to the newly constructed element.
+     */
+    template <typename... Args>
+    T& emplace_back( Args&&... args )
+    {
+      const auto [segment, offset] = locate( count );
+      if ( segments[segment] == nullptr ) segments[segment] = std::allocator<T>{}.allocate( capacity( segment ) );
+      auto* ptr = std::construct_at( segments[segment] + offset, std::forward<Args>( args )... );
+      ++count;
+      return *ptr;
+    }
+
+    /// Destroy all elements and release all storage.
+    void clear()
+    {
+      for ( std::size_t i = 0; i < count; ++i ) std::destroy_at( &( *this )[i] );
+      for ( std::size_t i = 0; i < segments.size(); ++i )
+      {
+        if ( segments[i] == nullptr ) break;
+        std::allocator<T>{}.deallocate( segments[i], capacity( i ) );
+        segments[i] = nullptr;
+      }
+      count = 0;
+    }
+
+    T& operator[]( std::size_t index )
+    {
+      const auto [segment, offset] = locate( index );
+      return segments[segment][offset];
+    }
+
+    const T& operator[]( std::size_t index ) const
+    {
+      const auto [segment, offset] = locate( index );
+      return segments[segment][offset];
+    }
+
+    T& front() { return ( *this )[0]; }
+    const T& front() const { return ( *this )[0]; }
+    T& back() { return ( *this )[count - 1]; }
+    const T& back() const { return ( *this )[count - 1]; }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    iterator begin() { return iterator{ this, 0 }; }
+    iterator end() { return iterator{ this, count }; }
+    const_iterator begin() const { return const_iterator{ this, 0 }; }
+    const_iterator end() const { return const_iterator{ this, count }; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+  private:
+    static constexpr std::size_t base = 8;
+
+    static constexpr std::size_t capacity( std::size_t segment ) { return base << segment; }
+
+    // Segment k holds base * 2^k elements, starting at index base * ( 2^k - 1 ).
+    static constexpr std::pair<std::size_t, std::size_t> locate( std::size_t index )
+    {
+      const auto segment = static_cast<std::size_t>( std::bit_width( index / base + 1 ) - 1 );
+      return { segment, index - base * ( ( std::size_t{ 1 } << segment ) - 1 ) };
+    }
+
+    std::array<T*, 48> segments{};
+    std::size_t count{ 0 };
+  };
+}
@@ -27,9 +27,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 */
 
 #include "NanoLog.hpp"
-#include "tee.hpp"
+#include "binary.hpp"
 #include "day.hpp"
+#include <algorithm>
 #include <atomic>
+#include <bit>
 #include <cstring>
 #include <chrono>
 #include <ctime>
@@ -38,11 +40,13 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include <iomanip>
 #include <iostream>
 #include <memory>
-#include <queue>
+#include <mutex>
 #include <sstream>
 #include <streambuf>
 #include <thread>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #ifdef WITH_BSON_SUPPORT
   #include <bsoncxx/json.hpp>
@@ -100,6 +104,45 @@ namespace nanolog
 {
   typedef std::tuple < char, uint32_t, uint64_t, int32_t, int64_t, double, NanoLogLine::string_literal_t, char * > SupportedTypes;
 
+  static_assert(TupleIndex < NanoLogLine::string_literal_t, SupportedTypes >::value == static_cast<size_t>(binary::Type::Literal));
+  static_assert(TupleIndex < char *, SupportedTypes >::value == static_cast<size_t>(binary::Type::String));
+  static_assert(sizeof(std::thread::id) <= sizeof(uint64_t));
+
+  /*
+   * Maps string literals (by address) to the ids written to binary log files.  The string is written
+   * to definitions the first time it is interned.  Only accessed by the writer thread.
+   */
+  struct StringTable
+  {
+    uint32_t intern(char const * s)
+    {
+      if (s == nullptr) return 0;
+
+      auto [iter, inserted] = m_ids.try_emplace(s, static_cast<uint32_t>(m_ids.size() + 1));
+      if (inserted)
+      {
+        auto const length = static_cast<uint32_t>(strlen(s)); // flawfinder: ignore
+        definitions.push_back(binary::string);
+        definitions.append(reinterpret_cast<char const *>(&iter->second), sizeof(uint32_t));
+        definitions.append(reinterpret_cast<char const *>(&length), sizeof(uint32_t));
+        definitions.append(s, length);
+      }
+      return iter->second;
+    }
+
+    void clear()
+    {
+      m_ids.clear();
+      definitions.clear();
+    }
+
+    // String records not yet written to the file
+    std::string definitions;
+
+  private:
+    std::unordered_map < char const *, uint32_t > m_ids;
+  };
+
   char const * to_string(LogLevel loglevel)
   {
     switch (loglevel)
@@ -233,6 +276,67 @@ namespace nanolog
     }
   }
 
+  namespace
+  {
+    template < typename Arg >
+    void append(std::string & out, Arg arg)
+    {
+      out.append(reinterpret_cast<char const *>(&arg), sizeof(Arg));
+    }
+  }
+
+  void NanoLogLine::serialise(std::string & out, StringTable & table)
+  {
+    constexpr size_t sizes[] = { sizeof(char), sizeof(uint32_t), sizeof(uint64_t), sizeof(int32_t), sizeof(int64_t), sizeof(double) };
+
+    char * b = !m_heap_buffer ? m_stack_buffer : m_heap_buffer.get();
+    char const * const end = b + m_bytes_used;
+    uint64_t timestamp = *reinterpret_cast < uint64_t * >(b); b += sizeof(uint64_t);
+    uint64_t thread = 0;
+    memcpy(&thread, b, sizeof(std::thread::id)); b += sizeof(std::thread::id); // flawfinder: ignore
+    string_literal_t file = *reinterpret_cast < string_literal_t * >(b); b += sizeof(string_literal_t);
+    string_literal_t function = *reinterpret_cast < string_literal_t * >(b); b += sizeof(string_literal_t);
+    uint32_t line = *reinterpret_cast < uint32_t * >(b); b += sizeof(uint32_t);
+    LogLevel loglevel = *reinterpret_cast < LogLevel * >(b); b += sizeof(LogLevel);
+
+    out.push_back(binary::line);
+    auto const length_at = out.size();
+    append < uint32_t >(out, 0);
+    append(out, timestamp);
+    append(out, thread);
+    append(out, table.intern(file.m_s));
+    append(out, table.intern(function.m_s));
+    append(out, line);
+    append(out, static_cast<uint8_t>(loglevel));
+
+    while (b < end)
+    {
+      auto const type = static_cast<binary::Type>(*b);
+      out.push_back(*b++);
+
+      switch (type)
+      {
+      case binary::Type::Literal:
+        append(out, table.intern(reinterpret_cast < string_literal_t * >(b)->m_s));
+        b += sizeof(string_literal_t);
+        break;
+      case binary::Type::String:
+      {
+        auto const length = strlen(b) + 1; // flawfinder: ignore
+        out.append(b, length);
+        b += length;
+        break;
+      }
+      default:
+        out.append(b, sizes[static_cast<size_t>(type)]);
+        b += sizes[static_cast<size_t>(type)];
+      }
+    }
+
+    auto const length = static_cast<uint32_t>(out.size() - length_at - sizeof(uint32_t));
+    memcpy(out.data() + length_at, &length, sizeof(uint32_t)); // flawfinder: ignore
+  }
+
   char * NanoLogLine::buffer()
   {
     return !m_heap_buffer ? &m_stack_buffer[m_bytes_used] : &(m_heap_buffer.get())[m_bytes_used];
@@ -418,262 +522,161 @@ namespace nanolog
   }
 #endif
 
-  struct BufferBase
-  {
-    virtual ~BufferBase() = default;
-    virtual void push(NanoLogLine && logline) = 0;
-    virtual bool try_pop(NanoLogLine & logline) = 0;
-  };
-
-  struct SpinLock
-  {
-    explicit SpinLock(std::atomic_flag & flag) : m_flag(flag)
-    {
-      while (m_flag.test_and_set(std::memory_order_acquire));
-    }
-
-    ~SpinLock()
-    {
-      m_flag.clear(std::memory_order_release);
-    }
-
-  private:
-    std::atomic_flag & m_flag;
-  };
-
-  /* Multi Producer Single Consumer Ring Buffer */
-  class RingBuffer : public BufferBase
+  /*
+   * Single Producer Single Consumer ring buffer used to stage log lines.  Each thread that logs
+   * owns one of these, so producers never contend with each other.  The writer thread drains all
+   * registered staging buffers.
+   */
+  class StagingBuffer
   {
   public:
-    struct alignas(64) Item
+    explicit StagingBuffer(size_t const size)
+        : m_size(std::bit_ceil(std::max(size, static_cast<size_t>(2))))
+        , m_mask(m_size - 1)
     {
-      Item()
-          : flag ATOMIC_FLAG_INIT
-          , written(0)
-          , logline(LogLevel::INFO, nullptr, nullptr, 0)
-      {
-      }
+      m_ring.reserve(m_size);
+      for (size_t i = 0; i < m_size; ++i) m_ring.emplace_back(LogLevel::INFO, nullptr, nullptr, 0);
+    }
 
-      std::atomic_flag flag;
-      char written;
-      char padding[256 - sizeof(std::atomic_flag) - sizeof(char) - sizeof(NanoLogLine)]; // flawfinder: ignore
-      NanoLogLine logline;
-    };
+    StagingBuffer(StagingBuffer const &) = delete;
+    StagingBuffer& operator=(StagingBuffer const &) = delete;
 
-    explicit RingBuffer(size_t const size)
-        : m_size(size)
-        , m_ring(static_cast<Item*>(std::malloc(size * sizeof(Item))))
-        , m_write_index(0)
-        , m_read_index(0)
+    // Returns false without consuming the log line if the buffer is full
+    bool try_push(NanoLogLine && logline)
     {
-      for (size_t i = 0; i < m_size; ++i)
+      size_t const tail = m_tail.load(std::memory_order_relaxed);
+      if (tail - m_cached_head == m_size)
       {
-        new (&m_ring[i]) Item();
+        m_cached_head = m_head.load(std::memory_order_acquire);
+        if (tail - m_cached_head == m_size) return false;
       }
-      static_assert(sizeof(Item) == 256, "Unexpected size != 256");
-    }
 
-    ~RingBuffer() override
-    {
-      for (size_t i = 0; i < m_size; ++i)
-      {
-        m_ring[i].~Item();
-      }
-      std::free(m_ring);
+      m_ring[tail & m_mask] = std::move(logline);
+      m_tail.store(tail + 1, std::memory_order_release);
+      return true;
     }
 
-    void push(NanoLogLine && logline) override
+    // Invoke the callback with each staged log line, and release the slots.  Only invoked by the writer thread.
+    template < typename Callback >
+    size_t consume(Callback && callback)
     {
-      unsigned int write_index = m_write_index.fetch_add(1, std::memory_order_relaxed) % m_size;
-      Item & item = m_ring[write_index];
-      SpinLock spinlock(item.flag);
-      item.logline = std::move(logline);
-      item.written = 1;
+      size_t const head = m_head.load(std::memory_order_relaxed);
+      size_t const tail = m_tail.load(std::memory_order_acquire);
+      for (size_t i = head; i != tail; ++i) callback(m_ring[i & m_mask]);
+      m_head.store(tail, std::memory_order_release);
+      return tail - head;
     }
 
-    bool try_pop(NanoLogLine & logline) override
-    {
-      Item & item = m_ring[m_read_index % m_size];
-      SpinLock spinlock(item.flag);
-      if (item.written == 1)
-      {
-        logline = std::move(item.logline);
-        item.written = 0;
-        ++m_read_index;
-        return true;
-      }
-      return false;
-    }
+    // Invoked when the owning thread exits.  The writer removes the buffer once drained.
+    void retire() { m_retired.store(true, std::memory_order_release); }
+    bool retired() const { return m_retired.load(std::memory_order_acquire); }
 
-    RingBuffer(RingBuffer const &) = delete;
-    RingBuffer& operator=(RingBuffer const &) = delete;
+    // Only accurate on the writer thread.  Once retired, no further lines are pushed.
+    bool empty() const { return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire); }
 
   private:
     size_t const m_size;
-    Item * m_ring;
-    std::atomic < unsigned int > m_write_index;
-    unsigned int m_read_index;
+    size_t const m_mask;
+    std::vector < NanoLogLine > m_ring;
+    alignas(64) std::atomic < size_t > m_tail{0};
+    size_t m_cached_head{0};
+    alignas(64) std::atomic < size_t > m_head{0};
+    std::atomic < bool > m_retired{false};
   };
 
-
-  class Buffer
+  /* Stream buffer that appends to a string which retains its capacity between batches */
+  class StringBuffer : public std::streambuf
   {
   public:
-    struct Item
-    {
-      Item(NanoLogLine && nanologline) : logline(std::move(nanologline)) {}
-      char padding[256 - sizeof(NanoLogLine)]; // flawfinder: ignore
-      NanoLogLine logline;
-    };
-
-    static constexpr const size_t size = 32768; // 8MB. Helps reduce memory fragmentation
+    std::string & str() { return m_value; }
 
-    Buffer() : m_buffer(static_cast<Item*>(std::malloc(size * sizeof(Item))))
+  protected:
+    int overflow(int c) override
     {
-      for (size_t i = 0; i <= size; ++i)
-      {
-        m_write_state[i].store(0, std::memory_order_relaxed);
-      }
-      static_assert(sizeof(Item) == 256, "Unexpected size != 256");
+      if (c != EOF) m_value.push_back(static_cast<char>(c));
+      return c;
     }
 
-    ~Buffer()
+    std::streamsize xsputn(char const * s, std::streamsize n) override
     {
-      unsigned int write_count = m_write_state[size].load();
-      for (size_t i = 0; i < write_count; ++i)
-      {
-        m_buffer[i].~Item();
-      }
-      std::free(m_buffer);
+      m_value.append(s, static_cast<size_t>(n));
+      return n;
     }
 
-    // Returns true if we need to switch to next buffer
-    bool push(NanoLogLine && logline, unsigned int const write_index)
-    {
-      new (&m_buffer[write_index]) Item(std::move(logline));
-      m_write_state[write_index].store(1, std::memory_order_release);
-      return m_write_state[size].fetch_add(1, std::memory_order_acquire) + 1 == size;
-    }
-
-    bool try_pop(NanoLogLine & logline, unsigned int const read_index)
-    {
-      if (m_write_state[read_index].load(std::memory_order_acquire))
-      {
-        Item & item = m_buffer[read_index];
-        logline = std::move(item.logline);
-        return true;
-      }
-      return false;
-    }
-
-    Buffer(Buffer const &) = delete;
-    Buffer& operator=(Buffer const &) = delete;
-
   private:
-    Item * m_buffer;
-    std::atomic < unsigned int > m_write_state[size + 1];
+    std::string m_value;
   };
 
-  class QueueBuffer : public BufferBase
+
+  class FileWriter
   {
   public:
-    QueueBuffer(QueueBuffer const &) = delete;
-    QueueBuffer& operator=(QueueBuffer const &) = delete;
-
-    QueueBuffer() : m_current_read_buffer{nullptr}
-        , m_write_index(0)
-        , m_flag ATOMIC_FLAG_INIT
-        , m_read_index(0)
+    FileWriter(std::string const & log_directory, std::string const & log_file_name, bool echo, LogFormat format)
+        : m_name(log_directory + log_file_name), m_stream(&m_buffer), echo(echo), binary_format(format == LogFormat::BINARY)
     {
-      setup_next_write_buffer();
+      m_buffer.str().reserve(batch_size * 2);
+      if (binary_format) m_records.reserve(batch_size * 2);
+      roll_file();
     }
 
-    void push(NanoLogLine && logline) override
+    /*
+     * Format the log line into the current batch.  The batch is written when full or when flush is invoked.
+     * Binary files receive the serialised line, preceded by any new string table entries.  The text form
+     * is only generated in binary mode if echoing to the console.
+     */
+    void write(NanoLogLine & logline)
     {
-      unsigned int write_index = m_write_index.fetch_add(1, std::memory_order_relaxed);
-      if (write_index < Buffer::size)
-      {
-        if (m_current_write_buffer.load(std::memory_order_acquire)->push(std::move(logline), write_index))
-        {
-          setup_next_write_buffer();
-        }
-      }
-      else
+      if (binary_format)
       {
-        while (m_write_index.load(std::memory_order_acquire) >= Buffer::size);
-        push(std::move(logline));
+        m_line.clear();
+        logline.serialise(m_line, m_table);
+        m_records.append(m_table.definitions);
+        m_table.definitions.clear();
+        m_records.append(m_line);
+        if (echo) logline.stringify(m_stream);
+        if (m_records.size() >= batch_size || m_buffer.str().size() >= batch_size) flush();
+        return;
       }
+
+      logline.stringify(m_stream);
+      if (m_buffer.str().size() >= batch_size) flush();
     }
 
-    bool try_pop(NanoLogLine & logline) override
+    // Write the current batch with a single write to the file (and console if echoing).
+    void flush()
     {
-      if (m_current_read_buffer == nullptr)
-        m_current_read_buffer = get_next_read_buffer();
-
-      Buffer * read_buffer = m_current_read_buffer;
-
-      if (read_buffer == nullptr)
-        return false;
-
-      if (read_buffer->try_pop(logline, m_read_index))
+      auto & value = m_buffer.str();
+      auto & file = binary_format ? m_records : value;
+      if (!file.empty())
       {
-        m_read_index++;
-        if (m_read_index == Buffer::size)
-        {
-          m_read_index = 0;
-          m_current_read_buffer = nullptr;
-          SpinLock spinlock(m_flag);
-          m_buffers.pop();
-        }
-        return true;
+        m_os->write(file.data(), static_cast<std::streamsize>(file.size()));
+        m_os->flush();
       }
 
-      return false;
-    }
-
-  private:
-    void setup_next_write_buffer()
-    {
-      std::unique_ptr < Buffer > next_write_buffer(new Buffer());
-      m_current_write_buffer.store(next_write_buffer.get(), std::memory_order_release);
-      SpinLock spinlock(m_flag);
-      m_buffers.push(std::move(next_write_buffer));
-      m_write_index.store(0, std::memory_order_relaxed);
-    }
+      if (echo && !value.empty())
+      {
+        std::cout.write(value.data(), static_cast<std::streamsize>(value.size()));
+        std::cout.flush();
+      }
 
-    Buffer * get_next_read_buffer()
-    {
-      SpinLock spinlock(m_flag);
-      return m_buffers.empty() ? nullptr : m_buffers.front().get();
+      value.clear();
+      m_records.clear();
     }
 
-  private:
-    std::queue < std::unique_ptr < Buffer > > m_buffers;
-    std::atomic < Buffer * > m_current_write_buffer;
-    Buffer * m_current_read_buffer;
-    std::atomic < unsigned int > m_write_index;
-    std::atomic_flag m_flag;
-    unsigned int m_read_index;
-  };
-
-
-  class FileWriter
-  {
-  public:
-    FileWriter(std::string const & log_directory, std::string const & log_file_name, bool echo)
-        : m_name(log_directory + log_file_name), echo(echo)
+    /*
+     * Roll to a new file if the day has changed since the current file was opened.  Invoked between
+     * batches, since binary batches reference the string table of the file they were serialised for.
+     */
+    void roll_if_needed()
     {
+      if (day == Day()) return;
+      flush();
       roll_file();
     }
 
-    void write(NanoLogLine & logline)
-    {
-      if (day != Day()) roll_file();
-      if (echo) logline.stringify(*tee);
-      else logline.stringify(*m_os);
-    }
-
   private:
+    static constexpr size_t batch_size = 64 * 1024;
+
     void roll_file()
     {
       if (m_os)
@@ -685,36 +688,68 @@ namespace nanolog
       day = Day();
       m_os = std::make_unique<std::ofstream>();
       std::ostringstream ss;
-      ss << m_name << "-" << day << ".log";
-      m_os->open(ss.str(), std::ofstream::out | std::ofstream::app); // flawfinder: ignore
-      if (echo) tee = std::make_unique<spt::log::teestream>(std::cout, *m_os);
+      ss << m_name << "-" << day << (binary_format ? ".nlb" : ".log");
+      m_os->open(ss.str(), std::ofstream::out | std::ofstream::app | (binary_format ? std::ofstream::binary : std::ofstream::openmode{})); // flawfinder: ignore
+      if (!binary_format) return;
+
+      // Existing files for the day are appended to, so string ids are scoped to each header.
+      m_table.clear();
+      m_os->put(binary::header);
+      m_os->write(binary::magic, sizeof(binary::magic));
+      m_os->put(static_cast<char>(binary::version));
+      m_os->put(std::endian::native == std::endian::little ? 1 : 0);
+      m_os->flush();
     }
 
   private:
     std::string const m_name;
     Day day;
     std::unique_ptr<std::ofstream> m_os;
-    std::unique_ptr<spt::log::teestream> tee;
+    StringBuffer m_buffer;
+    std::ostream m_stream;
+    StringTable m_table;
+    std::string m_records;
+    std::string m_line;
     bool echo;
+    bool binary_format;
   };
 
 
+  namespace
+  {
+    int64_t steady_seconds()
+    {
+      return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Intrusive list of call sites that have suppressed log lines.  Sites are static, and never removed.
+    std::atomic < LogSite * > log_sites{nullptr};
+  }
+
   class NanoLogger
   {
   public:
-    NanoLogger(NonGuaranteedLogger ngl, std::string const & log_directory, std::string const & log_file_name, bool echo)
+    /*
+     * Non guaranteed loggers split the configured buffer size between the hardware threads, and drop
+     * log lines when a thread's staging buffer is full.  Guaranteed loggers wait for the writer to
+     * drain the staging buffer instead.
+     */
+    NanoLogger(NonGuaranteedLogger ngl, std::string const & log_directory, std::string const & log_file_name, bool echo, LogFormat format)
         : m_state(State::INIT)
-        , m_buffer_base(new RingBuffer(std::max(1u, ngl.ring_buffer_size_mb) * 1024 * 4))
-        , m_file_writer(log_directory, log_file_name, echo)
+        , m_staging_size(std::max(static_cast<size_t>(256),
+            static_cast<size_t>(std::max(1u, ngl.ring_buffer_size_mb)) * 1024 * 4 / std::max(1u, std::thread::hardware_concurrency())))
+        , m_guaranteed(false)
+        , m_file_writer(log_directory, log_file_name, echo, format)
         , m_thread(&NanoLogger::pop, this)
     {
       m_state.store(State::READY, std::memory_order_release);
     }
 
-    NanoLogger(GuaranteedLogger, std::string const & log_directory, std::string const & log_file_name, bool echo)
+    NanoLogger(GuaranteedLogger, std::string const & log_directory, std::string const & log_file_name, bool echo, LogFormat format)
         : m_state(State::INIT)
-        , m_buffer_base(new QueueBuffer())
-        , m_file_writer(log_directory, log_file_name, echo)
+        , m_staging_size(4096)
+        , m_guaranteed(true)
+        , m_file_writer(log_directory, log_file_name, echo, format)
         , m_thread(&NanoLogger::pop, this)
     {
       m_state.store(State::READY, std::memory_order_release);
@@ -728,7 +763,16 @@ namespace nanolog
 
     void add(NanoLogLine && logline)
     {
-      m_buffer_base->push(std::move(logline));
+      auto & buffer = staging_buffer();
+      if (buffer.try_push(std::move(logline))) return;
+
+      if (!m_guaranteed)
+      {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+
+      while (!buffer.try_push(std::move(logline))) std::this_thread::yield();
     }
 
     void pop()
@@ -737,24 +781,113 @@ namespace nanolog
       while (m_state.load(std::memory_order_acquire) == State::INIT)
         std::this_thread::sleep_for(std::chrono::microseconds(50));
 
-      NanoLogLine logline(LogLevel::INFO, nullptr, nullptr, 0);
-
       while (m_state.load() == State::READY)
       {
-        if (m_buffer_base->try_pop(logline))
-          m_file_writer.write(logline);
-        else
-          std::this_thread::sleep_for(std::chrono::microseconds(50));
+        if (drain() == 0) std::this_thread::sleep_for(std::chrono::microseconds(50));
       }
 
       // Pop and log all remaining entries
-      while (m_buffer_base->try_pop(logline))
+      while (drain() > 0);
+      report_suppressed(true);
+      m_file_writer.flush();
+    }
+
+  private:
+    struct Producer
+    {
+      ~Producer()
+      {
+        if (buffer) buffer->retire();
+      }
+
+      std::shared_ptr < StagingBuffer > buffer;
+      uint64_t logger{0};
+    };
+
+    StagingBuffer & staging_buffer()
+    {
+      static thread_local Producer producer;
+      if (producer.logger == m_id) [[likely]] return *producer.buffer;
+
+      if (producer.buffer) producer.buffer->retire();
+      producer.buffer = std::make_shared<StagingBuffer>(m_staging_size);
+      producer.logger = m_id;
+
+      std::scoped_lock lock(m_mutex);
+      m_buffers.push_back(producer.buffer);
+      m_generation.fetch_add(1, std::memory_order_release);
+      return *producer.buffer;
+    }
+
+    size_t drain()
+    {
+      if (auto const generation = m_generation.load(std::memory_order_acquire); generation != m_drain_generation)
+      {
+        std::scoped_lock lock(m_mutex);
+        m_drain_buffers = m_buffers;
+        m_drain_generation = generation;
+      }
+
+      m_file_writer.roll_if_needed();
+
+      size_t count = 0;
+      bool remove = false;
+      for (auto & buffer : m_drain_buffers)
       {
+        bool const retired = buffer->retired();
+        count += buffer->consume([this](NanoLogLine & logline) { m_file_writer.write(logline); });
+        remove |= retired;
+      }
+
+      if (auto const dropped = m_dropped.load(std::memory_order_relaxed); dropped != m_reported)
+      {
+        NanoLogLine logline(LogLevel::WARN, __FILE__, __func__, __LINE__);
+        logline << "Dropped " << (dropped - m_reported) << " log lines due to full staging buffers";
         m_file_writer.write(logline);
+        m_reported = dropped;
+      }
+
+      if (auto const now = steady_seconds(); now - m_sites_reported >= 10)
+      {
+        report_suppressed(false);
+        m_sites_reported = now;
       }
+
+      m_file_writer.flush();
+      if (remove) remove_retired();
+      return count;
+    }
+
+    // Log the pending suppressed counts for sites that have not reported within the last 10 seconds,
+    // or for all sites when forced.
+    void report_suppressed(bool force)
+    {
+      auto const now = steady_seconds();
+      for (auto site = log_sites.load(std::memory_order_acquire); site != nullptr; site = site->m_next)
+      {
+        if (site->m_suppressed.load(std::memory_order_relaxed) == 0) continue;
+
+        auto reported = site->m_reported.load(std::memory_order_relaxed);
+        if (!force && (now - reported < 10 || !site->m_reported.compare_exchange_strong(reported, now, std::memory_order_relaxed))) continue;
+
+        if (auto const count = site->m_suppressed.exchange(0, std::memory_order_relaxed); count > 0)
+        {
+          NanoLogLine logline(site->m_level, site->m_file, site->m_function, site->m_line);
+          logline << "Suppressed " << count << " log lines";
+          m_file_writer.write(logline);
+        }
+      }
+    }
+
+    void remove_retired()
+    {
+      std::scoped_lock lock(m_mutex);
+      // A buffer may have been retired after it was drained in this pass
+      std::erase_if(m_buffers, [](auto const & buffer) { return buffer->retired() && buffer->empty(); });
+      m_drain_buffers = m_buffers;
+      m_drain_generation = m_generation.fetch_add(1, std::memory_order_acq_rel) + 1;
     }
 
-  private:
     enum class State
     {
       INIT,
@@ -762,8 +895,21 @@ namespace nanolog
       SHUTDOWN
     };
 
+    static inline std::atomic < uint64_t > next_id{0};
+
+    uint64_t const m_id{++next_id};
     std::atomic < State > m_state;
-    std::unique_ptr < BufferBase > m_buffer_base;
+    size_t const m_staging_size;
+    bool const m_guaranteed;
+    std::mutex m_mutex;
+    std::vector < std::shared_ptr < StagingBuffer > > m_buffers;
+    std::atomic < uint64_t > m_generation{0};
+    std::atomic < uint64_t > m_dropped{0};
+    // Only accessed by the writer thread
+    std::vector < std::shared_ptr < StagingBuffer > > m_drain_buffers;
+    uint64_t m_drain_generation{0};
+    uint64_t m_reported{0};
+    int64_t m_sites_reported{steady_seconds()};
     FileWriter m_file_writer;
     std::thread m_thread;
   };
@@ -777,18 +923,64 @@ namespace nanolog
     return true;
   }
 
-  void initialize(NonGuaranteedLogger ngl, std::string const & log_directory, std::string const & log_file_name, bool echo)
+  void initialize(NonGuaranteedLogger ngl, std::string const & log_directory, std::string const & log_file_name, bool echo, LogFormat format)
   {
-    nanologger = std::make_unique<NanoLogger>(ngl, log_directory, log_file_name, echo);
+    nanologger = std::make_unique<NanoLogger>(ngl, log_directory, log_file_name, echo, format);
     atomic_nanologger.store(nanologger.get(), std::memory_order_seq_cst);
   }
 
-  void initialize(GuaranteedLogger gl, std::string const & log_directory, std::string const & log_file_name, bool echo)
+  void initialize(GuaranteedLogger gl, std::string const & log_directory, std::string const & log_file_name, bool echo, LogFormat format)
   {
-    nanologger = std::make_unique<NanoLogger>(gl, log_directory, log_file_name, echo);
+    nanologger = std::make_unique<NanoLogger>(gl, log_directory, log_file_name, echo, format);
     atomic_nanologger.store(nanologger.get(), std::memory_order_seq_cst);
   }
 
+  bool LogSite::every_n(LogLevel level, uint32_t n, char const * file, char const * function, uint32_t line)
+  {
+    if (m_count.fetch_add(1, std::memory_order_relaxed) % std::max(n, 1u) != 0) return suppress(level, file, function, line);
+    return admit(level, file, function, line);
+  }
+
+  bool LogSite::rate(LogLevel level, uint32_t per_second, char const * file, char const * function, uint32_t line)
+  {
+    auto const now = steady_seconds();
+    auto window = m_window.load(std::memory_order_relaxed);
+    if (window != now && m_window.compare_exchange_strong(window, now, std::memory_order_relaxed))
+      m_count.store(0, std::memory_order_relaxed);
+
+    if (m_count.fetch_add(1, std::memory_order_relaxed) >= per_second) return suppress(level, file, function, line);
+    return admit(level, file, function, line);
+  }
+
+  bool LogSite::suppress(LogLevel level, char const * file, char const * function, uint32_t line)
+  {
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+    if (m_registered.load(std::memory_order_relaxed) || m_registered.exchange(true, std::memory_order_relaxed)) return false;
+
+    m_level = level;
+    m_file = file;
+    m_function = function;
+    m_line = line;
+    m_next = log_sites.load(std::memory_order_relaxed);
+    while (!log_sites.compare_exchange_weak(m_next, this, std::memory_order_release, std::memory_order_relaxed));
+    return false;
+  }
+
+  bool LogSite::admit(LogLevel level, char const * file, char const * function, uint32_t line)
+  {
+    if (m_suppressed.load(std::memory_order_relaxed) == 0) return true;
+
+    auto const now = steady_seconds();
+    auto reported = m_reported.load(std::memory_order_relaxed);
+    if (now - reported < 10 || !m_reported.compare_exchange_strong(reported, now, std::memory_order_relaxed)) return true;
+
+    if (auto const count = m_suppressed.exchange(0, std::memory_order_relaxed); count > 0)
+    {
+      NanoLog() == NanoLogLine(level, file, function, line) << "Suppressed " << count << " log lines";
+    }
+    return true;
+  }
+
   std::atomic < unsigned int > loglevel = {0};
 
   void set_log_level(LogLevel level)
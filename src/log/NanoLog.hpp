@@ -26,6 +26,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #ifndef NANO_LOG_HEADER_GUARD
 #define NANO_LOG_HEADER_GUARD
 
+#include <atomic>
 #include <cstdint>
 #include <chrono>
 #include <memory>
@@ -44,6 +45,14 @@ namespace nanolog
 {
   enum class LogLevel : uint8_t { DEBUG, INFO, WARN, CRIT };
 
+  /*
+   * Format in which log files are written.  BINARY files are written without formatting
+   * the log lines, and are rendered offline using the nanolog-decode utility.
+   */
+  enum class LogFormat : uint8_t { TEXT, BINARY };
+
+  struct StringTable;
+
   class NanoLogLine
   {
   public:
@@ -55,6 +64,12 @@ namespace nanolog
 
     void stringify(std::ostream & os);
 
+    /*
+     * Append the binary representation of this line to out.  String literals (including the file
+     * and function) are replaced with ids from the table.  See binary.hpp for the format.
+     */
+    void serialise(std::string & out, StringTable & table);
+
     NanoLogLine& operator<<(char arg);
     NanoLogLine& operator<<(int16_t arg);
     NanoLogLine& operator<<(uint16_t arg);
@@ -147,14 +162,49 @@ namespace nanolog
 
   bool is_logged(LogLevel level);
 
+  /*
+   * State for a sampled or rate limited log statement.  One instance exists per call site (see
+   * LOG_INFO_EVERY_N and LOG_WARN_RATE).  Arguments of suppressed lines are not evaluated.  Suppressed
+   * lines are counted, and the count is logged (at most once every 10 seconds) when a line is next
+   * admitted.  Sites are registered when a line is first suppressed, and the writer thread logs pending
+   * counts for sites that have not admitted a line recently, as well as all pending counts on shutdown.
+   */
+  class LogSite
+  {
+  public:
+    // Admit the first and every n-th line after that.
+    bool every_n(LogLevel level, uint32_t n, char const * file, char const * function, uint32_t line);
+
+    // Admit (approximately) up to per_second lines in each second.
+    bool rate(LogLevel level, uint32_t per_second, char const * file, char const * function, uint32_t line);
+
+  private:
+    friend class NanoLogger;
+
+    bool admit(LogLevel level, char const * file, char const * function, uint32_t line);
+    bool suppress(LogLevel level, char const * file, char const * function, uint32_t line);
+
+    std::atomic < uint64_t > m_count{0};
+    std::atomic < int64_t > m_window{0};
+    std::atomic < uint64_t > m_suppressed{0};
+    std::atomic < int64_t > m_reported{0};
+    std::atomic < bool > m_registered{false};
+    // Set once when registered, before the site is published to the writer thread
+    LogLevel m_level{LogLevel::INFO};
+    char const * m_file{nullptr};
+    char const * m_function{nullptr};
+    uint32_t m_line{0};
+    LogSite * m_next{nullptr};
+  };
+
 
   /*
-   * Non guaranteed logging. Uses a ring buffer to hold log lines.
-   * When the ring gets full, the previous log line in the slot will be dropped.
-   * Does not block producer even if the ring buffer is full.
-   * ring_buffer_size_mb - LogLines are pushed into a mpsc ring buffer whose size
-   * is determined by this parameter. Since each LogLine is 256 bytes,
-   * ring_buffer_size = ring_buffer_size_mb * 1024 * 1024 / 256
+   * Non guaranteed logging. Each logging thread stages log lines in its own spsc ring buffer.
+   * When a thread's ring gets full, new log lines from that thread are dropped (and the number
+   * dropped is logged). Does not block producer even if the ring buffer is full.
+   * ring_buffer_size_mb - Total size of the staging buffers, split between the hardware threads.
+   * Since each LogLine is 256 bytes, ring_buffer_size per thread =
+   * ring_buffer_size_mb * 1024 * 1024 / 256 / hardware_concurrency (minimum 256)
    */
   struct NonGuaranteedLogger
   {
@@ -163,7 +213,8 @@ namespace nanolog
   };
 
   /*
-   * Provides a guarantee log lines will not be dropped.
+   * Provides a guarantee log lines will not be dropped. Each logging thread stages log lines in its
+   * own spsc ring buffer, and waits for the writer thread if the ring buffer is full.
    */
   struct GuaranteedLogger
   {
@@ -178,9 +229,10 @@ namespace nanolog
    * /tmp/nanolog.2.txt
    * etc.
    * log_file_roll_size_mb - mega bytes after which we roll to next log file.
+   * format - BINARY writes files with a .nlb extension instead of .log.  Console output is always text.
    */
-  void initialize(GuaranteedLogger gl, std::string const & log_directory, std::string const & log_file_name, bool echo = false);
-  void initialize(NonGuaranteedLogger ngl, std::string const & log_directory, std::string const & log_file_name, bool echo = false);
+  void initialize(GuaranteedLogger gl, std::string const & log_directory, std::string const & log_file_name, bool echo = false, LogFormat format = LogFormat::TEXT);
+  void initialize(NonGuaranteedLogger ngl, std::string const & log_directory, std::string const & log_file_name, bool echo = false, LogFormat format = LogFormat::TEXT);
 
 } // namespace nanolog
 
@@ -190,4 +242,18 @@ namespace nanolog
 #define LOG_WARN nanolog::is_logged(nanolog::LogLevel::WARN) && NANO_LOG(nanolog::LogLevel::WARN)
 #define LOG_CRIT nanolog::is_logged(nanolog::LogLevel::CRIT) && NANO_LOG(nanolog::LogLevel::CRIT)
 
+#define NANO_LOG_SITE ([]() -> nanolog::LogSite & { static nanolog::LogSite site; return site; }())
+#define NANO_LOG_EVERY_N(LEVEL, N) nanolog::is_logged(LEVEL) && NANO_LOG_SITE.every_n(LEVEL, N, __FILE__, __func__, __LINE__) && NANO_LOG(LEVEL)
+#define NANO_LOG_RATE(LEVEL, PER_SECOND) nanolog::is_logged(LEVEL) && NANO_LOG_SITE.rate(LEVEL, PER_SECOND, __FILE__, __func__, __LINE__) && NANO_LOG(LEVEL)
+
+#define LOG_DEBUG_EVERY_N(N) NANO_LOG_EVERY_N(nanolog::LogLevel::DEBUG, N)
+#define LOG_INFO_EVERY_N(N) NANO_LOG_EVERY_N(nanolog::LogLevel::INFO, N)
+#define LOG_WARN_EVERY_N(N) NANO_LOG_EVERY_N(nanolog::LogLevel::WARN, N)
+#define LOG_CRIT_EVERY_N(N) NANO_LOG_EVERY_N(nanolog::LogLevel::CRIT, N)
+
+#define LOG_DEBUG_RATE(PER_SECOND) NANO_LOG_RATE(nanolog::LogLevel::DEBUG, PER_SECOND)
+#define LOG_INFO_RATE(PER_SECOND) NANO_LOG_RATE(nanolog::LogLevel::INFO, PER_SECOND)
+#define LOG_WARN_RATE(PER_SECOND) NANO_LOG_RATE(nanolog::LogLevel::WARN, PER_SECOND)
+#define LOG_CRIT_RATE(PER_SECOND) NANO_LOG_RATE(nanolog::LogLevel::CRIT, PER_SECOND)
+
 #endif /* NANO_LOG_HEADER_GUARD */
@@ -0,0 +1,34 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace nanolog::binary
+{
+  /*
+   * Binary log files (`.nlb`) contain a sequence of records, each starting with a single byte
+   * record kind.  Integers are written in native byte order, which is recorded in the header.
+   *
+   * Header  'H' | "NLOG" | uint8 version | uint8 little endian (1) or big endian (0)
+   * String  'S' | uint32 id | uint32 length | characters
+   * Line    'L' | uint32 length of remainder | uint64 timestamp (microseconds since epoch) |
+   *             uint64 thread | uint32 file id | uint32 function id | uint32 line | uint8 level |
+   *             arguments
+   *
+   * Each argument is a uint8 `Type` followed by the value.  String literals (`Literal`) are written
+   * as the uint32 id of a previously written `String` record, other strings (`String`) as null
+   * terminated characters.  A header is written each time the file is opened, and string ids are
+   * only valid until the next header.  Id 0 represents a null string.
+   */
+  constexpr char header = 'H';
+  constexpr char string = 'S';
+  constexpr char line = 'L';
+  constexpr char magic[] = { 'N', 'L', 'O', 'G' };
+  constexpr uint8_t version = 1;
+
+  /* Argument type ids.  Same as the type ids used to encode NanoLogLine */
+  enum class Type : uint8_t { Char, UInt32, UInt64, Int32, Int64, Double, Literal, String };
+}
@@ -0,0 +1,330 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "../common/util/clara.hpp"
+#include "../log/binary.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+  namespace binary = nanolog::binary;
+
+  struct Reader
+  {
+    explicit Reader( std::string_view data ) : data{ data } {}
+
+    template <typename T>
+    std::optional<T> read()
+    {
+      if ( remaining() < sizeof(T) ) return std::nullopt;
+      T value;
+      std::memcpy( &value, data.data() + offset, sizeof(T) );
+      offset += sizeof(T);
+      return value;
+    }
+
+    std::optional<std::string_view> bytes( std::size_t length )
+    {
+      if ( remaining() < length ) return std::nullopt;
+      auto value = data.substr( offset, length );
+      offset += length;
+      return value;
+    }
+
+    std::optional<std::string_view> cstring()
+    {
+      auto end = data.find( '\0', offset );
+      if ( end == std::string_view::npos ) return std::nullopt;
+      auto value = data.substr( offset, end - offset );
+      offset = end + 1;
+      return value;
+    }
+
+    [[nodiscard]] std::size_t remaining() const { return data.size() - offset; }
+
+    std::string_view data;
+    std::size_t offset{ 0 };
+  };
+
+  struct Line
+  {
+    std::string message;
+    std::string_view file;
+    std::string_view function;
+    uint64_t timestamp{ 0 };
+    uint64_t thread{ 0 };
+    uint32_t line{ 0 };
+    uint8_t level{ 0 };
+  };
+
+  using Strings = std::unordered_map<uint32_t, std::string_view>;
+
+  const char* level( uint8_t value )
+  {
+    switch ( value )
+    {
+    case 0: return "DEBUG";
+    case 1: return "INFO";
+    case 2: return "WARN";
+    case 3: return "CRIT";
+    default: return "XXXX";
+    }
+  }
+
+  // Same as the timestamp in text log files - 2016-10-13 00:01:23.528514
+  std::string timestamp( uint64_t micros )
+  {
+    auto time = static_cast<std::time_t>( micros / 1'000'000 );
+    std::tm tm{};
+    gmtime_r( &time, &tm );
+    char buffer[32]; // flawfinder: ignore
+    auto length = std::strftime( buffer, sizeof(buffer), "%Y-%m-%d %T.", &tm );
+    std::snprintf( buffer + length, sizeof(buffer) - length, "%06u", static_cast<unsigned>( micros % 1'000'000 ) ); // flawfinder: ignore
+    return { buffer };
+  }
+
+  void escape( std::ostream& os, std::string_view value )
+  {
+    for ( const char c : value )
+    {
+      switch ( c )
+      {
+      case '"': os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\r': os << "\\r"; break;
+      case '\t': os << "\\t"; break;
+      default:
+        if ( static_cast<unsigned char>( c ) < 0x20 )
+        {
+          char buffer[8]; // flawfinder: ignore
+          std::snprintf( buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>( c ) ); // flawfinder: ignore
+          os << buffer;
+        }
+        else os << c;
+      }
+    }
+  }
+
+  void writeText( std::ostream& os, const Line& line )
+  {
+    os << '[' << timestamp( line.timestamp ) << ']' <<
+      '[' << level( line.level ) << ']' <<
+      '[' << line.thread << ']' <<
+      '[' << line.file << ':' << line.function << ':' << line.line << "] " <<
+      line.message << '\n';
+  }
+
+  void writeJson( std::ostream& os, const Line& line )
+  {
+    os << R"({"timestamp":")" << timestamp( line.timestamp ) <<
+      R"(","level":")" << level( line.level ) <<
+      R"(","thread":)" << line.thread << R"(,"file":")";
+    escape( os, line.file );
+    os << R"(","function":")";
+    escape( os, line.function );
+    os << R"(","line":)" << line.line << R"(,"message":")";
+    escape( os, line.message );
+    os << "\"}\n";
+  }
+
+  // Render the arguments the same way NanoLogLine::stringify does.
+  bool message( Reader& reader, const Strings& strings, std::ostringstream& ss )
+  {
+    while ( reader.remaining() > 0 )
+    {
+      auto type = static_cast<binary::Type>( *reader.read<uint8_t>() );
+      switch ( type )
+      {
+      case binary::Type::Char:
+        if ( auto v = reader.read<char>() ) ss << *v; else return false;
+        break;
+      case binary::Type::UInt32:
+        if ( auto v = reader.read<uint32_t>() ) ss << *v; else return false;
+        break;
+      case binary::Type::UInt64:
+        if ( auto v = reader.read<uint64_t>() ) ss << *v; else return false;
+        break;
+      case binary::Type::Int32:
+        if ( auto v = reader.read<int32_t>() ) ss << *v; else return false;
+        break;
+      case binary::Type::Int64:
+        if ( auto v = reader.read<int64_t>() ) ss << *v; else return false;
+        break;
+      case binary::Type::Double:
+        if ( auto v = reader.read<double>() ) ss << *v; else return false;
+        break;
+      case binary::Type::Literal:
+        if ( auto v = reader.read<uint32_t>() )
+        {
+          if ( auto iter = strings.find( *v ); iter != strings.end() ) ss << iter->second;
+        }
+        else return false;
+        break;
+      case binary::Type::String:
+        if ( auto v = reader.cstring() ) ss << *v; else return false;
+        break;
+      default:
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  std::optional<Line> parse( std::string_view payload, const Strings& strings, std::ostringstream& ss )
+  {
+    auto lookup = [&strings]( uint32_t id ) -> std::string_view
+    {
+      auto iter = strings.find( id );
+      return iter == strings.end() ? std::string_view{} : iter->second;
+    };
+
+    auto reader = Reader{ payload };
+    auto ts = reader.read<uint64_t>();
+    auto thread = reader.read<uint64_t>();
+    auto file = reader.read<uint32_t>();
+    auto function = reader.read<uint32_t>();
+    auto number = reader.read<uint32_t>();
+    auto lvl = reader.read<uint8_t>();
+    if ( !ts || !thread || !file || !function || !number || !lvl ) return std::nullopt;
+
+    ss.str( {} );
+    if ( !message( reader, strings, ss ) ) return std::nullopt;
+
+    return Line{ .message = ss.str(), .file = lookup( *file ), .function = lookup( *function ),
+      .timestamp = *ts, .thread = *thread, .line = *number, .level = *lvl };
+  }
+
+  bool decode( const std::string& name, std::string_view data, bool json, std::ostream& out )
+  {
+    auto error = [&name]( std::string_view msg, std::size_t offset )
+    {
+      std::cerr << name << ": " << msg << " at offset " << offset << '\n';
+      return false;
+    };
+
+    Strings strings;
+    std::ostringstream ss;
+    auto reader = Reader{ data };
+    bool headerSeen = false;
+
+    while ( reader.remaining() > 0 )
+    {
+      const auto offset = reader.offset;
+      const auto kind = *reader.read<char>();
+
+      if ( kind == binary::header )
+      {
+        auto magic = reader.bytes( sizeof(binary::magic) );
+        auto version = reader.read<uint8_t>();
+        auto little = reader.read<uint8_t>();
+        if ( !magic || !version || !little ) return error( "Truncated header", offset );
+        if ( *magic != std::string_view{ binary::magic, sizeof(binary::magic) } ) return error( "Invalid header", offset );
+        if ( *version > binary::version ) return error( "Unsupported version", offset );
+        if ( ( *little == 1 ) != ( std::endian::native == std::endian::little ) ) return error( "Unsupported byte order", offset );
+
+        strings.clear();
+        headerSeen = true;
+        continue;
+      }
+
+      if ( !headerSeen ) return error( "Not a binary log file", offset );
+
+      if ( kind == binary::string )
+      {
+        auto id = reader.read<uint32_t>();
+        auto length = reader.read<uint32_t>();
+        if ( !id || !length ) return error( "Truncated string", offset );
+        auto value = reader.bytes( *length );
+        if ( !value ) return error( "Truncated string", offset );
+        strings[*id] = *value;
+        continue;
+      }
+
+      if ( kind == binary::line )
+      {
+        auto length = reader.read<uint32_t>();
+        if ( !length ) return error( "Truncated line", offset );
+        auto payload = reader.bytes( *length );
+        if ( !payload ) return error( "Truncated line", offset );
+
+        auto line = parse( *payload, strings, ss );
+        if ( !line ) return error( "Invalid line", offset );
+
+        if ( json ) writeJson( out, *line );
+        else writeText( out, *line );
+        continue;
+      }
+
+      return error( "Unknown record", offset );
+    }
+
+    return true;
+  }
+}
+
+int main( int argc, char const * const * argv )
+{
+  using clara::Opt;
+
+  std::vector<std::string> files;
+  std::string format{ "text" };
+  bool help = false;
+
+  auto options = clara::Help( help ) |
+      Opt( format, "text" )["-f"]["--format"]( "Output format [text|json] (default text)." ) |
+      clara::Arg( files, "files" )( "Binary (.nlb) log files to decode." );
+
+  auto result = options.parse( clara::Args( argc, argv ));
+  if ( !result )
+  {
+    std::cerr << "Error in command line: " << result.errorMessage() << std::endl;
+    exit( 1 );
+  }
+
+  if ( help || files.empty() )
+  {
+    options.writeToStream( std::cout );
+    exit( help ? 0 : 1 );
+  }
+
+  if ( format != "text" && format != "json" )
+  {
+    std::cerr << "Invalid format " << format << ".  Must be one of text or json.\n";
+    exit( 1 );
+  }
+
+  int status = 0;
+  for ( const auto& file : files )
+  {
+    std::ifstream in{ file, std::ios::binary };
+    if ( !in )
+    {
+      std::cerr << "Unable to open " << file << '\n';
+      status = 1;
+      continue;
+    }
+
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    if ( !decode( file, ss.view(), format == "json", std::cout ) ) status = 1;
+  }
+
+  std::cout.flush();
+  exit( status );
+}
@@ -0,0 +1,96 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <span>
+#include <vector>
+
+namespace spt::db::bulk
+{
+  /// Counts aggregated from the bulk writes executed for a request.
+  struct Result
+  {
+    Result& operator+=( const Result& r )
+    {
+      inserted += r.inserted;
+      deleted += r.deleted;
+      failed = failed || r.failed;
+      return *this;
+    }
+
+    int32_t inserted{ 0 };
+    int32_t deleted{ 0 };
+    bool failed{ false };
+  };
+
+  /**
+   * Split the operations into chunks of `size`, and execute them concurrently on up to `parallelism` connections.
+   * The caller's connection executes chunks `0, workers, 2 * workers, ...`, while worker `w` acquires its own
+   * connection and executes chunks `w, w + workers, ...`.  Chunks of a worker that could not acquire a connection
+   * are handed back, and executed on the caller's connection once all the workers have finished.
+   * @param operations The operations to execute.  Must not be empty.
+   * @param size The number of operations in each chunk.  Must not be zero.
+   * @param parallelism The maximum number of connections to use, including the caller's connection.
+   * @param connection The caller's connection.
+   * @param acquire Callable returning a `std::optional` connection for a worker.  Invoked concurrently.
+   * @param execute Callable that executes a `std::span` of operations on a connection and returns a `Result`.
+   *   Invoked concurrently, each time on a different connection.
+   * @return The counts aggregated across all the chunks.
+   */
+  template <typename Operation, typename Connection, typename Acquire, typename Execute>
+  Result execute( std::span<const Operation> operations, std::size_t size, std::size_t parallelism,
+      Connection& connection, Acquire&& acquire, Execute&& execute )
+  {
+    auto chunks = std::vector<std::span<const Operation>>{};
+    chunks.reserve( ( operations.size() + size - 1 ) / size );
+    for ( std::size_t i = 0; i < operations.size(); i += size )
+    {
+      chunks.push_back( operations.subspan( i, std::min( size, operations.size() - i ) ) );
+    }
+
+    const auto workers = std::max( std::min( parallelism, chunks.size() ), std::size_t{ 1 } );
+
+    struct Partial
+    {
+      Result result{};
+      std::vector<std::size_t> pending{};
+    };
+
+    const auto worker = [&]( std::size_t w ) -> Partial
+    {
+      auto partial = Partial{};
+      auto client = acquire();
+      if ( !client )
+      {
+        for ( auto i = w; i < chunks.size(); i += workers ) partial.pending.push_back( i );
+        return partial;
+      }
+
+      for ( auto i = w; i < chunks.size(); i += workers ) partial.result += execute( *client, chunks[i] );
+      return partial;
+    };
+
+    auto futures = std::vector<std::future<Partial>>{};
+    futures.reserve( workers - 1 );
+    for ( std::size_t w = 1; w < workers; ++w ) futures.push_back( std::async( std::launch::async, worker, w ) );
+
+    auto total = Result{};
+    for ( std::size_t i = 0; i < chunks.size(); i += workers ) total += execute( connection, chunks[i] );
+
+    auto pending = std::vector<std::size_t>{};
+    for ( auto& f : futures )
+    {
+      auto partial = f.get();
+      total += partial.result;
+      pending.insert( pending.end(), partial.pending.begin(), partial.pending.end() );
+    }
+
+    for ( const auto i : pending ) total += execute( connection, chunks[i] );
+    return total;
+  }
+}
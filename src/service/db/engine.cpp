@@ -0,0 +1,20 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "engine.hpp"
+#include "model/configuration.hpp"
+#include "../log/NanoLog.hpp"
+
+using spt::db::Engine;
+
+Engine& Engine::instance()
+{
+  static const auto engine = []
+  {
+    const auto& name = model::Configuration::instance().storage.engine;
+    LOG_INFO << "Using " << name << " storage engine";
+    return name == "memory" ? engine::memory() : engine::mongo();
+  }();
+  return *engine;
+}
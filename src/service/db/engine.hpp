@@ -0,0 +1,54 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+#include "model/document.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/awaitable.hpp>
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view_or_value.hpp>
+
+namespace spt::db
+{
+  /**
+   * Storage engine that executes the database operations for requests.  The engine is selected at startup
+   * via the `storage.engine` configuration, and the same instance is used for the lifetime of the process.
+   */
+  struct Engine
+  {
+    static Engine& instance();
+
+    virtual ~Engine() = default;
+
+    /**
+     * Execute the database action specified in the request.
+     * @param document The validated request.
+     * @return The response to send to the client.
+     */
+    virtual boost::asio::awaitable<bsoncxx::document::view_or_value> process( const model::Document& document ) = 0;
+
+    /**
+     * Store a batch of documents generated by the service (metrics, rollups, ...).  Errors are logged and not
+     * propagated to the caller.
+     * @param database The database to store the documents in.
+     * @param collection The collection to store the documents in.
+     * @param documents The documents to store.
+     */
+    virtual void save( const std::string& database, const std::string& collection,
+        std::vector<bsoncxx::document::value>&& documents ) = 0;
+  };
+
+  namespace engine
+  {
+    /// Engine backed by the configured MongoDB cluster.
+    std::unique_ptr<Engine> mongo();
+
+    /// Engine that stores documents in process memory.  Data is lost when the service exits.
+    std::unique_ptr<Engine> memory();
+  }
+}
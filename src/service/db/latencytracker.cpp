@@ -0,0 +1,135 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "latencytracker.hpp"
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+using spt::db::LatencyTracker;
+
+namespace spt::db::platencytracker
+{
+  struct Hash
+  {
+    using is_transparent = void;
+    std::size_t operator()( std::string_view value ) const { return std::hash<std::string_view>{}( value ); }
+  };
+
+  struct Entry
+  {
+    Entry( std::string_view action, std::string_view database, std::string_view collection ) :
+      action{ action }, database{ database }, collection{ collection } {}
+
+    std::string action;
+    std::string database;
+    std::string collection;
+    util::AtomicHistogram histogram{};
+    Entry* next{ nullptr };
+  };
+}
+
+struct LatencyTracker::Slot
+{
+  Slot() = default;
+  ~Slot()
+  {
+    auto entry = head.load( std::memory_order_acquire );
+    while ( entry )
+    {
+      auto next = entry->next;
+      delete entry;
+      entry = next;
+    }
+  }
+
+  Slot( Slot&& ) = delete;
+  Slot& operator=( Slot&& ) = delete;
+  Slot( const Slot& ) = delete;
+  Slot& operator=( const Slot& ) = delete;
+
+  platencytracker::Entry& entry( std::string_view action, std::string_view database, std::string_view collection )
+  {
+    key.clear();
+    key.append( action ).append( 1, '\x1f' ).append( database ).append( 1, '\x1f' ).append( collection );
+    if ( auto iter = index.find( std::string_view{ key } ); iter != index.end() ) return *iter->second;
+
+    // Only the owning thread adds entries, readers traverse the list from the published head.
+    auto e = new platencytracker::Entry{ action, database, collection };
+    e->next = head.load( std::memory_order_relaxed );
+    head.store( e, std::memory_order_release );
+    index.emplace( key, e );
+    return *e;
+  }
+
+  std::atomic<platencytracker::Entry*> head{ nullptr };
+
+private:
+  // Only accessed by the owning thread
+  std::unordered_map<std::string, platencytracker::Entry*, platencytracker::Hash, std::equal_to<>> index{};
+  std::string key{};
+};
+
+LatencyTracker& LatencyTracker::instance()
+{
+  static LatencyTracker tracker;
+  return tracker;
+}
+
+LatencyTracker::Slot& LatencyTracker::slot()
+{
+  static thread_local Slot* current = nullptr;
+  if ( current ) return *current;
+
+  auto lock = std::scoped_lock{ mutex };
+  slots.push_back( std::make_unique<Slot>() );
+  current = slots.back().get();
+  return *current;
+}
+
+void LatencyTracker::record( std::string_view action, std::string_view database,
+  std::string_view collection, std::chrono::nanoseconds duration )
+{
+  slot().entry( action, database, collection ).histogram.record( duration.count() );
+}
+
+std::vector<spt::model::Latency> LatencyTracker::collect()
+{
+  using Key = std::tuple<std::string_view, std::string_view, std::string_view>;
+
+  const auto now = std::chrono::system_clock::now();
+  auto merged = std::map<Key, model::Latency>{};
+
+  {
+    auto lock = std::scoped_lock{ mutex };
+    for ( const auto& s : slots )
+    {
+      for ( auto entry = s->head.load( std::memory_order_acquire ); entry != nullptr; entry = entry->next )
+      {
+        auto& latency = merged[Key{ entry->action, entry->database, entry->collection }];
+        if ( latency.action.empty() )
+        {
+          latency.action = entry->action;
+          latency.database = entry->database;
+          latency.collection = entry->collection;
+          latency.start = start;
+          latency.end = now;
+        }
+        entry->histogram.drain( latency.histogram );
+      }
+    }
+    start = now;
+  }
+
+  auto vector = std::vector<model::Latency>{};
+  vector.reserve( merged.size() );
+  for ( auto&& [_, latency] : merged )
+  {
+    if ( latency.histogram.count() > 0 ) vector.push_back( std::move( latency ) );
+  }
+  return vector;
+}
@@ -0,0 +1,51 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include "../model/latency.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace spt::db
+{
+  /**
+   * Tracks request latency distributions per action and database collection.  Each I/O thread
+   * records into its own set of histograms without taking any locks.  The per-thread histograms
+   * are merged when `collect` is invoked (periodically, from the metrics flusher thread).
+   */
+  struct LatencyTracker
+  {
+    static LatencyTracker& instance();
+
+    ~LatencyTracker() = default;
+    LatencyTracker( LatencyTracker&& ) = delete;
+    LatencyTracker& operator=( LatencyTracker&& ) = delete;
+
+    LatencyTracker( const LatencyTracker& ) = delete;
+    LatencyTracker& operator=( const LatencyTracker& ) = delete;
+
+    void record( std::string_view action, std::string_view database, std::string_view collection, std::chrono::nanoseconds duration );
+
+    /**
+     * Merge and reset the histograms recorded by all threads since the previous invocation.
+     * @return The merged latency distributions for each action and collection with recorded values.
+     */
+    [[nodiscard]] std::vector<model::Latency> collect();
+
+  private:
+    LatencyTracker() = default;
+
+    struct Slot;
+    Slot& slot();
+
+    std::mutex mutex{};
+    std::vector<std::unique_ptr<Slot>> slots{};
+    std::chrono::time_point<std::chrono::system_clock> start{ std::chrono::system_clock::now() };
+  };
+}
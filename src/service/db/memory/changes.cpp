@@ -0,0 +1,43 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#include "changes.hpp"
+
+#include <utility>
+
+using spt::db::memory::Changes;
+
+bool Changes::create( Documents& documents, const bsoncxx::oid& id, bsoncxx::document::value document )
+{
+  if ( !documents.try_emplace( id, std::move( document ) ).second ) return false;
+  undo.push_back( Undo{ &documents, id, std::nullopt } );
+  return true;
+}
+
+bool Changes::update( Documents& documents, const bsoncxx::oid& id, bsoncxx::document::value document )
+{
+  const auto it = documents.find( id );
+  if ( it == documents.end() ) return false;
+
+  undo.push_back( Undo{ &documents, id, std::move( it->second ) } );
+  it->second = std::move( document );
+  return true;
+}
+
+void Changes::erase( Documents& documents, Documents::iterator it )
+{
+  undo.push_back( Undo{ &documents, it->first, std::move( it->second ) } );
+  documents.erase( it );
+}
+
+void Changes::rollback()
+{
+  for ( auto it = undo.rbegin(); it != undo.rend(); ++it )
+  {
+    if ( it->previous ) it->documents->insert_or_assign( it->id, std::move( *it->previous ) );
+    else it->documents->erase( it->id );
+  }
+
+  undo.clear();
+}
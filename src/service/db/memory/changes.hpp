@@ -0,0 +1,67 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#pragma once
+
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/oid.hpp>
+
+namespace spt::db::memory
+{
+  struct OidHash
+  {
+    std::size_t operator()( const bsoncxx::oid& oid ) const noexcept
+    {
+      return std::hash<std::string_view>{}( std::string_view{ oid.bytes(), oid.size() } );
+    }
+  };
+
+  using Documents = std::unordered_map<bsoncxx::oid, bsoncxx::document::value, OidHash>;
+
+  /**
+   * Changes made to in-memory collections within a transaction, recorded so that they can be reverted
+   * if the transaction fails.  The caller must hold exclusive locks on all the collections involved until
+   * the transaction is either committed or rolled back.
+   */
+  struct Changes
+  {
+    /**
+     * Add a new document to the collection.
+     * @return `false` if a document with the same `_id` exists.  The collection is not modified.
+     */
+    bool create( Documents& documents, const bsoncxx::oid& id, bsoncxx::document::value document );
+
+    /**
+     * Replace an existing document in the collection.
+     * @return `false` if no document with the `_id` exists.  The collection is not modified.
+     */
+    bool update( Documents& documents, const bsoncxx::oid& id, bsoncxx::document::value document );
+
+    /**
+     * Remove the document at the iterator from the collection.  Other iterators remain valid.
+     */
+    void erase( Documents& documents, Documents::iterator it );
+
+    /**
+     * Revert all the recorded changes in reverse order, and clear the log.
+     */
+    void rollback();
+
+  private:
+    struct Undo
+    {
+      Documents* documents;
+      bsoncxx::oid id;
+      // Document before the change, or empty if the change added the document.
+      std::optional<bsoncxx::document::value> previous;
+    };
+
+    std::vector<Undo> undo;
+  };
+}
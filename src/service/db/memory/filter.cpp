@@ -0,0 +1,488 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "filter.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include <bsoncxx/array/view.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/types.hpp>
+
+namespace spt::db::memory::pfilter
+{
+  using Value = bsoncxx::types::bson_value::view;
+
+  // Position of the type in the MongoDB comparison order.  Types with the same rank are compared by value.
+  int rank( bsoncxx::type type )
+  {
+    switch ( type )
+    {
+    case bsoncxx::type::k_minkey: return 0;
+    case bsoncxx::type::k_undefined:
+    case bsoncxx::type::k_null: return 1;
+    case bsoncxx::type::k_int32:
+    case bsoncxx::type::k_int64:
+    case bsoncxx::type::k_double:
+    case bsoncxx::type::k_decimal128: return 2;
+    case bsoncxx::type::k_symbol:
+    case bsoncxx::type::k_string: return 3;
+    case bsoncxx::type::k_document: return 4;
+    case bsoncxx::type::k_array: return 5;
+    case bsoncxx::type::k_binary: return 6;
+    case bsoncxx::type::k_oid: return 7;
+    case bsoncxx::type::k_bool: return 8;
+    case bsoncxx::type::k_date: return 9;
+    case bsoncxx::type::k_timestamp: return 10;
+    case bsoncxx::type::k_regex: return 11;
+    case bsoncxx::type::k_maxkey: return 13;
+    default: return 12;
+    }
+  }
+
+  template <typename T>
+  int order( const T& lhs, const T& rhs )
+  {
+    if ( lhs < rhs ) return -1;
+    return rhs < lhs ? 1 : 0;
+  }
+
+  bool integral( bsoncxx::type type )
+  {
+    return type == bsoncxx::type::k_int32 || type == bsoncxx::type::k_int64;
+  }
+
+  int64_t integer( const Value& value )
+  {
+    return value.type() == bsoncxx::type::k_int32 ? value.get_int32().value : value.get_int64().value;
+  }
+
+  double number( const Value& value )
+  {
+    switch ( value.type() )
+    {
+    case bsoncxx::type::k_int32: return value.get_int32().value;
+    case bsoncxx::type::k_int64: return static_cast<double>( value.get_int64().value );
+    case bsoncxx::type::k_double: return value.get_double().value;
+    default: return std::strtod( value.get_decimal128().value.to_string().c_str(), nullptr );
+    }
+  }
+
+  int numeric( const Value& lhs, const Value& rhs )
+  {
+    if ( integral( lhs.type() ) && integral( rhs.type() ) ) return order( integer( lhs ), integer( rhs ) );
+
+    const auto l = number( lhs );
+    const auto r = number( rhs );
+    // NaN sorts before all other numbers
+    if ( std::isnan( l ) || std::isnan( r ) ) return order( !std::isnan( l ), !std::isnan( r ) );
+    return order( l, r );
+  }
+
+  std::string_view text( const Value& value )
+  {
+    if ( value.type() == bsoncxx::type::k_symbol ) return value.get_symbol().symbol;
+    return value.get_string().value;
+  }
+
+  bool truthy( const Value& value )
+  {
+    switch ( rank( value.type() ) )
+    {
+    case 1: return false;
+    case 2: return number( value ) != 0;
+    case 8: return value.get_bool().value;
+    default: return true;
+    }
+  }
+
+  bsoncxx::document::view document( const bsoncxx::array::view& array )
+  {
+    return bsoncxx::document::view{ array.data(), array.length() };
+  }
+
+  int elements( bsoncxx::document::view lhs, bsoncxx::document::view rhs, bool keys )
+  {
+    auto l = lhs.begin();
+    auto r = rhs.begin();
+    for ( ; l != lhs.end() && r != rhs.end(); ++l, ++r )
+    {
+      if ( const auto c = order( rank( l->type() ), rank( r->type() ) ); c != 0 ) return c;
+      if ( keys )
+      {
+        if ( const auto c = l->key().compare( r->key() ); c != 0 ) return c < 0 ? -1 : 1;
+      }
+      if ( const auto c = memory::compare( l->get_value(), r->get_value() ); c != 0 ) return c;
+    }
+
+    return order( l != lhs.end(), r != rhs.end() );
+  }
+
+  int binary( const bsoncxx::types::b_binary& lhs, const bsoncxx::types::b_binary& rhs )
+  {
+    if ( const auto c = order( lhs.size, rhs.size ); c != 0 ) return c;
+    if ( const auto c = order( static_cast<int>( lhs.sub_type ), static_cast<int>( rhs.sub_type ) ); c != 0 ) return c;
+    if ( lhs.size == 0 ) return 0;
+    return order( std::memcmp( lhs.bytes, rhs.bytes, lhs.size ), 0 );
+  }
+
+  void descend( const Value& value, std::string_view path, std::vector<Value>& out );
+
+  void resolve( bsoncxx::document::view document, std::string_view path, std::vector<Value>& out )
+  {
+    const auto dot = path.find( '.' );
+    const auto it = document.find( path.substr( 0, dot ) );
+    if ( it == document.end() ) return;
+    if ( dot == std::string_view::npos ) out.push_back( it->get_value() );
+    else descend( it->get_value(), path.substr( dot + 1 ), out );
+  }
+
+  void descend( const Value& value, std::string_view path, std::vector<Value>& out )
+  {
+    if ( value.type() == bsoncxx::type::k_document )
+    {
+      resolve( value.get_document().value, path, out );
+      return;
+    }
+
+    if ( value.type() != bsoncxx::type::k_array ) return;
+
+    const auto array = value.get_array().value;
+    const auto key = path.substr( 0, path.find( '.' ) );
+    if ( !key.empty() && key.find_first_not_of( "0123456789" ) == std::string_view::npos )
+    {
+      // Array elements are keyed by their index
+      resolve( document( array ), path, out );
+      return;
+    }
+
+    for ( const auto& e : array )
+    {
+      if ( e.type() == bsoncxx::type::k_document ) resolve( e.get_document().value, path, out );
+    }
+  }
+
+  bool operators( bsoncxx::document::view document )
+  {
+    return document.begin() != document.end() && document.begin()->key().starts_with( '$' );
+  }
+
+  bool equals( const std::vector<Value>& values, const Value& query )
+  {
+    if ( values.empty() ) return query.type() == bsoncxx::type::k_null;
+
+    for ( const auto& value : values )
+    {
+      if ( memory::compare( value, query ) == 0 ) return true;
+      if ( value.type() != bsoncxx::type::k_array ) continue;
+      for ( const auto& e : value.get_array().value )
+      {
+        if ( memory::compare( e.get_value(), query ) == 0 ) return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Range operators only match values in the same type bracket as the query value.
+  template <typename Predicate>
+  bool range( const std::vector<Value>& values, const Value& query, Predicate&& predicate )
+  {
+    const auto check = [&query, &predicate]( const Value& value )
+    {
+      return rank( value.type() ) == rank( query.type() ) && predicate( memory::compare( value, query ) );
+    };
+
+    for ( const auto& value : values )
+    {
+      if ( check( value ) ) return true;
+      if ( value.type() != bsoncxx::type::k_array ) continue;
+      for ( const auto& e : value.get_array().value ) if ( check( e.get_value() ) ) return true;
+    }
+
+    return false;
+  }
+
+  bool apply( const std::vector<Value>& values, std::string_view op, const Value& operand )
+  {
+    if ( op == "$eq" ) return equals( values, operand );
+    if ( op == "$ne" ) return !equals( values, operand );
+    if ( op == "$gt" ) return range( values, operand, []( int c ) { return c > 0; } );
+    if ( op == "$gte" ) return range( values, operand, []( int c ) { return c >= 0; } );
+    if ( op == "$lt" ) return range( values, operand, []( int c ) { return c < 0; } );
+    if ( op == "$lte" ) return range( values, operand, []( int c ) { return c <= 0; } );
+    if ( op == "$exists" ) return values.empty() != truthy( operand );
+
+    if ( op == "$in" || op == "$nin" )
+    {
+      if ( operand.type() != bsoncxx::type::k_array ) throw std::invalid_argument( std::format( "{} requires an array", op ) );
+
+      auto found = false;
+      for ( const auto& e : operand.get_array().value )
+      {
+        if ( equals( values, e.get_value() ) )
+        {
+          found = true;
+          break;
+        }
+      }
+
+      return op == "$in" ? found : !found;
+    }
+
+    throw std::invalid_argument( std::format( "Unsupported query operator {}", op ) );
+  }
+
+  bool field( bsoncxx::document::view document, std::string_view path, const Value& query )
+  {
+    const auto values = memory::values( document, path );
+    if ( query.type() == bsoncxx::type::k_document && operators( query.get_document().value ) )
+    {
+      for ( const auto& e : query.get_document().value )
+      {
+        if ( !apply( values, e.key(), e.get_value() ) ) return false;
+      }
+      return true;
+    }
+
+    return equals( values, query );
+  }
+
+  // Tree of the paths modified by an update specification.
+  struct Node
+  {
+    std::optional<Value> value{ std::nullopt };
+    std::map<std::string, Node, std::less<>> children{};
+    bool remove{ false };
+  };
+
+  void add( Node& root, std::string_view path, std::optional<Value> value )
+  {
+    auto* node = &root;
+    for (;;)
+    {
+      const auto dot = path.find( '.' );
+      const auto key = path.substr( 0, dot );
+      if ( key.empty() ) throw std::invalid_argument( std::format( "Invalid update path {}", path ) );
+
+      node = &node->children.try_emplace( std::string{ key } ).first->second;
+      if ( dot == std::string_view::npos ) break;
+      path.remove_prefix( dot + 1 );
+    }
+
+    node->value = value;
+    node->remove = !value;
+    node->children.clear();
+  }
+
+  bsoncxx::document::value build( bsoncxx::document::view document, const Node& node );
+
+  void append( bsoncxx::builder::basic::document& builder, std::string_view key, const Node& node,
+      const std::optional<Value>& current )
+  {
+    using bsoncxx::builder::basic::kvp;
+
+    if ( node.value )
+    {
+      builder.append( kvp( key, *node.value ) );
+      return;
+    }
+
+    if ( current && current->type() == bsoncxx::type::k_array )
+    {
+      const auto v = build( pfilter::document( current->get_array().value ), node );
+      builder.append( kvp( key, bsoncxx::array::view{ v.view().data(), v.view().length() } ) );
+      return;
+    }
+
+    const auto parent = current && current->type() == bsoncxx::type::k_document ?
+      current->get_document().value : bsoncxx::document::view{};
+    builder.append( kvp( key, build( parent, node ).view() ) );
+  }
+
+  bsoncxx::document::value build( bsoncxx::document::view document, const Node& node )
+  {
+    using bsoncxx::builder::basic::kvp;
+
+    auto builder = bsoncxx::builder::basic::document{};
+    for ( const auto& e : document )
+    {
+      const auto iter = node.children.find( e.key() );
+      if ( iter == node.children.end() ) builder.append( kvp( e.key(), e.get_value() ) );
+      else if ( !iter->second.remove ) append( builder, e.key(), iter->second, e.get_value() );
+    }
+
+    for ( const auto& [key, child] : node.children )
+    {
+      if ( child.remove || document.find( key ) != document.end() ) continue;
+      append( builder, key, child, std::nullopt );
+    }
+
+    return builder.extract();
+  }
+}
+
+int spt::db::memory::compare( const bsoncxx::types::bson_value::view& lhs, const bsoncxx::types::bson_value::view& rhs )
+{
+  using namespace pfilter;
+
+  const auto lr = rank( lhs.type() );
+  if ( const auto c = order( lr, rank( rhs.type() ) ); c != 0 ) return c;
+
+  switch ( lr )
+  {
+  case 0:
+  case 1:
+  case 13: return 0;
+  case 2: return numeric( lhs, rhs );
+  case 3: return order( text( lhs ), text( rhs ) );
+  case 4: return elements( lhs.get_document().value, rhs.get_document().value, true );
+  case 5: return elements( pfilter::document( lhs.get_array().value ), pfilter::document( rhs.get_array().value ), false );
+  case 6: return binary( lhs.get_binary(), rhs.get_binary() );
+  case 7: return order( lhs.get_oid().value.compare( rhs.get_oid().value ), 0 );
+  case 8: return order( lhs.get_bool().value, rhs.get_bool().value );
+  case 9: return order( lhs.get_date().value, rhs.get_date().value );
+  case 10:
+    if ( const auto c = order( lhs.get_timestamp().timestamp, rhs.get_timestamp().timestamp ); c != 0 ) return c;
+    return order( lhs.get_timestamp().increment, rhs.get_timestamp().increment );
+  case 11:
+    if ( const auto c = order( lhs.get_regex().regex, rhs.get_regex().regex ); c != 0 ) return c;
+    return order( lhs.get_regex().options, rhs.get_regex().options );
+  default:
+    // Remaining types have no defined order, only equality
+    if ( lhs == rhs ) return 0;
+    return lhs.type() < rhs.type() ? -1 : 1;
+  }
+}
+
+std::vector<bsoncxx::types::bson_value::view> spt::db::memory::values( bsoncxx::document::view document, std::string_view path )
+{
+  auto out = std::vector<bsoncxx::types::bson_value::view>{};
+  pfilter::resolve( document, path, out );
+  return out;
+}
+
+bool spt::db::memory::matches( bsoncxx::document::view document, bsoncxx::document::view filter )
+{
+  for ( const auto& e : filter )
+  {
+    const auto key = e.key();
+    if ( key == "$and" || key == "$or" || key == "$nor" )
+    {
+      if ( e.type() != bsoncxx::type::k_array ) throw std::invalid_argument( std::format( "{} requires an array", key ) );
+
+      auto any = false;
+      auto all = true;
+      for ( const auto& f : e.get_array().value )
+      {
+        if ( f.type() != bsoncxx::type::k_document ) throw std::invalid_argument( std::format( "{} requires an array of documents", key ) );
+        const auto m = matches( document, f.get_document().value );
+        any = any || m;
+        all = all && m;
+      }
+
+      if ( key == "$and" && !all ) return false;
+      if ( key == "$or" && !any ) return false;
+      if ( key == "$nor" && any ) return false;
+      continue;
+    }
+
+    if ( key.starts_with( '$' ) ) throw std::invalid_argument( std::format( "Unsupported query operator {}", key ) );
+    if ( !pfilter::field( document, key, e.get_value() ) ) return false;
+  }
+
+  return true;
+}
+
+bsoncxx::document::value spt::db::memory::update( bsoncxx::document::view document, bsoncxx::document::view update )
+{
+  auto root = pfilter::Node{};
+  for ( const auto& e : update )
+  {
+    const auto key = e.key();
+    if ( key == "_id" ) continue;
+
+    if ( key == "$set" || key == "$unset" )
+    {
+      if ( e.type() != bsoncxx::type::k_document ) throw std::invalid_argument( std::format( "{} requires a document", key ) );
+      for ( const auto& f : e.get_document().value )
+      {
+        if ( f.key() == "_id" ) continue;
+        pfilter::add( root, f.key(), key == "$set" ? std::optional{ f.get_value() } : std::nullopt );
+      }
+      continue;
+    }
+
+    if ( key.starts_with( '$' ) ) throw std::invalid_argument( std::format( "Unsupported update operator {}", key ) );
+    pfilter::add( root, key, e.get_value() );
+  }
+
+  return pfilter::build( document, root );
+}
+
+bsoncxx::document::value spt::db::memory::project( bsoncxx::document::view document, bsoncxx::document::view projection )
+{
+  using bsoncxx::builder::basic::kvp;
+
+  auto include = std::optional<bool>{};
+  auto id = true;
+  for ( const auto& e : projection )
+  {
+    const auto key = e.key();
+    if ( key.find( '.' ) != std::string_view::npos || key.starts_with( '$' ) ||
+      ( e.type() != bsoncxx::type::k_bool && pfilter::rank( e.type() ) != 2 ) )
+    {
+      throw std::invalid_argument( std::format( "Unsupported projection for {}", key ) );
+    }
+
+    const auto flag = pfilter::truthy( e.get_value() );
+    if ( key == "_id" )
+    {
+      id = flag;
+      continue;
+    }
+
+    if ( include && *include != flag ) throw std::invalid_argument( "Projection cannot mix inclusion and exclusion" );
+    include = flag;
+  }
+
+  auto builder = bsoncxx::builder::basic::document{};
+  for ( const auto& e : document )
+  {
+    if ( e.key() == "_id" )
+    {
+      if ( id ) builder.append( kvp( e.key(), e.get_value() ) );
+      continue;
+    }
+
+    const auto listed = projection.find( e.key() ) != projection.end();
+    if ( include.value_or( false ) == listed ) builder.append( kvp( e.key(), e.get_value() ) );
+  }
+
+  return builder.extract();
+}
+
+bool spt::db::memory::less( bsoncxx::document::view lhs, bsoncxx::document::view rhs, bsoncxx::document::view sort )
+{
+  const auto null = pfilter::Value{ bsoncxx::types::b_null{} };
+  for ( const auto& e : sort )
+  {
+    if ( pfilter::rank( e.type() ) != 2 ) throw std::invalid_argument( std::format( "Unsupported sort order for {}", e.key() ) );
+
+    const auto l = values( lhs, e.key() );
+    const auto r = values( rhs, e.key() );
+    const auto c = compare( l.empty() ? null : l.front(), r.empty() ? null : r.front() );
+    if ( c != 0 ) return pfilter::number( e.get_value() ) < 0 ? c > 0 : c < 0;
+  }
+
+  return false;
+}
@@ -0,0 +1,55 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+
+namespace spt::db::memory
+{
+  /**
+   * Compare two BSON values using the MongoDB sort order for types.  Numeric values are compared by value
+   * irrespective of their BSON type.  Values of types without a defined order (code, db pointer, ...) are
+   * only compared for equality.
+   * @return A negative value if `lhs` sorts before `rhs`, zero if equal, and a positive value otherwise.
+   */
+  int compare( const bsoncxx::types::bson_value::view& lhs, const bsoncxx::types::bson_value::view& rhs );
+
+  /**
+   * Resolve the values at the dotted `path` in the document.  Arrays encountered along the path are
+   * traversed, either by numeric index, or by resolving the remainder of the path in each embedded document.
+   * Values at the end of the path are not expanded.
+   */
+  std::vector<bsoncxx::types::bson_value::view> values( bsoncxx::document::view document, std::string_view path );
+
+  /**
+   * Check whether the document matches the query filter.  Supports equality (including matching any
+   * element of an array), the `$eq, $ne, $gt, $gte, $lt, $lte, $in, $nin, $exists` field operators, and
+   * the top level `$and, $or, $nor` logical operators.
+   * @throws std::invalid_argument if the filter uses an operator that is not supported.
+   */
+  bool matches( bsoncxx::document::view document, bsoncxx::document::view filter );
+
+  /**
+   * Apply the update specification to the document and return the updated document.  The specification
+   * may use the `$set` and `$unset` operators with dotted paths, and plain fields which are treated as
+   * though they were specified in `$set`.  The `_id` field is never modified.
+   * @throws std::invalid_argument if the specification uses an operator that is not supported.
+   */
+  bsoncxx::document::value update( bsoncxx::document::view document, bsoncxx::document::view update );
+
+  /**
+   * Apply an inclusion or exclusion projection of top level fields to the document.
+   * @throws std::invalid_argument if the projection uses dotted paths, expressions, or mixes inclusion and exclusion.
+   */
+  bsoncxx::document::value project( bsoncxx::document::view document, bsoncxx::document::view projection );
+
+  /// Check whether `lhs` sorts before `rhs` using the sort specification (`{ field: 1|-1, ... }`).
+  bool less( bsoncxx::document::view lhs, bsoncxx::document::view rhs, bsoncxx::document::view sort );
+}
@@ -0,0 +1,1145 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "changes.hpp"
+#include "filter.hpp"
+#include "db/engine.hpp"
+#include "model/configuration.hpp"
+#include "model/errors.hpp"
+#include "../log/NanoLog.hpp"
+#include "../common/util/bson.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <bsoncxx/json.hpp>
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/stream/array.hpp>
+#include <bsoncxx/builder/stream/document.hpp>
+
+using std::operator""sv;
+
+namespace
+{
+  namespace pmemory
+  {
+    using namespace spt;
+    using namespace spt::db;
+    using boost::asio::awaitable;
+
+    // Maximum number of lines written per second by each per-document log statement.
+    constexpr uint32_t logRate = 100;
+    // Maximum number of lines written per second by each error log statement.
+    constexpr uint32_t errorLogRate = 10;
+
+    using memory::Documents;
+
+    struct Collection
+    {
+      std::shared_mutex mutex;
+      Documents documents;
+    };
+
+    /**
+     * All the collections stored by the engine, keyed by namespace (`database.collection`).  Each collection
+     * has its own lock, the store lock is only held while looking up, adding or removing collections.
+     */
+    struct Store
+    {
+      static Store& instance()
+      {
+        static Store s;
+        return s;
+      }
+
+      static std::string key( std::string_view database, std::string_view collection )
+      {
+        return std::format( "{}.{}", database, collection );
+      }
+
+      std::shared_ptr<Collection> find( std::string_view database, std::string_view collection ) const
+      {
+        auto lock = std::shared_lock( mutex );
+        const auto iter = collections.find( key( database, collection ) );
+        return iter == collections.end() ? nullptr : iter->second;
+      }
+
+      std::shared_ptr<Collection> get( std::string_view database, std::string_view collection )
+      {
+        if ( auto c = find( database, collection ); c ) return c;
+
+        auto lock = std::unique_lock( mutex );
+        auto [iter, _] = collections.try_emplace( key( database, collection ), std::make_shared<Collection>() );
+        return iter->second;
+      }
+
+      bool create( std::string_view database, std::string_view collection )
+      {
+        auto lock = std::unique_lock( mutex );
+        return collections.try_emplace( key( database, collection ), std::make_shared<Collection>() ).second;
+      }
+
+      bool drop( std::string_view database, std::string_view collection )
+      {
+        auto lock = std::unique_lock( mutex );
+        return collections.erase( key( database, collection ) ) > 0;
+      }
+
+      bool rename( std::string_view database, std::string_view collection, std::string_view target )
+      {
+        auto lock = std::unique_lock( mutex );
+        const auto iter = collections.find( key( database, collection ) );
+        if ( iter == collections.end() ) return false;
+        if ( !collections.try_emplace( key( database, target ), iter->second ).second ) return false;
+        collections.erase( iter );
+        return true;
+      }
+
+      Store( const Store& ) = delete;
+      Store& operator=( const Store& ) = delete;
+
+    private:
+      Store() = default;
+      ~Store() = default;
+
+      mutable std::shared_mutex mutex;
+      std::unordered_map<std::string, std::shared_ptr<Collection>> collections;
+    };
+
+    bool isVersionHistory( std::string_view database, std::string_view collection )
+    {
+      const auto& conf = model::Configuration::instance();
+      return database == conf.versionHistoryDatabase && collection == conf.versionHistoryCollection;
+    }
+
+    // Identifiers when the filter selects documents by `_id` (value, `$eq` or `$in`), in ascending order.
+    std::optional<std::vector<bsoncxx::oid>> indexed( bsoncxx::document::view filter )
+    {
+      const auto it = filter.find( "_id" );
+      if ( it == filter.end() ) return std::nullopt;
+      if ( it->type() == bsoncxx::type::k_oid ) return std::vector{ it->get_oid().value };
+      if ( it->type() != bsoncxx::type::k_document ) return std::nullopt;
+
+      const auto spec = it->get_document().view();
+      if ( const auto eq = spec.find( "$eq" ); eq != spec.end() && eq->type() == bsoncxx::type::k_oid )
+      {
+        return std::vector{ eq->get_oid().value };
+      }
+
+      const auto in = spec.find( "$in" );
+      if ( in == spec.end() || in->type() != bsoncxx::type::k_array ) return std::nullopt;
+
+      auto ids = std::vector<bsoncxx::oid>{};
+      for ( const auto& e : in->get_array().value )
+      {
+        if ( e.type() != bsoncxx::type::k_oid ) return std::nullopt;
+        ids.push_back( e.get_oid().value );
+      }
+
+      std::sort( ids.begin(), ids.end() );
+      ids.erase( std::unique( ids.begin(), ids.end() ), ids.end() );
+      return ids;
+    }
+
+    /**
+     * Select the documents matching the filter in `_id` order.  Filters on `_id` use the hash index, all other
+     * filters scan the collection.  Caller must hold the collection lock.
+     */
+    std::vector<Documents::iterator> select( Documents& documents, bsoncxx::document::view filter,
+        std::size_t limit = std::numeric_limits<std::size_t>::max() )
+    {
+      auto result = std::vector<Documents::iterator>{};
+      if ( const auto ids = indexed( filter ); ids )
+      {
+        for ( const auto& id : *ids )
+        {
+          if ( result.size() >= limit ) break;
+          const auto it = documents.find( id );
+          if ( it != documents.end() && memory::matches( it->second.view(), filter ) ) result.push_back( it );
+        }
+        return result;
+      }
+
+      for ( auto it = documents.begin(); it != documents.end(); ++it )
+      {
+        if ( memory::matches( it->second.view(), filter ) ) result.push_back( it );
+      }
+
+      std::sort( result.begin(), result.end(), []( const auto& lhs, const auto& rhs ) { return lhs->first < rhs->first; } );
+      if ( result.size() > limit ) result.erase( result.begin() + static_cast<std::ptrdiff_t>( limit ), result.end() );
+      return result;
+    }
+
+    std::vector<bsoncxx::document::value> copy( std::string_view database, std::string_view collection,
+        bsoncxx::document::view filter, std::size_t limit = std::numeric_limits<std::size_t>::max() )
+    {
+      auto result = std::vector<bsoncxx::document::value>{};
+      const auto coll = Store::instance().find( database, collection );
+      if ( !coll ) return result;
+
+      auto lock = std::shared_lock( coll->mutex );
+      const auto selected = select( coll->documents, filter, limit );
+      result.reserve( selected.size() );
+      for ( const auto& it : selected ) result.push_back( it->second );
+      return result;
+    }
+
+    std::size_t size( const bsoncxx::document::element& e )
+    {
+      switch ( e.type() )
+      {
+      case bsoncxx::type::k_int32: return static_cast<std::size_t>( std::max( e.get_int32().value, 0 ) );
+      case bsoncxx::type::k_int64: return static_cast<std::size_t>( std::max( e.get_int64().value, int64_t{ 0 } ) );
+      case bsoncxx::type::k_double: return static_cast<std::size_t>( std::max( e.get_double().value, 0.0 ) );
+      default: throw std::invalid_argument( std::format( "Invalid numeric value for {}", e.key() ) );
+      }
+    }
+
+    void sort( std::vector<bsoncxx::document::value>& documents, bsoncxx::document::view spec )
+    {
+      std::stable_sort( documents.begin(), documents.end(),
+        [&spec]( const auto& lhs, const auto& rhs ) { return memory::less( lhs.view(), rhs.view(), spec ); } );
+    }
+
+    void skip( std::vector<bsoncxx::document::value>& documents, std::size_t count )
+    {
+      documents.erase( documents.begin(), documents.begin() + static_cast<std::ptrdiff_t>( std::min( count, documents.size() ) ) );
+    }
+
+    void limit( std::vector<bsoncxx::document::value>& documents, std::size_t count )
+    {
+      if ( count == 0 || count >= documents.size() ) return;
+      documents.erase( documents.begin() + static_cast<std::ptrdiff_t>( count ), documents.end() );
+    }
+
+    void project( std::vector<bsoncxx::document::value>& documents, bsoncxx::document::view projection )
+    {
+      for ( auto& d : documents ) d = memory::project( d.view(), projection );
+    }
+
+    bsoncxx::document::value entry( const bsoncxx::oid& oid, std::string_view database, std::string_view collection,
+        std::string_view action, bsoncxx::document::view entity, std::optional<bsoncxx::document::view> metadata )
+    {
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      auto d = document{};
+      d << "_id" << oid <<
+        "database" << database <<
+        "collection" << collection <<
+        "action" << action <<
+        "entity" << entity <<
+        "created" << bsoncxx::types::b_date{ std::chrono::system_clock::now() };
+      if ( metadata ) d << "metadata" << *metadata;
+      return d << finalize;
+    }
+
+    using Versions = std::vector<std::pair<std::string_view, bsoncxx::document::view>>;
+
+    // Store version history documents for the entities, and return the references to the version documents.
+    std::vector<bsoncxx::document::value> history( const model::Document& request, const Versions& entities )
+    {
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      auto timer = model::Phases::Timer{ request.phases().history };
+      const auto& conf = model::Configuration::instance();
+      const auto dbname = request.database();
+      const auto collname = request.collection();
+      const auto metadata = request.metadata();
+
+      auto refs = std::vector<bsoncxx::document::value>{};
+      refs.reserve( entities.size() );
+
+      auto vh = Store::instance().get( conf.versionHistoryDatabase, conf.versionHistoryCollection );
+      auto lock = std::unique_lock( vh->mutex );
+      for ( const auto& [action, entity] : entities )
+      {
+        const auto oid = bsoncxx::oid{};
+        const auto id = util::bsonValue<bsoncxx::oid>( "_id", entity );
+        vh->documents.try_emplace( oid, entry( oid, dbname, collname, action, entity, metadata ) );
+        LOG_INFO_RATE( logRate ) << "Created version for " << dbname << ':' << collname << ':' <<
+          id.to_string() << " with id: " << oid.to_string();
+
+        refs.push_back( document{} << "_id" << oid <<
+          "database" << conf.versionHistoryDatabase <<
+          "collection" << conf.versionHistoryCollection <<
+          "entity" << id << finalize );
+      }
+
+      return refs;
+    }
+
+    bsoncxx::document::view_or_value duplicate( const model::Document& model, const bsoncxx::oid& id )
+    {
+      LOG_WARN_RATE( errorLogRate ) << "Duplicate _id " << id.to_string() << " in " << model.database() << ':' << model.collection();
+      return model::withMessage( std::format( "Error processing database action {}", model.action() ) );
+    }
+
+    bool insert( std::string_view database, std::string_view collection, const bsoncxx::oid& id, bsoncxx::document::view document )
+    {
+      auto coll = Store::instance().get( database, collection );
+      auto lock = std::unique_lock( coll->mutex );
+      return coll->documents.try_emplace( id, document ).second;
+    }
+
+    bsoncxx::document::view_or_value create( const model::Document& model )
+    {
+      using util::bsonValueIfExists;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      const auto doc = model.document();
+      const auto dbname = model.database();
+      const auto collname = model.collection();
+
+      if ( isVersionHistory( dbname, collname ) )
+      {
+        LOG_WARN << "Attempting to create in version history " << model.json();
+        return model::notModifyable();
+      }
+
+      const auto idopt = bsonValueIfExists<bsoncxx::oid>( "_id", doc );
+      if ( !idopt ) return model::missingId();
+      if ( !insert( dbname, collname, *idopt, doc ) ) return duplicate( model, *idopt );
+
+      LOG_INFO_RATE( logRate ) << "Created document " << dbname << ':' << collname << ':' << idopt->to_string();
+      if ( const auto nv = model.skipVersion(); nv && *nv )
+      {
+        return document{} << "_id" << *idopt << "skipVersion" << true << finalize;
+      }
+
+      return std::move( history( model, { { "create"sv, doc } } ).front() );
+    }
+
+    bsoncxx::document::view_or_value createTimeseries( const model::Document& model )
+    {
+      using util::bsonValueIfExists;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      const auto doc = model.document();
+      const auto dbname = model.database();
+      const auto collname = model.collection();
+
+      if ( isVersionHistory( dbname, collname ) )
+      {
+        LOG_WARN << "Attempting to create in version history " << model.json();
+        return model::notModifyable();
+      }
+
+      auto idopt = bsonValueIfExists<bsoncxx::oid>( "_id", doc );
+      if ( !idopt && doc.find( "_id" ) != doc.end() ) return model::missingId();
+
+      auto value = bsoncxx::document::value{ doc };
+      if ( !idopt )
+      {
+        idopt = bsoncxx::oid{};
+        auto d = document{};
+        d << "_id" << *idopt;
+        for ( const auto& e : doc ) d << e.key() << e.get_value();
+        value = d << finalize;
+      }
+
+      if ( !insert( dbname, collname, *idopt, value.view() ) ) return duplicate( model, *idopt );
+      return document{} << "database" << dbname << "collection" << collname << "_id" << *idopt << finalize;
+    }
+
+    bsoncxx::document::view_or_value retrieve( const model::Document& model )
+    {
+      using util::bsonValueIfExists;
+      using bsoncxx::builder::stream::array;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      const auto doc = model.document();
+      const auto options = model.options();
+      const auto projection = options ? bsonValueIfExists<bsoncxx::document::view>( "projection", *options ) : std::nullopt;
+
+      if ( doc.find( "_id" ) != doc.end() && bsoncxx::type::k_oid == doc["_id"].type() )
+      {
+        auto results = copy( model.database(), model.collection(), doc, 1 );
+        if ( results.empty() )
+        {
+          LOG_WARN << "Document not found: " << model.database() << ':' << model.collection() << ':'
+            << doc["_id"].get_oid().value.to_string() << ". " << bsoncxx::to_json( doc );
+          return model::notFound();
+        }
+
+        if ( projection ) project( results, *projection );
+        return document{} << "result" << results.front().view() << finalize;
+      }
+
+      const auto order = options ? bsonValueIfExists<bsoncxx::document::view>( "sort", *options ) : std::nullopt;
+      const auto offset = static_cast<std::size_t>( std::max( options ? bsonValueIfExists<int64_t>( "skip", *options ).value_or( 0 ) : 0, int64_t{ 0 } ) );
+      const auto count = static_cast<std::size_t>( std::max( options ? bsonValueIfExists<int64_t>( "limit", *options ).value_or( 0 ) : 0, int64_t{ 0 } ) );
+
+      // Without a sort, only the documents that will be returned need to be copied
+      auto results = order || count == 0 ?
+        copy( model.database(), model.collection(), doc ) :
+        copy( model.database(), model.collection(), doc, offset + count );
+      if ( order ) sort( results, *order );
+      skip( results, offset );
+      limit( results, count );
+      if ( projection ) project( results, *projection );
+
+      auto arr = array{};
+      for ( const auto& d : results ) if ( !d.view().empty() ) arr << d.view();
+      return document{} << "results" << ( arr << finalize ) << finalize;
+    }
+
+    bsoncxx::document::view_or_value count( const model::Document& model )
+    {
+      using util::bsonValueIfExists;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      auto count = int64_t{ 0 };
+      if ( const auto coll = Store::instance().find( model.database(), model.collection() ); coll )
+      {
+        auto lock = std::shared_lock( coll->mutex );
+        count = static_cast<int64_t>( select( coll->documents, model.document() ).size() );
+      }
+
+      if ( const auto opts = model.options(); opts )
+      {
+        if ( const auto skip = bsonValueIfExists<int64_t>( "skip", *opts ); skip ) count = std::max( count - *skip, int64_t{ 0 } );
+        if ( const auto limit = bsonValueIfExists<int64_t>( "limit", *opts ); limit && *limit > 0 ) count = std::min( count, *limit );
+      }
+
+      return document{} << "count" << count << finalize;
+    }
+
+    bsoncxx::document::view_or_value distinct( const model::Document& model )
+    {
+      using util::bsonValue;
+      using util::bsonValueIfExists;
+      using bsoncxx::builder::stream::array;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      const auto doc = model.document();
+      if ( !bsonValueIfExists<std::string>( "field", doc ) ) return model::missingName();
+
+      const auto field = bsonValue<std::string>( "field", doc );
+      const auto filter = bsonValueIfExists<bsoncxx::document::view>( "filter", doc );
+      const auto documents = copy( model.database(), model.collection(), filter ? *filter : bsoncxx::document::view{} );
+
+      auto values = std::vector<bsoncxx::types::bson_value::view>{};
+      for ( const auto& d : documents )
+      {
+        for ( const auto& v : memory::values( d.view(), field ) )
+        {
+          if ( v.type() != bsoncxx::type::k_array ) values.push_back( v );
+          else for ( const auto& e : v.get_array().value ) values.push_back( e.get_value() );
+        }
+      }
+
+      std::stable_sort( values.begin(), values.end(), []( const auto& lhs, const auto& rhs ) { return memory::compare( lhs, rhs ) < 0; } );
+      values.erase( std::unique( values.begin(), values.end(),
+        []( const auto& lhs, const auto& rhs ) { return memory::compare( lhs, rhs ) == 0; } ), values.end() );
+
+      auto arr = array{};
+      for ( const auto& v : values ) arr << v;
+      return document{} << "results" << ( arr << finalize ) << finalize;
+    }
+
+    // Initial document for an upsert, built from the equality conditions in the filter.
+    bsoncxx::document::value seed( bsoncxx::document::view filter )
+    {
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      const auto id = filter.find( "_id" );
+      auto d = document{};
+      d << "_id" << ( id != filter.end() && id->type() == bsoncxx::type::k_oid ? id->get_oid().value : bsoncxx::oid{} );
+
+      for ( const auto& e : filter )
+      {
+        const auto key = e.key();
+        if ( key == "_id" || key.starts_with( '$' ) || key.find( '.' ) != std::string_view::npos ) continue;
+        if ( e.type() == bsoncxx::type::k_document )
+        {
+          const auto v = e.get_document().view();
+          if ( v.begin() != v.end() && v.begin()->key().starts_with( '$' ) ) continue;
+        }
+        d << key << e.get_value();
+      }
+
+      return d << finalize;
+    }
+
+    struct Modified
+    {
+      std::vector<bsoncxx::document::value> documents{};
+      bool upserted{ false };
+    };
+
+    /**
+     * Apply the transform to the documents matching the filter, and return copies of the modified documents.
+     * If no documents match and the request options specify `upsert`, the transformed seed document is inserted.
+     */
+    template <typename Transform>
+    Modified modify( const model::Document& model, bsoncxx::document::view filter, bool many, Transform&& transform )
+    {
+      const auto options = model.options();
+      const auto upsert = options && util::bsonValueIfExists<bool>( "upsert", *options ).value_or( false );
+
+      auto result = Modified{};
+      auto coll = Store::instance().get( model.database(), model.collection() );
+      auto lock = std::unique_lock( coll->mutex );
+      for ( auto& it : select( coll->documents, filter, many ? std::numeric_limits<std::size_t>::max() : 1 ) )
+      {
+        it->second = transform( it->first, it->second.view() );
+        result.documents.push_back( it->second );
+      }
+
+      if ( !result.documents.empty() || !upsert ) return result;
+
+      const auto initial = seed( filter );
+      const auto id = util::bsonValue<bsoncxx::oid>( "_id", initial.view() );
+      auto [iter, _] = coll->documents.try_emplace( id, transform( id, initial.view() ) );
+      result.documents.push_back( iter->second );
+      result.upserted = true;
+      return result;
+    }
+
+    // Response for updates that modify a single document.
+    bsoncxx::document::view_or_value single( const model::Document& model, const Modified& modified, std::string_view action )
+    {
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      if ( const auto skip = model.skipVersion(); skip && *skip ) return document{} << "skipVersion" << true << finalize;
+      if ( modified.documents.empty() ) return model::notFound();
+
+      const auto& d = modified.documents.front();
+      const auto refs = history( model, { { modified.upserted && action == "update"sv ? "create"sv : action, d.view() } } );
+      return document{} << "document" << d.view() << "history" << refs.front().view() << finalize;
+    }
+
+    bsoncxx::document::view_or_value update( const model::Document& model )
+    {
+      using util::bsonValue;
+      using util::bsonValueIfExists;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      const auto doc = model.document();
+      const auto dbname = model.database();
+      const auto collname = model.collection();
+      const auto skip = model.skipVersion();
+
+      if ( isVersionHistory( dbname, collname ) )
+      {
+        LOG_WARN << "Attempting to update in version history " << model.json();
+        return model::notModifyable();
+      }
+
+      const auto apply = []( bsoncxx::document::view spec )
+      {
+        return [spec]( const bsoncxx::oid&, bsoncxx::document::view d ) { return memory::update( d, spec ); };
+      };
+
+      if ( const auto idopt = bsonValueIfExists<bsoncxx::oid>( "_id", doc ); idopt )
+      {
+        const auto modified = modify( model, document{} << "_id" << *idopt << finalize, false, apply( doc ) );
+        LOG_INFO_RATE( logRate ) << "Updated document " << dbname << ':' << collname << ':' << idopt->to_string();
+        return single( model, modified, "update"sv );
+      }
+
+      const auto filter = bsonValueIfExists<bsoncxx::document::view>( "filter", doc );
+      if ( !filter ) return model::invalidAUpdate();
+
+      if ( const auto replace = bsonValueIfExists<bsoncxx::document::view>( "replace", doc ); replace )
+      {
+        const auto modified = modify( model, *filter, false, [&replace]( const bsoncxx::oid& id, bsoncxx::document::view )
+        {
+          auto d = document{};
+          d << "_id" << id;
+          for ( const auto& e : *replace ) if ( e.key() != "_id" ) d << e.key() << e.get_value();
+          return d << finalize;
+        } );
+        LOG_INFO << "Updated document in " << dbname << ':' << collname << " with filter " << bsoncxx::to_json( *filter );
+        return single( model, modified, "replace"sv );
+      }
+
+      const auto spec = bsonValueIfExists<bsoncxx::document::view>( "update", doc );
+      if ( !spec ) return model::invalidAUpdate();
+
+      if ( const auto iter = filter->find( "_id" ); iter != filter->end() && iter->type() == bsoncxx::type::k_oid )
+      {
+        const auto modified = modify( model, *filter, false, apply( *spec ) );
+        LOG_INFO_RATE( logRate ) << "Updated document " << dbname << ':' << collname << ':' << iter->get_oid().value.to_string();
+        return single( model, modified, "update"sv );
+      }
+
+      const auto modified = modify( model, *filter, true, apply( *spec ) );
+      LOG_INFO << "Updated " << int( modified.documents.size() ) << " documents in " << dbname << ':' << collname;
+      if ( skip && *skip ) return document{} << "skipVersion" << true << finalize;
+
+      auto success = bsoncxx::builder::basic::array{};
+      auto versions = Versions{};
+      versions.reserve( modified.documents.size() );
+      for ( const auto& d : modified.documents )
+      {
+        success.append( bsonValue<bsoncxx::oid>( "_id", d.view() ) );
+        versions.emplace_back( "update"sv, d.view() );
+      }
+
+      auto vh = bsoncxx::builder::basic::array{};
+      for ( const auto& ref : history( model, versions ) ) vh.append( ref.view() );
+
+      auto fail = bsoncxx::builder::basic::array{};
+      return document{} << "success" << success << "failure" << fail
+        << "history" << vh << finalize;
+    }
+
+    bsoncxx::document::view_or_value remove( const model::Document& model )
+    {
+      using util::bsonValue;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      const auto dbname = model.database();
+      const auto collname = model.collection();
+      const auto skip = model.skipVersion();
+
+      if ( isVersionHistory( dbname, collname ) )
+      {
+        LOG_WARN << "Attempting to delete from version history " << model.json();
+        return model::notModifyable();
+      }
+
+      auto removed = std::vector<bsoncxx::document::value>{};
+      if ( const auto coll = Store::instance().find( dbname, collname ); coll )
+      {
+        auto lock = std::unique_lock( coll->mutex );
+        for ( const auto& it : select( coll->documents, model.document() ) )
+        {
+          removed.push_back( std::move( it->second ) );
+          coll->documents.erase( it );
+        }
+      }
+
+      auto success = bsoncxx::builder::basic::array{};
+      auto versions = Versions{};
+      versions.reserve( removed.size() );
+      for ( const auto& d : removed )
+      {
+        const auto oid = bsonValue<bsoncxx::oid>( "_id", d.view() );
+        LOG_INFO_RATE( logRate ) << "Deleted document " << dbname << ':' << collname << ':' << oid.to_string();
+        success.append( oid );
+        versions.emplace_back( "delete"sv, d.view() );
+      }
+
+      auto vh = bsoncxx::builder::basic::array{};
+      if ( !( skip && *skip ) )
+      {
+        for ( const auto& ref : history( model, versions ) ) vh.append( ref.view() );
+      }
+
+      auto fail = bsoncxx::builder::basic::array{};
+      return document{} << "success" << success << "failure" << fail
+        << "history" << vh << finalize;
+    }
+
+    bsoncxx::document::view_or_value bulk( const model::Document& model )
+    {
+      using util::bsonValueIfExists;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      const auto doc = model.document();
+      const auto skip = model.skipVersion();
+      const auto options = model.options();
+
+      const auto insert = bsonValueIfExists<bsoncxx::array::view>( "insert", doc );
+      const auto rem = bsonValueIfExists<bsoncxx::array::view>( "remove", doc );
+      if ( !insert && !rem ) return model::withMessage( "Bulk insert missing arrays." );
+
+      auto ordered = true;
+      if ( options )
+      {
+        if ( const auto o = bsonValueIfExists<bool>( "ordered", *options ); o ) ordered = *o;
+      }
+
+      auto created = std::vector<bsoncxx::document::view>{};
+      auto removed = std::vector<bsoncxx::document::value>{};
+      auto failed = false;
+
+      {
+        auto coll = Store::instance().get( model.database(), model.collection() );
+        auto lock = std::unique_lock( coll->mutex );
+
+        if ( insert )
+        {
+          for ( const auto& e : *insert )
+          {
+            const auto dv = e.get_document().view();
+            const auto oid = bsonValueIfExists<bsoncxx::oid>( "_id", dv );
+            if ( !oid ) continue;
+
+            if ( coll->documents.try_emplace( *oid, dv ).second ) created.push_back( dv );
+            else
+            {
+              failed = true;
+              if ( ordered ) break;
+            }
+          }
+        }
+
+        if ( rem && !( failed && ordered ) )
+        {
+          for ( const auto& e : *rem )
+          {
+            for ( const auto& it : select( coll->documents, e.get_document().view(), 1 ) )
+            {
+              removed.push_back( std::move( it->second ) );
+              coll->documents.erase( it );
+            }
+          }
+        }
+      }
+
+      auto ihc = 0;
+      if ( !skip || !*skip )
+      {
+        auto versions = Versions{};
+        versions.reserve( created.size() + removed.size() );
+        for ( const auto& d : created ) versions.emplace_back( "create"sv, d );
+        for ( const auto& d : removed ) versions.emplace_back( "delete"sv, d.view() );
+        if ( !versions.empty() ) ihc = static_cast<int>( history( model, versions ).size() );
+      }
+
+      if ( failed )
+      {
+        LOG_WARN << "Error executing bulk statements";
+        return model::withMessage( "Error executing bulk statements." );
+      }
+
+      return document{} <<
+        "create" << static_cast<int32_t>( created.size() ) <<
+        "history" << ihc <<
+        "remove" << static_cast<int32_t>( removed.size() ) << finalize;
+    }
+
+    bsoncxx::document::view_or_value pipeline( const model::Document& model )
+    {
+      using util::bsonValueIfExists;
+      using bsoncxx::builder::stream::array;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      LOG_DEBUG << "Executing aggregation pipeline query";
+      const auto spec = bsonValueIfExists<bsoncxx::array::view>( "specification", model.document() );
+      if ( !spec )
+      {
+        LOG_WARN << "No aggregation specification";
+        return model::withMessage( "No aggregation specification." );
+      }
+
+      auto stages = std::vector<bsoncxx::document::element>{};
+      for ( const auto& s : *spec )
+      {
+        const auto stage = s.get_document().view();
+        if ( stage.begin() == stage.end() ) throw std::invalid_argument( "Empty pipeline stage" );
+        stages.push_back( *stage.begin() );
+      }
+
+      // A leading $match selects the documents to copy, making use of the _id index where possible
+      auto first = stages.begin();
+      auto filter = bsoncxx::document::view{};
+      if ( first != stages.end() && first->key() == "$match" )
+      {
+        filter = first->get_document().view();
+        ++first;
+      }
+
+      auto documents = copy( model.database(), model.collection(), filter );
+      for ( auto it = first; it != stages.end(); ++it )
+      {
+        const auto& stage = *it;
+        const auto name = stage.key();
+        if ( name == "$match" )
+        {
+          const auto f = stage.get_document().view();
+          std::erase_if( documents, [&f]( const auto& d ) { return !memory::matches( d.view(), f ); } );
+        }
+        else if ( name == "$sort" ) sort( documents, stage.get_document().view() );
+        else if ( name == "$skip" ) skip( documents, size( stage ) );
+        else if ( name == "$limit" ) limit( documents, size( stage ) );
+        else if ( name == "$project" ) project( documents, stage.get_document().view() );
+        else if ( name == "$count" )
+        {
+          const auto total = static_cast<int32_t>( documents.size() );
+          documents.clear();
+          if ( total > 0 ) documents.push_back( document{} << stage.get_string().value << total << finalize );
+        }
+        else throw std::invalid_argument( std::format( "Unsupported pipeline stage {}", name ) );
+      }
+
+      auto arr = array{};
+      for ( const auto& d : documents ) arr << d.view();
+      return document{} << "results" << ( arr << finalize ) << finalize;
+    }
+
+    bsoncxx::document::view_or_value index( const model::Document& model )
+    {
+      using util::bsonValueIfExists;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      LOG_INFO << "Ignoring index creation for memory engine " << model.json();
+
+      auto name = std::string{};
+      if ( const auto options = model.options(); options )
+      {
+        if ( const auto n = bsonValueIfExists<std::string>( "name", *options ); n ) name = *n;
+      }
+
+      if ( name.empty() )
+      {
+        for ( const auto& e : model.document() )
+        {
+          if ( !name.empty() ) name.push_back( '_' );
+          name.append( e.key() ).push_back( '_' );
+          switch ( e.type() )
+          {
+          case bsoncxx::type::k_string: name.append( e.get_string().value );
+            break;
+          case bsoncxx::type::k_int32: name.append( std::to_string( e.get_int32().value ) );
+            break;
+          case bsoncxx::type::k_int64: name.append( std::to_string( e.get_int64().value ) );
+            break;
+          case bsoncxx::type::k_double: name.append( std::format( "{}", e.get_double().value ) );
+            break;
+          default: name.append( "1" );
+          }
+        }
+      }
+
+      return document{} << "name" << name << finalize;
+    }
+
+    bsoncxx::document::view_or_value dropIndex( const model::Document& )
+    {
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+      return document{} << "dropIndex" << true << finalize;
+    }
+
+    bsoncxx::document::view_or_value transaction( const model::Document& model )
+    {
+      using util::bsonValue;
+      using util::bsonValueIfExists;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::open_document;
+      using bsoncxx::builder::stream::close_document;
+      using bsoncxx::builder::stream::finalize;
+
+      LOG_DEBUG << "Executing transaction";
+      const auto array = bsonValueIfExists<bsoncxx::array::view>( "items", model.document() );
+      if ( !array )
+      {
+        LOG_WARN << "No items array in transaction payload";
+        return model::missingField();
+      }
+
+      auto items = std::vector<model::Document>{};
+      for ( const auto& d : *array )
+      {
+        auto doc = model::Document{ d.get_document().view() };
+        if ( !doc.valid() )
+        {
+          if ( doc.bson() ) LOG_WARN << "Skipping invalid document in transaction array " << bsoncxx::to_json( *doc.bson() );
+          continue;
+        }
+
+        if ( !bsonValueIfExists<bsoncxx::oid>( "_id", doc.document() ) )
+        {
+          LOG_WARN << "Document id not specified " << doc.json();
+          return model::transactionError();
+        }
+
+        if ( isVersionHistory( doc.database(), doc.collection() ) )
+        {
+          LOG_WARN << "Attempting to modify version history in transaction " << doc.json();
+          return model::transactionError();
+        }
+
+        items.push_back( std::move( doc ) );
+      }
+
+      // Lock all the collections involved in namespace order, so that concurrent transactions cannot deadlock.
+      const auto& conf = model::Configuration::instance();
+      auto& store = Store::instance();
+      auto collections = std::map<std::string, std::shared_ptr<Collection>>{};
+      for ( const auto& item : items )
+      {
+        collections.try_emplace( Store::key( item.database(), item.collection() ), store.get( item.database(), item.collection() ) );
+      }
+      const auto vhkey = Store::key( conf.versionHistoryDatabase, conf.versionHistoryCollection );
+      collections.try_emplace( vhkey, store.get( conf.versionHistoryDatabase, conf.versionHistoryCollection ) );
+
+      auto locks = std::vector<std::unique_lock<std::shared_mutex>>{};
+      locks.reserve( collections.size() );
+      for ( auto& [_, c] : collections ) locks.emplace_back( c->mutex );
+
+      auto changes = memory::Changes{};
+      auto& versions = collections[vhkey]->documents;
+      const auto version = [&versions, &changes]( const model::Document& item, std::string_view action, bsoncxx::document::view entity )
+      {
+        const auto oid = bsoncxx::oid{};
+        changes.create( versions, oid, entry( oid, item.database(), item.collection(), action, entity, std::nullopt ) );
+        return oid;
+      };
+
+      auto vhidc = bsoncxx::builder::basic::array{};
+      auto vhidd = bsoncxx::builder::basic::array{};
+      auto created = 0;
+      auto updated = 0;
+      auto deleted = 0;
+
+      try
+      {
+        for ( const auto& item : items )
+        {
+          const auto dv = item.document();
+          const auto id = bsonValue<bsoncxx::oid>( "_id", dv );
+          const auto action = item.action();
+          const auto skip = item.skipVersion().value_or( false );
+          auto& documents = collections[Store::key( item.database(), item.collection() )]->documents;
+
+          if ( action == "create" )
+          {
+            if ( !changes.create( documents, id, bsoncxx::document::value{ dv } ) )
+            {
+              LOG_WARN << "Duplicate _id in transaction " << item.json();
+              changes.rollback();
+              return model::transactionError();
+            }
+
+            ++created;
+            if ( !skip ) vhidc.append( version( item, action, dv ) );
+          }
+          else if ( action == "update" )
+          {
+            if ( !changes.update( documents, id, bsoncxx::document::value{ dv } ) )
+            {
+              LOG_INFO_RATE( logRate ) << "No document to update in transaction " << item.json();
+              continue;
+            }
+
+            ++updated;
+            if ( !skip ) vhidc.append( version( item, action, dv ) );
+          }
+          else if ( action == "delete" )
+          {
+            for ( const auto& it : select( documents, dv ) )
+            {
+              if ( !skip ) vhidd.append( version( item, action, it->second.view() ) );
+              changes.erase( documents, it );
+              ++deleted;
+            }
+          }
+        }
+      }
+      catch ( ... )
+      {
+        changes.rollback();
+        throw;
+      }
+
+      return document{} <<
+        "created" << created <<
+        "updated" << updated <<
+        "deleted" << deleted <<
+        "history" <<
+          open_document <<
+            "database" << conf.versionHistoryDatabase <<
+            "collection" << conf.versionHistoryCollection <<
+            "created" << vhidc.extract() <<
+            "deleted" << vhidd.extract() <<
+          close_document <<
+        finalize;
+    }
+
+    bsoncxx::document::view_or_value createCollection( const model::Document& model )
+    {
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      if ( model.database().empty() ) return model::missingField();
+      if ( model.collection().empty() ) return model::missingField();
+
+      LOG_INFO << "Creating collection " << model.database() << ':' << model.collection();
+      if ( !Store::instance().create( model.database(), model.collection() ) )
+      {
+        LOG_WARN << "A collection " << model.collection() << " exists in database " << model.database();
+        return model::withMessage( "Collection exists in database"sv );
+      }
+
+      return document{} << "database"sv << model.database() << "collection"sv << model.collection() << finalize;
+    }
+
+    // Apply the function to the version history documents of the collection.
+    template <typename Function>
+    void versions( std::string_view database, std::string_view collection, Function&& function )
+    {
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      const auto& conf = model::Configuration::instance();
+      const auto vh = Store::instance().find( conf.versionHistoryDatabase, conf.versionHistoryCollection );
+      if ( !vh ) return;
+
+      const auto filter = document{} << "database"sv << database << "collection"sv << collection << finalize;
+      auto lock = std::unique_lock( vh->mutex );
+      const auto selected = select( vh->documents, filter.view() );
+      for ( const auto& it : selected ) function( vh->documents, it );
+      LOG_INFO << "Processed " << int( selected.size() ) << " version history documents for " << database << ':' << collection;
+    }
+
+    bsoncxx::document::view_or_value dropCollection( const model::Document& model )
+    {
+      using util::bsonValueIfExists;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::finalize;
+
+      LOG_INFO << "Dropping collection " << model.database() << ':' << model.collection();
+      Store::instance().drop( model.database(), model.collection() );
+
+      const auto clean = bsonValueIfExists<bool>( "clearVersionHistory", model.document() );
+      if ( clean && *clean )
+      {
+        versions( model.database(), model.collection(), []( Documents& documents, Documents::iterator it ) { documents.erase( it ); } );
+      }
+
+      return document{} << "dropCollection" << true << finalize;
+    }
+
+    bsoncxx::document::view_or_value renameCollection( const model::Document& model )
+    {
+      using util::bsonValueIfExists;
+      using bsoncxx::builder::stream::document;
+      using bsoncxx::builder::stream::open_document;
+      using bsoncxx::builder::stream::close_document;
+      using bsoncxx::builder::stream::finalize;
+
+      if ( model.database().empty() ) return model::missingField();
+      if ( model.collection().empty() ) return model::missingField();
+      const auto target = bsonValueIfExists<std::string>( "target"sv, model.document() );
+      if ( !target )
+      {
+        LOG_WARN << "No target collection name specified in document. " << model.json();
+        return model::missingField();
+      }
+
+      LOG_INFO << "Renaming collection " << model.database() << ':' << model.collection() << " to " <<
+        model.database() << ':' << *target;
+
+      auto& store = Store::instance();
+      if ( store.find( model.database(), *target ) )
+      {
+        LOG_WARN << "Target collection " << *target << " exists in database " << model.database();
+        return model::withMessage( "Target exists in database"sv );
+      }
+
+      if ( !store.rename( model.database(), model.collection(), *target ) )
+      {
+        LOG_WARN << "Unable to rename collection " << model.database() << ':' << model.collection() << " to " << *target;
+        return model::withMessage( std::format( "Error processing database action {}", model.action() ) );
+      }
+
+      const auto spec = document{} << "$set" << open_document << "collection"sv << *target << close_document << finalize;
+      versions( model.database(), model.collection(), [&spec]( Documents&, Documents::iterator it )
+      {
+        it->second = memory::update( it->second.view(), spec.view() );
+      } );
+
+      return document{} << "database"sv << model.database() << "collection"sv << *target << finalize;
+    }
+
+    bsoncxx::document::view_or_value dispatch( const model::Document& document )
+    {
+      const auto action = document.action();
+
+      if ( action == "create"sv ) return create( document );
+      if ( action == "update"sv ) return update( document );
+      if ( action == "retrieve"sv ) return retrieve( document );
+      if ( action == "delete"sv ) return remove( document );
+      if ( action == "count"sv ) return count( document );
+      if ( action == "index"sv ) return index( document );
+      if ( action == "dropIndex"sv ) return dropIndex( document );
+      if ( action == "bulk"sv ) return bulk( document );
+      if ( action == "pipeline"sv ) return pipeline( document );
+      if ( action == "transaction"sv ) return transaction( document );
+      if ( action == "distinct"sv ) return distinct( document );
+      if ( action == "createTimeseries"sv ) return createTimeseries( document );
+      if ( action == "dropCollection"sv ) return dropCollection( document );
+      if ( action == "createCollection"sv ) return createCollection( document );
+      if ( action == "renameCollection"sv ) return renameCollection( document );
+
+      LOG_INFO << "Invalid action " << action << " in document " << document.json();
+      return model::invalidAction();
+    }
+
+    struct Memory final : Engine
+    {
+      Memory()
+      {
+        LOG_WARN << "Using memory storage engine.  Data will not be persisted.";
+      }
+
+      awaitable<bsoncxx::document::view_or_value> process( const model::Document& document ) override
+      {
+        try
+        {
+          co_return dispatch( document );
+        }
+        catch ( const std::invalid_argument& ex )
+        {
+          LOG_WARN_RATE( errorLogRate ) << "Unsupported request for memory engine. " << ex.what();
+          co_return model::withMessage( ex.what() );
+        }
+        catch ( const std::exception& ex )
+        {
+          LOG_CRIT_RATE( errorLogRate ) << "Error processing database action " << document.action() << ". " << ex.what();
+          co_return model::unexpectedError();
+        }
+      }
+
+      // Documents generated by the service (metrics, rollups) are counted and discarded.  Storing them would
+      // grow memory with every request over a long load test, skewing the overhead being measured.
+      void save( const std::string& database, const std::string& collection,
+          std::vector<bsoncxx::document::value>&& documents ) override
+      {
+        const auto count = static_cast<uint64_t>( documents.size() );
+        const auto total = discarded.fetch_add( count, std::memory_order_relaxed ) + count;
+        LOG_INFO_RATE( 1 ) << "Discarded batch of " << count << " documents for " << database << ':' << collection <<
+          ". Total discarded " << total;
+      }
+
+    private:
+      std::atomic_uint64_t discarded{ 0 };
+    };
+  }
+}
+
+std::unique_ptr<spt::db::Engine> spt::db::engine::memory()
+{
+  return std::make_unique<pmemory::Memory>();
+}
@@ -2,12 +2,19 @@
 // Created by Rakesh on 26/06/2023.
 //
 
+#include "engine.hpp"
+#include "latencytracker.hpp"
 #include "metricscollector.hpp"
-#include "pool.hpp"
+#include "../model/rollup.hpp"
 #include "../../ilp/builder.hpp"
-#include "../../ilp/ilp.hpp"
+#include "../../ilp/asyncilp.hpp"
 
-#include <future>
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <map>
+#include <tuple>
+#include <boost/asio/executor_work_guard.hpp>
 #include <boost/asio/io_context.hpp>
 
 using spt::db::MetricsCollector;
@@ -26,17 +33,41 @@ namespace spt::db::pmetricscollector
     void save( std::string&& body )
     {
       client.write( std::move( body ) );
-      ioc.run();
     }
 
+    void flush()
+    {
+      using namespace std::literals::chrono_literals;
+      if ( !client.flush( 5s ) ) LOG_WARN << "Timed out flushing metrics to ILP service";
+
+      const auto stats = client.stats();
+      LOG_INFO << "ILP client sent " << int64_t( stats.batchesSent ) << " batches (" << int64_t( stats.bytesSent ) <<
+        " bytes), dropped " << int64_t( stats.batchesDropped ) << " batches (" << int64_t( stats.bytesDropped ) <<
+        " bytes), " << int64_t( stats.errors ) << " errors.";
+    }
+
+    ~Client()
+    {
+      guard.reset();
+      ioc.stop();
+      if ( thread.joinable() ) thread.join();
+    }
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+    Client(Client&&) = delete;
+    Client& operator=(Client&&) = delete;
+
   private:
-    Client() = default;
+    Client() : thread{ [this] { ioc.run(); } } {}
 
     boost::asio::io_context ioc;
-    ilp::ILPClient client{ ioc, model::Configuration::instance().ilp->server, model::Configuration::instance().ilp->port };
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> guard{ boost::asio::make_work_guard( ioc ) };
+    ilp::AsyncILPClient client{ ioc, model::Configuration::instance().ilp->server, model::Configuration::instance().ilp->port };
+    std::thread thread;
   };
 
-  void ilp( std::vector<model::Metric> vector )
+  void ilp( std::vector<model::Metric>&& vector )
   {
     if ( vector.empty() ) return;
     try
@@ -52,6 +83,12 @@ namespace spt::db::pmetricscollector
             addTag( "collection"sv, metric.collection ).
             addValue( "duration"sv, metric.duration.count() ).
             addValue( "size"sv, static_cast<uint64_t>( metric.size ) ).
+            addValue( "read"sv, metric.phases.read.count() ).
+            addValue( "validate"sv, metric.phases.validate.count() ).
+            addValue( "pool"sv, metric.phases.pool.count() ).
+            addValue( "operation"sv, metric.phases.operation.count() ).
+            addValue( "history"sv, metric.phases.history.count() ).
+            addValue( "write"sv, metric.phases.write.count() ).
             timestamp( std::chrono::duration_cast<std::chrono::nanoseconds>( metric.timestamp.time_since_epoch() ) );
 
         if ( metric.application ) builder.addTag( "application"sv, *metric.application );
@@ -62,7 +99,7 @@ namespace spt::db::pmetricscollector
       }
 
       Client::instance().save( builder.finish() );
-      LOG_INFO << "Saved batch of " << int(vector.size()) << " metrics to " << conf.ilp->server << ".";
+      LOG_INFO << "Queued batch of " << int(vector.size()) << " metrics to " << conf.ilp->server << ".";
     }
     catch ( const std::exception& ex )
     {
@@ -70,39 +107,172 @@ namespace spt::db::pmetricscollector
     }
   }
 
-  void mongo( std::vector<model::Metric> vector )
+  void ilp( std::vector<model::Rollup>&& vector )
   {
     if ( vector.empty() ) return;
     try
     {
-      auto cliento = Pool::instance().acquire();
-      if ( !cliento )
+      const auto& conf = model::Configuration::instance();
+      const auto name = std::format( "{}_rollup", conf.ilp->name );
+      auto builder = ilp::Builder{};
+
+      for ( const auto& rollup : vector )
       {
-        LOG_WARN << "Connection pool exhausted";
-        return;
+        builder.startRecord( name ).
+            addTag( "action"sv, rollup.action ).
+            addTag( "database"sv, rollup.database ).
+            addTag( "collection"sv, rollup.collection ).
+            addValue( "count"sv, rollup.count ).
+            addValue( "errors"sv, rollup.errors ).
+            addValue( "size"sv, rollup.size ).
+            addValue( "min"sv, rollup.histogram.min() ).
+            addValue( "mean"sv, rollup.histogram.mean() ).
+            addValue( "p50"sv, rollup.histogram.percentile( 50.0 ) ).
+            addValue( "p90"sv, rollup.histogram.percentile( 90.0 ) ).
+            addValue( "p99"sv, rollup.histogram.percentile( 99.0 ) ).
+            addValue( "p999"sv, rollup.histogram.percentile( 99.9 ) ).
+            addValue( "max"sv, rollup.histogram.max() ).
+            timestamp( std::chrono::duration_cast<std::chrono::nanoseconds>( rollup.end.time_since_epoch() ) );
+
+        if ( rollup.application ) builder.addTag( "application"sv, *rollup.application );
+        builder.endRecord();
       }
 
-      auto& client = *cliento;
+      Client::instance().save( builder.finish() );
+      LOG_INFO << "Queued batch of " << int(vector.size()) << " metric rollups to " << conf.ilp->server << ".";
+    }
+    catch ( const std::exception& ex )
+    {
+      LOG_WARN << "Error saving batch of metric rollups. " << ex.what();
+    }
+  }
+
+  void ilp( std::vector<model::Latency>&& vector )
+  {
+    if ( vector.empty() ) return;
+    try
+    {
       const auto& conf = model::Configuration::instance();
-      auto wl = mongocxx::write_concern{};
-      wl.acknowledge_level( mongocxx::write_concern::level::k_unacknowledged );
-      auto opts = mongocxx::options::bulk_write{};
-      opts.write_concern( wl );
-      auto bw = ( *client )[conf.metrics.database][conf.metrics.collection].create_bulk_write( opts );
+      const auto name = std::format( "{}_latency", conf.ilp->name );
+      auto builder = ilp::Builder{};
 
-      for ( const auto& metric : vector )
+      for ( const auto& latency : vector )
       {
-        bw.append( mongocxx::model::insert_one{ metric.bson() } );
+        builder.startRecord( name ).
+            addTag( "action"sv, latency.action ).
+            addTag( "database"sv, latency.database ).
+            addTag( "collection"sv, latency.collection ).
+            addValue( "count"sv, latency.histogram.count() ).
+            addValue( "min"sv, latency.histogram.min() ).
+            addValue( "mean"sv, latency.histogram.mean() ).
+            addValue( "p50"sv, latency.histogram.percentile( 50.0 ) ).
+            addValue( "p90"sv, latency.histogram.percentile( 90.0 ) ).
+            addValue( "p99"sv, latency.histogram.percentile( 99.0 ) ).
+            addValue( "p999"sv, latency.histogram.percentile( 99.9 ) ).
+            addValue( "max"sv, latency.histogram.max() ).
+            timestamp( std::chrono::duration_cast<std::chrono::nanoseconds>( latency.end.time_since_epoch() ) ).
+            endRecord();
       }
-      auto r = bw.execute();
-      if ( r ) LOG_INFO << "Saved batch of " << r->inserted_count() << " metrics.";
-      else LOG_INFO << "Saved batch of " << int(vector.size()) << " metrics.";
+
+      Client::instance().save( builder.finish() );
+      LOG_INFO << "Queued batch of " << int(vector.size()) << " latency histograms to " << conf.ilp->server << ".";
     }
     catch ( const std::exception& ex )
     {
-      LOG_WARN << "Error saving batch of metrics. " << ex.what();
+      LOG_WARN << "Error saving batch of latency histograms. " << ex.what();
     }
   }
+
+  template <typename M>
+  void mongo( std::vector<M>&& vector, const std::string& collection )
+  {
+    if ( vector.empty() ) return;
+    try
+    {
+      auto documents = std::vector<bsoncxx::document::value>{};
+      documents.reserve( vector.size() );
+      for ( const auto& metric : vector ) documents.push_back( metric.bson() );
+
+      Engine::instance().save( model::Configuration::instance().metrics.database, collection, std::move( documents ) );
+    }
+    catch ( const std::exception& ex )
+    {
+      LOG_WARN << "Error saving batch of documents to " << collection << ". " << ex.what();
+    }
+  }
+
+  /**
+   * Aggregates metrics by action, database, collection and application.  Only used from the flusher thread.
+   */
+  struct Rollups
+  {
+    explicit Rollups( int sampleRate ) : sampleRate{ sampleRate } {}
+
+    /**
+     * Aggregate the metrics in the batch starting at `from`.  Metrics for failed requests, and a sample of
+     * the successful requests are retained in the batch, the rest are removed.
+     */
+    void add( std::vector<model::Metric>& batch, std::size_t from )
+    {
+      auto out = batch.begin() + static_cast<std::ptrdiff_t>( from );
+      for ( auto it = out; it != batch.end(); ++it )
+      {
+        rollup( *it ).add( *it );
+
+        const auto keep = it->message || ( sampleRate > 0 && ++counter % static_cast<uint64_t>( sampleRate ) == 0 );
+        if ( !keep ) continue;
+        if ( out != it ) *out = std::move( *it );
+        ++out;
+      }
+
+      batch.erase( out, batch.end() );
+    }
+
+    /**
+     * Take the rollups for the current interval, and start the next interval.  All the rollups for an
+     * interval share the same start and end, so consecutive intervals tile without gaps.
+     */
+    [[nodiscard]] std::vector<model::Rollup> take()
+    {
+      const auto now = std::chrono::system_clock::now();
+      auto vector = std::vector<model::Rollup>{};
+      vector.reserve( rollups.size() );
+      for ( auto&& [_, r] : rollups )
+      {
+        r.end = now;
+        vector.push_back( std::move( r ) );
+      }
+
+      rollups.clear();
+      start = now;
+      return vector;
+    }
+
+  private:
+    using Key = std::tuple<std::string, std::string, std::string, std::optional<std::string>>;
+    using KeyView = std::tuple<std::string_view, std::string_view, std::string_view, std::optional<std::string_view>>;
+
+    model::Rollup& rollup( const model::Metric& metric )
+    {
+      const auto app = metric.application ? std::optional<std::string_view>{ *metric.application } : std::nullopt;
+      if ( auto iter = rollups.find( KeyView{ metric.action, metric.database, metric.collection, app } ); iter != rollups.end() ) return iter->second;
+
+      auto r = model::Rollup{};
+      r.action = metric.action;
+      r.database = metric.database;
+      r.collection = metric.collection;
+      r.application = metric.application;
+      r.start = start;
+      r.end = start;
+      auto [iter, _] = rollups.emplace( Key{ metric.action, metric.database, metric.collection, metric.application }, std::move( r ) );
+      return iter->second;
+    }
+
+    std::map<Key, model::Rollup, std::less<>> rollups;
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    uint64_t counter{ 0 };
+    int sampleRate;
+  };
 }
 
 MetricsCollector& MetricsCollector::instance()
@@ -111,38 +281,161 @@ MetricsCollector& MetricsCollector::instance()
   return mc;
 }
 
+MetricsCollector::MetricsCollector()
+{
+  const auto& conf = model::Configuration::instance();
+  const auto count = std::max( conf.threads, 1 );
+  const auto capacity = static_cast<std::size_t>( std::max( conf.metrics.bufferSize, conf.metrics.batchSize ) );
+
+  shards.reserve( count );
+  for ( auto i = 0; i < count; ++i ) shards.push_back( std::make_unique<Shard>( capacity ) );
+
+  flusher = std::thread{ &MetricsCollector::run, this };
+}
+
+MetricsCollector::~MetricsCollector()
+{
+  finish();
+}
+
+MetricsCollector::Shard& MetricsCollector::shard()
+{
+  static thread_local const std::size_t index = next.fetch_add( 1, std::memory_order_relaxed );
+  return *shards[index % shards.size()];
+}
+
 void MetricsCollector::add( model::Metric&& metric )
 {
-  auto lock = std::scoped_lock{ mutex };
-  vector.emplace_back( std::move( metric ) );
+  if ( stopped.load( std::memory_order_acquire ) || !shard().push( std::move( metric ) ) )
+  {
+    droppedCount.fetch_add( 1, std::memory_order_relaxed );
+    return;
+  }
+
+  const auto size = queued.fetch_add( 1, std::memory_order_relaxed ) + 1;
+  if ( static_cast<int>( size ) >= model::Configuration::instance().metrics.batchSize &&
+    !signalled.exchange( true, std::memory_order_acq_rel ) )
+  {
+    // Notify while holding the mutex so that the signal cannot be raised between the flusher
+    // evaluating the wait predicate and blocking, which would delay the flush until the deadline.
+    auto lock = std::scoped_lock{ mutex };
+    cv.notify_one();
+  }
+}
+
+std::size_t MetricsCollector::drain( std::vector<model::Metric>& batch )
+{
+  std::size_t count = 0;
+  for ( auto& s : shards )
+  {
+    while ( auto metric = s->pop() )
+    {
+      batch.push_back( std::move( *metric ) );
+      ++count;
+    }
+  }
+
+  queued.fetch_sub( count, std::memory_order_relaxed );
+  return count;
+}
+
+void MetricsCollector::run()
+{
   const auto& conf = model::Configuration::instance();
-  if ( static_cast<int>( vector.size() ) == conf.metrics.batchSize )
+  const auto interval = std::chrono::seconds{ std::max( conf.metrics.flushInterval, 1 ) };
+  const auto rollupInterval = std::chrono::seconds{ std::max( conf.metrics.rollupInterval, 0 ) };
+  const auto latencyInterval = std::chrono::seconds{ std::max( conf.metrics.latencyInterval, 0 ) };
+  const auto batchSize = static_cast<std::size_t>( std::max( conf.metrics.batchSize, 1 ) );
+
+  const auto save = [&conf]( std::vector<model::Metric>&& batch )
+  {
+    if ( conf.ilp ) pmetricscollector::ilp( std::move( batch ) );
+    else pmetricscollector::mongo( std::move( batch ), conf.metrics.collection );
+  };
+
+  const auto saveRollups = [&conf]( std::vector<model::Rollup>&& rollups )
   {
-    if ( conf.ilp )
+    if ( conf.ilp ) pmetricscollector::ilp( std::move( rollups ) );
+    else pmetricscollector::mongo( std::move( rollups ), std::format( "{}_rollup", conf.metrics.collection ) );
+  };
+
+  const auto saveLatencies = [&conf]( std::vector<model::Latency>&& latencies )
+  {
+    if ( conf.ilp ) pmetricscollector::ilp( std::move( latencies ) );
+    else pmetricscollector::mongo( std::move( latencies ), std::format( "{}_latency", conf.metrics.collection ) );
+  };
+
+  auto rollups = rollupInterval.count() > 0 ?
+    std::make_optional<pmetricscollector::Rollups>( conf.metrics.sampleRate ) : std::nullopt;
+  auto batch = std::vector<model::Metric>{};
+  batch.reserve( batchSize );
+  auto last = std::chrono::steady_clock::now();
+  auto lastRollup = last;
+  auto lastLatency = last;
+  uint64_t reported = 0;
+
+  for (;;)
+  {
+    const auto stopping = stopped.load( std::memory_order_acquire );
+    const auto from = batch.size();
+    drain( batch );
+    if ( rollups ) rollups->add( batch, from );
+
+    const auto now = std::chrono::steady_clock::now();
+    if ( batch.size() >= batchSize || ( !batch.empty() && ( stopping || now - last >= interval ) ) )
+    {
+      if ( stopping ) LOG_INFO << "Flushing " << int(batch.size()) << " metrics before exit";
+      save( std::move( batch ) );
+      batch = std::vector<model::Metric>{};
+      batch.reserve( batchSize );
+      last = now;
+    }
+    else if ( batch.empty() ) last = now;
+
+    if ( rollups && ( stopping || now - lastRollup >= rollupInterval ) )
     {
-      [[maybe_unused]] auto res = std::async( std::launch::async, pmetricscollector::ilp, std::move( vector ) );
+      saveRollups( rollups->take() );
+      lastRollup = now;
     }
-    else
+
+    if ( latencyInterval.count() > 0 && ( stopping || now - lastLatency >= latencyInterval ) )
+    {
+      saveLatencies( LatencyTracker::instance().collect() );
+      lastLatency = now;
+    }
+
+    if ( const auto d = dropped(); d != reported )
     {
-      [[maybe_unused]] auto res = std::async( std::launch::async, pmetricscollector::mongo, std::move( vector ) );
+      LOG_WARN << "Dropped " << static_cast<int64_t>( d - reported ) << " metrics due to full buffers. Total dropped " << static_cast<int64_t>( d );
+      reported = d;
     }
-    vector = std::vector<model::Metric>{};
-    vector.reserve( conf.metrics.batchSize );
+
+    if ( stopping )
+    {
+      if ( conf.ilp ) pmetricscollector::Client::instance().flush();
+      break;
+    }
+
+    auto deadline = last + interval;
+    if ( rollups ) deadline = std::min( deadline, lastRollup + rollupInterval );
+    if ( latencyInterval.count() > 0 ) deadline = std::min( deadline, lastLatency + latencyInterval );
+
+    auto lock = std::unique_lock{ mutex };
+    cv.wait_until( lock, deadline,
+      [this] { return signalled.load( std::memory_order_acquire ) || stopped.load( std::memory_order_acquire ); } );
+    signalled.store( false, std::memory_order_release );
   }
 }
 
 void MetricsCollector::finish()
 {
-  LOG_INFO << "Flushing " << int(vector.size()) << " metrics before exit";
-  const auto& conf = model::Configuration::instance();
-  if ( conf.ilp )
-  {
-    auto res = std::async( std::launch::async, pmetricscollector::ilp, std::move( vector ) );
-    res.wait();
-  }
-  else
+  if ( stopped.exchange( true, std::memory_order_acq_rel ) ) return;
+
   {
-    auto res = std::async( std::launch::async, pmetricscollector::mongo, std::move( vector ) );
-    res.wait();
+    auto lock = std::scoped_lock{ mutex };
+    cv.notify_one();
   }
-}
\ No newline at end of file
+
+  if ( flusher.joinable() ) flusher.join();
+  LOG_INFO << "Metrics collector stopped";
+}
@@ -6,17 +6,28 @@
 
 #include "../model/configuration.hpp"
 #include "../model/metric.hpp"
+#include "../../common/util/ringbuffer.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 namespace spt::db
 {
+  /**
+   * Collects metrics generated by the request handlers.  Metrics are staged in per-thread
+   * shards of bounded lock-free ring buffers, and drained by a single long lived flusher thread.
+   * The flusher saves a batch when it reaches the configured batch size, or when the configured
+   * flush interval has elapsed.  Metrics are dropped (and counted) if a shard is full.
+   */
   struct MetricsCollector
   {
     static MetricsCollector& instance();
 
-    ~MetricsCollector() = default;
+    ~MetricsCollector();
     MetricsCollector( MetricsCollector&& ) = delete;
     MetricsCollector& operator=( MetricsCollector&& ) = delete;
 
@@ -24,12 +35,34 @@ namespace spt::db
     MetricsCollector& operator=( const MetricsCollector& ) = delete;
 
     void add( model::Metric&& metric );
+
+    /**
+     * Stop the flusher thread after it has saved all the staged metrics.  Safe to invoke multiple times.
+     */
     void finish();
 
+    /**
+     * @return The total number of metrics dropped since startup due to full buffers.
+     */
+    [[nodiscard]] uint64_t dropped() const { return droppedCount.load( std::memory_order_relaxed ); }
+
   private:
-    MetricsCollector() { vector.reserve( model::Configuration::instance().metrics.batchSize ); }
+    MetricsCollector();
+
+    using Shard = util::RingBuffer<model::Metric>;
+
+    Shard& shard();
+    void run();
+    std::size_t drain( std::vector<model::Metric>& batch );
 
+    std::vector<std::unique_ptr<Shard>> shards{};
     std::mutex mutex{};
-    std::vector<model::Metric> vector{};
+    std::condition_variable cv{};
+    std::atomic<std::size_t> queued{ 0 };
+    std::atomic<std::size_t> next{ 0 };
+    std::atomic<uint64_t> droppedCount{ 0 };
+    std::atomic_bool signalled{ false };
+    std::atomic_bool stopped{ false };
+    std::thread flusher{};
   };
-}
\ No newline at end of file
+}
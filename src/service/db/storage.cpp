@@ -2,6 +2,9 @@
 // Created by Rakesh on 20/07/2020.
 //
 
+#include "bulk.hpp"
+#include "engine.hpp"
+#include "latencytracker.hpp"
 #include "metricscollector.hpp"
 #include "storage.hpp"
 #include "pool.hpp"
@@ -15,12 +18,18 @@
 #include <bsoncxx/json.hpp>
 #include <bsoncxx/builder/stream/array.hpp>
 #include <bsoncxx/builder/stream/document.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
 #include <mongocxx/exception/bulk_write_exception.hpp>
 #include <mongocxx/exception/logic_error.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <format>
+#include <random>
 #include <ranges>
+#include <span>
 #include <vector>
 
 namespace
@@ -31,11 +40,25 @@ namespace
     using namespace spt::db;
     using boost::asio::awaitable;
 
-    awaitable<bsoncxx::document::view_or_value> history( bsoncxx::document::view view, mongocxx::pool::entry& client,
-        std::optional<bsoncxx::document::view> metadata = std::nullopt )
+    // Maximum number of lines written per second by each per-document log statement.
+    constexpr uint32_t logRate = 100;
+    // Maximum number of lines written per second by each error log statement.
+    constexpr uint32_t errorLogRate = 10;
+    // Maximum number of full request documents logged per second by each error path.
+    constexpr uint32_t documentLogRate = 1;
+
+    std::optional<mongocxx::pool::entry> acquire( const model::Document& request )
+    {
+      auto timer = model::Phases::Timer{ request.phases().pool };
+      return Pool::instance().acquire();
+    }
+
+    awaitable<bsoncxx::document::view_or_value> history( const model::Document& request, bsoncxx::document::view view,
+        mongocxx::pool::entry& client, std::optional<bsoncxx::document::view> metadata = std::nullopt )
     {
       using util::bsonValue;
 
+      auto timer = model::Phases::Timer{ request.phases().history };
       using bsoncxx::builder::stream::document;
       using bsoncxx::builder::stream::finalize;
 
@@ -60,7 +83,7 @@ namespace
       {
         if ( vr )
         {
-          LOG_INFO <<
+          LOG_INFO_RATE( logRate ) <<
             "Created version for " << dbname << ':' << collname << ':' <<
             id.to_string() << " with id: " << oid.to_string();
           co_return document{} << "_id" << oid <<
@@ -68,13 +91,13 @@ namespace
             "collection" << conf.versionHistoryCollection <<
             "entity" << id << finalize;
         }
-        LOG_WARN
+        LOG_WARN_RATE( logRate )
           << "Unable to create version for " << dbname << ':' << collname
           << ':' << id.to_string();
       }
       else
       {
-        LOG_INFO
+        LOG_INFO_RATE( logRate )
           << "Created version for " << dbname << ':' << collname << ':' <<
           id.to_string() << " with id: " << oid.to_string();
         co_return document{} << "_id" << oid <<
@@ -135,7 +158,7 @@ namespace
       const auto options = model.options();
 
       LOG_INFO << "Creating index " << model.json();
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -160,7 +183,7 @@ namespace
       const auto collname = model.collection();
       const auto options = model.options();
 
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -236,7 +259,7 @@ namespace
         if ( const auto rp = bsonValueIfExists<bsoncxx::document::view>( "readPreference", *opts ); rp ) options.read_preference( readPreference(  *rp ) );
       }
 
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -271,7 +294,7 @@ namespace
         if ( const auto rp = bsonValueIfExists<bsoncxx::document::view>( "readPreference", *opts ); rp ) options.read_preference( readPreference(  *rp ) );
       }
 
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -333,7 +356,7 @@ namespace
       const auto id = bsonValue<bsoncxx::oid>( "_id", doc );
       const auto opts = findOpts( model );
 
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -366,7 +389,7 @@ namespace
       }
 
       const auto opts = findOpts( model );
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -416,7 +439,7 @@ namespace
       const auto idopt = bsonValueIfExists<bsoncxx::oid>( "_id", doc );
       if ( !idopt ) co_return model::missingId();
 
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( document );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -433,7 +456,7 @@ namespace
       {
         if ( result )
         {
-          LOG_INFO << "Created document " << dbname << ':' << collname << ':' << idopt->to_string();
+          LOG_INFO_RATE( logRate ) << "Created document " << dbname << ':' << collname << ':' << idopt->to_string();
           const auto nv = document.skipVersion();
           if ( nv && *nv )
           {
@@ -441,17 +464,17 @@ namespace
               "_id" << *idopt <<
               "skipVersion" << true << bsoncxx::builder::stream::finalize;
           }
-          co_return co_await history( *document.bson(), client, metadata );
+          co_return co_await history( document, *document.bson(), client, metadata );
         }
         else
         {
-          LOG_WARN << "Unable to create document " << dbname << ':' << collname
+          LOG_WARN_RATE( logRate ) << "Unable to create document " << dbname << ':' << collname
             << ':' << idopt->to_string();
         }
       }
       else
       {
-        LOG_INFO << "Created document " << dbname << ':' << collname << ':' << idopt->to_string();
+        LOG_INFO_RATE( logRate ) << "Created document " << dbname << ':' << collname << ':' << idopt->to_string();
         const auto nv = document.skipVersion();
         if ( nv && *nv )
         {
@@ -459,7 +482,7 @@ namespace
             "_id" << *idopt <<
             "skipVersion" << true << bsoncxx::builder::stream::finalize;
         }
-        co_return co_await history( *document.bson(), client, metadata );
+        co_return co_await history( document, *document.bson(), client, metadata );
       }
 
       co_return model::insertError();
@@ -482,7 +505,7 @@ namespace
 
       const auto idopt = bsonValueIfExists<bsoncxx::oid>( "_id", doc );
 
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( document );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -605,7 +628,7 @@ namespace
       const auto skip = model.skipVersion();
 
       auto opts = updateOptions( model );
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -626,7 +649,7 @@ namespace
           co_return bsoncxx::document::value{ updated.value() };
         }
 
-        auto d = co_await history( document{} <<
+        auto d = co_await history( model, document{} <<
           "action" << action <<
           "database" << dbname <<
           "collection" << collname <<
@@ -645,17 +668,17 @@ namespace
         {
           if ( result->upserted_count() > 0 )
           {
-            LOG_INFO << "Upserted document " << dbname << ':' << collname << ':' << oid.to_string();
+            LOG_INFO_RATE( logRate ) << "Upserted document " << dbname << ':' << collname << ':' << oid.to_string();
             co_return co_await vhd( "create" );
           }
-          LOG_INFO << "Updated document " << dbname << ':' << collname << ':' << oid.to_string();
+          LOG_INFO_RATE( logRate ) << "Updated document " << dbname << ':' << collname << ':' << oid.to_string();
           co_return co_await vhd();
         }
-        LOG_WARN << "Unable to update document " << dbname << ':' << collname << ':' << oid.to_string();
+        LOG_WARN_RATE( logRate ) << "Unable to update document " << dbname << ':' << collname << ':' << oid.to_string();
       }
       else
       {
-        LOG_INFO << "Updated document " << dbname << ':' << collname << ':' << oid.to_string();
+        LOG_INFO_RATE( logRate ) << "Updated document " << dbname << ':' << collname << ':' << oid.to_string();
         co_return co_await vhd();
       }
 
@@ -678,7 +701,7 @@ namespace
       const auto filter = bsonValue<bsoncxx::document::view>( "filter", doc );
 
       auto opts = updateOptions( model );
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -699,7 +722,7 @@ namespace
           co_return bsoncxx::document::value{ updated.value() };
         }
 
-        auto vhd = co_await history( document{} <<
+        auto vhd = co_await history( model, document{} <<
           "action" << action <<
           "database" << dbname <<
           "collection" << collname <<
@@ -719,18 +742,18 @@ namespace
         {
           if ( result->upserted_count() > 0 )
           {
-            LOG_INFO << "Upserted document " << dbname << ':' << collname << ':' << oid.to_string();
+            LOG_INFO_RATE( logRate ) << "Upserted document " << dbname << ':' << collname << ':' << oid.to_string();
             co_return co_await vhd( "create" );
           }
-          LOG_INFO << "Updated document " << dbname << ':' << collname << ':' << oid.to_string();
+          LOG_INFO_RATE( logRate ) << "Updated document " << dbname << ':' << collname << ':' << oid.to_string();
           co_return co_await vhd();
         }
-        LOG_WARN << "Unable to update document " << dbname << ':' << collname
+        LOG_WARN_RATE( logRate ) << "Unable to update document " << dbname << ':' << collname
           << ':' << oid.to_string();
       }
       else
       {
-        LOG_INFO << "Updated document " << dbname << ':' << collname << ':' << oid.to_string();
+        LOG_INFO_RATE( logRate ) << "Updated document " << dbname << ':' << collname << ':' << oid.to_string();
         co_return co_await vhd();
       }
 
@@ -754,7 +777,7 @@ namespace
       const auto oid = bsonValueIfExists<bsoncxx::oid>( "_id", replace );
       const auto skip = model.skipVersion();
 
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -782,7 +805,7 @@ namespace
 
         if ( oid )
         {
-          auto vhd = co_await history( document{} <<
+          auto vhd = co_await history( model, document{} <<
             "action" << action <<
             "database" << dbname <<
             "collection" << collname <<
@@ -801,7 +824,7 @@ namespace
           co_return model::notFound();
         }
 
-        auto d = co_await history( document{} <<
+        auto d = co_await history( model, document{} <<
           "action" << "replace" <<
           "database" << dbname <<
           "collection" << collname <<
@@ -876,7 +899,7 @@ namespace
         }
       }
 
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -909,7 +932,7 @@ namespace
         {
           const auto res = ( *client )[dbname][collname].find_one( document{} << "_id" << id << finalize );
           if ( !res ) continue;
-          auto vhd = co_await history( document{} << "action" << "update" <<
+          auto vhd = co_await history( model, document{} << "action" << "update" <<
             "database" << dbname << "collection" << collname <<
             "document" << res->view() << finalize,
             client, metadata );
@@ -976,7 +999,7 @@ namespace
         if ( auto co = bsonValueIfExists<bsoncxx::document::view>( "let", *options ); co ) opts.let( *co );
       }
 
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -1009,7 +1032,7 @@ namespace
 
           if ( metadata ) vdoc << "metadata" << *metadata;
 
-          auto vhdr = co_await history( vdoc << finalize, client, metadata );
+          auto vhdr = co_await history( model, vdoc << finalize, client, metadata );
           vh.append( vhdr );
           co_return true;
         };
@@ -1021,19 +1044,19 @@ namespace
         {
           if ( res )
           {
-            LOG_INFO << "Deleted document " << dbname << ':' << collname << ':' << oid.to_string();
+            LOG_INFO_RATE( logRate ) << "Deleted document " << dbname << ':' << collname << ':' << oid.to_string();
             success.append( oid );
             co_await vhd( d );
           }
           else
           {
-            LOG_WARN << "Unable to delete document " << dbname << ':' << collname << ':' << oid.to_string();
+            LOG_WARN_RATE( logRate ) << "Unable to delete document " << dbname << ':' << collname << ':' << oid.to_string();
             fail.append( oid );
           }
         }
         else
         {
-          LOG_INFO << "Deleted document " << dbname << ':' << collname << ':' << oid.to_string();
+          LOG_INFO_RATE( logRate ) << "Deleted document " << dbname << ':' << collname << ':' << oid.to_string();
           success.append( oid );
           co_await vhd( d );
         }
@@ -1051,6 +1074,58 @@ namespace
         << "history" << vh << finalize;
     }
 
+    bulk::Result executeChunk( mongocxx::pool::entry& client, const std::string& dbname, const std::string& collname,
+        std::span<const mongocxx::model::write> ops, const mongocxx::options::bulk_write& opts )
+    {
+      auto result = bulk::Result{};
+      if ( ops.empty() ) return result;
+
+      auto bw = ( *client )[dbname][collname].create_bulk_write( opts );
+      for ( const auto& op : ops ) bw.append( op );
+
+      auto r = bw.execute();
+      if ( !client->write_concern().is_acknowledged() ) return result;
+      if ( !r )
+      {
+        result.failed = true;
+        return result;
+      }
+
+      result.inserted = r->inserted_count();
+      result.deleted = r->deleted_count();
+      return result;
+    }
+
+    bulk::Result executeBulk( mongocxx::pool::entry& client, const std::string& dbname, const std::string& collname,
+        const std::vector<mongocxx::model::write>& ops, bool ordered )
+    {
+      const auto& conf = model::Configuration::instance().bulk;
+      auto opts = mongocxx::options::bulk_write{};
+      opts.ordered( ordered );
+
+      const auto size = static_cast<std::size_t>( std::max( conf.chunkSize, 0 ) );
+      if ( ordered || size == 0 || ops.size() <= size || conf.parallelism < 2 )
+      {
+        return executeChunk( client, dbname, collname, ops, opts );
+      }
+
+      const auto parallelism = static_cast<std::size_t>( conf.parallelism );
+      LOG_INFO << "Executing " << int( ops.size() ) << " bulk operations against " << dbname << ':' << collname <<
+        " in chunks of " << int( size ) << " using up to " << int( parallelism ) << " connections";
+
+      return bulk::execute( std::span{ ops }, size, parallelism, client,
+        [&dbname, &collname]
+        {
+          auto cliento = Pool::instance().acquire();
+          if ( !cliento ) LOG_WARN << "Connection pool exhausted, deferring bulk chunks for " << dbname << ':' << collname;
+          return cliento;
+        },
+        [&]( mongocxx::pool::entry& c, std::span<const mongocxx::model::write> chunk )
+        {
+          return executeChunk( c, dbname, collname, chunk, opts );
+        } );
+    }
+
     awaitable<bsoncxx::document::view_or_value> bulk( const model::Document& model )
     {
       using bsoncxx::builder::stream::document;
@@ -1062,6 +1137,7 @@ namespace
       const auto collname = model.collection();
       const auto metadata = model.metadata();
       const auto skip = model.skipVersion();
+      const auto options = model.options();
 
       const auto insert = bsonValueIfExists<bsoncxx::array::view>( "insert", doc );
       auto icount = 0;
@@ -1071,7 +1147,13 @@ namespace
 
       if ( !insert && !rem ) co_return model::withMessage( "Bulk insert missing arrays." );
 
-      auto cliento = Pool::instance().acquire();
+      auto ordered = true;
+      if ( options )
+      {
+        if ( const auto o = bsonValueIfExists<bool>( "ordered", *options ); o ) ordered = *o;
+      }
+
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -1080,8 +1162,8 @@ namespace
 
       auto& client = *cliento;
       const auto& conf = model::Configuration::instance();
-      auto bw = ( *client )[dbname][collname].create_bulk_write();
-      auto bwh = ( *client )[conf.versionHistoryDatabase][conf.versionHistoryCollection].create_bulk_write();
+      std::vector<mongocxx::model::write> ops;
+      std::vector<mongocxx::model::write> hops;
       std::vector<bsoncxx::document::value> histv;
 
       if ( insert )
@@ -1092,7 +1174,7 @@ namespace
           const auto oid = util::bsonValueIfExists<bsoncxx::oid>( "_id", dv );
           if ( oid )
           {
-            bw.append( mongocxx::model::insert_one{ dv } );
+            ops.emplace_back( mongocxx::model::insert_one{ dv } );
             ++icount;
           }
         }
@@ -1100,6 +1182,7 @@ namespace
         if ( !skip || !*skip )
         {
           histv.reserve( icount );
+          hops.reserve( icount );
 
           for ( const auto& e : *insert )
           {
@@ -1116,7 +1199,7 @@ namespace
                 "created" << bsoncxx::types::b_date{ std::chrono::system_clock::now() };
               if ( metadata ) d << "metadata" << *metadata;
               histv.emplace_back( d << finalize );
-              bwh.append( mongocxx::model::insert_one{ histv.back().view() } );
+              hops.emplace_back( mongocxx::model::insert_one{ histv.back().view() } );
               ++ihcount;
             }
           }
@@ -1127,7 +1210,7 @@ namespace
       {
         for ( const auto& e : *rem )
         {
-          bw.append( mongocxx::model::delete_one{ e.get_document().view() } );
+          ops.emplace_back( mongocxx::model::delete_one{ e.get_document().view() } );
           ++rcount;
         }
 
@@ -1149,39 +1232,36 @@ namespace
                 "created" << bsoncxx::types::b_date{ std::chrono::system_clock::now() };
               if ( metadata ) vhd << "metadata" << *metadata;
               histv.emplace_back( vhd << finalize );
-              bwh.append( mongocxx::model::insert_one{ histv.back().view() } );
+              hops.emplace_back( mongocxx::model::insert_one{ histv.back().view() } );
               ++ihcount;
             }
           }
         }
       }
 
-      auto r = bw.execute();
+      const auto r = executeBulk( client, dbname, collname, ops, ordered );
       auto ihc = 0;
       if ( !skip || !*skip )
       {
-        if ( !histv.empty() )
+        if ( !hops.empty() )
         {
-          auto rh = bwh.execute();
-          if ( client->write_concern().is_acknowledged() )
-          {
-            ihc = rh->inserted_count();
-          }
+          auto timer = model::Phases::Timer{ model.phases().history };
+          ihc = executeBulk( client, conf.versionHistoryDatabase, conf.versionHistoryCollection, hops, ordered ).inserted;
         }
       }
 
       if ( client->write_concern().is_acknowledged() )
       {
-        if ( !r )
+        if ( r.failed )
         {
           LOG_WARN << "Error executing bulk statements";
           co_return model::withMessage( "Error executing bulk statements." );
         }
 
         co_return document{} <<
-          "create" << r->inserted_count() <<
+          "create" << r.inserted <<
           "history" << ihc <<
-          "remove" << r->deleted_count() << finalize;
+          "remove" << r.deleted << finalize;
       }
 
       co_return document{} <<
@@ -1214,7 +1294,7 @@ namespace
       auto pipeline = mongocxx::pipeline{};
       for ( const auto& s : *spec ) pipeline.append_stage( s.get_document().view() );
 
-      auto cliento = Pool::instance().acquire();
+      auto cliento = acquire( model );
       if ( !cliento )
       {
         LOG_WARN << "Connection pool exhausted";
@@ -1269,52 +1349,121 @@ namespace
       }
       catch ( const mongocxx::bulk_write_exception& be )
       {
-        LOG_CRIT << "Error processing database action " << document.action() <<
+        LOG_CRIT_RATE( errorLogRate ) << "Error processing database action " << document.action() <<
          " code: " << be.code().message() << ", message: " << be.what();
-        LOG_INFO << document.json();
+        LOG_INFO_RATE( documentLogRate ) << document.json();
 
         co_return model::withMessage( std::format( "Error processing database action {}", document.action() ) );
       }
       catch ( const mongocxx::logic_error& le )
       {
-        LOG_CRIT << "Error processing database action " << document.action() <<
+        LOG_CRIT_RATE( errorLogRate ) << "Error processing database action " << document.action() <<
          " code: " << le.code().message() << ", message: " << le.what();
-        LOG_INFO << document.json();
+        LOG_INFO_RATE( documentLogRate ) << document.json();
 
         co_return model::withMessage( std::format( "Error processing database action {}", document.action() ) );
       }
       catch ( const mongocxx::operation_exception& oe )
       {
-        LOG_CRIT << "Error processing database action " << document.action() <<
+        LOG_CRIT_RATE( errorLogRate ) << "Error processing database action " << document.action() <<
           " code: " << oe.code().message() << ", message: " << oe.what();
-        LOG_INFO << document.json();
+        LOG_INFO_RATE( documentLogRate ) << document.json();
 
         co_return model::withMessage( std::format( "Error processing database action {}", document.action() ) );
       }
       catch ( const std::exception& ex )
       {
-        LOG_CRIT << "Error processing database action " << document.action() << ". " << ex.what();
-        LOG_INFO << document.json();
+        LOG_CRIT_RATE( errorLogRate ) << "Error processing database action " << document.action() << ". " << ex.what();
+        LOG_INFO_RATE( documentLogRate ) << document.json();
         co_return model::unexpectedError();
       }
     }
+
+    struct Mongo final : Engine
+    {
+      awaitable<bsoncxx::document::view_or_value> process( const model::Document& document ) override
+      {
+        co_return co_await pstorage::process( document );
+      }
+
+      void save( const std::string& database, const std::string& collection,
+          std::vector<bsoncxx::document::value>&& documents ) override
+      {
+        auto cliento = Pool::instance().acquire();
+        if ( !cliento )
+        {
+          LOG_WARN << "Connection pool exhausted";
+          return;
+        }
+
+        auto& client = *cliento;
+        auto wl = mongocxx::write_concern{};
+        wl.acknowledge_level( mongocxx::write_concern::level::k_unacknowledged );
+        auto opts = mongocxx::options::bulk_write{};
+        opts.write_concern( wl );
+        auto bw = ( *client )[database][collection].create_bulk_write( opts );
+
+        for ( auto& d : documents ) bw.append( mongocxx::model::insert_one{ std::move( d ) } );
+        auto r = bw.execute();
+        if ( r ) LOG_INFO << "Saved batch of " << r->inserted_count() << " documents to " << collection << '.';
+        else LOG_INFO << "Saved batch of " << int(documents.size()) << " documents to " << collection << '.';
+      }
+    };
+
+    // Simulate a slower backend by suspending the request for the configured latency and random jitter.
+    awaitable<void> delay( const model::Configuration::Storage& conf )
+    {
+      static thread_local auto engine = std::minstd_rand{ std::random_device{}() };
+      auto us = std::max( conf.latency, 0 );
+      if ( conf.jitter > 0 ) us += std::uniform_int_distribution<int>{ 0, conf.jitter }( engine );
+
+      auto timer = boost::asio::steady_timer{ co_await boost::asio::this_coro::executor, std::chrono::microseconds{ us } };
+      co_await timer.async_wait( boost::asio::use_awaitable );
+    }
   }
 }
 
-boost::asio::awaitable<bsoncxx::document::view_or_value> spt::db::process( const model::Document& document )
+std::unique_ptr<spt::db::Engine> spt::db::engine::mongo()
 {
-  using util::bsonValueIfExists;
+  return std::make_unique<pstorage::Mongo>();
+}
 
+boost::asio::awaitable<bsoncxx::document::view_or_value> spt::db::process( const model::Document& document )
+{
+  auto& phases = document.phases();
+  const auto& storage = model::Configuration::instance().storage;
   const auto st = std::chrono::steady_clock::now();
-  auto value = co_await pstorage::process( document );
+  if ( storage.latency > 0 || storage.jitter > 0 ) co_await pstorage::delay( storage );
+  auto value = co_await Engine::instance().process( document );
   const auto et = std::chrono::steady_clock::now();
-  const auto delta = std::chrono::duration_cast<std::chrono::nanoseconds>( et - st );
+  phases.duration = std::chrono::duration_cast<std::chrono::nanoseconds>( et - st );
+  phases.operation = std::max( phases.duration - phases.pool - phases.history, std::chrono::nanoseconds{ 0 } );
+
+  if ( model::Configuration::instance().metrics.latencyInterval > 0 )
+  {
+    LatencyTracker::instance().record( document.action(), document.database(), document.collection(), phases.duration );
+  }
+
+  co_return value;
+}
+
+void spt::db::record( const model::Document& document, bsoncxx::document::view response )
+{
+  using util::bsonValueIfExists;
+
+  auto skip = document.skipMetric();
+  if ( skip && *skip )
+  {
+    LOG_INFO << "Skipping metric " << document.json();
+    return;
+  }
 
   auto metric = model::Metric{};
   metric.action = document.action();
   metric.database = document.database();
   metric.collection = document.collection();
-  metric.duration = delta;
+  metric.phases = document.phases();
+  metric.duration = metric.phases.duration;
 
   auto doc = document.document();
   if ( doc.find( "_id" ) != doc.end() && bsoncxx::type::k_oid == doc["_id"].type() )
@@ -1324,12 +1473,8 @@ boost::asio::awaitable<bsoncxx::document::view_or_value> spt::db::process( const
 
   metric.application = document.application();
   metric.correlationId = document.correlationId();
-  metric.message = bsonValueIfExists<std::string>( "error", value.view() );
-  metric.size = value.view().length();
-
-  auto skip = document.skipMetric();
-  if ( skip && *skip ) LOG_INFO << "Skipping metric " << document.json();
-  else MetricsCollector::instance().add( std::move( metric ) );
+  metric.message = bsonValueIfExists<std::string>( "error", response );
+  metric.size = response.length();
 
-  co_return value;
+  MetricsCollector::instance().add( std::move( metric ) );
 }
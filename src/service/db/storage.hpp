@@ -11,4 +11,12 @@
 namespace spt::db
 {
   boost::asio::awaitable<bsoncxx::document::view_or_value> process( const spt::model::Document& document );
+
+  /**
+   * Record the metric for a processed request.  Invoked once the response has been written to the
+   * client (or writing failed), so that all the phase timings for the request are available.
+   * @param document The request that was processed.
+   * @param response The response that was sent to the client.
+   */
+  void record( const spt::model::Document& document, bsoncxx::document::view response );
 }
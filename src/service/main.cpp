@@ -10,6 +10,7 @@
 
 #include <mongocxx/instance.hpp>
 
+#include <filesystem>
 #include <iostream>
 
 int main( int argc, char const * const * argv )
@@ -19,6 +20,7 @@ int main( int argc, char const * const * argv )
   auto& config = spt::model::Configuration::instance();
   bool console = false;
   bool async = true;
+  bool binaryLog = false;
   int logBuffer{ 3 };
   std::string dir{"logs/"};
   bool help = false;
@@ -33,6 +35,21 @@ int main( int argc, char const * const * argv )
       Opt(config.metrics.database, "metricDatabase")["-s"]["--metric-database"]("MongoDB database to store metrics generated by service (default versionHistory).") |
       Opt(config.metrics.collection, "metricCollection")["-t"]["--metric-collection"]("MongoDB collection to store metrics generated by service (default metrics).") |
       Opt(config.metrics.batchSize, "metricBatchSize")["-w"]["--metric-batch-size"]("Number of metrics to accumulate before storing. (default 100).") |
+      Opt(config.metrics.flushInterval, "metricFlushInterval")["-f"]["--metric-flush-interval"]("Maximum number of seconds to hold a partial batch of metrics before storing. (default 30).") |
+      Opt(config.metrics.bufferSize, "metricBufferSize")["-q"]["--metric-buffer-size"]("Number of metrics to buffer per I/O thread before dropping. (default 8192).") |
+      Opt(config.metrics.rollupInterval, "metricRollupInterval")["-r"]["--metric-rollup-interval"]("Interval in seconds over which metrics are aggregated.  Raw metrics are only stored for errors and sampled requests. (default 0 - disabled).") |
+      Opt(config.metrics.sampleRate, "metricSampleRate")["-g"]["--metric-sample-rate"]("Store raw metrics for 1 in N successful requests when rolling up metrics. (default 0 - none).") |
+      Opt(config.metrics.latencyInterval, "metricLatencyInterval")["-u"]["--metric-latency-interval"]("Interval in seconds at which latency percentiles per action and collection are stored. (default 0 - disabled).") |
+      Opt(config.bulk.chunkSize, "bulkChunkSize")["-k"]["--bulk-chunk-size"]("Number of unordered bulk operations above which requests are split into chunks and executed in parallel (default 0 - disabled).") |
+      Opt(config.bulk.parallelism, "bulkParallelism")["-j"]["--bulk-parallelism"]("Maximum number of pooled connections used to execute chunked bulk requests (default 4).") |
+      Opt(config.storage.engine, "mongo")["--storage-engine"]("Storage engine to use [mongo|memory].  The memory engine does not persist data, and is meant for benchmarking the service (default mongo).") |
+      Opt(config.storage.latency, "0")["--storage-latency"]("Latency in microseconds added to each database operation to simulate a slower backend (default 0).") |
+      Opt(config.storage.jitter, "0")["--storage-jitter"]("Maximum random latency in microseconds added to each database operation in addition to the storage latency (default 0).") |
+      Opt(config.capture.directory, "/tmp/capture")["--capture-dir"]("Directory to which a sample of the requests received are captured for replay (default disabled).") |
+      Opt(config.capture.sampleRate, "1")["--capture-sample-rate"]("Capture 1 in N requests (default 1).") |
+      Opt(config.capture.fileSize, "64")["--capture-file-size"]("Size in MB of each capture file (default 64).") |
+      Opt(config.capture.files, "16")["--capture-files"]("Number of capture files to retain (default 16).") |
+      Opt(config.capture.bufferSize, "8192")["--capture-buffer-size"]("Number of captured requests to buffer before dropping (default 8192).") |
       Opt(ilp.server, "ilpServer")["-i"]["--ilp-server"]("ILP Server hostname") |
       Opt(ilp.port, "ilpPort")["-x"]["--ilp-port"]("ILP Server port") |
       Opt(ilp.name, "ilpMeasurement")["-y"]["--ilp-series-name"]("ILP series/(table) name") |
@@ -41,6 +58,7 @@ int main( int argc, char const * const * argv )
       Opt(logBuffer, "3")["-b"]["--buffer"]("Buffer size for async logging (default 3)") |
       Opt(console, "true")["-e"]["--console"]("Log to console (default false)") |
       Opt(async, "false")["-z"]["--log-async"]("Use async logging (default true)") |
+      Opt(binaryLog, "true")["-a"]["--log-binary"]("Write log files in binary format, decoded offline using nanolog-decode (default false)") |
       Opt(dir, "/tmp/")["-o"]["--dir"]("Log directory (default logs/)");
 
   auto result = options.parse(clara::Args(argc, argv));
@@ -50,7 +68,37 @@ int main( int argc, char const * const * argv )
     exit(1);
   }
 
-  if ( config.mongoUri.empty() )
+  if ( config.storage.engine != "mongo" && config.storage.engine != "memory" )
+  {
+    std::cerr << "Invalid storage engine " << config.storage.engine << std::endl;
+    options.writeToStream( std::cout );
+    exit(1);
+  }
+
+  if ( config.storage.latency < 0 || config.storage.jitter < 0 )
+  {
+    std::cerr << "Storage latency and jitter cannot be negative." << std::endl;
+    exit(1);
+  }
+
+  if ( !config.capture.directory.empty() )
+  {
+    if ( config.capture.sampleRate < 1 || config.capture.fileSize < 1 || config.capture.files < 1 || config.capture.bufferSize < 1 )
+    {
+      std::cerr << "Capture sample rate, file size, files and buffer size must be greater than 0." << std::endl;
+      exit(1);
+    }
+
+    auto ec = std::error_code{};
+    std::filesystem::create_directories( config.capture.directory, ec );
+    if ( ec )
+    {
+      std::cerr << "Unable to create capture directory " << config.capture.directory << ". " << ec.message() << std::endl;
+      exit(1);
+    }
+  }
+
+  if ( config.storage.engine == "mongo" && config.mongoUri.empty() )
   {
     std::cerr << "Mongo URI not configured." << std::endl;
     options.writeToStream( std::cout );
@@ -75,19 +123,21 @@ int main( int argc, char const * const * argv )
     "configuration: " << config.str() << '\n' <<
     "console: " << std::boolalpha << console << '\n' <<
     "async logging: " << std::boolalpha << async << '\n' <<
+    "binary logging: " << std::boolalpha << binaryLog << '\n' <<
     "dir: " << dir << '\n';
 
   if ( config.logLevel == "debug" ) nanolog::set_log_level( nanolog::LogLevel::DEBUG );
   else if ( config.logLevel == "info" ) nanolog::set_log_level( nanolog::LogLevel::INFO );
   else if ( config.logLevel == "warn" ) nanolog::set_log_level( nanolog::LogLevel::WARN );
   else if ( config.logLevel == "critical" ) nanolog::set_log_level( nanolog::LogLevel::CRIT );
+  const auto logFormat = binaryLog ? nanolog::LogFormat::BINARY : nanolog::LogFormat::TEXT;
   if ( async )
   {
-    nanolog::initialize(nanolog::NonGuaranteedLogger(logBuffer), dir, "mongo-service", console);
+    nanolog::initialize(nanolog::NonGuaranteedLogger(logBuffer), dir, "mongo-service", console, logFormat);
   }
   else
   {
-    nanolog::initialize( nanolog::GuaranteedLogger(), dir, "mongo-service", console );
+    nanolog::initialize( nanolog::GuaranteedLogger(), dir, "mongo-service", console, logFormat );
   }
 
   mongocxx::instance instance{ std::make_unique<spt::db::Logger>() };
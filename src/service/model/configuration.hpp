@@ -25,6 +25,11 @@ namespace spt::model
       VISITABLE(std::string, database);
       VISITABLE(std::string, collection);
       VISITABLE(int, batchSize);
+      VISITABLE(int, flushInterval);
+      VISITABLE(int, bufferSize);
+      VISITABLE(int, rollupInterval);
+      VISITABLE(int, sampleRate);
+      VISITABLE(int, latencyInterval);
       END_VISITABLES;
     };
 
@@ -37,6 +42,34 @@ namespace spt::model
       END_VISITABLES;
     };
 
+    struct Bulk
+    {
+      BEGIN_VISITABLES(Bulk);
+      VISITABLE(int, chunkSize);
+      VISITABLE(int, parallelism);
+      END_VISITABLES;
+    };
+
+    struct Storage
+    {
+      BEGIN_VISITABLES(Storage);
+      VISITABLE(std::string, engine);
+      VISITABLE(int, latency);
+      VISITABLE(int, jitter);
+      END_VISITABLES;
+    };
+
+    struct Capture
+    {
+      BEGIN_VISITABLES(Capture);
+      VISITABLE(std::string, directory);
+      VISITABLE(int, sampleRate);
+      VISITABLE(int, fileSize);
+      VISITABLE(int, files);
+      VISITABLE(int, bufferSize);
+      END_VISITABLES;
+    };
+
     ~Configuration() = default;
     Configuration( Configuration&& ) = default;
     Configuration& operator=( Configuration&& ) = default;
@@ -46,7 +79,10 @@ namespace spt::model
 
     BEGIN_VISITABLES(Configuration);
     VISITABLE_DIRECT_INIT(std::optional<ILPServer>, ilp, {std::nullopt});
-    VISITABLE_DIRECT_INIT(Metrics, metrics, { .database = "versionHistory", .collection = "metrics", .batchSize = 100});
+    VISITABLE_DIRECT_INIT(Metrics, metrics, { .database = "versionHistory", .collection = "metrics", .batchSize = 100, .flushInterval = 30, .bufferSize = 8192, .rollupInterval = 0, .sampleRate = 0, .latencyInterval = 0 });
+    VISITABLE_DIRECT_INIT(Bulk, bulk, { .chunkSize = 0, .parallelism = 4 });
+    VISITABLE_DIRECT_INIT(Storage, storage, { .engine = "mongo", .latency = 0, .jitter = 0 });
+    VISITABLE_DIRECT_INIT(Capture, capture, { .directory = "", .sampleRate = 1, .fileSize = 64, .files = 16, .bufferSize = 8192 });
     VISITABLE(std::string, mongoUri);
     VISITABLE_DIRECT_INIT(std::string, versionHistoryDatabase, {"versionHistory"});
     VISITABLE_DIRECT_INIT(std::string, versionHistoryCollection, {"entities"});
@@ -7,7 +7,6 @@
 #include "../common/util/bson.hpp"
 #include "../common/magic_enum/magic_enum.hpp"
 
-#include <bsoncxx/json.hpp>
 #include <bsoncxx/validate.hpp>
 
 using spt::model::Document;
@@ -82,7 +81,7 @@ bsoncxx::document::view Document::document() const
 
 std::string Document::json() const
 {
-  return bsoncxx::to_json( *view );
+  return util::toJsonString( *view );
 }
 
 std::optional<bsoncxx::document::view> Document::options() const
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "metric.hpp"
+
 #include <optional>
 
 #include <bsoncxx/document/view.hpp>
@@ -37,7 +39,13 @@ namespace spt::model
 
     [[nodiscard]] std::string json() const;
 
+    /**
+     * Timings for the phases of processing this request.  Updated as the request is processed.
+     */
+    [[nodiscard]] Phases& phases() const { return timings; }
+
   private:
     std::optional<bsoncxx::document::view> view;
+    mutable Phases timings{};
   };
 }
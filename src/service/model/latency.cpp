@@ -0,0 +1,31 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "latency.hpp"
+
+#include <bsoncxx/oid.hpp>
+#include <bsoncxx/types.hpp>
+#include <bsoncxx/builder/stream/document.hpp>
+
+bsoncxx::document::value spt::model::Latency::bson() const
+{
+  using bsoncxx::builder::stream::document;
+  using bsoncxx::builder::stream::finalize;
+
+  return document{} << "_id" << bsoncxx::oid{} <<
+    "action" << action <<
+    "database" << database <<
+    "collection" << collection <<
+    "count" << static_cast<int64_t>( histogram.count() ) <<
+    "min" << histogram.min() <<
+    "mean" << histogram.mean() <<
+    "p50" << histogram.percentile( 50.0 ) <<
+    "p90" << histogram.percentile( 90.0 ) <<
+    "p99" << histogram.percentile( 99.0 ) <<
+    "p999" << histogram.percentile( 99.9 ) <<
+    "max" << histogram.max() <<
+    "start" << bsoncxx::types::b_date{ start } <<
+    "date" << bsoncxx::types::b_date{ end } <<
+    finalize;
+}
@@ -0,0 +1,38 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include "../../common/util/histogram.hpp"
+
+#include <chrono>
+#include <string>
+
+#include <bsoncxx/document/value.hpp>
+
+namespace spt::model
+{
+  /**
+   * Latency distribution for an action against a database collection over an interval.
+   */
+  struct Latency
+  {
+    Latency() = default;
+    ~Latency() = default;
+    Latency( Latency&& ) = default;
+    Latency& operator=( Latency&& ) = default;
+
+    Latency( const Latency& ) = delete;
+    Latency& operator=( const Latency& ) = delete;
+
+    std::string action;
+    std::string database;
+    std::string collection;
+    util::Histogram histogram;
+    std::chrono::time_point<std::chrono::system_clock> start;
+    std::chrono::time_point<std::chrono::system_clock> end;
+
+    [[nodiscard]] bsoncxx::document::value bson() const;
+  };
+}
@@ -12,6 +12,8 @@
 bsoncxx::document::value spt::model::Metric::bson() const
 {
   using bsoncxx::builder::stream::document;
+  using bsoncxx::builder::stream::open_document;
+  using bsoncxx::builder::stream::close_document;
   using bsoncxx::builder::stream::finalize;
 
   const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( timestamp.time_since_epoch() );
@@ -24,6 +26,14 @@ bsoncxx::document::value spt::model::Metric::bson() const
     "collection" << collection <<
     "size" << int64_t( size ) <<
     "time" << duration.count() <<
+    "phases" << open_document <<
+      "read" << phases.read.count() <<
+      "validate" << phases.validate.count() <<
+      "pool" << phases.pool.count() <<
+      "operation" << phases.operation.count() <<
+      "history" << phases.history.count() <<
+      "write" << phases.write.count() <<
+    close_document <<
     "timestamp" << bsoncxx::types::b_int64{ ns.count() } <<
     "date" << bsoncxx::types::b_date{ ms };
 
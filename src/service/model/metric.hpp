@@ -13,6 +13,45 @@
 
 namespace spt::model
 {
+  /**
+   * Time spent in each phase of processing a request.
+   */
+  struct Phases
+  {
+    /**
+     * Add the time elapsed between construction and destruction to the specified phase.
+     */
+    struct Timer
+    {
+      explicit Timer( std::chrono::nanoseconds& target ) : target{ target } {}
+      ~Timer() { target += std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ); }
+
+      Timer( Timer&& ) = delete;
+      Timer& operator=( Timer&& ) = delete;
+      Timer( const Timer& ) = delete;
+      Timer& operator=( const Timer& ) = delete;
+
+    private:
+      std::chrono::nanoseconds& target;
+      std::chrono::time_point<std::chrono::steady_clock> start{ std::chrono::steady_clock::now() };
+    };
+
+    // Reading the remainder of the request after the first bytes were received.
+    std::chrono::nanoseconds read{ 0 };
+    // Validating the request BSON.
+    std::chrono::nanoseconds validate{ 0 };
+    // Waiting to acquire a connection from the pool.
+    std::chrono::nanoseconds pool{ 0 };
+    // The primary database operation(s), including building the response document.
+    std::chrono::nanoseconds operation{ 0 };
+    // Writing version history documents.
+    std::chrono::nanoseconds history{ 0 };
+    // Writing the response to the socket.
+    std::chrono::nanoseconds write{ 0 };
+    // Total time spent in the database handler (pool + operation + history).
+    std::chrono::nanoseconds duration{ 0 };
+  };
+
   struct Metric
   {
     Metric() = default;
@@ -33,6 +72,7 @@ namespace spt::model
     std::optional<bsoncxx::oid> id;
     std::chrono::time_point<std::chrono::high_resolution_clock, std::chrono::nanoseconds> timestamp = std::chrono::high_resolution_clock::now();
     std::chrono::nanoseconds duration;
+    Phases phases;
     std::size_t size;
 
     [[nodiscard]] bsoncxx::document::value bson() const;
@@ -0,0 +1,51 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "rollup.hpp"
+
+#include <bsoncxx/oid.hpp>
+#include <bsoncxx/types.hpp>
+#include <bsoncxx/builder/stream/document.hpp>
+
+void spt::model::Rollup::add( const Metric& metric )
+{
+  histogram.record( metric.duration.count() );
+  ++count;
+  if ( metric.message ) ++errors;
+  size += metric.size;
+}
+
+bsoncxx::document::value spt::model::Rollup::bson() const
+{
+  using bsoncxx::builder::stream::document;
+  using bsoncxx::builder::stream::open_document;
+  using bsoncxx::builder::stream::close_document;
+  using bsoncxx::builder::stream::finalize;
+
+  const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>( end.time_since_epoch() );
+
+  auto doc = document{};
+  doc << "_id" << bsoncxx::oid{} <<
+    "action" << action <<
+    "database" << database <<
+    "collection" << collection <<
+    "count" << static_cast<int64_t>( count ) <<
+    "errors" << static_cast<int64_t>( errors ) <<
+    "size" << static_cast<int64_t>( size ) <<
+    "time" << open_document <<
+      "min" << histogram.min() <<
+      "mean" << histogram.mean() <<
+      "p50" << histogram.percentile( 50.0 ) <<
+      "p90" << histogram.percentile( 90.0 ) <<
+      "p99" << histogram.percentile( 99.0 ) <<
+      "p999" << histogram.percentile( 99.9 ) <<
+      "max" << histogram.max() <<
+    close_document <<
+    "start" << bsoncxx::types::b_date{ start } <<
+    "date" << bsoncxx::types::b_date{ ms };
+
+  if ( application ) doc << "application" << *application;
+
+  return doc << finalize;
+}
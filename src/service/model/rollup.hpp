@@ -0,0 +1,48 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include "metric.hpp"
+#include "../../common/util/histogram.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <bsoncxx/document/value.hpp>
+
+namespace spt::model
+{
+  /**
+   * Pre-aggregated metrics for all requests with the same action, database, collection and
+   * application over an interval.
+   */
+  struct Rollup
+  {
+    Rollup() = default;
+    ~Rollup() = default;
+    Rollup( Rollup&& ) = default;
+    Rollup& operator=( Rollup&& ) = default;
+
+    Rollup( const Rollup& ) = delete;
+    Rollup& operator=( const Rollup& ) = delete;
+
+    void add( const Metric& metric );
+
+    std::string action;
+    std::string database;
+    std::string collection;
+    std::optional<std::string> application;
+    util::Histogram histogram;
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    std::chrono::time_point<std::chrono::system_clock> end = start;
+    uint64_t count{ 0 };
+    uint64_t errors{ 0 };
+    uint64_t size{ 0 };
+
+    [[nodiscard]] bsoncxx::document::value bson() const;
+  };
+}
@@ -0,0 +1,57 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#include "capture.hpp"
+#include "model/configuration.hpp"
+#include "../log/NanoLog.hpp"
+
+#include <algorithm>
+
+using spt::server::Capture;
+
+bool Capture::enabled()
+{
+  static const bool value = !model::Configuration::instance().capture.directory.empty();
+  return value;
+}
+
+Capture& Capture::instance()
+{
+  static Capture c;
+  return c;
+}
+
+Capture::Capture() :
+  writer{ util::capture::Writer::Configuration{
+    .directory = model::Configuration::instance().capture.directory,
+    .fileSize = static_cast<uint64_t>( std::max( model::Configuration::instance().capture.fileSize, 1 ) ) * 1024 * 1024,
+    .files = static_cast<uint32_t>( std::max( model::Configuration::instance().capture.files, 1 ) ),
+    .bufferSize = static_cast<uint32_t>( std::max( model::Configuration::instance().capture.bufferSize, 1 ) ) } }
+{
+  const auto& conf = model::Configuration::instance().capture;
+  LOG_INFO << "Capturing 1 in " << conf.sampleRate << " requests to " << conf.directory;
+  writer.start();
+}
+
+void Capture::add( uint64_t connection, std::chrono::steady_clock::time_point start, const uint8_t* data, std::size_t size )
+{
+  const auto rate = static_cast<uint64_t>( std::max( model::Configuration::instance().capture.sampleRate, 1 ) );
+  if ( counter.fetch_add( 1, std::memory_order_relaxed ) % rate != 0 ) return;
+  if ( size > util::capture::MaxFrameSize ) return;
+
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  auto header = util::capture::Header{};
+  header.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    ( std::chrono::system_clock::now() - elapsed ).time_since_epoch() ).count();
+  header.duration = std::chrono::duration_cast<std::chrono::nanoseconds>( elapsed ).count();
+  header.connection = connection;
+  header.size = static_cast<uint32_t>( size );
+  writer.add( header, data );
+}
+
+void Capture::finish()
+{
+  writer.finish();
+  LOG_INFO << "Request capture stopped";
+}
@@ -0,0 +1,56 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#pragma once
+
+#include "../../common/util/capture.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace spt::server
+{
+  /**
+   * Records a sample of the request frames received by the service to rotating capture files, for
+   * replay using `mongo-service-shell`.  Selected frames are written by a `util::capture::Writer`
+   * configured from the `capture` options.
+   */
+  struct Capture
+  {
+    /**
+     * @return `true` if a capture directory has been configured.
+     */
+    static bool enabled();
+
+    static Capture& instance();
+
+    ~Capture() = default;
+    Capture( Capture&& ) = delete;
+    Capture& operator=( Capture&& ) = delete;
+
+    Capture( const Capture& ) = delete;
+    Capture& operator=( const Capture& ) = delete;
+
+    /**
+     * Stage a request frame if selected by the configured sample rate.  Safe to invoke from multiple threads.
+     * @param connection The identifier of the connection on which the request was received.
+     * @param start The time at which the request started to be read.
+     * @param data The request frame.
+     * @param size The size of the request frame.
+     */
+    void add( uint64_t connection, std::chrono::steady_clock::time_point start, const uint8_t* data, std::size_t size );
+
+    /**
+     * Stop the writer thread after it has written all the staged frames.  Safe to invoke multiple times.
+     */
+    void finish();
+
+  private:
+    Capture();
+
+    util::capture::Writer writer;
+    std::atomic<uint64_t> counter{ 0 };
+  };
+}
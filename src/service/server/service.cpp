@@ -3,6 +3,7 @@
 //
 
 #include "service.hpp"
+#include "capture.hpp"
 #include "db/metricscollector.hpp"
 #include "db/storage.hpp"
 #include "model/configuration.hpp"
@@ -17,6 +18,8 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/write.hpp>
 
+#include <chrono>
+#include <optional>
 #include <vector>
 
 using boost::asio::use_awaitable;
@@ -28,9 +31,30 @@ using boost::asio::use_awaitable;
 
 namespace spt::server::coroutine
 {
+  // Record the metric for the request.  Errors are logged, so that a failure to record a metric never
+  // affects the response to the client.
+  void record( const model::Document& doc, bsoncxx::document::view response )
+  {
+    try
+    {
+      db::record( doc, response );
+    }
+    catch ( const std::exception& ex )
+    {
+      LOG_WARN_RATE( 1 ) << "Error recording metric for request. " << ex.what();
+    }
+  }
+
   boost::asio::awaitable<void> process( boost::asio::ip::tcp::socket& socket,
       const model::Document& doc )
   {
+    auto& phases = doc.phases();
+    const auto valid = [&doc, &phases]
+    {
+      auto timer = model::Phases::Timer{ phases.validate };
+      return doc.valid();
+    }();
+
     if ( !doc.bson() )
     {
       auto view = spt::model::notBson();
@@ -38,7 +62,7 @@ namespace spt::server::coroutine
       co_await boost::asio::async_write(
           socket, boost::asio::buffer( view.data(), view.length() ), use_awaitable );
     }
-    else if ( !doc.valid() )
+    else if ( !valid )
     {
       auto view = spt::model::missingField();
       LOG_DEBUG << "Invalid bson received.  Returning not bson message...";
@@ -47,16 +71,23 @@ namespace spt::server::coroutine
     }
     else
     {
+      // Kept so that the metric is recorded even if writing the response fails, in which case the write phase is not set.
+      auto response = std::optional<bsoncxx::document::view_or_value>{};
       try
       {
-        auto v = co_await db::process( doc );
-        auto view = v.view();
+        response = co_await db::process( doc );
+        const auto view = response->view();
+
+        const auto st = std::chrono::steady_clock::now();
         co_await boost::asio::async_write(
             socket, boost::asio::buffer( view.data(), view.length() ), use_awaitable );
+        phases.write = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - st );
+        record( doc, view );
       }
       catch ( const std::exception& ex )
       {
         LOG_WARN << "Error processing request " << ex.what();
+        if ( response ) record( doc, response->view() );
         auto view = model::unexpectedError();
         boost::system::error_code ec;
         boost::asio::write( socket, boost::asio::buffer( view.data(), view.length() ), ec );
@@ -65,7 +96,7 @@ namespace spt::server::coroutine
     }
   }
 
-  boost::asio::awaitable<void> respond( boost::asio::ip::tcp::socket& socket )
+  boost::asio::awaitable<void> respond( boost::asio::ip::tcp::socket& socket, uint64_t connection )
   {
     static constexpr int bufSize = 1024;
     static constexpr auto maxBytes = 8 * 1024 * 1024;
@@ -82,6 +113,7 @@ namespace spt::server::coroutine
     };
 
     std::size_t osize = co_await socket.async_read_some( boost::asio::buffer( data ), use_awaitable );
+    const auto st = std::chrono::steady_clock::now();
     const auto docSize = documentSize( osize );
 
     // echo, noop, ping etc.
@@ -91,10 +123,20 @@ namespace spt::server::coroutine
       co_return;
     }
 
+    const auto document = [&st]( const uint8_t* buffer, std::size_t size )
+    {
+      const auto et = std::chrono::steady_clock::now();
+      auto doc = model::Document{ buffer, size };
+      doc.phases().read = std::chrono::duration_cast<std::chrono::nanoseconds>( et - st );
+      doc.phases().validate = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - et );
+      return doc;
+    };
+
     if ( docSize <= bufSize )
     {
-      auto doc = model::Document{ reinterpret_cast<const uint8_t*>( data ), docSize };
+      auto doc = document( reinterpret_cast<const uint8_t*>( data ), docSize );
       co_await process( socket, doc );
+      if ( Capture::enabled() ) Capture::instance().add( connection, st, reinterpret_cast<const uint8_t*>( data ), docSize );
       co_return;
     }
 
@@ -110,17 +152,18 @@ namespace spt::server::coroutine
       read += osize;
     }
 
-    auto doc = model::Document{ reinterpret_cast<const uint8_t*>( rbuf.data() ), docSize };
+    auto doc = document( reinterpret_cast<const uint8_t*>( rbuf.data() ), docSize );
     co_await process( socket, doc );
+    if ( Capture::enabled() && read == docSize ) Capture::instance().add( connection, st, rbuf.data(), docSize );
   }
 
-  boost::asio::awaitable<void> serve( boost::asio::ip::tcp::socket socket )
+  boost::asio::awaitable<void> serve( boost::asio::ip::tcp::socket socket, uint64_t connection )
   {
     try
     {
       for (;;)
       {
-        co_await respond( socket );
+        co_await respond( socket, connection );
       }
     }
     catch ( const std::exception& e )
@@ -136,10 +179,11 @@ namespace spt::server::coroutine
     auto executor = co_await boost::asio::this_coro::executor;
     boost::asio::ip::tcp::acceptor acceptor( executor,
         { boost::asio::ip::tcp::v4(), static_cast<boost::asio::ip::port_type>( model::Configuration::instance().port ) } );
+    uint64_t connection = 0;
     for (;;)
     {
       boost::asio::ip::tcp::socket socket = co_await acceptor.async_accept( use_awaitable );
-      boost::asio::co_spawn( executor, serve( std::move(socket) ), boost::asio::detached );
+      boost::asio::co_spawn( executor, serve( std::move(socket), ++connection ), boost::asio::detached );
     }
   }
 }
@@ -167,6 +211,7 @@ int spt::server::run()
       v.emplace_back( [&ioc] { ioc.run(); } );
     }
 
+    if ( Capture::enabled() ) Capture::instance();
     boost::asio::co_spawn( ioc, coroutine::listener(), boost::asio::detached );
 
     LOG_INFO << "TCP service started";
@@ -175,6 +220,7 @@ int spt::server::run()
     LOG_INFO << "TCP service stopping";
     for ( auto& t : v ) if ( t.joinable() ) t.join();
     db::MetricsCollector::instance().finish();
+    if ( Capture::enabled() ) Capture::instance().finish();
     LOG_INFO << "All I/O threads stopped";
   }
   catch ( const std::exception& ex )
@@ -67,7 +67,7 @@ namespace
       try
       {
         LOG_INFO << "Executing " << payload;
-        auto bson = bsoncxx::from_json( payload );
+        auto bson = spt::util::toBson( payload );
 
         auto act = bsonValueIfExists<std::string>( "action", bson.view() );
         if ( !act )
@@ -149,13 +149,13 @@ namespace
 
         if ( const auto res = bsonValueIfExists<bsoncxx::document::view>( "result", view ); res )
         {
-          std::cout << bsoncxx::to_json( *res ) << '\n';
+          spt::util::writeJson( std::cout, *res ) << '\n';
           return;
         }
 
         if ( const auto res = bsonValueIfExists<bsoncxx::array::view>( "results", view ); res )
         {
-          std::cout << bsoncxx::to_json( *res ) << '\n';
+          spt::util::writeJson( std::cout, *res ) << '\n';
         }
       }
       catch ( const std::exception& e )
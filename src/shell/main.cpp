@@ -3,16 +3,71 @@
 //
 
 #include "client/client.hpp"
+#include "replay/replay.hpp"
+#include "../api/api.hpp"
 #include "../api/contextholder.hpp"
+#include "../common/util/capture.hpp"
 #include "../common/util/clara.hpp"
 #include "../log/NanoLog.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <thread>
 #include <vector>
 
+#include <boost/asio/co_spawn.hpp>
 #include <boost/asio/signal_set.hpp>
 
+namespace spt::mongoservice::pmain
+{
+  int replay( std::string_view server, std::string_view port, replay::Configuration configuration, uint32_t threads )
+  {
+    auto files = util::capture::files( configuration.path );
+    if ( files.empty() )
+    {
+      std::cerr << "No capture files found at " << configuration.path << std::endl;
+      return 1;
+    }
+
+    if ( configuration.speed < 0 || configuration.connections == 0 || threads == 0 )
+    {
+      std::cerr << "Speed cannot be negative, and connections and threads must be greater than 0" << std::endl;
+      return 1;
+    }
+
+    auto pool = spt::mongoservice::pool::Configuration{};
+    pool.initialSize = 0;
+    pool.maxPoolSize = configuration.connections;
+    pool.maxConnections = configuration.connections;
+    api::init( server, port, "mongo-service-replay", pool );
+
+    auto& ioc = api::ContextHolder::instance().ioc;
+    boost::asio::signal_set signals( ioc, SIGINT, SIGTERM );
+    signals.async_wait( [&ioc](auto const&, int ) { ioc.stop(); } );
+
+    auto player = replay::Player{ std::move( configuration ), std::move( files ) };
+    boost::asio::co_spawn( ioc, player.run(),
+      [&ioc, &signals]( std::exception_ptr ep )
+      {
+        if ( ep )
+        {
+          try { std::rethrow_exception( ep ); }
+          catch ( const std::exception& ex ) { LOG_CRIT << "Error replaying requests. " << ex.what(); }
+        }
+        signals.cancel();
+        ioc.stop();
+      } );
+
+    std::vector<std::thread> v;
+    v.reserve( threads );
+    for ( uint32_t i = 0; i < threads; ++i ) v.emplace_back( [&ioc] { ioc.run(); } );
+    for ( auto&& t : v ) if ( t.joinable() ) t.join();
+
+    std::cout << player.report();
+    return 0;
+  }
+}
+
 int main( int argc, char const * const * argv )
 {
   using clara::Opt;
@@ -25,11 +80,17 @@ int main( int argc, char const * const * argv )
   std::string logLevel{"info"};
 #endif
   std::string dir{"/tmp/"};
+  auto replay = spt::mongoservice::replay::Configuration{};
+  uint32_t threads{ std::max( std::thread::hardware_concurrency(), 1u ) };
   bool help = false;
 
   auto options = clara::Help(help) |
       Opt(server, "localhost")["-s"]["--server"]("Server to connect to (default localhost).") |
       Opt(port, "2000")["-p"]["--port"]("TCP port for the server (default 2000)") |
+      Opt(replay.path, "/tmp/capture")["-r"]["--replay"]("Replay the requests in a capture file, or directory of capture files, instead of starting the shell.") |
+      Opt(replay.speed, "1.0")["--replay-speed"]("Multiple of the captured rate at which to replay requests.  0 replays as fast as possible (default 1).") |
+      Opt(replay.connections, "64")["--replay-connections"]("Maximum number of connections to the service when replaying (default 64).") |
+      Opt(threads, "4")["--replay-threads"]("Number of threads to run the io context on when replaying (default number of cores).") |
       Opt(logLevel, "info")["-l"]["--log-level"]("Log level to use [debug|info|warn|critical] (default info).") |
       Opt(dir, "/tmp/")["-o"]["--log-dir"]("Log directory (default /tmp/)");
 
@@ -52,6 +113,8 @@ int main( int argc, char const * const * argv )
   else if ( logLevel == "critical" ) nanolog::set_log_level( nanolog::LogLevel::CRIT );
   nanolog::initialize( nanolog::GuaranteedLogger(), dir, "mongo-service-shell", false );
 
+  if ( !replay.path.empty() ) return spt::mongoservice::pmain::replay( server, port, std::move( replay ), threads );
+
   boost::asio::signal_set signals( spt::mongoservice::api::ContextHolder::instance().ioc, SIGINT, SIGTERM );
   signals.async_wait( [&](auto const&, int ) { spt::mongoservice::api::ContextHolder::instance().ioc.stop(); } );
 
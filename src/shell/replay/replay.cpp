@@ -0,0 +1,212 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#include "replay.hpp"
+#include "../../api/api.hpp"
+#include "../../common/util/capture.hpp"
+#include "../../log/NanoLog.hpp"
+
+#include <algorithm>
+#include <format>
+#include <optional>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <bsoncxx/validate.hpp>
+
+using spt::mongoservice::replay::Player;
+
+namespace spt::mongoservice::replay::preplay
+{
+  double millis( int64_t nanos )
+  {
+    return static_cast<double>( nanos ) / 1'000'000.0;
+  }
+}
+
+Player::Player( Configuration configuration, std::vector<std::filesystem::path> files ) :
+  configuration{ std::move( configuration ) }, captures{ std::move( files ) } {}
+
+auto Player::stats( bsoncxx::document::view request ) -> Stats&
+{
+  using std::operator""sv;
+  auto name = "unknown"sv;
+  if ( const auto it = request.find( "action" ); it != request.end() && it->type() == bsoncxx::type::k_string )
+  {
+    name = it->get_string().value;
+  }
+
+  if ( const auto iter = actions.find( name ); iter != actions.end() ) return iter->second;
+  return actions.try_emplace( std::string{ name } ).first->second;
+}
+
+boost::asio::awaitable<void> Player::run()
+{
+  using namespace std::chrono_literals;
+
+  auto executor = co_await boost::asio::this_coro::executor;
+  auto timer = boost::asio::steady_timer{ executor };
+  auto reader = util::capture::Reader{ captures };
+  const auto unlimited = configuration.speed <= 0.0;
+  const auto limit = std::max( configuration.connections, 1u );
+
+  LOG_INFO << "Replaying " << int64_t( captures.size() ) << " capture files at " <<
+    ( unlimited ? std::string{ "maximum speed" } : std::format( "{}x speed", configuration.speed ) );
+
+  auto first = std::optional<int64_t>{};
+  int64_t last = 0;
+  const auto start = Clock::now();
+
+  while ( auto record = reader.next() )
+  {
+    const auto& header = record->header;
+    const auto view = bsoncxx::validate( record->frame.data(), record->frame.size() );
+    if ( !view )
+    {
+      ++skipped;
+      continue;
+    }
+
+    if ( !first ) first = header.timestamp;
+    last = std::max( last, header.timestamp );
+
+    auto next = Clock::now();
+    if ( unlimited )
+    {
+      while ( inflight.load( std::memory_order_acquire ) >= limit )
+      {
+        timer.expires_after( 100us );
+        co_await timer.async_wait( boost::asio::use_awaitable );
+      }
+      next = Clock::now();
+    }
+    else
+    {
+      // Requests are written in the order in which they completed, so a request that took longer than
+      // the following one may be slightly behind schedule.  Such requests are started immediately.
+      const auto offset = static_cast<double>( std::max( header.timestamp - *first, int64_t{ 0 } ) ) / configuration.speed;
+      next = start + std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double, std::nano>( offset ) );
+      if ( next > Clock::now() )
+      {
+        timer.expires_at( next );
+        co_await timer.async_wait( boost::asio::use_awaitable );
+      }
+      lag = std::max( lag, std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - next ) );
+    }
+
+    auto& s = stats( *view );
+    s.original.record( header.duration );
+    connections.insert( header.connection );
+    ++started;
+    inflight.fetch_add( 1, std::memory_order_relaxed );
+    boost::asio::co_spawn( executor, send( std::move( record->frame ), s, next ), boost::asio::detached );
+  }
+
+  LOG_INFO << "Started " << started << " requests. Waiting for " << inflight.load() << " outstanding requests";
+  const auto deadline = Clock::now() + configuration.drain;
+  while ( inflight.load( std::memory_order_acquire ) > 0 && Clock::now() < deadline )
+  {
+    timer.expires_after( 10ms );
+    co_await timer.async_wait( boost::asio::use_awaitable );
+  }
+
+  pending = inflight.load( std::memory_order_acquire );
+  if ( pending > 0 ) LOG_WARN << pending << " requests outstanding after waiting " << int64_t( configuration.drain.count() ) << 's';
+
+  elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - start );
+  if ( first ) captured = std::chrono::nanoseconds{ last - *first };
+  summary = results();
+}
+
+boost::asio::awaitable<void> Player::send( std::vector<uint8_t> frame, Stats& s, Clock::time_point scheduled )
+{
+  auto type = api::ResultType::commandFailure;
+  auto error = false;
+  try
+  {
+    auto [result, response] = co_await api::executeAsync( bsoncxx::document::view{ frame.data(), frame.size() } );
+    type = result;
+    error = response && response->view().find( "error" ) != response->view().end();
+  }
+  catch ( const std::exception& ex )
+  {
+    LOG_WARN_RATE( 1 ) << "Error replaying request. " << ex.what();
+  }
+
+  s.latency.record( std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - scheduled ).count() );
+  s.count.fetch_add( 1, std::memory_order_relaxed );
+  if ( error ) s.errors.fetch_add( 1, std::memory_order_relaxed );
+  if ( type != api::ResultType::success ) s.failures.fetch_add( 1, std::memory_order_relaxed );
+
+  inflight.fetch_sub( 1, std::memory_order_release );
+}
+
+auto Player::results() -> std::vector<Result>
+{
+  auto out = std::vector<Result>{};
+  out.reserve( actions.size() + 1 );
+  auto all = Result{ "total", {}, {}, 0, 0, 0 };
+
+  for ( auto& [name, s] : actions )
+  {
+    auto& result = out.emplace_back( name, s.original, util::Histogram{}, s.count.load(), s.errors.load(), s.failures.load() );
+    s.latency.drain( result.latency );
+    all.original.merge( result.original );
+    all.latency.merge( result.latency );
+    all.count += result.count;
+    all.errors += result.errors;
+    all.failures += result.failures;
+  }
+
+  out.push_back( std::move( all ) );
+  return out;
+}
+
+std::string Player::report() const
+{
+  using namespace std::string_view_literals;
+  using preplay::millis;
+
+  auto out = std::string{};
+  out.reserve( 2048 );
+
+  std::format_to( std::back_inserter( out ), "{:<18}{:>10}{:>8}{:>8}{:>22}{:>22}{:>22}\n",
+    ""sv, ""sv, ""sv, ""sv, "p50"sv, "p99"sv, "max"sv );
+  std::format_to( std::back_inserter( out ), "{:<18}{:>10}{:>8}{:>8}{:>8}{:>7}{:>7}{:>8}{:>7}{:>7}{:>8}{:>7}{:>7}\n",
+    "action"sv, "count"sv, "errors"sv, "failed"sv, "orig"sv, "replay"sv, "diff"sv, "orig"sv, "replay"sv, "diff"sv,
+    "orig"sv, "replay"sv, "diff"sv );
+
+  for ( const auto& result : summary )
+  {
+    const auto& o = result.original;
+    const auto& r = result.latency;
+    const auto p50 = std::pair{ millis( o.percentile( 50 ) ), millis( r.percentile( 50 ) ) };
+    const auto p99 = std::pair{ millis( o.percentile( 99 ) ), millis( r.percentile( 99 ) ) };
+    const auto max = std::pair{ millis( o.max() ), millis( r.max() ) };
+    std::format_to( std::back_inserter( out ),
+      "{:<18}{:>10}{:>8}{:>8}{:>8.2f}{:>7.2f}{:>+7.2f}{:>8.2f}{:>7.2f}{:>+7.2f}{:>8.2f}{:>7.2f}{:>+7.2f}\n",
+      result.name, result.count, result.errors, result.failures,
+      p50.first, p50.second, p50.second - p50.first, p99.first, p99.second, p99.second - p99.first,
+      max.first, max.second, max.second - max.first );
+  }
+
+  const auto seconds = std::chrono::duration<double>( elapsed ).count();
+  const auto original = std::chrono::duration<double>( captured ).count();
+  std::format_to( std::back_inserter( out ),
+    "\nLatencies in milliseconds.  Original latencies were measured by the service (excluding network),\n"
+    "replay latencies by the client from the scheduled start of each request.\n"
+    "Replayed {} requests from {} connections ({} invalid frames skipped) in {:.1f}s ({:.1f}/s).\n"
+    "Captured over {:.1f}s ({:.1f}/s).  Maximum scheduling lag {:.3f}ms.  {} requests outstanding at exit.\n",
+    started, connections.size(), skipped, seconds, seconds > 0 ? static_cast<double>( started ) / seconds : 0.0,
+    original, original > 0 ? static_cast<double>( started ) / original : 0.0, millis( lag.count() ), pending );
+
+  const auto pool = api::asyncPoolStats();
+  std::format_to( std::back_inserter( out ),
+    "Connection pool: {} acquired, {} waited, {} timed out, maximum wait {:.3f}ms.\n",
+    pool.acquired, pool.waited, pool.timeouts, static_cast<double>( pool.maxWait.count() ) / 1000.0 );
+
+  return out;
+}
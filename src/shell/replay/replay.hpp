@@ -0,0 +1,108 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#pragma once
+
+#include "../../common/util/histogram.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/asio/awaitable.hpp>
+#include <bsoncxx/document/view.hpp>
+
+namespace spt::mongoservice::replay
+{
+  struct Configuration
+  {
+    // Capture file, or directory containing capture files.
+    std::string path;
+    // Multiple of the original rate at which requests are replayed.  `0` replays as fast as possible.
+    double speed{ 1.0 };
+    // Maximum number of outstanding requests when replaying as fast as possible.
+    uint32_t connections{ 64 };
+    // Maximum time to wait for outstanding requests once all requests have been started.
+    std::chrono::seconds drain{ 30 };
+  };
+
+  /**
+   * Replays the requests in capture files written by the service.  Requests are started at the
+   * offsets at which they were received by the service, scaled by the configured speed, irrespective
+   * of how long earlier requests take to complete.  Latency is measured from the time at which a request
+   * was scheduled to start, and compared with the time the service originally took to process the request.
+   * When replaying as fast as possible, latency is measured from the time a request was started.
+   *
+   * Requests are read from the capture files as they are replayed, so captures larger than available
+   * memory may be replayed.
+   */
+  struct Player
+  {
+    Player( Configuration configuration, std::vector<std::filesystem::path> files );
+    ~Player() = default;
+
+    Player(const Player&) = delete;
+    Player& operator=(const Player&) = delete;
+
+    /**
+     * Replay all the captured requests, and wait (up to `drain`) for outstanding requests to complete.
+     */
+    boost::asio::awaitable<void> run();
+
+    /**
+     * Summary of the replayed requests by action as a table.  Latencies are in milliseconds.
+     */
+    [[nodiscard]] std::string report() const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats
+    {
+      util::AtomicHistogram latency;
+      // Only recorded by the coroutine scheduling requests.
+      util::Histogram original;
+      std::atomic_uint64_t count{ 0 };
+      // Requests for which the service responded with an error document.
+      std::atomic_uint64_t errors{ 0 };
+      // Requests that could not be sent, or for which no response was received.
+      std::atomic_uint64_t failures{ 0 };
+    };
+
+    struct Result
+    {
+      std::string name;
+      util::Histogram original;
+      util::Histogram latency;
+      uint64_t count;
+      uint64_t errors;
+      uint64_t failures;
+    };
+
+    boost::asio::awaitable<void> send( std::vector<uint8_t> frame, Stats& stats, Clock::time_point scheduled );
+    Stats& stats( bsoncxx::document::view request );
+    std::vector<Result> results();
+
+    Configuration configuration;
+    std::vector<std::filesystem::path> captures;
+    // Stats by action.  Only modified by the coroutine scheduling requests, entries are never removed.
+    std::map<std::string, Stats, std::less<>> actions;
+    // Identifiers of the connections on which the replayed requests were originally received.
+    std::unordered_set<uint64_t> connections;
+    std::atomic_uint32_t inflight{ 0 };
+    uint64_t started{ 0 };
+    uint64_t skipped{ 0 };
+    uint64_t pending{ 0 };
+    std::chrono::nanoseconds lag{ 0 };
+    std::chrono::nanoseconds captured{ 0 };
+    std::chrono::nanoseconds elapsed{ 0 };
+    // Results by action, followed by the total for all actions.  Populated at the end of `run`.
+    std::vector<Result> summary;
+  };
+}
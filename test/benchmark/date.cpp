@@ -0,0 +1,51 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "../../src/common/util/date.hpp"
+
+#include <format>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+SCENARIO( "ISO8601 date-time benchmark", "[benchmark][date]" )
+{
+  GIVEN( "A set of date-time values" )
+  {
+    constexpr auto count = 1'000;
+    auto micros = std::vector<std::string>{};
+    auto offsets = std::vector<std::string>{};
+    micros.reserve( count );
+    offsets.reserve( count );
+    for ( auto i = 0; i < count; ++i )
+    {
+      micros.push_back( spt::util::isoDateMicros( std::chrono::microseconds{ int64_t( 1760745600123456 ) + int64_t( i ) * 1'234'567 } ) );
+      offsets.push_back( std::format( "{}-05:00", micros.back().substr( 0, 23 ) ) );
+    }
+
+    BENCHMARK( std::format( "Parse {} UTC values", count ) )
+    {
+      int64_t total{ 0 };
+      for ( const auto& value : micros ) total += spt::util::parseISO8601( value )->time_since_epoch().count();
+      return total;
+    };
+
+    BENCHMARK( std::format( "Parse {} values with zone offset", count ) )
+    {
+      int64_t total{ 0 };
+      for ( const auto& value : offsets ) total += spt::util::parseISO8601( value )->time_since_epoch().count();
+      return total;
+    };
+
+    BENCHMARK( std::format( "Format {} values", count ) )
+    {
+      std::size_t total{ 0 };
+      for ( auto i = 0; i < count; ++i )
+      {
+        total += spt::util::isoDateMillis( std::chrono::milliseconds{ int64_t( 1760745600123 ) + int64_t( i ) * 1'234 } ).size();
+      }
+      return total;
+    };
+  }
+}
@@ -0,0 +1,46 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "model.hpp"
+#include "../../src/service/model/document.hpp"
+
+#include <bsoncxx/validate.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+SCENARIO( "Service request benchmark", "[benchmark][document]" )
+{
+  GIVEN( "Requests of various sizes" )
+  {
+    for ( const auto size : { std::size_t{ 1024 }, std::size_t{ 64 * 1024 }, std::size_t{ 1024 * 1024 } } )
+    {
+      const auto request = spt::bench::request( size );
+      const auto* data = request.view().data();
+      const auto length = request.view().length();
+
+      BENCHMARK( std::format( "Parse and check request of {} bytes", length ) )
+      {
+        const auto document = spt::model::Document{ data, length };
+        return document.valid();
+      };
+
+      BENCHMARK( std::format( "Read properties of request of {} bytes", length ) )
+      {
+        const auto document = spt::model::Document{ request.view() };
+        return document.action().size() + document.database().size() + document.collection().size() +
+          document.document().length() + document.correlationId().value_or( "" ).size();
+      };
+
+      BENCHMARK( std::format( "Validate BSON buffer of {} bytes", length ) )
+      {
+        return bsoncxx::validate( data, length ).has_value();
+      };
+
+      BENCHMARK( std::format( "Validate strings in BSON document of {} bytes", length ) )
+      {
+        return spt::util::json::validate( "document", request.view() );
+      };
+    }
+  }
+}
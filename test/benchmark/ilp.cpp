@@ -0,0 +1,39 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "../../src/ilp/builder.hpp"
+
+#include <format>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+using std::operator""sv;
+
+SCENARIO( "ILP builder benchmark", "[benchmark][ilp]" )
+{
+  GIVEN( "ILP builder instance" )
+  {
+    constexpr auto count = 1'000;
+    auto builder = spt::ilp::Builder{};
+
+    BENCHMARK( std::format( "Build {} records", count ) )
+    {
+      builder.clear();
+      for ( auto i = 0; i < count; ++i )
+      {
+        builder.startRecord( "request"sv ).
+          addTag( "action"sv, "retrieve"sv ).
+          addTag( "database"sv, "bench"sv ).
+          addTag( "collection"sv, "customer"sv ).
+          addValue( "duration"sv, int64_t( 1234 + i ) ).
+          addValue( "size"sv, uint32_t( 4096 ) ).
+          addValue( "ratio"sv, 0.75 ).
+          addValue( "correlationId"sv, "c0ffee"sv ).
+          timestamp( std::chrono::nanoseconds{ 1760745600123456789 + i } ).
+          endRecord();
+      }
+      return builder.size();
+    };
+  }
+}
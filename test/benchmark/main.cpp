@@ -0,0 +1,45 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "../../src/log/NanoLog.hpp"
+#include <catch2/catch_session.hpp>
+
+#include <string_view>
+#include <vector>
+#if defined(_WIN32) || defined(WIN32)
+#include <filesystem>
+#endif
+
+int main( int argc, char* argv[] )
+{
+#if defined(_WIN32) || defined(WIN32)
+  auto str = std::filesystem::temp_directory_path().string();
+  str.append( "\\" );
+  nanolog::initialize( nanolog::GuaranteedLogger(), str, "mongo-service-bench", false );
+#else
+  nanolog::initialize( nanolog::GuaranteedLogger(), "/tmp/", "mongo-service-bench", false );
+#endif
+
+  // Results are written as JSON (to stdout, or the file specified with --out) unless a reporter is specified.
+  auto args = std::vector<char*>{ argv, argv + argc };
+  const auto reporter = [&args]
+  {
+    for ( const auto* arg : args )
+    {
+      const auto value = std::string_view{ arg };
+      if ( value == "-r" || value.starts_with( "--reporter" ) ) return true;
+    }
+    return false;
+  };
+
+  static char option[] = "--reporter";
+  static char json[] = "JSON";
+  if ( !reporter() )
+  {
+    args.push_back( option );
+    args.push_back( json );
+  }
+
+  return Catch::Session().run( static_cast<int>( args.size() ), args.data() );
+}
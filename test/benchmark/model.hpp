@@ -0,0 +1,96 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include "../../src/common/util/json.hpp"
+#include "../../src/common/util/serialise.hpp"
+#include "../../src/common/visit_struct/visit_struct_intrusive.hpp"
+
+#include <format>
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+
+namespace spt::bench
+{
+  struct Address
+  {
+    bool operator==(const Address&) const = default;
+
+    BEGIN_VISITABLES(Address);
+    VISITABLE(std::string, street);
+    VISITABLE(std::string, city);
+    VISITABLE(std::string, postcode);
+    END_VISITABLES;
+  };
+
+  struct Customer
+  {
+    bool operator==(const Customer&) const = default;
+
+    BEGIN_VISITABLES(Customer);
+    VISITABLE(bsoncxx::oid, id);
+    VISITABLE(std::string, name);
+    VISITABLE(std::string, email);
+    VISITABLE(Address, address);
+    VISITABLE(std::vector<std::string>, tags);
+    VISITABLE(std::vector<Address>, previous);
+    VISITABLE(std::optional<std::string>, notes);
+    VISITABLE_DIRECT_INIT(spt::util::DateTimeMs, created, {std::chrono::milliseconds{ 1760745600123 }});
+    VISITABLE_DIRECT_INIT(int64_t, orders, {42});
+    VISITABLE_DIRECT_INIT(double, balance, {1234.56});
+    VISITABLE_DIRECT_INIT(bool, active, {true});
+    END_VISITABLES;
+  };
+
+  inline Customer customer()
+  {
+    auto c = Customer{};
+    c.name = "Jane Citizen";
+    c.email = "jane.citizen@example.com";
+    c.address = Address{ "1 Main Street", "Springfield", "12345" };
+    c.tags = { "retail", "priority", "newsletter", "loyalty" };
+    for ( auto i = 0; i < 4; ++i ) c.previous.push_back( Address{ std::format( "{} Old Road", i + 10 ), "Shelbyville", "54321" } );
+    c.notes = "Prefers delivery in the morning";
+    return c;
+  }
+
+  // A document of approximately the specified size, with nested documents and arrays.
+  inline bsoncxx::document::value payload( std::size_t size )
+  {
+    using bsoncxx::builder::basic::kvp;
+    auto builder = bsoncxx::builder::basic::document{};
+    std::size_t length{ 0 };
+    for ( auto i = 0; length < size; ++i )
+    {
+      builder.append( kvp( std::format( "item{}", i ), [i]( bsoncxx::builder::basic::sub_document doc )
+      {
+        doc.append( kvp( "_id", bsoncxx::oid{} ),
+          kvp( "name", std::format( "Item number {}", i ) ),
+          kvp( "description", "A reasonably long description of the item, used to exercise string handling" ),
+          kvp( "price", i * 1.25 ),
+          kvp( "quantity", int64_t( i ) ),
+          kvp( "created", bsoncxx::types::b_date{ std::chrono::milliseconds{ 1760745600123 + i } } ),
+          kvp( "tags", []( bsoncxx::builder::basic::sub_array arr ) { arr.append( "one", "two", "three" ); } ) );
+      } ) );
+      length = builder.view().length();
+    }
+    return builder.extract();
+  }
+
+  // A service request in the same form as sent by the API.
+  inline bsoncxx::document::value request( std::size_t size )
+  {
+    using bsoncxx::builder::basic::kvp;
+    return bsoncxx::builder::basic::make_document(
+      kvp( "action", "create" ),
+      kvp( "database", "bench" ),
+      kvp( "collection", "customer" ),
+      kvp( "document", payload( size ) ),
+      kvp( "metadata", bsoncxx::builder::basic::make_document( kvp( "project", "bench" ), kvp( "product", "mongo-service" ) ) ),
+      kvp( "application", "mongo-service-bench" ),
+      kvp( "correlationId", "c0ffee" ) );
+  }
+}
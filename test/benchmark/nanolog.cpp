@@ -0,0 +1,68 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "../../src/log/NanoLog.hpp"
+
+#include <atomic>
+#include <barrier>
+#include <format>
+#include <thread>
+#include <vector>
+#include <bsoncxx/oid.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+SCENARIO( "NanoLog benchmark", "[benchmark][nanolog]" )
+{
+  GIVEN( "Threads logging concurrently" )
+  {
+    constexpr auto lines = 10'000;
+    const auto id = bsoncxx::oid{};
+
+    for ( const auto count : { 1, 2, 4, 8, 16, 32, 64 } )
+    {
+      const auto work = [&id]
+      {
+        for ( auto j = 0; j < lines; ++j )
+        {
+          LOG_INFO << "Retrieved document " << id << " from " << std::string_view{ "bench:customer" } << " in " << j << "us";
+        }
+      };
+
+      // Workers are started once, outside the measured code, so that thread start-up and the allocation
+      // of the per-thread staging buffers are not measured.  Each iteration releases all the workers
+      // together with the benchmark thread, and completes when they have all finished.
+      auto start = std::barrier{ count };
+      auto done = std::barrier{ count };
+      auto stop = std::atomic_bool{ false };
+      auto workers = std::vector<std::thread>{};
+      workers.reserve( count - 1 );
+      for ( auto i = 1; i < count; ++i )
+      {
+        workers.emplace_back( [&]
+        {
+          for (;;)
+          {
+            start.arrive_and_wait();
+            if ( stop.load( std::memory_order_acquire ) ) break;
+            work();
+            done.arrive_and_wait();
+          }
+        } );
+      }
+
+      BENCHMARK( std::format( "{} threads logging {} lines each", count, lines ) )
+      {
+        start.arrive_and_wait();
+        work();
+        done.arrive_and_wait();
+        return workers.size();
+      };
+
+      stop.store( true, std::memory_order_release );
+      start.arrive_and_wait();
+      for ( auto& t : workers ) t.join();
+    }
+  }
+}
@@ -0,0 +1,84 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "../../src/api/pool/pool.hpp"
+
+#include <atomic>
+#include <barrier>
+#include <format>
+#include <thread>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+namespace
+{
+  namespace ppool
+  {
+    struct Connection
+    {
+      [[nodiscard]] bool valid() const { return true; }
+      uint64_t used{ 0 };
+    };
+
+    std::unique_ptr<Connection> create() { return std::make_unique<Connection>(); }
+  }
+}
+
+SCENARIO( "Connection pool benchmark", "[benchmark][pool]" )
+{
+  GIVEN( "A connection pool shared by threads" )
+  {
+    constexpr auto operations = 10'000;
+    auto config = spt::mongoservice::pool::Configuration{};
+    config.initialSize = 4;
+    config.maxPoolSize = 64;
+    config.maxConnections = 128;
+
+    for ( const auto count : { 1, 2, 4, 8, 16, 32 } )
+    {
+      auto pool = spt::mongoservice::pool::Pool<ppool::Connection>{ ppool::create, config };
+      const auto work = [&pool]
+      {
+        for ( auto j = 0; j < operations; ++j )
+        {
+          if ( auto proxy = pool.acquire(); proxy ) ++( *proxy )->used;
+        }
+      };
+
+      // Workers are started once, outside the measured code.  Each iteration releases all the workers
+      // together with the benchmark thread, and completes when they have all finished.
+      auto start = std::barrier{ count };
+      auto done = std::barrier{ count };
+      auto stop = std::atomic_bool{ false };
+      auto workers = std::vector<std::thread>{};
+      workers.reserve( count - 1 );
+      for ( auto i = 1; i < count; ++i )
+      {
+        workers.emplace_back( [&]
+        {
+          for (;;)
+          {
+            start.arrive_and_wait();
+            if ( stop.load( std::memory_order_acquire ) ) break;
+            work();
+            done.arrive_and_wait();
+          }
+        } );
+      }
+
+      BENCHMARK( std::format( "{} threads acquiring and releasing {} times each", count, operations ) )
+      {
+        start.arrive_and_wait();
+        work();
+        done.arrive_and_wait();
+        return pool.totalCreated();
+      };
+
+      stop.store( true, std::memory_order_release );
+      start.arrive_and_wait();
+      for ( auto& t : workers ) t.join();
+    }
+  }
+}
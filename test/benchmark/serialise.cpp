@@ -0,0 +1,59 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "model.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+SCENARIO( "Serialisation benchmark", "[benchmark][serialise]" )
+{
+  GIVEN( "A visitable model" )
+  {
+    const auto customer = spt::bench::customer();
+    const auto bson = spt::util::marshall( customer );
+    const auto json = spt::util::json::str( customer );
+
+    BENCHMARK( "Marshall model to BSON" )
+    {
+      return spt::util::marshall( customer );
+    };
+
+    BENCHMARK( "Unmarshall model from BSON" )
+    {
+      return spt::util::unmarshall<spt::bench::Customer>( bson.view() );
+    };
+
+    BENCHMARK( "Serialise model to JSON" )
+    {
+      return spt::util::json::str( customer );
+    };
+
+    BENCHMARK( "Parse model from JSON" )
+    {
+      return spt::util::json::unmarshall<spt::bench::Customer>( json );
+    };
+
+    BENCHMARK( "JSON round trip" )
+    {
+      return spt::util::json::unmarshall<spt::bench::Customer>( spt::util::json::str( customer ) );
+    };
+  }
+
+  GIVEN( "A large BSON document" )
+  {
+    const auto document = spt::bench::payload( 256 * 1024 );
+    const auto json = spt::util::toJsonString( document.view() );
+
+    BENCHMARK( std::format( "Write JSON for BSON document of {} bytes", document.view().length() ) )
+    {
+      return spt::util::toJsonString( document.view() );
+    };
+
+    BENCHMARK( std::format( "Transcode JSON document of {} bytes to BSON", json.size() ) )
+    {
+      return spt::util::toBson( json );
+    };
+  }
+}
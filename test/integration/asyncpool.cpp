@@ -0,0 +1,108 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+#include "../../src/api/pool/asyncpool.hpp"
+
+#include <chrono>
+#include <vector>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+  namespace pasyncpool
+  {
+    struct Connection
+    {
+      [[nodiscard]] bool valid() const { return true; }
+    };
+
+    using Pool = spt::mongoservice::pool::AsyncPool<Connection>;
+
+    std::unique_ptr<Connection> create() { return std::make_unique<Connection>(); }
+
+    // Acquire a connection and hold it for the specified duration.  Records whether a connection was acquired.
+    boost::asio::awaitable<void> hold( Pool& pool, std::chrono::milliseconds duration, std::vector<bool>& results )
+    {
+      auto proxy = co_await pool.acquire();
+      results.push_back( proxy.has_value() );
+      if ( !proxy ) co_return;
+
+      auto timer = boost::asio::steady_timer{ co_await boost::asio::this_coro::executor, duration };
+      co_await timer.async_wait( boost::asio::use_awaitable );
+    }
+  }
+}
+
+SCENARIO( "Async connection pool test suite", "[pool]" )
+{
+  GIVEN( "An async pool with a single connection" )
+  {
+    using namespace std::chrono_literals;
+    auto config = spt::mongoservice::pool::Configuration{};
+    config.initialSize = 0;
+    config.maxConnections = 1;
+    config.maxWaitTime = 200ms;
+
+    auto ioc = boost::asio::io_context{};
+    auto results = std::vector<bool>{};
+
+    WHEN( "A second coroutine waits for the connection to be released" )
+    {
+      auto pool = pasyncpool::Pool{ pasyncpool::create, config };
+      boost::asio::co_spawn( ioc, pasyncpool::hold( pool, 50ms, results ), boost::asio::detached );
+      boost::asio::co_spawn( ioc, pasyncpool::hold( pool, 0ms, results ), boost::asio::detached );
+      ioc.run();
+
+      REQUIRE( results.size() == 2 );
+      CHECK( results[0] );
+      CHECK( results[1] );
+
+      const auto stats = pool.stats();
+      CHECK( stats.acquired == 2 );
+      CHECK( stats.waited == 1 );
+      CHECK( stats.timeouts == 0 );
+      CHECK( stats.maxWait >= 40ms );
+      CHECK( stats.waiting == 0 );
+      CHECK( pool.active() == 0 );
+      CHECK( pool.totalCreated() == 1 );
+    }
+
+    AND_WHEN( "Waiting coroutines are woken in order, or time out" )
+    {
+      auto pool = pasyncpool::Pool{ pasyncpool::create, config };
+      boost::asio::co_spawn( ioc, pasyncpool::hold( pool, 50ms, results ), boost::asio::detached );
+      boost::asio::co_spawn( ioc, pasyncpool::hold( pool, 500ms, results ), boost::asio::detached );
+      boost::asio::co_spawn( ioc, pasyncpool::hold( pool, 0ms, results ), boost::asio::detached );
+      ioc.run();
+
+      REQUIRE( results.size() == 3 );
+      CHECK( results[0] );
+      CHECK( results[1] );
+      CHECK_FALSE( results[2] );
+
+      const auto stats = pool.stats();
+      CHECK( stats.acquired == 2 );
+      CHECK( stats.waited == 1 );
+      CHECK( stats.timeouts == 1 );
+      CHECK( stats.waiting == 0 );
+      CHECK( pool.active() == 0 );
+    }
+
+    AND_WHEN( "Waiting is disabled" )
+    {
+      config.maxWaitTime = 0ms;
+      auto pool = pasyncpool::Pool{ pasyncpool::create, config };
+      boost::asio::co_spawn( ioc, pasyncpool::hold( pool, 50ms, results ), boost::asio::detached );
+      boost::asio::co_spawn( ioc, pasyncpool::hold( pool, 0ms, results ), boost::asio::detached );
+      ioc.run();
+
+      REQUIRE( results.size() == 2 );
+      CHECK( results[0] );
+      CHECK_FALSE( results[1] );
+      CHECK( pool.stats().timeouts == 1 );
+    }
+  }
+}
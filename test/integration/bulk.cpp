@@ -23,6 +23,78 @@ namespace
     const auto oid2 = bsoncxx::oid{};
     std::vector<bsoncxx::oid> oids;
     int64_t count = 0;
+
+    const auto group = bsoncxx::oid{};
+    std::vector<bsoncxx::oid> unordered;
+
+    struct Counts
+    {
+      int32_t create;
+      int32_t history;
+      int32_t remove;
+    };
+
+    // Execute an unordered bulk request with the specified documents to insert and remove.
+    Counts execute( const std::vector<bsoncxx::oid>& insert, const std::vector<bsoncxx::oid>& remove )
+    {
+      namespace basic = bsoncxx::builder::basic;
+      using basic::kvp;
+
+      auto doc = basic::document{};
+      if ( !insert.empty() )
+      {
+        auto arr = basic::array{};
+        for ( const auto& id : insert ) arr.append( basic::make_document( kvp( "_id", id ), kvp( "group", group ), kvp( "key", "value" ) ) );
+        doc.append( kvp( "insert", arr.extract() ) );
+      }
+      if ( !remove.empty() )
+      {
+        auto arr = basic::array{};
+        for ( const auto& id : remove ) arr.append( basic::make_document( kvp( "_id", id ) ) );
+        doc.append( kvp( "remove", arr.extract() ) );
+      }
+
+      bsoncxx::document::value document = basic::make_document(
+          kvp( "action", "bulk" ),
+          kvp( "database", "itest" ),
+          kvp( "collection", "test" ),
+          kvp( "document", doc.extract() ),
+          kvp( "options", basic::make_document( kvp( "ordered", false ) ) ) );
+
+      const auto [type, option] = spt::mongoservice::api::execute( document.view() );
+      REQUIRE( type == spt::mongoservice::api::ResultType::success );
+      REQUIRE( option.has_value() );
+      const auto opt = option->view();
+      REQUIRE( opt.find( "error" ) == opt.end() );
+
+      return Counts{
+        .create = spt::util::bsonValue<int32_t>( "create", opt ),
+        .history = spt::util::bsonValue<int32_t>( "history", opt ),
+        .remove = spt::util::bsonValue<int32_t>( "remove", opt )
+      };
+    }
+
+    // Number of documents in the collection created by the unordered bulk requests.
+    int64_t total()
+    {
+      namespace basic = bsoncxx::builder::basic;
+      using basic::kvp;
+
+      bsoncxx::document::value document = basic::make_document(
+          kvp( "action", "count" ),
+          kvp( "database", "itest" ),
+          kvp( "collection", "test" ),
+          kvp( "document", basic::make_document( kvp( "group", group ) ) ) );
+
+      const auto [type, option] = spt::mongoservice::api::execute( document.view() );
+      REQUIRE( type == spt::mongoservice::api::ResultType::success );
+      REQUIRE( option.has_value() );
+      REQUIRE( option->view().find( "error" ) == option->view().end() );
+
+      const auto count = spt::util::bsonValueIfExists<int64_t>( "count", option->view() );
+      REQUIRE( count );
+      return *count;
+    }
   }
 }
 
@@ -256,3 +328,48 @@ SCENARIO( "Bulk operation test suite", "[bulk]" )
   }
 }
 
+// Unordered requests with more operations than the `bulkChunkSize` of the service are executed in chunks.
+// Run the service with a small chunk size (for example `--bulk-chunk-size 100`) to exercise chunking.
+SCENARIO( "Unordered bulk operation test suite", "[bulk]" )
+{
+  GIVEN( "Connected to Mongo Service" )
+  {
+    WHEN( "Creating documents in an unordered bulk request" )
+    {
+      pbulk::unordered.reserve( 1600 );
+      for ( auto i = 0; i < 1000; ++i ) pbulk::unordered.emplace_back( bsoncxx::oid{} );
+
+      const auto counts = pbulk::execute( pbulk::unordered, {} );
+      CHECK( counts.create == 1000 );
+      CHECK( counts.history == 1000 );
+      CHECK( counts.remove == 0 );
+      REQUIRE( pbulk::total() == 1000 );
+    }
+
+    AND_THEN( "Creating and deleting documents in an unordered bulk request" )
+    {
+      auto insert = std::vector<bsoncxx::oid>{};
+      insert.reserve( 600 );
+      for ( auto i = 0; i < 600; ++i ) insert.emplace_back( bsoncxx::oid{} );
+      const auto remove = std::vector<bsoncxx::oid>{ pbulk::unordered.begin(), pbulk::unordered.begin() + 400 };
+
+      const auto counts = pbulk::execute( insert, remove );
+      CHECK( counts.create == 600 );
+      CHECK( counts.history == 1000 );
+      CHECK( counts.remove == 400 );
+      REQUIRE( pbulk::total() == 1200 );
+
+      pbulk::unordered.erase( pbulk::unordered.begin(), pbulk::unordered.begin() + 400 );
+      pbulk::unordered.insert( pbulk::unordered.end(), insert.begin(), insert.end() );
+    }
+
+    AND_THEN( "Deleting documents in an unordered bulk request" )
+    {
+      const auto counts = pbulk::execute( {}, pbulk::unordered );
+      CHECK( counts.create == 0 );
+      CHECK( counts.history == 1200 );
+      CHECK( counts.remove == 1200 );
+      REQUIRE( pbulk::total() == 0 );
+    }
+  }
+}
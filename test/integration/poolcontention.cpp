@@ -0,0 +1,204 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+#include "../../src/api/pool/pool.hpp"
+#include "../../src/common/util/defer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <chrono>
+#include <format>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+namespace
+{
+  namespace ppoolcontention
+  {
+    struct Connection
+    {
+      [[nodiscard]] bool valid() const { return true; }
+    };
+
+    std::unique_ptr<Connection> create() { return std::make_unique<Connection>(); }
+
+    // Connection that tracks the number of instances, to check that expired connections are closed.
+    struct Counted
+    {
+      Counted() { ++live; }
+      ~Counted() { --live; }
+
+      Counted(const Counted&) = delete;
+      Counted& operator=(const Counted&) = delete;
+
+      [[nodiscard]] bool valid() const { return true; }
+
+      static inline std::atomic_int live{ 0 };
+    };
+
+    // Mutex guarded pool, used as the baseline for the benchmarks.
+    struct LockedPool
+    {
+      std::unique_ptr<Connection> acquire()
+      {
+        auto lock = std::unique_lock( mutex );
+        if ( available.empty() ) return create();
+        auto con = std::move( available.front() );
+        available.pop_front();
+        return con;
+      }
+
+      void release( std::unique_ptr<Connection> con )
+      {
+        auto lock = std::unique_lock( mutex );
+        if ( available.size() < 25 ) available.push_back( std::move( con ) );
+      }
+
+    private:
+      std::mutex mutex;
+      std::deque<std::unique_ptr<Connection>> available;
+    };
+
+    template <typename Function>
+    void run( std::size_t count, Function&& function )
+    {
+      auto threads = std::vector<std::thread>{};
+      threads.reserve( count );
+      for ( std::size_t i = 0; i < count; ++i ) threads.emplace_back( function );
+      for ( auto& t : threads ) t.join();
+    }
+  }
+}
+
+SCENARIO( "Connection pool contention test suite", "[pool]" )
+{
+  using ppoolcontention::Connection;
+
+  GIVEN( "A connection pool shared by multiple threads" )
+  {
+    auto config = spt::mongoservice::pool::Configuration{};
+    config.initialSize = 1;
+    config.maxPoolSize = 4;
+    config.maxConnections = 6;
+    spt::mongoservice::pool::Pool<Connection> pool{ ppoolcontention::create, std::move( config ) };
+
+    WHEN( "Threads acquire and release connections concurrently" )
+    {
+      std::atomic_uint32_t maximum{ 0 };
+      std::atomic_uint32_t failures{ 0 };
+
+      ppoolcontention::run( 12, [&pool, &maximum, &failures]
+      {
+        for ( auto i = 0; i < 10'000; ++i )
+        {
+          auto proxy = pool.acquire();
+          if ( !proxy )
+          {
+            ++failures;
+            continue;
+          }
+
+          auto current = maximum.load();
+          while ( current < pool.active() && !maximum.compare_exchange_weak( current, pool.active() ) );
+        }
+      } );
+
+      INFO( "Failed to acquire " << failures.load() << " times" );
+      CHECK( maximum.load() <= 6 );
+      CHECK( pool.active() == 0 );
+      CHECK( pool.inactive() <= 4 );
+    }
+  }
+}
+
+SCENARIO( "Connection pool idle expiry test suite", "[pool]" )
+{
+  using ppoolcontention::Counted;
+  using namespace std::chrono_literals;
+
+  GIVEN( "A connection pool with idle connections cached by running threads" )
+  {
+    auto config = spt::mongoservice::pool::Configuration{};
+    config.initialSize = 0;
+    config.maxPoolSize = 4;
+    config.maxIdleTime = std::chrono::seconds{ 1 };
+    spt::mongoservice::pool::Pool<Counted> pool{ []{ return std::make_unique<Counted>(); }, std::move( config ) };
+
+    {
+      // Released to the cache of this thread and to the shared queue.
+      auto p1 = pool.acquire();
+      auto p2 = pool.acquire();
+    }
+
+    auto cached = std::latch{ 1 };
+    auto done = std::latch{ 1 };
+    auto worker = std::thread{ [&pool, &cached, &done]
+    {
+      // Takes the connection from the shared queue, and caches it on release.
+      pool.acquire();
+      cached.count_down();
+      done.wait();
+    } };
+    DEFER( done.count_down(); worker.join() );
+
+    cached.wait();
+    REQUIRE( pool.inactive() == 2 );
+    REQUIRE( Counted::live.load() == 2 );
+    REQUIRE( pool.totalCreated() == 2 );
+
+    WHEN( "The connections have been idle for longer than the maximum idle time" )
+    {
+      const auto deadline = std::chrono::steady_clock::now() + 10s;
+      while ( pool.inactive() > 0 && std::chrono::steady_clock::now() < deadline ) std::this_thread::sleep_for( 50ms );
+
+      CHECK( pool.inactive() == 0 );
+      CHECK( Counted::live.load() == 0 );
+      CHECK( pool.active() == 0 );
+
+      auto proxy = pool.acquire();
+      REQUIRE( proxy );
+      CHECK( pool.totalCreated() == 3 );
+    }
+  }
+}
+
+SCENARIO( "Connection pool contention benchmark", "[.][benchmark]" )
+{
+  using ppoolcontention::Connection;
+
+  GIVEN( "Pools shared by multiple threads" )
+  {
+    constexpr auto iterations = 100'000;
+
+    for ( const auto count : { 1, 2, 4, 8, 16 } )
+    {
+      auto config = spt::mongoservice::pool::Configuration{};
+      config.maxConnections = 1024;
+      spt::mongoservice::pool::Pool<Connection> pool{ ppoolcontention::create, std::move( config ) };
+
+      BENCHMARK( std::format( "Pool {} threads acquiring {} times each", count, iterations ) )
+      {
+        ppoolcontention::run( count, [&pool]
+        {
+          for ( auto i = 0; i < iterations; ++i ) auto proxy = pool.acquire();
+        } );
+        return pool.active();
+      };
+
+      auto locked = ppoolcontention::LockedPool{};
+      BENCHMARK( std::format( "Mutex guarded pool {} threads acquiring {} times each", count, iterations ) )
+      {
+        ppoolcontention::run( count, [&locked]
+        {
+          for ( auto i = 0; i < iterations; ++i ) locked.release( locked.acquire() );
+        } );
+        return count;
+      };
+    }
+  }
+}
@@ -0,0 +1,451 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "load.hpp"
+#include "../../src/api/api.hpp"
+#include "../../src/log/NanoLog.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <ranges>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/json/array.hpp>
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/types.hpp>
+
+namespace spt::load::pload
+{
+  using namespace std::string_view_literals;
+  constexpr std::array<std::string_view, ActionCount> names{ "create"sv, "retrieve"sv, "update"sv, "delete"sv,
+    "count"sv, "distinct"sv, "pipeline"sv, "bulk"sv, "transaction"sv };
+  constexpr std::string_view application{ "mongo-service-load" };
+  constexpr int64_t categories = 16;
+
+  std::string_view trim( std::string_view value )
+  {
+    while ( !value.empty() && value.front() == ' ' ) value.remove_prefix( 1 );
+    while ( !value.empty() && value.back() == ' ' ) value.remove_suffix( 1 );
+    return value;
+  }
+
+  bsoncxx::types::b_date now()
+  {
+    return bsoncxx::types::b_date{ std::chrono::time_point_cast<std::chrono::milliseconds>( std::chrono::system_clock::now() ) };
+  }
+
+  bsoncxx::document::value entity( const bsoncxx::oid& id, int64_t value )
+  {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_array;
+    using bsoncxx::builder::basic::make_document;
+
+    return make_document(
+      kvp( "_id", id ),
+      kvp( "name", std::format( "Load test entity {}", value ) ),
+      kvp( "category", std::format( "category-{}", value % categories ) ),
+      kvp( "value", value ),
+      kvp( "tags", make_array( "load", "test", std::format( "tag-{}", value % 7 ) ) ),
+      kvp( "created", now() ) );
+  }
+
+  // Common properties for a request, with the action specific payload appended by the caller.
+  void header( bsoncxx::builder::basic::document& builder, std::string_view action, const Configuration& configuration )
+  {
+    using bsoncxx::builder::basic::kvp;
+    builder.append( kvp( "action", action ), kvp( "database", configuration.database ),
+      kvp( "collection", configuration.collection ), kvp( "application", application ) );
+    if ( configuration.skipVersion ) builder.append( kvp( "skipVersion", true ) );
+    if ( configuration.skipMetric ) builder.append( kvp( "skipMetric", true ) );
+  }
+
+  // Nanosecond values (counts or means) in milliseconds and microseconds.
+  template <typename T>
+  double millis( T nanos ) { return static_cast<double>( nanos ) / 1'000'000.0; }
+
+  template <typename T>
+  double micros( T nanos ) { return static_cast<double>( nanos ) / 1'000.0; }
+}
+
+auto spt::load::parseMix( std::string_view mix ) -> std::expected<Weights, std::string>
+{
+  auto weights = Weights{};
+  for ( const auto part : mix | std::views::split( ',' ) )
+  {
+    const auto entry = pload::trim( std::string_view{ part.begin(), part.end() } );
+    if ( entry.empty() ) continue;
+
+    const auto colon = entry.find( ':' );
+    if ( colon == std::string_view::npos ) return std::unexpected( std::format( "Missing weight for {}", entry ) );
+
+    const auto name = pload::trim( entry.substr( 0, colon ) );
+    const auto iter = std::ranges::find( pload::names, name );
+    if ( iter == pload::names.end() ) return std::unexpected( std::format( "Unknown action {}", name ) );
+
+    const auto weight = pload::trim( entry.substr( colon + 1 ) );
+    uint32_t value{ 0 };
+    if ( const auto [ptr, ec] = std::from_chars( weight.data(), weight.data() + weight.size(), value );
+        ec != std::errc{} || ptr != weight.data() + weight.size() )
+    {
+      return std::unexpected( std::format( "Invalid weight {} for {}", weight, name ) );
+    }
+
+    weights[static_cast<std::size_t>( std::distance( pload::names.begin(), iter ) )] = value;
+  }
+
+  if ( std::ranges::all_of( weights, []( uint32_t w ) { return w == 0; } ) ) return std::unexpected( "No actions in mix" );
+  return weights;
+}
+
+using spt::load::Generator;
+
+Generator::Generator( Configuration conf, Weights w ) : configuration{ std::move( conf ) }, weights{ w }
+{
+  for ( const auto weight : weights ) total += weight;
+}
+
+boost::asio::awaitable<bool> Generator::seed()
+{
+  using bsoncxx::builder::basic::kvp;
+  constexpr uint32_t batch = 100;
+
+  seeds.reserve( configuration.seed );
+  for ( uint32_t i = 0; i < configuration.seed; i += batch )
+  {
+    auto insert = bsoncxx::builder::basic::array{};
+    auto ids = std::vector<bsoncxx::oid>{};
+    ids.reserve( batch );
+    for ( uint32_t j = i; j < std::min( i + batch, configuration.seed ); ++j )
+    {
+      insert.append( pload::entity( ids.emplace_back(), j ) );
+    }
+
+    auto builder = bsoncxx::builder::basic::document{};
+    pload::header( builder, "bulk", configuration );
+    builder.append( kvp( "document", bsoncxx::builder::basic::make_document( kvp( "insert", insert.extract() ) ) ) );
+
+    const auto [type, response] = co_await mongoservice::api::executeAsync( builder.view() );
+    if ( type != mongoservice::api::ResultType::success || !response || response->view().find( "error" ) != response->view().end() )
+    {
+      LOG_CRIT << "Error seeding documents in " << configuration.database << ':' << configuration.collection <<
+        ". " << ( response ? response->view() : bsoncxx::document::view{} );
+      co_return false;
+    }
+
+    seeds.insert( seeds.end(), ids.begin(), ids.end() );
+  }
+
+  LOG_INFO << "Seeded " << uint32_t( seeds.size() ) << " documents in " << configuration.database << ':' << configuration.collection;
+  co_return true;
+}
+
+boost::asio::awaitable<void> Generator::run()
+{
+  using namespace std::chrono_literals;
+
+  auto executor = co_await boost::asio::this_coro::executor;
+  auto timer = boost::asio::steady_timer{ executor };
+
+  const auto start = Clock::now();
+  const auto measure = start + configuration.ramp + configuration.warmup;
+  const auto end = measure + configuration.duration;
+  const auto target = static_cast<double>( std::max( configuration.rate, 1u ) );
+  const auto ramp = std::chrono::duration<double>( configuration.ramp ).count();
+
+  // Scheduled start of the n-th request.  The rate increases linearly from 0 to the target during the ramp,
+  // during which `target * ramp / 2` requests are started.  Computed from the start of the run rather than
+  // accumulated, so that rounding errors do not drift the rate.
+  const auto ramped = target * ramp / 2.0;
+  const auto scheduled = [&]( uint64_t n )
+  {
+    const auto count = static_cast<double>( n );
+    const auto offset = count < ramped ? std::sqrt( 2.0 * ramp * count / target ) : ramp + ( count - ramped ) / target;
+    return start + std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( offset ) );
+  };
+
+  LOG_INFO << "Starting load at " << configuration.rate << " requests/second. Ramp " <<
+    int64_t( configuration.ramp.count() ) << "s, warmup " << int64_t( configuration.warmup.count() ) <<
+    "s, duration " << int64_t( configuration.duration.count() ) << 's';
+
+  uint64_t n = 0;
+  auto next = scheduled( n );
+  while ( next < end )
+  {
+    timer.expires_at( next );
+    co_await timer.async_wait( boost::asio::use_awaitable );
+
+    // Start every request that is due.  If the timer fired late, the requests that should have been started
+    // in the meantime are started now, but keep their scheduled time so that the delay is reported.
+    const auto now = Clock::now();
+    if ( next >= measure ) lag = std::max( lag, std::chrono::duration_cast<std::chrono::nanoseconds>( now - next ) );
+    while ( next <= now && next < end )
+    {
+      const auto record = next >= measure;
+      if ( record ) ++started;
+      inflight.fetch_add( 1, std::memory_order_relaxed );
+      boost::asio::co_spawn( executor, send( request( pick() ), next, record ), boost::asio::detached );
+      next = scheduled( ++n );
+    }
+  }
+
+  LOG_INFO << "Started " << started << " recorded requests. Waiting for " << inflight.load() << " outstanding requests";
+  const auto deadline = Clock::now() + configuration.drain;
+  while ( inflight.load( std::memory_order_acquire ) > 0 && Clock::now() < deadline )
+  {
+    timer.expires_after( 10ms );
+    co_await timer.async_wait( boost::asio::use_awaitable );
+  }
+  pending = inflight.load( std::memory_order_acquire );
+  if ( pending > 0 ) LOG_WARN << pending << " requests outstanding after waiting " << int64_t( configuration.drain.count() ) << 's';
+
+  summary = results();
+}
+
+std::string Generator::report() const
+{
+  using namespace std::string_view_literals;
+  auto out = std::string{};
+  out.reserve( 2048 );
+
+  std::format_to( std::back_inserter( out ), "{:<12}{:>10}{:>8}{:>8}{:>10}{:>10}{:>10}{:>10}{:>10}{:>10}\n",
+    "action"sv, "count"sv, "errors"sv, "failed"sv, "mean"sv, "p50"sv, "p90"sv, "p99"sv, "p99.9"sv, "max"sv );
+  for ( const auto& result : summary )
+  {
+    const auto& h = result.latency;
+    std::format_to( std::back_inserter( out ), "{:<12}{:>10}{:>8}{:>8}{:>10.3f}{:>10.3f}{:>10.3f}{:>10.3f}{:>10.3f}{:>10.3f}\n",
+      result.name, result.count, result.errors, result.poolFailures + result.commandFailures,
+      pload::millis( h.mean() ), pload::millis( h.percentile( 50 ) ), pload::millis( h.percentile( 90 ) ),
+      pload::millis( h.percentile( 99 ) ), pload::millis( h.percentile( 99.9 ) ), pload::millis( h.max() ) );
+  }
+
+  const auto seconds = std::chrono::duration<double>( configuration.duration ).count();
+  const auto completed = summary.empty() ? uint64_t{ 0 } : summary.back().count;
+  std::format_to( std::back_inserter( out ),
+    "\nLatencies in milliseconds, measured from the scheduled start of each request.\n"
+    "Target rate {} requests/s.  Started {} ({:.1f}/s), completed {} ({:.1f}/s) in {}s.\n"
+    "Maximum scheduling lag {:.3f}ms.  {} requests outstanding at exit.\n",
+    configuration.rate, started, static_cast<double>( started ) / seconds, completed,
+    static_cast<double>( completed ) / seconds, configuration.duration.count(), pload::millis( lag.count() ), pending );
+
+  const auto pool = mongoservice::api::asyncPoolStats();
+  std::format_to( std::back_inserter( out ),
+    "Connection pool: {} acquired, {} waited, {} timed out, maximum wait {:.3f}ms.\n",
+    pool.acquired, pool.waited, pool.timeouts, static_cast<double>( pool.maxWait.count() ) / 1000.0 );
+
+  return out;
+}
+
+boost::json::object Generator::json() const
+{
+  const auto latency = []( const util::Histogram& h )
+  {
+    return boost::json::object{
+      { "mean", pload::micros( h.mean() ) },
+      { "p50", pload::micros( h.percentile( 50 ) ) },
+      { "p90", pload::micros( h.percentile( 90 ) ) },
+      { "p99", pload::micros( h.percentile( 99 ) ) },
+      { "p999", pload::micros( h.percentile( 99.9 ) ) },
+      { "max", pload::micros( h.max() ) } };
+  };
+
+  auto actions = boost::json::object{};
+  for ( const auto& result : summary )
+  {
+    actions.emplace( result.name, boost::json::object{
+      { "count", result.count },
+      { "errors", result.errors },
+      { "poolFailures", result.poolFailures },
+      { "commandFailures", result.commandFailures },
+      { "latency", latency( result.latency ) } } );
+  }
+
+  const auto pool = mongoservice::api::asyncPoolStats();
+  const auto seconds = std::chrono::duration<double>( configuration.duration ).count();
+  const auto completed = summary.empty() ? uint64_t{ 0 } : summary.back().count;
+  return boost::json::object{
+    { "configuration", boost::json::object{
+      { "database", configuration.database },
+      { "collection", configuration.collection },
+      { "mix", configuration.mix },
+      { "rate", configuration.rate },
+      { "ramp", configuration.ramp.count() },
+      { "warmup", configuration.warmup.count() },
+      { "duration", configuration.duration.count() } } },
+    { "started", started },
+    { "completed", completed },
+    { "throughput", static_cast<double>( completed ) / seconds },
+    { "outstanding", pending },
+    { "maxLag", pload::micros( lag.count() ) },
+    { "actions", std::move( actions ) },
+    { "pool", boost::json::object{
+      { "acquired", pool.acquired },
+      { "waited", pool.waited },
+      { "timeouts", pool.timeouts },
+      { "totalWait", pool.totalWait.count() },
+      { "maxWait", pool.maxWait.count() } } } };
+}
+
+boost::asio::awaitable<void> Generator::send( Request req, Clock::time_point scheduled, bool record )
+{
+  auto type = mongoservice::api::ResultType::commandFailure;
+  auto error = false;
+  try
+  {
+    auto [result, response] = co_await mongoservice::api::executeAsync( req.document.view() );
+    type = result;
+    error = response && response->view().find( "error" ) != response->view().end();
+  }
+  catch ( const std::exception& ex )
+  {
+    LOG_WARN_RATE( 1 ) << "Error executing " << pload::names[static_cast<std::size_t>( req.action )] << " request. " << ex.what();
+  }
+
+  const auto elapsed = Clock::now() - scheduled;
+  const auto success = type == mongoservice::api::ResultType::success && !error;
+  if ( success && !req.created.empty() )
+  {
+    auto lock = std::scoped_lock{ mutex };
+    created.insert( created.end(), req.created.begin(), req.created.end() );
+  }
+
+  if ( record )
+  {
+    auto& s = stats[static_cast<std::size_t>( req.action )];
+    s.latency.record( std::chrono::duration_cast<std::chrono::nanoseconds>( elapsed ).count() );
+    s.count.fetch_add( 1, std::memory_order_relaxed );
+    if ( error ) s.errors.fetch_add( 1, std::memory_order_relaxed );
+    if ( type == mongoservice::api::ResultType::poolFailure ) s.poolFailures.fetch_add( 1, std::memory_order_relaxed );
+    if ( type == mongoservice::api::ResultType::commandFailure ) s.commandFailures.fetch_add( 1, std::memory_order_relaxed );
+  }
+
+  inflight.fetch_sub( 1, std::memory_order_release );
+}
+
+auto Generator::request( Action action ) -> Request
+{
+  using bsoncxx::builder::basic::kvp;
+  using bsoncxx::builder::basic::make_array;
+  using bsoncxx::builder::basic::make_document;
+
+  auto value = std::uniform_int_distribution<int64_t>{ 0, 1'000'000 }( engine );
+  auto ids = std::vector<bsoncxx::oid>{};
+
+  // Only delete documents created during the run, so that the seeded documents remain available.  Issue
+  // a create instead if there are none yet.
+  auto deleted = std::optional<bsoncxx::oid>{};
+  if ( action == Action::_delete )
+  {
+    auto lock = std::scoped_lock{ mutex };
+    if ( created.empty() ) action = Action::create;
+    else
+    {
+      deleted = created.back();
+      created.pop_back();
+    }
+  }
+
+  auto builder = bsoncxx::builder::basic::document{};
+  if ( action == Action::transaction )
+  {
+    const auto& id = ids.emplace_back();
+    builder.append( kvp( "action", "transaction" ), kvp( "application", pload::application ),
+      kvp( "document", make_document( kvp( "items", make_array(
+        make_document( kvp( "action", "create" ), kvp( "database", configuration.database ),
+          kvp( "collection", configuration.collection ), kvp( "document", pload::entity( id, value ) ) ),
+        make_document( kvp( "action", "update" ), kvp( "database", configuration.database ),
+          kvp( "collection", configuration.collection ),
+          kvp( "document", make_document( kvp( "_id", seeded() ), kvp( "value", value ), kvp( "modified", pload::now() ) ) ) ) ) ) ) ) );
+    return Request{ builder.extract(), std::move( ids ), action };
+  }
+
+  pload::header( builder, pload::names[static_cast<std::size_t>( action )], configuration );
+  switch ( action )
+  {
+  case Action::create:
+    builder.append( kvp( "document", pload::entity( ids.emplace_back(), value ) ) );
+    break;
+  case Action::retrieve:
+    builder.append( kvp( "document", make_document( kvp( "_id", seeded() ) ) ) );
+    break;
+  case Action::update:
+    builder.append( kvp( "document", make_document( kvp( "_id", seeded() ), kvp( "value", value ), kvp( "modified", pload::now() ) ) ) );
+    break;
+  case Action::_delete:
+    builder.append( kvp( "document", make_document( kvp( "_id", *deleted ) ) ) );
+    break;
+  case Action::count:
+    builder.append( kvp( "document", make_document( kvp( "value", make_document( kvp( "$gte", value ) ) ) ) ) );
+    break;
+  case Action::distinct:
+    builder.append( kvp( "document", make_document( kvp( "field", "category" ),
+      kvp( "filter", make_document( kvp( "value", make_document( kvp( "$lt", value ) ) ) ) ) ) ) );
+    break;
+  case Action::pipeline:
+    builder.append( kvp( "document", make_document( kvp( "specification", make_array(
+      make_document( kvp( "$match", make_document( kvp( "category", std::format( "category-{}", value % pload::categories ) ) ) ) ),
+      make_document( kvp( "$sort", make_document( kvp( "_id", -1 ) ) ) ),
+      make_document( kvp( "$limit", 20 ) ) ) ) ) ) );
+    break;
+  case Action::bulk:
+  {
+    auto insert = bsoncxx::builder::basic::array{};
+    ids.reserve( configuration.batch );
+    for ( uint32_t i = 0; i < configuration.batch; ++i ) insert.append( pload::entity( ids.emplace_back(), value + i ) );
+    builder.append( kvp( "document", make_document( kvp( "insert", insert.extract() ) ) ) );
+    break;
+  }
+  case Action::transaction:
+    break;
+  }
+
+  return Request{ builder.extract(), std::move( ids ), action };
+}
+
+auto Generator::pick() -> Action
+{
+  auto value = std::uniform_int_distribution<uint32_t>{ 0, total - 1 }( engine );
+  for ( std::size_t i = 0; i < weights.size(); ++i )
+  {
+    if ( value < weights[i] ) return static_cast<Action>( i );
+    value -= weights[i];
+  }
+  return Action::retrieve;
+}
+
+const bsoncxx::oid& Generator::seeded()
+{
+  return seeds[std::uniform_int_distribution<std::size_t>{ 0, seeds.size() - 1 }( engine )];
+}
+
+auto Generator::results() -> std::vector<Result>
+{
+  auto out = std::vector<Result>{};
+  out.reserve( ActionCount + 1 );
+  auto all = Result{ "total", {}, 0, 0, 0, 0 };
+
+  for ( std::size_t i = 0; i < ActionCount; ++i )
+  {
+    auto& s = stats[i];
+    if ( weights[i] == 0 && s.count.load() == 0 ) continue;
+
+    auto& result = out.emplace_back( pload::names[i], util::Histogram{}, s.count.load(), s.errors.load(),
+      s.poolFailures.load(), s.commandFailures.load() );
+    s.latency.drain( result.latency );
+    all.latency.merge( result.latency );
+    all.count += result.count;
+    all.errors += result.errors;
+    all.poolFailures += result.poolFailures;
+    all.commandFailures += result.commandFailures;
+  }
+
+  out.push_back( std::move( all ) );
+  return out;
+}
@@ -0,0 +1,153 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#pragma once
+
+#include "../../src/common/util/histogram.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/json/object.hpp>
+#include <bsoncxx/oid.hpp>
+#include <bsoncxx/document/value.hpp>
+
+namespace spt::load
+{
+  enum class Action : uint8_t { create, retrieve, update, _delete, count, distinct, pipeline, bulk, transaction };
+  constexpr std::size_t ActionCount = 9;
+  using Weights = std::array<uint32_t, ActionCount>;
+
+  struct Configuration
+  {
+    std::string database{ "load" };
+    std::string collection{ "test" };
+    // Weighted request mix, see `parseMix`.
+    std::string mix{ "create:20,retrieve:40,update:15,delete:5,count:4,distinct:4,pipeline:6,bulk:3,transaction:3" };
+    // Number of requests started per second once the ramp is complete.
+    uint32_t rate{ 1000 };
+    // Number of documents created before the run for retrieve, update and transaction requests.
+    uint32_t seed{ 1000 };
+    // Number of documents inserted by each bulk request.
+    uint32_t batch{ 10 };
+    std::chrono::seconds ramp{ 10 };
+    std::chrono::seconds warmup{ 10 };
+    std::chrono::seconds duration{ 60 };
+    // Maximum time to wait for outstanding requests once all requests have been started.
+    std::chrono::seconds drain{ 30 };
+    bool skipVersion{ false };
+    bool skipMetric{ false };
+  };
+
+  /**
+   * Parse a request mix of the form `action:weight,action:weight...`.  Actions that are not
+   * specified have a weight of `0`.
+   * @param mix The mix to parse.
+   * @return The weights indexed by action, or the reason the mix is invalid.
+   */
+  std::expected<Weights, std::string> parseMix( std::string_view mix );
+
+  /**
+   * Open loop load generator.  Requests are started at fixed intervals for the configured rate,
+   * irrespective of how long earlier requests take to complete.  Latency is measured from the
+   * time at which a request was scheduled to start, not from when it was sent, so that time
+   * spent queued behind slow requests is included in the results (avoids coordinated omission).
+   *
+   * A run has three phases.  The rate is increased linearly to the target over the `ramp` period,
+   * the target rate is held for the `warmup` period, and then for the `duration` period.  Only
+   * requests scheduled in the final phase are recorded.
+   */
+  struct Generator
+  {
+    Generator( Configuration configuration, Weights weights );
+    ~Generator() = default;
+
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+    /**
+     * Create the documents used by the retrieve, update and transaction requests.
+     * @return `false` if the documents could not be created.
+     */
+    boost::asio::awaitable<bool> seed();
+
+    /**
+     * Run all the phases, and wait (up to `drain`) for outstanding requests to complete.
+     */
+    boost::asio::awaitable<void> run();
+
+    /**
+     * Summary of the recorded requests as a table.  Latencies are in milliseconds.
+     */
+    [[nodiscard]] std::string report() const;
+
+    /**
+     * Summary of the recorded requests as JSON.  Latencies are in microseconds.
+     */
+    [[nodiscard]] boost::json::object json() const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats
+    {
+      util::AtomicHistogram latency;
+      std::atomic_uint64_t count{ 0 };
+      // Requests for which the service responded with an error document.
+      std::atomic_uint64_t errors{ 0 };
+      std::atomic_uint64_t poolFailures{ 0 };
+      std::atomic_uint64_t commandFailures{ 0 };
+    };
+
+    struct Result
+    {
+      std::string_view name;
+      util::Histogram latency;
+      uint64_t count;
+      uint64_t errors;
+      uint64_t poolFailures;
+      uint64_t commandFailures;
+    };
+
+    struct Request
+    {
+      bsoncxx::document::value document;
+      // Documents that may be deleted once the request has completed successfully.
+      std::vector<bsoncxx::oid> created;
+      Action action;
+    };
+
+    boost::asio::awaitable<void> send( Request request, Clock::time_point scheduled, bool record );
+    Request request( Action action );
+    Action pick();
+    const bsoncxx::oid& seeded();
+    std::vector<Result> results();
+
+    Configuration configuration;
+    Weights weights;
+    uint32_t total{ 0 };
+    std::array<Stats, ActionCount> stats{};
+    // Only accessed by the coroutine scheduling requests.
+    std::mt19937_64 engine{ std::random_device{}() };
+    std::vector<bsoncxx::oid> seeds;
+    // Documents created during the run, available for delete requests.
+    std::vector<bsoncxx::oid> created;
+    std::mutex mutex;
+    std::atomic_uint32_t inflight{ 0 };
+    uint64_t started{ 0 };
+    uint64_t pending{ 0 };
+    std::chrono::nanoseconds lag{ 0 };
+    // Results by action, followed by the total for all actions.  Populated at the end of `run`.
+    std::vector<Result> summary;
+  };
+}
@@ -0,0 +1,147 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "load.hpp"
+#include "../../src/api/api.hpp"
+#include "../../src/common/util/clara.hpp"
+#include "../../src/log/NanoLog.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/json/serialize.hpp>
+
+namespace spt::load::pmain
+{
+  boost::asio::awaitable<void> execute( Generator& generator, bool& seeded )
+  {
+    seeded = co_await generator.seed();
+    if ( seeded ) co_await generator.run();
+  }
+}
+
+int main( int argc, char const * const * argv )
+{
+  using clara::Opt;
+  auto configuration = spt::load::Configuration{};
+  std::string server{ "localhost" };
+  std::string port{ "2000" };
+  std::string logLevel{ "info" };
+  std::string dir{ "/tmp/" };
+  std::string output;
+  uint32_t connections{ 64 };
+  uint32_t threads{ std::max( std::thread::hardware_concurrency(), 1u ) };
+  uint32_t ramp{ 10 };
+  uint32_t warmup{ 10 };
+  uint32_t duration{ 60 };
+  bool help = false;
+
+  auto options = clara::Help(help) |
+      Opt(server, "localhost")["-s"]["--server"]("Server to connect to (default localhost).") |
+      Opt(port, "2000")["-p"]["--port"]("TCP port for the server (default 2000)") |
+      Opt(configuration.database, "load")["-d"]["--database"]("Database to use for the test (default load).") |
+      Opt(configuration.collection, "test")["-c"]["--collection"]("Collection to use for the test (default test).") |
+      Opt(configuration.mix, "create:20,retrieve:40,...")["-m"]["--mix"]("Weighted request mix (action:weight,...).") |
+      Opt(configuration.rate, "1000")["-r"]["--rate"]("Requests started per second (default 1000).") |
+      Opt(ramp, "10")["--ramp"]("Seconds over which the rate is increased to the target (default 10).") |
+      Opt(warmup, "10")["--warmup"]("Seconds at the target rate before recording (default 10).") |
+      Opt(duration, "60")["--duration"]("Seconds at the target rate that are recorded (default 60).") |
+      Opt(connections, "64")["-n"]["--connections"]("Maximum number of connections to the service (default 64).") |
+      Opt(threads, "4")["-t"]["--threads"]("Number of threads to run the io context on (default number of cores).") |
+      Opt(configuration.seed, "1000")["--seed"]("Number of documents to create before the test (default 1000).") |
+      Opt(configuration.batch, "10")["--batch"]("Number of documents inserted by each bulk request (default 10).") |
+      Opt(configuration.skipVersion)["--skip-version"]("Do not create version history documents.") |
+      Opt(configuration.skipMetric)["--skip-metric"]("Do not create metric documents.") |
+      Opt(output, "/tmp/load.json")["-j"]["--json"]("File to write the results to as JSON.") |
+      Opt(logLevel, "info")["-l"]["--log-level"]("Log level to use [debug|info|warn|critical] (default info).") |
+      Opt(dir, "/tmp/")["-o"]["--log-dir"]("Log directory (default /tmp/)");
+
+  auto result = options.parse(clara::Args(argc, argv));
+  if ( !result )
+  {
+    std::cerr << "Error in command line: " << result.errorMessage() << std::endl;
+    exit( 1 );
+  }
+
+  if ( help )
+  {
+    options.writeToStream( std::cout );
+    exit( 0 );
+  }
+
+  const auto weights = spt::load::parseMix( configuration.mix );
+  if ( !weights )
+  {
+    std::cerr << "Invalid request mix " << configuration.mix << ". " << weights.error() << std::endl;
+    exit( 1 );
+  }
+
+  if ( configuration.rate == 0 || configuration.seed == 0 || connections == 0 || threads == 0 || duration == 0 )
+  {
+    std::cerr << "Rate, seed, connections, threads and duration must be greater than 0" << std::endl;
+    exit( 1 );
+  }
+
+  configuration.ramp = std::chrono::seconds{ ramp };
+  configuration.warmup = std::chrono::seconds{ warmup };
+  configuration.duration = std::chrono::seconds{ duration };
+
+  if ( logLevel == "debug" ) nanolog::set_log_level( nanolog::LogLevel::DEBUG );
+  else if ( logLevel == "info" ) nanolog::set_log_level( nanolog::LogLevel::INFO );
+  else if ( logLevel == "warn" ) nanolog::set_log_level( nanolog::LogLevel::WARN );
+  else if ( logLevel == "critical" ) nanolog::set_log_level( nanolog::LogLevel::CRIT );
+  nanolog::initialize( nanolog::NonGuaranteedLogger( 10 ), dir, "mongo-service-load", false );
+
+  auto pool = spt::mongoservice::pool::Configuration{};
+  pool.initialSize = 0;
+  pool.maxPoolSize = connections;
+  pool.maxConnections = connections;
+  spt::mongoservice::api::init( server, port, "mongo-service-load", pool );
+
+  auto& ioc = spt::mongoservice::api::ContextHolder::instance().ioc;
+  boost::asio::signal_set signals( ioc, SIGINT, SIGTERM );
+  signals.async_wait( [&ioc](auto const&, int ) { ioc.stop(); } );
+
+  auto generator = spt::load::Generator{ configuration, *weights };
+  auto seeded = false;
+  boost::asio::co_spawn( ioc, spt::load::pmain::execute( generator, seeded ),
+    [&ioc, &signals]( std::exception_ptr ep )
+    {
+      if ( ep )
+      {
+        try { std::rethrow_exception( ep ); }
+        catch ( const std::exception& ex ) { LOG_CRIT << "Error running load test. " << ex.what(); }
+      }
+      signals.cancel();
+      ioc.stop();
+    } );
+
+  std::vector<std::thread> v;
+  v.reserve( threads );
+  for ( uint32_t i = 0; i < threads; ++i ) v.emplace_back( [&ioc] { ioc.run(); } );
+  for ( auto&& t : v ) if ( t.joinable() ) t.join();
+
+  if ( !seeded )
+  {
+    std::cerr << "Error seeding documents.  See logs in " << dir << " for details." << std::endl;
+    exit( 2 );
+  }
+
+  std::cout << generator.report();
+
+  if ( !output.empty() )
+  {
+    auto file = std::ofstream{ output };
+    if ( !file )
+    {
+      std::cerr << "Error opening output file " << output << std::endl;
+      exit( 3 );
+    }
+    file << boost::json::serialize( generator.json() ) << '\n';
+  }
+}
@@ -0,0 +1,94 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include "../../src/ilp/apmexporter.hpp"
+
+#include "../../src/common/util/defer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <future>
+#include <boost/asio/ip/tcp.hpp>
+
+using namespace std::literals::chrono_literals;
+
+SCENARIO( "APM exporter test suite", "[apm]" )
+{
+  GIVEN( "A local TCP server receiving ILP data" )
+  {
+    constexpr std::size_t expected = 500;
+
+    // Listen on an ephemeral port, and signal once the expected number of lines have been received.
+    // The server runs for a bounded time, so that a failure to connect fails the test instead of hanging.
+    boost::asio::io_context ioc;
+    auto acceptor = boost::asio::ip::tcp::acceptor{ ioc, { boost::asio::ip::tcp::v4(), 0 } };
+    const auto port = std::to_string( acceptor.local_endpoint().port() );
+    auto socket = boost::asio::ip::tcp::socket{ ioc };
+    auto buf = std::array<char, 4096>{};
+
+    std::string received;
+    std::size_t lines = 0;
+    auto complete = std::promise<void>{};
+    auto done = complete.get_future();
+
+    std::function<void()> read = [&]
+    {
+      socket.async_read_some( boost::asio::buffer( buf ),
+        [&]( const boost::system::error_code& ec, std::size_t n )
+        {
+          if ( ec ) return;
+          received.append( buf.data(), n );
+          const auto before = lines;
+          lines += static_cast<std::size_t>( std::count( buf.data(), buf.data() + n, '\n' ) );
+          if ( before < expected && lines >= expected ) complete.set_value();
+          read();
+        } );
+    };
+    acceptor.async_accept( socket, [&read]( const boost::system::error_code& ec ) { if ( !ec ) read(); } );
+
+    auto server = std::thread{ [&ioc] { ioc.run_for( 30s ); } };
+    DEFER( ioc.stop(); if ( server.joinable() ) server.join() );
+
+    WHEN( "Exporting records from multiple threads" )
+    {
+      {
+        auto exporter = spt::ilp::APMExporter{ { .host = "127.0.0.1", .port = port, .batchSize = 10, .flushInterval = 50ms, .sampleRate = 2 } };
+
+        auto threads = std::vector<std::thread>{};
+        for ( auto i = 0; i < 4; ++i )
+        {
+          threads.emplace_back( [&exporter]
+          {
+            for ( auto j = 0; j < 250; ++j )
+            {
+              auto record = spt::ilp::APMRecord{ "abc123" };
+              record.application = "unit test";
+              spt::ilp::setDuration( record );
+              exporter.add( std::move( record ) );
+            }
+          } );
+        }
+        for ( auto& t : threads ) t.join();
+        REQUIRE( done.wait_for( 10s ) == std::future_status::ready );
+
+        exporter.stop();
+        const auto stats = exporter.stats();
+        CHECK( stats.exported == 500 );
+        CHECK( stats.sampled == 500 );
+        CHECK( stats.dropped == 0 );
+        CHECK( stats.batches >= 50 );
+        CHECK( stats.client.bytesBuffered == 0 );
+
+        CHECK_FALSE( exporter.add( spt::ilp::APMRecord{ "abc123" } ) );
+        CHECK( exporter.stats().dropped == 1 );
+      }
+
+      ioc.stop();
+      server.join();
+      CHECK( std::ranges::count( received, '\n' ) == expected );
+    }
+  }
+}
@@ -0,0 +1,167 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include "../../src/ilp/asyncilp.hpp"
+
+#include "../../src/common/util/defer.hpp"
+
+#include <array>
+#include <format>
+#include <future>
+#include <thread>
+
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+  namespace pasyncilp
+  {
+    // A line of ILP data.  All lines are of the same size.
+    std::string line( int id )
+    {
+      return std::format( "test,id={:04} value=1i\n", id );
+    }
+
+    // A local TCP server listening on an ephemeral port.  Signals once the expected number of bytes have
+    // been received.  Only the latest connection is read from.
+    struct Server
+    {
+      Server( boost::asio::io_context& ioc, std::size_t expected ) :
+        acceptor{ ioc, { boost::asio::ip::tcp::v4(), 0 } }, socket{ ioc },
+        endpoint{ acceptor.local_endpoint() }, port{ std::to_string( endpoint.port() ) }, expected{ expected }
+      {
+        accept();
+      }
+
+      // Close the connection and listening socket, and listen on the same port again.
+      // The io_context must not be running.
+      void restart( std::size_t bytes )
+      {
+        auto ec = boost::system::error_code{};
+        socket.close( ec );
+        acceptor.close( ec );
+        acceptor = boost::asio::ip::tcp::acceptor{ socket.get_executor(), endpoint };
+
+        data.clear();
+        expected = bytes;
+        complete = std::promise<void>{};
+        done = complete.get_future();
+        accept();
+      }
+
+      void accept()
+      {
+        acceptor.async_accept( socket, [this]( const boost::system::error_code& ec ) { if ( !ec ) read(); } );
+      }
+
+      void read()
+      {
+        socket.async_read_some( boost::asio::buffer( buf ),
+          [this]( const boost::system::error_code& ec, std::size_t n )
+          {
+            if ( ec ) return;
+            const auto before = data.size();
+            data.append( buf.data(), n );
+            if ( before < expected && data.size() >= expected ) complete.set_value();
+            read();
+          } );
+      }
+
+      boost::asio::ip::tcp::acceptor acceptor;
+      boost::asio::ip::tcp::socket socket;
+      boost::asio::ip::tcp::endpoint endpoint;
+      std::string port;
+      std::string data;
+      std::array<char, 4096> buf{};
+      std::size_t expected;
+      std::promise<void> complete;
+      std::future<void> done{ complete.get_future() };
+    };
+  }
+}
+
+SCENARIO( "Async ILP client test suite", "[ilp]" )
+{
+  const auto size = pasyncilp::line( 0 ).size();
+
+  GIVEN( "A local TCP server receiving ILP data" )
+  {
+    boost::asio::io_context ioc;
+    auto server = pasyncilp::Server{ ioc, 5 * size };
+
+    WHEN( "Writing more data than the client buffers before it connects" )
+    {
+      auto client = spt::ilp::AsyncILPClient{ ioc, "127.0.0.1", server.port, { .maxBufferSize = 5 * size } };
+      for ( auto i = 0; i < 10; ++i ) client.write( pasyncilp::line( i ) );
+      client.write( std::string( 5 * size, 'x' ) + '\n' );
+      REQUIRE( client.stats().bytesBuffered == 15 * size + 1 );
+
+      // Nothing is sent until the io_context runs.
+      REQUIRE_FALSE( client.flush( 20ms ) );
+
+      auto thread = std::thread{ [&ioc] { ioc.run_for( 30s ); } };
+      DEFER( ioc.stop(); if ( thread.joinable() ) thread.join() );
+
+      REQUIRE( server.done.wait_for( 10s ) == std::future_status::ready );
+      REQUIRE( client.flush( 10s ) );
+
+      const auto stats = client.stats();
+      CHECK( stats.bytesSent == 5 * size );
+      CHECK( stats.batchesSent == 5 );
+      CHECK( stats.bytesDropped == 10 * size + 1 );
+      CHECK( stats.batchesDropped == 6 );
+      CHECK( stats.bytesBuffered == 0 );
+      CHECK( stats.connects == 1 );
+      CHECK( stats.errors == 0 );
+
+      ioc.stop();
+      thread.join();
+
+      // The oldest batches were dropped, and the batch larger than the buffer was discarded.
+      auto expected = std::string{};
+      for ( auto i = 5; i < 10; ++i ) expected.append( pasyncilp::line( i ) );
+      CHECK( server.data == expected );
+    }
+
+    AND_WHEN( "Writing data before and after the server restarts" )
+    {
+      auto client = spt::ilp::AsyncILPClient{ ioc, "127.0.0.1", server.port,
+        { .initialBackoff = 10ms, .maxBackoff = 100ms } };
+
+      auto thread = std::thread{ [&ioc] { ioc.run_for( 30s ); } };
+      DEFER( ioc.stop(); if ( thread.joinable() ) thread.join() );
+
+      for ( auto i = 0; i < 5; ++i ) client.write( pasyncilp::line( i ) );
+      REQUIRE( server.done.wait_for( 10s ) == std::future_status::ready );
+      REQUIRE( client.flush( 10s ) );
+      REQUIRE( server.data.size() == 5 * size );
+
+      ioc.stop();
+      thread.join();
+      server.restart( 5 * size );
+      ioc.restart();
+      thread = std::thread{ [&ioc] { ioc.run_for( 30s ); } };
+
+      // The client only detects the closed connection when writing, and data written to it before the
+      // failure is detected is lost.  Keep writing until enough data reaches the restarted server.
+      for ( auto i = 5; i < 1000 && server.done.wait_for( 10ms ) != std::future_status::ready; ++i )
+      {
+        client.write( pasyncilp::line( i ) );
+      }
+      REQUIRE( server.done.wait_for( 10s ) == std::future_status::ready );
+      REQUIRE( client.flush( 10s ) );
+
+      const auto stats = client.stats();
+      CHECK( stats.connects == 2 );
+      CHECK( stats.errors >= 1 );
+      CHECK( stats.bytesBuffered == 0 );
+
+      ioc.stop();
+      thread.join();
+      CHECK( server.data.size() >= 5 * size );
+      CHECK( server.data.size() % size == 0 );
+    }
+  }
+}
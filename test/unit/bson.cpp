@@ -5,8 +5,15 @@
 #include "../../src/common/util/bson.hpp"
 #include "../../src/common/util/date.hpp"
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 
+#include <format>
+#include <sstream>
+#include <boost/json/parse.hpp>
+#include <boost/json/serialize.hpp>
 #include <bsoncxx/builder/list.hpp>
+#include <bsoncxx/builder/stream/document.hpp>
+#include <bsoncxx/json.hpp>
 
 using namespace spt::util;
 using std::operator""s;
@@ -91,3 +98,272 @@ SCENARIO( "BSON util functions test suite", "[bson]" )
     }
   }
 }
+
+namespace
+{
+  namespace ptranscode
+  {
+    std::string payload( std::size_t count )
+    {
+      auto out = std::string{ R"({"action":"create","database":"itest","collection":"test","document":{"items":[)" };
+      for ( std::size_t i = 0; i < count; ++i )
+      {
+        if ( i ) out.push_back( ',' );
+        out.append( std::format( R"({{"_id":{{"$oid":"5f35e5e1e799c52186{:06x}"}},"name":"Item \"{}\"","count":{},"total":{},"price":{}.25,"active":true,"created":{{"$date":"2021-02-11T11:17:43.123Z"}},"tags":["a","b","c"],"nested":{{"key":"value","missing":null}}}})",
+          i, i, i, int64_t{ 5000000000 } + i, i ) );
+      }
+      out.append( "]}}" );
+      return out;
+    }
+  }
+}
+
+SCENARIO( "JSON to BSON transcoding test suite", "[bson][transcode]" )
+{
+  GIVEN( "JSON documents with extended JSON values" )
+  {
+    WHEN( "Transcoding values without type information" )
+    {
+      const auto json = R"({"int":1,"long":-3000000000,"double":1.5,"string":"a\"b\u00e9","yes":true,"no":false,"none":null,"empty":{},"list":[1,[2,{}],{"k":"v"},null]})"sv;
+      const auto bson = toBson( json );
+      CHECK( bson.view() == bsoncxx::from_json( json ).view() );
+      CHECK( bson.view()["int"].type() == bsoncxx::type::k_int32 );
+      CHECK( bson.view()["long"].type() == bsoncxx::type::k_int64 );
+      CHECK( bson.view()["string"].get_string().value == "a\"b\u00e9"sv );
+      CHECK( bson.view()["none"].type() == bsoncxx::type::k_null );
+    }
+
+    AND_WHEN( "Transcoding extended JSON values" )
+    {
+      const auto json = R"({"_id":{"$oid":"5f35e5e1e799c52186039122"},"date":{"$date":"2021-02-11T11:17:43.123Z"},"millis":{"$date":{"$numberLong":"1613042263123"}},"long":{"$numberLong":"9007199254740993"},"int":{"$numberInt":"-5"},"double":{"$numberDouble":"2.5"}})"sv;
+      const auto bson = toBson( json );
+      CHECK( bson.view() == bsoncxx::from_json( json ).view() );
+      CHECK( bsonValue<bsoncxx::oid>( "_id", bson.view() ) == bsoncxx::oid{ "5f35e5e1e799c52186039122" } );
+      CHECK( bsonValue<std::chrono::milliseconds>( "date", bson.view() ).count() == 1613042263123 );
+      CHECK( bsonValue<std::chrono::milliseconds>( "millis", bson.view() ).count() == 1613042263123 );
+      CHECK( bsonValue<int64_t>( "long", bson.view() ) == 9007199254740993 );
+      CHECK( bsonValue<int32_t>( "int", bson.view() ) == -5 );
+      CHECK( bsonValue<double>( "double", bson.view() ) == 2.5 );
+    }
+
+    AND_WHEN( "Transcoding query operators" )
+    {
+      const auto json = R"({"filter":{"count":{"$gt":5,"$lt":{"$numberLong":"7"}},"$or":[{"a":1},{"b":2}]}})"sv;
+      const auto bson = toBson( json );
+      CHECK( bson.view() == bsoncxx::from_json( json ).view() );
+      CHECK( bson.view()["filter"]["count"]["$gt"].get_int32().value == 5 );
+    }
+
+    AND_WHEN( "Transcoding extended JSON types that are not transcoded directly" )
+    {
+      const auto json = R"({"decimal":{"$numberDecimal":"1.25"},"binary":{"$binary":{"base64":"AQID","subType":"00"}},"ts":{"$timestamp":{"t":1613042263,"i":1}},"regex":{"$regularExpression":{"pattern":"^a","options":"i"}},"min":{"$minKey":1},"max":{"$maxKey":1},"nested":{"list":[{"$numberDecimal":"2"}]}})"sv;
+      const auto bson = toBson( json );
+      CHECK( bson.view() == bsoncxx::from_json( json ).view() );
+      CHECK( bson.view()["decimal"].type() == bsoncxx::type::k_decimal128 );
+      CHECK( bson.view()["binary"].type() == bsoncxx::type::k_binary );
+      CHECK( bson.view()["ts"].type() == bsoncxx::type::k_timestamp );
+      CHECK( bson.view()["regex"].type() == bsoncxx::type::k_regex );
+      CHECK( bson.view()["min"].type() == bsoncxx::type::k_minkey );
+      CHECK( bson.view()["max"].type() == bsoncxx::type::k_maxkey );
+      CHECK( bson.view()["nested"]["list"][0].type() == bsoncxx::type::k_decimal128 );
+
+      CHECK_THROWS( toBson( R"({"a":{"$numberDecimal":"1.25"}})"sv, JsonTypes::Inferred ) );
+      CHECK_THROWS( toBson( R"({"a":{"$numberDecimal":"not a number"}})"sv ) );
+    }
+
+    AND_WHEN( "Transcoding a large document" )
+    {
+      const auto json = ptranscode::payload( 1000 );
+      const auto bson = toBson( json );
+      CHECK( bson.view() == bsoncxx::from_json( json ).view() );
+    }
+  }
+
+  GIVEN( "JSON documents with types inferred from values" )
+  {
+    WHEN( "Transcoding values in the same way as boost::json" )
+    {
+      const auto json = R"({"id":"5f35e5e1e799c52186039122","date":"2021-02-11T11:17:43.123Z","name":"12-ab","empty":"","none":null,"count":5,"list":[1,null,"",2,"5f35e5e1e799c52186039122"],"nested":{"value":1.5}})"sv;
+      const auto bson = toBson( json, JsonTypes::Inferred );
+      CHECK( bson.view() == toBson( boost::json::parse( json ).as_object() ).view() );
+      CHECK( bson.view()["id"].type() == bsoncxx::type::k_oid );
+      CHECK( bson.view()["date"].type() == bsoncxx::type::k_date );
+      CHECK( bson.view()["name"].type() == bsoncxx::type::k_string );
+      CHECK( bson.view()["count"].type() == bsoncxx::type::k_int64 );
+      CHECK( bson.view().find( "empty" ) == bson.view().end() );
+      CHECK( bson.view().find( "none" ) == bson.view().end() );
+    }
+  }
+
+  GIVEN( "Invalid JSON documents" )
+  {
+    WHEN( "Transcoding invalid input" )
+    {
+      CHECK_THROWS( toBson( R"({"a":1)"sv ) );
+      CHECK_THROWS( toBson( R"({"a":1} x)"sv ) );
+      CHECK_THROWS( toBson( R"([1,2])"sv ) );
+      CHECK_THROWS( toBson( R"({"a":nul})"sv ) );
+      CHECK_THROWS( toBson( R"({"a\u0000":1})"sv ) );
+    }
+
+    AND_WHEN( "Transcoding invalid extended JSON" )
+    {
+      CHECK_THROWS( toBson( R"({"a":{"$oid":"xyz"}})"sv ) );
+      CHECK_THROWS( toBson( R"({"a":{"$oid":"5f35e5e1e799c52186039122","b":1}})"sv ) );
+      CHECK_THROWS( toBson( R"({"a":{"$numberLong":"12a"}})"sv ) );
+      CHECK_THROWS( toBson( R"({"a":{"$date":"not a date"}})"sv ) );
+    }
+  }
+}
+
+SCENARIO( "JSON to BSON transcoding benchmark", "[.][benchmark]" )
+{
+  GIVEN( "JSON documents of increasing size" )
+  {
+    for ( const auto count : { 1, 100, 10'000 } )
+    {
+      const auto json = ptranscode::payload( count );
+
+      BENCHMARK( std::format( "Transcode {} items with simdjson", count ) )
+      {
+        return toBson( json );
+      };
+
+      BENCHMARK( std::format( "Transcode {} items with bsoncxx::from_json", count ) )
+      {
+        return bsoncxx::from_json( json );
+      };
+
+      BENCHMARK( std::format( "Transcode {} items with inferred types with simdjson", count ) )
+      {
+        return toBson( json, JsonTypes::Inferred );
+      };
+
+      BENCHMARK( std::format( "Transcode {} items with inferred types with boost::json", count ) )
+      {
+        return toBson( boost::json::parse( json ).as_object() );
+      };
+    }
+  }
+}
+
+SCENARIO( "BSON to JSON streaming writer test suite", "[bson][json]" )
+{
+  GIVEN( "A BSON document with various types of values" )
+  {
+    const auto bson = toBson( R"({"_id":{"$oid":"5f35e5e1e799c52186039122"},"int":{"$numberInt":"5"},"long":{"$numberLong":"9007199254740993"},"double":{"$numberDouble":"1.0"},"string":"a\"b\\c\n\u0001\u00e9","date":{"$date":{"$numberLong":"1613042263123"}},"yes":true,"none":null,"nested":{"list":[1,{"$numberDouble":"2.5"},"x"]}})"sv );
+
+    WHEN( "Writing canonical extended JSON" )
+    {
+      const auto json = toJsonString( bson.view(), JsonFormat::Canonical );
+      CHECK( json == R"({"_id":{"$oid":"5f35e5e1e799c52186039122"},"int":{"$numberInt":"5"},"long":{"$numberLong":"9007199254740993"},"double":{"$numberDouble":"1.0"},"string":"a\"b\\c\n\u0001é","date":{"$date":{"$numberLong":"1613042263123"}},"yes":true,"none":null,"nested":{"list":[{"$numberInt":"1"},{"$numberDouble":"2.5"},"x"]}})"sv );
+      CHECK( toBson( json ).view() == bson.view() );
+      CHECK( bsoncxx::from_json( json ).view() == bson.view() );
+    }
+
+    AND_WHEN( "Writing relaxed extended JSON" )
+    {
+      const auto json = toJsonString( bson.view() );
+      CHECK( json == R"({"_id":{"$oid":"5f35e5e1e799c52186039122"},"int":5,"long":9007199254740993,"double":1.0,"string":"a\"b\\c\n\u0001é","date":{"$date":"2021-02-11T11:17:43.123Z"},"yes":true,"none":null,"nested":{"list":[1,2.5,"x"]}})"sv );
+      CHECK( bsonValue<int64_t>( "long", toBson( json ).view() ) == 9007199254740993 );
+      CHECK( bsonValue<std::chrono::milliseconds>( "date", toBson( json ).view() ).count() == 1613042263123 );
+    }
+
+    AND_WHEN( "Writing plain JSON" )
+    {
+      const auto json = toJsonString( bson.view(), JsonFormat::Plain );
+      CHECK( boost::json::parse( json ).as_object() == toJson( bson.view() ) );
+      CHECK( json.find( "none" ) == std::string::npos );
+
+      auto ss = std::ostringstream{};
+      toJson( ss, bson.view() );
+      CHECK( ss.str() == json );
+    }
+
+    AND_WHEN( "Writing plain JSON for documents with duplicate keys" )
+    {
+      auto builder = bsoncxx::builder::stream::document{};
+      builder << "a" << 1 << "b" << "x" << "a" << 2 << "nested" << bsoncxx::builder::stream::open_document <<
+        "c" << true << "c" << false << bsoncxx::builder::stream::close_document;
+      for ( auto i = 0; i < 40; ++i ) builder << std::format( "k{}", i % 35 ) << i;
+      const auto doc = builder << bsoncxx::builder::stream::finalize;
+
+      const auto json = toJsonString( doc.view(), JsonFormat::Plain );
+      CHECK( json == boost::json::serialize( toJson( doc.view() ) ) );
+      CHECK( json.starts_with( R"({"a":1,"b":"x","nested":{"c":true},"k0":0,)" ) );
+      CHECK( json.ends_with( R"("k34":34})" ) );
+    }
+
+    AND_WHEN( "Writing to a string, stream and fixed size buffer" )
+    {
+      const auto json = toJsonString( bson.view() );
+
+      auto out = std::string{ "prefix:" };
+      writeJson( out, bson.view() );
+      CHECK( out == "prefix:" + json );
+
+      auto ss = std::ostringstream{};
+      writeJson( ss, bson.view() );
+      CHECK( ss.str() == json );
+
+      auto buffer = std::array<char, 32>{};
+      CHECK( writeJson( buffer, bson.view() ) == json.size() );
+      CHECK( std::string_view{ buffer.data(), buffer.size() } == std::string_view{ json }.substr( 0, buffer.size() ) );
+
+      auto large = std::array<char, 1024>{};
+      const auto size = writeJson( large, bson.view() );
+      CHECK( std::string_view{ large.data(), size } == json );
+    }
+
+    AND_WHEN( "Writing an array" )
+    {
+      const auto array = bson.view()["nested"]["list"].get_array().value;
+      CHECK( toJsonString( array ) == R"([1,2.5,"x"])"sv );
+      CHECK( toJsonString( array, JsonFormat::Canonical ) == R"([{"$numberInt":"1"},{"$numberDouble":"2.5"},"x"])"sv );
+    }
+  }
+
+  GIVEN( "A BSON document with a long string that requires escaping" )
+  {
+    auto value = std::string{};
+    for ( auto i = 0; i < 100; ++i ) value.append( std::format( "Line {} with \"quotes\", a \\ and a tab\t.\n", i ) );
+    const auto bson = bsoncxx::builder::list{ "value", value };
+
+    WHEN( "Writing the document" )
+    {
+      const auto json = toJsonString( bson.view().get_document().value );
+      CHECK( boost::json::parse( json ).as_object().at( "value" ).as_string() == value );
+    }
+  }
+}
+
+SCENARIO( "BSON to JSON streaming writer benchmark", "[.][benchmark]" )
+{
+  GIVEN( "BSON documents of increasing size" )
+  {
+    for ( const auto count : { 1, 100, 10'000 } )
+    {
+      const auto bson = toBson( ptranscode::payload( count ) );
+
+      BENCHMARK( std::format( "Write {} items as relaxed extended JSON", count ) )
+      {
+        return toJsonString( bson.view() );
+      };
+
+      BENCHMARK( std::format( "Write {} items with bsoncxx::to_json", count ) )
+      {
+        return bsoncxx::to_json( bson.view(), bsoncxx::ExtendedJsonMode::k_relaxed );
+      };
+
+      BENCHMARK( std::format( "Write {} items as plain JSON", count ) )
+      {
+        return toJsonString( bson.view(), JsonFormat::Plain );
+      };
+
+      BENCHMARK( std::format( "Write {} items with boost::json", count ) )
+      {
+        return boost::json::serialize( toJson( bson.view() ) );
+      };
+    }
+  }
+}
@@ -0,0 +1,179 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#include "../../src/service/db/bulk.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <optional>
+
+using spt::db::bulk::Result;
+
+namespace
+{
+  namespace pbulk
+  {
+    struct Connection
+    {
+      int id;
+    };
+
+    // Positive operations are inserts and negative operations deletes.  Records the connection
+    // each operation was executed on.
+    struct Executor
+    {
+      // Operation that fails the chunk it is executed in.
+      explicit Executor( int failure = 0 ) : failure{ failure } {}
+
+      Result operator()( Connection& connection, std::span<const int> chunk )
+      {
+        auto result = Result{};
+        auto lock = std::scoped_lock{ mutex };
+        for ( const auto op : chunk )
+        {
+          if ( op == failure ) result.failed = true;
+          else if ( op > 0 ) ++result.inserted;
+          else ++result.deleted;
+          executed.emplace_back( op, connection.id );
+        }
+        return result;
+      }
+
+      std::vector<int> operations() const
+      {
+        auto out = std::vector<int>{};
+        out.reserve( executed.size() );
+        for ( const auto& [op, _] : executed ) out.push_back( op );
+        std::ranges::sort( out );
+        return out;
+      }
+
+      std::size_t count( int connection ) const
+      {
+        return static_cast<std::size_t>( std::ranges::count( executed, connection, &std::pair<int, int>::second ) );
+      }
+
+      std::mutex mutex;
+      std::vector<std::pair<int, int>> executed;
+      int failure;
+    };
+
+    // Hands out up to `available` connections, identified from 1.
+    struct Acquirer
+    {
+      explicit Acquirer( int available ) : available{ available } {}
+
+      std::optional<Connection> operator()()
+      {
+        auto lock = std::scoped_lock{ mutex };
+        if ( acquired == available ) return std::nullopt;
+        return Connection{ ++acquired };
+      }
+
+      std::mutex mutex;
+      int available;
+      int acquired{ 0 };
+    };
+
+    // 700 inserts followed by 300 deletes.
+    std::vector<int> operations()
+    {
+      auto out = std::vector<int>( 1000 );
+      std::iota( out.begin(), out.begin() + 700, 1 );
+      std::iota( out.begin() + 700, out.end(), -300 );
+      return out;
+    }
+  }
+}
+
+SCENARIO( "Chunked bulk execution test suite", "[bulk]" )
+{
+  const auto operations = pbulk::operations();
+  auto sorted = operations;
+  std::ranges::sort( sorted );
+  auto caller = pbulk::Connection{ 0 };
+
+  GIVEN( "A pool with enough connections for all the workers" )
+  {
+    auto acquire = pbulk::Acquirer{ 8 };
+
+    WHEN( "Executing the operations as a single chunk" )
+    {
+      auto executor = pbulk::Executor{};
+      const auto result = spt::db::bulk::execute( std::span{ operations }, operations.size(), 4, caller, acquire, executor );
+      REQUIRE( result.inserted == 700 );
+      REQUIRE( result.deleted == 300 );
+      REQUIRE_FALSE( result.failed );
+      REQUIRE( acquire.acquired == 0 );
+      REQUIRE( executor.count( 0 ) == operations.size() );
+    }
+
+    AND_WHEN( "Executing the operations in small chunks" )
+    {
+      auto executor = pbulk::Executor{};
+      const auto result = spt::db::bulk::execute( std::span{ operations }, 7, 4, caller, acquire, executor );
+      REQUIRE( result.inserted == 700 );
+      REQUIRE( result.deleted == 300 );
+      REQUIRE_FALSE( result.failed );
+      REQUIRE( acquire.acquired == 3 );
+      REQUIRE( executor.operations() == sorted );
+      for ( auto c = 0; c < 4; ++c ) CHECK( executor.count( c ) > 0 );
+    }
+
+    AND_WHEN( "Executing fewer chunks than the parallelism" )
+    {
+      auto executor = pbulk::Executor{};
+      const auto result = spt::db::bulk::execute( std::span{ operations }, 400, 8, caller, acquire, executor );
+      REQUIRE( result.inserted == 700 );
+      REQUIRE( result.deleted == 300 );
+      REQUIRE( acquire.acquired == 2 );
+      REQUIRE( executor.operations() == sorted );
+      REQUIRE( executor.count( 0 ) == 400 );
+    }
+
+    AND_WHEN( "A chunk fails" )
+    {
+      auto executor = pbulk::Executor{ 500 };
+      const auto result = spt::db::bulk::execute( std::span{ operations }, 7, 4, caller, acquire, executor );
+      REQUIRE( result.failed );
+      REQUIRE( result.inserted == 699 );
+      REQUIRE( result.deleted == 300 );
+    }
+  }
+
+  GIVEN( "An exhausted pool" )
+  {
+    auto acquire = pbulk::Acquirer{ 0 };
+
+    WHEN( "Executing the operations in small chunks" )
+    {
+      auto executor = pbulk::Executor{};
+      const auto result = spt::db::bulk::execute( std::span{ operations }, 7, 4, caller, acquire, executor );
+      REQUIRE( result.inserted == 700 );
+      REQUIRE( result.deleted == 300 );
+      REQUIRE_FALSE( result.failed );
+      REQUIRE( executor.operations() == sorted );
+      REQUIRE( executor.count( 0 ) == operations.size() );
+    }
+  }
+
+  GIVEN( "A pool with fewer connections than workers" )
+  {
+    auto acquire = pbulk::Acquirer{ 1 };
+
+    WHEN( "Executing the operations in small chunks" )
+    {
+      auto executor = pbulk::Executor{};
+      const auto result = spt::db::bulk::execute( std::span{ operations }, 7, 4, caller, acquire, executor );
+      REQUIRE( result.inserted == 700 );
+      REQUIRE( result.deleted == 300 );
+      REQUIRE_FALSE( result.failed );
+      REQUIRE( executor.operations() == sorted );
+      REQUIRE( executor.count( 1 ) > 0 );
+      REQUIRE( executor.count( 0 ) + executor.count( 1 ) == operations.size() );
+    }
+  }
+}
@@ -0,0 +1,250 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#include "../../src/common/util/capture.hpp"
+#include "../../src/common/util/defer.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <thread>
+#include <utility>
+
+using namespace spt::util::capture;
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+  namespace pcapture
+  {
+    // A new empty directory under the system temporary directory.
+    std::filesystem::path directory()
+    {
+      auto path = std::filesystem::temp_directory_path() /
+        std::format( "mongo-service-capture-{}", std::chrono::steady_clock::now().time_since_epoch().count() );
+      std::filesystem::create_directories( path );
+      return path;
+    }
+
+    // Header for a frame of the specified size.  The connection identifies the frame.
+    Header header( uint64_t connection, uint32_t size )
+    {
+      auto h = Header{};
+      h.timestamp = static_cast<int64_t>( connection * 1'000'000 );
+      h.duration = 1000;
+      h.connection = connection;
+      h.size = size;
+      return h;
+    }
+
+    // A frame of the specified size, filled with a byte derived from the connection.
+    std::vector<uint8_t> frame( uint64_t connection, uint32_t size )
+    {
+      return std::vector<uint8_t>( size, static_cast<uint8_t>( connection ) );
+    }
+
+    struct File
+    {
+      explicit File( const std::filesystem::path& path, std::string_view magic = Magic ) :
+        out{ path, std::ios::binary | std::ios::trunc }
+      {
+        out.write( magic.data(), static_cast<std::streamsize>( magic.size() ) );
+      }
+
+      // Write a record.  The header may specify a size other than that of the frame.
+      File& record( const Header& h, const std::vector<uint8_t>& data )
+      {
+        const auto bytes = h.encode();
+        out.write( bytes.data(), static_cast<std::streamsize>( bytes.size() ) );
+        out.write( reinterpret_cast<const char*>( data.data() ), static_cast<std::streamsize>( data.size() ) );
+        return *this;
+      }
+
+      File& record( uint64_t connection, uint32_t size ) { return record( header( connection, size ), frame( connection, size ) ); }
+
+      // Write the first `size` bytes of a header.
+      File& partial( const Header& h, std::size_t size )
+      {
+        const auto bytes = h.encode();
+        out.write( bytes.data(), static_cast<std::streamsize>( size ) );
+        return *this;
+      }
+
+      std::ofstream out;
+    };
+
+    std::vector<Record> read( const std::filesystem::path& path )
+    {
+      auto out = std::vector<Record>{};
+      auto reader = Reader{ files( path ) };
+      while ( auto record = reader.next() ) out.push_back( std::move( *record ) );
+      return out;
+    }
+
+    std::vector<uint64_t> connections( const std::vector<Record>& records )
+    {
+      auto out = std::vector<uint64_t>{};
+      for ( const auto& r : records ) out.push_back( r.header.connection );
+      return out;
+    }
+
+    // Wait (for a bounded time) until the writer has written the specified number of frames.
+    bool wait( const Writer& writer, uint64_t count )
+    {
+      const auto deadline = std::chrono::steady_clock::now() + 10s;
+      while ( writer.captured() < count && std::chrono::steady_clock::now() < deadline ) std::this_thread::sleep_for( 1ms );
+      return writer.captured() == count;
+    }
+  }
+}
+
+SCENARIO( "Capture record header test suite", "[capture]" )
+{
+  GIVEN( "A header for a captured request" )
+  {
+    auto header = Header{};
+    header.timestamp = 1760832000123456789;
+    header.duration = 1234567;
+    header.connection = 42;
+    header.size = 512;
+
+    WHEN( "Encoding and decoding the header" )
+    {
+      const auto bytes = header.encode();
+      REQUIRE( bytes.size() == Header::Size );
+
+      const auto decoded = Header::decode( bytes.data() );
+      REQUIRE( decoded.timestamp == header.timestamp );
+      REQUIRE( decoded.duration == header.duration );
+      REQUIRE( decoded.connection == header.connection );
+      REQUIRE( decoded.size == header.size );
+    }
+
+    AND_WHEN( "Decoding a header with the padding set" )
+    {
+      auto bytes = header.encode();
+      bytes[Header::Size - 1] = 0x7f;
+      const auto decoded = Header::decode( bytes.data() );
+      REQUIRE( decoded.size == header.size );
+    }
+  }
+}
+
+SCENARIO( "Capture file test suite", "[capture]" )
+{
+  const auto dir = pcapture::directory();
+  DEFER( auto ec = std::error_code{}; std::filesystem::remove_all( dir, ec ) );
+
+  GIVEN( "A directory with capture files and other entries" )
+  {
+    pcapture::File{ dir / "capture-100-000002.msc" };
+    pcapture::File{ dir / "capture-100-000000.msc" };
+    pcapture::File{ dir / "capture-200-000000.msc" };
+    pcapture::File{ dir / "capture-100-000001.msc" };
+    pcapture::File{ dir / "notes.txt" };
+    std::filesystem::create_directory( dir / "nested.msc" );
+
+    WHEN( "Listing the capture files in the directory" )
+    {
+      const auto list = files( dir );
+      REQUIRE( list.size() == 4 );
+      REQUIRE( list[0].filename() == "capture-100-000000.msc" );
+      REQUIRE( list[1].filename() == "capture-100-000001.msc" );
+      REQUIRE( list[2].filename() == "capture-100-000002.msc" );
+      REQUIRE( list[3].filename() == "capture-200-000000.msc" );
+    }
+
+    AND_WHEN( "Listing a single file or a missing path" )
+    {
+      REQUIRE( files( dir / "notes.txt" ) == std::vector{ dir / "notes.txt" } );
+      REQUIRE( files( dir / "missing" ).empty() );
+    }
+  }
+
+  GIVEN( "Capture files with truncated records, invalid content and invalid frame sizes" )
+  {
+    pcapture::File{ dir / "capture-1-000000.msc" }.record( 1, 64 ).record( 2, 5 ).
+      record( pcapture::header( 3, 64 ), pcapture::frame( 3, 20 ) );
+    pcapture::File{ dir / "capture-1-000001.msc", "NOTCAPT1" }.record( 10, 64 );
+    pcapture::File{ dir / "capture-1-000002.msc" }.record( 4, 64 ).
+      record( pcapture::header( 11, 3 ), pcapture::frame( 11, 3 ) ).record( 12, 64 );
+    pcapture::File{ dir / "capture-1-000003.msc" }.record( 5, 64 ).
+      partial( pcapture::header( 13, MaxFrameSize + 1 ), Header::Size ).record( 14, 64 );
+    pcapture::File{ dir / "capture-1-000004.msc" }.record( 6, 128 ).partial( pcapture::header( 15, 64 ), 10 );
+    pcapture::File{ dir / "capture-1-000005.msc" };
+    pcapture::File{ dir / "capture-1-000006.msc" }.record( 7, 32 );
+
+    WHEN( "Reading the records" )
+    {
+      const auto records = pcapture::read( dir );
+      REQUIRE( pcapture::connections( records ) == std::vector<uint64_t>{ 1, 2, 4, 5, 6, 7 } );
+
+      for ( const auto& r : records )
+      {
+        CHECK( r.header.timestamp == static_cast<int64_t>( r.header.connection * 1'000'000 ) );
+        CHECK( r.frame == pcapture::frame( r.header.connection, r.header.size ) );
+      }
+    }
+  }
+
+  GIVEN( "A writer that rotates capture files after each frame" )
+  {
+    auto writer = Writer{ Writer::Configuration{ .directory = dir, .fileSize = 256, .files = 3, .bufferSize = 2 } };
+    writer.start();
+
+    WHEN( "Writing more files than are retained" )
+    {
+      for ( uint64_t i = 1; i <= 5; ++i )
+      {
+        REQUIRE( writer.add( pcapture::header( i, 100 ), pcapture::frame( i, 100 ).data() ) );
+        REQUIRE( pcapture::wait( writer, i ) );
+      }
+      writer.finish();
+
+      REQUIRE( writer.dropped() == 0 );
+      REQUIRE( files( dir ).size() == 3 );
+
+      const auto records = pcapture::read( dir );
+      REQUIRE( pcapture::connections( records ) == std::vector<uint64_t>{ 3, 4, 5 } );
+      for ( const auto& r : records ) CHECK( r.frame == pcapture::frame( r.header.connection, 100 ) );
+    }
+  }
+
+  GIVEN( "A writer that has not been started" )
+  {
+    WHEN( "Staging more frames than the buffer holds" )
+    {
+      auto writer = Writer{ Writer::Configuration{ .directory = dir, .fileSize = 1024 * 1024, .files = 3, .bufferSize = 2 } };
+      REQUIRE( writer.add( pcapture::header( 1, 10 ), pcapture::frame( 1, 10 ).data() ) );
+      REQUIRE( writer.add( pcapture::header( 2, 10 ), pcapture::frame( 2, 10 ).data() ) );
+      REQUIRE_FALSE( writer.add( pcapture::header( 3, 10 ), pcapture::frame( 3, 10 ).data() ) );
+      REQUIRE_FALSE( writer.add( pcapture::header( 4, 10 ), pcapture::frame( 4, 10 ).data() ) );
+      REQUIRE( writer.dropped() == 2 );
+
+      writer.start();
+      writer.finish();
+      REQUIRE( writer.captured() == 2 );
+      REQUIRE( pcapture::connections( pcapture::read( dir ) ) == std::vector<uint64_t>{ 1, 2 } );
+
+      REQUIRE_FALSE( writer.add( pcapture::header( 5, 10 ), pcapture::frame( 5, 10 ).data() ) );
+      REQUIRE( writer.dropped() == 3 );
+    }
+
+    AND_WHEN( "Staging more bytes than a capture file holds" )
+    {
+      auto writer = Writer{ Writer::Configuration{ .directory = dir, .fileSize = 256, .files = 3, .bufferSize = 16 } };
+      REQUIRE_FALSE( writer.add( pcapture::header( 1, 300 ), pcapture::frame( 1, 300 ).data() ) );
+      REQUIRE( writer.add( pcapture::header( 2, 100 ), pcapture::frame( 2, 100 ).data() ) );
+      REQUIRE( writer.add( pcapture::header( 3, 100 ), pcapture::frame( 3, 100 ).data() ) );
+      REQUIRE_FALSE( writer.add( pcapture::header( 4, 100 ), pcapture::frame( 4, 100 ).data() ) );
+      REQUIRE( writer.dropped() == 2 );
+
+      writer.start();
+      writer.finish();
+      REQUIRE( writer.captured() == 2 );
+      REQUIRE( pcapture::connections( pcapture::read( dir ) ) == std::vector<uint64_t>{ 2, 3 } );
+    }
+  }
+}
@@ -0,0 +1,99 @@
+//
+// Created by Rakesh on 19/10/2026.
+//
+
+#include "../../src/service/db/memory/changes.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+#include <bsoncxx/builder/stream/document.hpp>
+
+using namespace spt::db::memory;
+using std::operator""sv;
+
+SCENARIO( "Memory engine transaction changes test suite", "[memory]" )
+{
+  using bsoncxx::builder::stream::document;
+  using bsoncxx::builder::stream::finalize;
+
+  const auto make = []( const bsoncxx::oid& id, std::string_view name )
+  {
+    return bsoncxx::document::value{ document{} << "_id" << id << "name" << name << finalize };
+  };
+  const auto name = []( const Documents& documents, const bsoncxx::oid& id )
+  {
+    return documents.at( id ).view()["name"].get_string().value;
+  };
+
+  GIVEN( "Collections with existing documents" )
+  {
+    const auto first = bsoncxx::oid{};
+    const auto second = bsoncxx::oid{};
+    const auto third = bsoncxx::oid{};
+    const auto missing = bsoncxx::oid{};
+
+    auto documents = Documents{};
+    documents.try_emplace( first, make( first, "first"sv ) );
+    documents.try_emplace( second, make( second, "second"sv ) );
+    auto versions = Documents{};
+    auto changes = Changes{};
+
+    WHEN( "Creating documents" )
+    {
+      REQUIRE( changes.create( documents, third, make( third, "third"sv ) ) );
+      REQUIRE( changes.create( versions, missing, make( missing, "version"sv ) ) );
+      REQUIRE_FALSE( changes.create( documents, first, make( first, "duplicate"sv ) ) );
+      REQUIRE( documents.size() == 3 );
+      REQUIRE( versions.size() == 1 );
+      REQUIRE( name( documents, first ) == "first"sv );
+
+      AND_WHEN( "Rolling back the changes" )
+      {
+        changes.rollback();
+        REQUIRE( documents.size() == 2 );
+        REQUIRE_FALSE( documents.contains( third ) );
+        REQUIRE( versions.empty() );
+        REQUIRE( name( documents, first ) == "first"sv );
+      }
+    }
+
+    AND_WHEN( "Updating documents" )
+    {
+      REQUIRE( changes.update( documents, first, make( first, "updated"sv ) ) );
+      REQUIRE_FALSE( changes.update( documents, missing, make( missing, "missing"sv ) ) );
+      REQUIRE( documents.size() == 2 );
+      REQUIRE_FALSE( documents.contains( missing ) );
+      REQUIRE( name( documents, first ) == "updated"sv );
+
+      AND_WHEN( "Rolling back the changes" )
+      {
+        changes.rollback();
+        REQUIRE( documents.size() == 2 );
+        REQUIRE_FALSE( documents.contains( missing ) );
+        REQUIRE( name( documents, first ) == "first"sv );
+      }
+    }
+
+    AND_WHEN( "Applying a sequence of changes to the same documents" )
+    {
+      REQUIRE( changes.update( documents, first, make( first, "once"sv ) ) );
+      REQUIRE( changes.update( documents, first, make( first, "twice"sv ) ) );
+      changes.erase( documents, documents.find( second ) );
+      REQUIRE( changes.create( documents, second, make( second, "recreated"sv ) ) );
+      changes.erase( documents, documents.find( first ) );
+      REQUIRE( documents.size() == 1 );
+      REQUIRE( name( documents, second ) == "recreated"sv );
+
+      AND_WHEN( "Rolling back the changes" )
+      {
+        changes.rollback();
+        REQUIRE( documents.size() == 2 );
+        REQUIRE( name( documents, first ) == "first"sv );
+        REQUIRE( name( documents, second ) == "second"sv );
+
+        changes.rollback();
+        REQUIRE( documents.size() == 2 );
+        REQUIRE( name( documents, first ) == "first"sv );
+      }
+    }
+  }
+}
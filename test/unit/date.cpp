@@ -3,7 +3,11 @@
 //
 
 #include "../../src/common/util/date.hpp"
+#include <array>
+#include <format>
+#include <vector>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
 using namespace spt::util;
@@ -88,6 +92,52 @@ SCENARIO( "DateTime test suite", "[datetime]" )
       REQUIRE( var->time_since_epoch().count() ==  expected );
     }
 
+    AND_WHEN( "Testing UTC values that are parsed without the generic parser" )
+    {
+      const auto data = GENERATE(
+        Catch::Generators::table<std::string_view, std::string_view, std::string_view>( {
+          { "Seconds"sv, "2015-05-04T02:51:59Z"sv, "2015-05-04T02:51:59+00:00"sv },
+          { "Millis"sv, "2015-05-04T02:51:59.789Z"sv, "2015-05-04T02:51:59.789+00:00"sv },
+          { "Micros"sv, "2015-05-04T02:51:59.789123Z"sv, "2015-05-04T02:51:59.789123+00:00"sv },
+          { "Before UNIX epoch"sv, "1969-07-20T20:17:40.000Z"sv, "1969-07-20T20:17:40.000+00:00"sv },
+          { "Leap day"sv, "2000-02-29T23:59:59.999Z"sv, "2000-02-29T23:59:59.999+00:00"sv },
+          { "Leap day in leap year"sv, "2024-02-29T12:00:00.000001Z"sv, "2024-02-29T12:00:00.000001+00:00"sv },
+          { "Last supported day"sv, "9999-12-31T23:59:59.999999Z"sv, "9999-12-31T23:59:59.999999+00:00"sv },
+          { "First supported day"sv, "0000-01-01T00:00:00.000Z"sv, "0000-01-01T00:00:00.000+00:00"sv }
+        } ) );
+
+      const auto [msg, utc, offset] = data;
+      INFO( msg );
+      const auto var = parseISO8601( utc );
+      REQUIRE( var.has_value() );
+      const auto off = parseISO8601( offset );
+      REQUIRE( off.has_value() );
+      CHECK( var->time_since_epoch().count() == off->time_since_epoch().count() );
+      if ( utc.size() == 24 ) CHECK( isoDateMillis( *var ) == utc );
+      if ( utc.size() == 27 ) CHECK( isoDateMicros( *var ) == utc );
+    }
+
+    AND_WHEN( "Testing values before the UNIX epoch" )
+    {
+      const auto var = parseISO8601( "1969-12-31T23:59:59.000Z" );
+      REQUIRE( var.has_value() );
+      CHECK( var->time_since_epoch().count() == -1000000 );
+      CHECK( isoDateMillis( std::chrono::milliseconds{ -1 } ) == "1969-12-31T23:59:59.999Z" );
+      CHECK( isoDateMicros( std::chrono::microseconds{ -1 } ) == "1969-12-31T23:59:59.999999Z" );
+    }
+
+    AND_WHEN( "Formatting into caller supplied buffers" )
+    {
+      auto millis = std::array<char, 24>{};
+      CHECK( isoDateMillis( std::chrono::milliseconds{ 1430707919789 }, millis ) == "2015-05-04T02:51:59.789Z" );
+      CHECK( isoDateMillis( std::chrono::milliseconds{ 1430707920001 }, millis ) == "2015-05-04T02:52:00.001Z" );
+      CHECK( isoDateMillis( std::chrono::milliseconds{ 1430784000000 }, millis ) == "2015-05-05T00:00:00.000Z" );
+
+      auto micros = std::array<char, 27>{};
+      CHECK( isoDateMicros( std::chrono::microseconds{ 1430707919789123 }, micros ) == "2015-05-04T02:51:59.789123Z" );
+      CHECK( isoDateMicros( std::chrono::microseconds{ 0 }, micros ) == "1970-01-01T00:00:00.000000Z" );
+    }
+
     AND_THEN( "ISO date time converted to UTC" )
     {
       const auto date = "2023-05-18T09:00:00.000-05:00"s;
@@ -112,7 +162,11 @@ SCENARIO( "DateTime test suite", "[datetime]" )
         { "Date time with invalid zone hour"sv, "2015-05-04T02:51:59+24:30"sv },
         { "Date time with invalid zone minute"sv, "2015-05-04T02:51:59+05:60"sv },
         { "Date time with invalid millisecond"sv, "2015-05-04T02:51:59.1+05:30"sv },
-        { "Date time with invalid microsecond"sv, "2015-05-04T02:51:59.1234+05:30"sv }
+        { "Date time with invalid microsecond"sv, "2015-05-04T02:51:59.1234+05:30"sv },
+        { "Date time with invalid month"sv, "2015-13-04T02:51:59.123Z"sv },
+        { "Date time with invalid day"sv, "2015-05-32T02:51:59.123Z"sv },
+        { "Date time with invalid hour"sv, "2015-05-04T24:51:59.123Z"sv },
+        { "Date time with invalid minute"sv, "2015-05-04T02:60:59.123456Z"sv }
       } ) );
 
     const auto [msg, date] = data;
@@ -120,3 +174,70 @@ SCENARIO( "DateTime test suite", "[datetime]" )
     REQUIRE_FALSE( var.has_value() );
   }
 }
+
+SCENARIO( "DateTime benchmark", "[.][benchmark]" )
+{
+  GIVEN( "A set of timestamps" )
+  {
+    constexpr auto count = 1'000;
+    auto values = std::vector<std::chrono::microseconds>{};
+    values.reserve( count );
+    for ( auto i = 0; i < count; ++i ) values.emplace_back( int64_t( 1430707919123456 ) + int64_t( i ) * 1'234'567 );
+
+    auto millis = std::vector<std::string>{};
+    auto micros = std::vector<std::string>{};
+    auto offsets = std::vector<std::string>{};
+    millis.reserve( count );
+    micros.reserve( count );
+    offsets.reserve( count );
+    for ( const auto& us : values )
+    {
+      millis.push_back( isoDateMillis( us ) );
+      micros.push_back( isoDateMicros( us ) );
+      offsets.push_back( std::format( "{}+05:30", micros.back().substr( 0, 26 ) ) );
+    }
+
+    BENCHMARK( std::format( "Parse {} UTC millisecond values", count ) )
+    {
+      int64_t total{ 0 };
+      for ( const auto& value : millis ) total += parseISO8601( value )->time_since_epoch().count();
+      return total;
+    };
+
+    BENCHMARK( std::format( "Parse {} UTC microsecond values", count ) )
+    {
+      int64_t total{ 0 };
+      for ( const auto& value : micros ) total += parseISO8601( value )->time_since_epoch().count();
+      return total;
+    };
+
+    BENCHMARK( std::format( "Parse {} values with zone offset", count ) )
+    {
+      int64_t total{ 0 };
+      for ( const auto& value : offsets ) total += parseISO8601( value )->time_since_epoch().count();
+      return total;
+    };
+
+    BENCHMARK( std::format( "Format {} millisecond values", count ) )
+    {
+      std::size_t total{ 0 };
+      for ( const auto& us : values ) total += isoDateMillis( us ).size();
+      return total;
+    };
+
+    BENCHMARK( std::format( "Format {} microsecond values", count ) )
+    {
+      std::size_t total{ 0 };
+      for ( const auto& us : values ) total += isoDateMicros( us ).size();
+      return total;
+    };
+
+    BENCHMARK( std::format( "Format {} millisecond values into a buffer", count ) )
+    {
+      auto buffer = std::array<char, 24>{};
+      std::size_t total{ 0 };
+      for ( const auto& us : values ) total += isoDateMillis( std::chrono::floor<std::chrono::milliseconds>( us ), buffer ).size();
+      return total;
+    };
+  }
+}
@@ -0,0 +1,182 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "../../src/service/db/memory/filter.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+#include <bsoncxx/builder/stream/array.hpp>
+#include <bsoncxx/builder/stream/document.hpp>
+#include <bsoncxx/oid.hpp>
+
+using namespace spt::db::memory;
+using std::operator""sv;
+
+SCENARIO( "Memory engine filter test suite", "[memory]" )
+{
+  using bsoncxx::builder::stream::document;
+  using bsoncxx::builder::stream::open_array;
+  using bsoncxx::builder::stream::close_array;
+  using bsoncxx::builder::stream::open_document;
+  using bsoncxx::builder::stream::close_document;
+  using bsoncxx::builder::stream::finalize;
+
+  const auto oid = bsoncxx::oid{};
+  const auto doc = document{} <<
+    "_id" << oid <<
+    "name" << "Test" <<
+    "count" << int32_t{ 5 } <<
+    "score" << 4.5 <<
+    "tags" << open_array << "one" << "two" << close_array <<
+    "nested" << open_document << "value" << int64_t{ 10 } << "text" << "inner" << close_document <<
+    "items" << open_array <<
+      open_document << "code" << "a" << close_document <<
+      open_document << "code" << "b" << close_document <<
+    close_array <<
+    finalize;
+
+  GIVEN( "BSON values of different types" )
+  {
+    const auto values = document{} <<
+      "i32" << int32_t{ 5 } << "i64" << int64_t{ 5 } << "dbl" << 5.0 << "big" << 7.5 <<
+      "str" << "5" << "null" << bsoncxx::types::b_null{} << finalize;
+    const auto v = values.view();
+
+    WHEN( "Comparing numeric values of different types" )
+    {
+      REQUIRE( compare( v["i32"].get_value(), v["i64"].get_value() ) == 0 );
+      REQUIRE( compare( v["i32"].get_value(), v["dbl"].get_value() ) == 0 );
+      REQUIRE( compare( v["i64"].get_value(), v["big"].get_value() ) < 0 );
+      REQUIRE( compare( v["big"].get_value(), v["i32"].get_value() ) > 0 );
+    }
+
+    AND_WHEN( "Comparing values of different types" )
+    {
+      REQUIRE( compare( v["null"].get_value(), v["i32"].get_value() ) < 0 );
+      REQUIRE( compare( v["i32"].get_value(), v["str"].get_value() ) < 0 );
+      REQUIRE( compare( v["str"].get_value(), v["null"].get_value() ) > 0 );
+    }
+  }
+
+  GIVEN( "A document with nested values" )
+  {
+    WHEN( "Resolving dotted paths" )
+    {
+      REQUIRE( values( doc.view(), "name"sv ).size() == 1 );
+      REQUIRE( values( doc.view(), "nested.value"sv ).front().get_int64().value == 10 );
+      REQUIRE( values( doc.view(), "items.code"sv ).size() == 2 );
+      REQUIRE( values( doc.view(), "items.1.code"sv ).front().get_string().value == "b"sv );
+      REQUIRE( values( doc.view(), "tags"sv ).front().type() == bsoncxx::type::k_array );
+      REQUIRE( values( doc.view(), "missing.value"sv ).empty() );
+    }
+
+    AND_WHEN( "Matching equality filters" )
+    {
+      REQUIRE( matches( doc.view(), bsoncxx::document::view{} ) );
+      REQUIRE( matches( doc.view(), document{} << "_id" << oid << finalize ) );
+      REQUIRE( matches( doc.view(), document{} << "name" << "Test" << "count" << int64_t{ 5 } << finalize ) );
+      REQUIRE( matches( doc.view(), document{} << "tags" << "two" << finalize ) );
+      REQUIRE( matches( doc.view(), document{} << "items.code" << "b" << finalize ) );
+      REQUIRE( matches( doc.view(), document{} << "missing" << bsoncxx::types::b_null{} << finalize ) );
+      REQUIRE_FALSE( matches( doc.view(), document{} << "name" << "Other" << finalize ) );
+      REQUIRE_FALSE( matches( doc.view(), document{} << "nested.value" << int32_t{ 11 } << finalize ) );
+    }
+
+    AND_WHEN( "Matching filters with operators" )
+    {
+      REQUIRE( matches( doc.view(), document{} << "count" << open_document << "$gt" << 4.9 << "$lte" << int32_t{ 5 } << close_document << finalize ) );
+      REQUIRE( matches( doc.view(), document{} << "name" << open_document << "$in" << open_array << "Other" << "Test" << close_array << close_document << finalize ) );
+      REQUIRE( matches( doc.view(), document{} << "name" << open_document << "$ne" << "Other" << close_document << finalize ) );
+      REQUIRE( matches( doc.view(), document{} << "missing" << open_document << "$exists" << false << close_document << finalize ) );
+      REQUIRE_FALSE( matches( doc.view(), document{} << "count" << open_document << "$lt" << "10" << close_document << finalize ) );
+      REQUIRE_FALSE( matches( doc.view(), document{} << "tags" << open_document << "$nin" << open_array << "one" << close_array << close_document << finalize ) );
+      REQUIRE( matches( doc.view(), document{} << "$or" << open_array <<
+        open_document << "name" << "Other" << close_document <<
+        open_document << "score" << open_document << "$gte" << 4.5 << close_document << close_document <<
+        close_array << finalize ) );
+      REQUIRE_FALSE( matches( doc.view(), document{} << "$nor" << open_array <<
+        open_document << "name" << "Test" << close_document << close_array << finalize ) );
+    }
+
+    AND_WHEN( "Matching filters with unsupported operators" )
+    {
+      REQUIRE_THROWS_AS( matches( doc.view(), document{} << "name" << open_document << "$regex" << "^T" << close_document << finalize ), std::invalid_argument );
+      REQUIRE_THROWS_AS( matches( doc.view(), document{} << "$where" << "true" << finalize ), std::invalid_argument );
+    }
+  }
+
+  GIVEN( "Update specifications for the document" )
+  {
+    WHEN( "Setting and removing fields" )
+    {
+      const auto updated = update( doc.view(), document{} <<
+        "$set" << open_document << "name" << "Updated" << "nested.other" << true << "added.value" << int32_t{ 1 } << close_document <<
+        "$unset" << open_document << "score" << 1 << "nested.text" << 1 << close_document <<
+        finalize );
+      const auto v = updated.view();
+
+      REQUIRE( v["_id"].get_oid().value == oid );
+      REQUIRE( v["name"].get_string().value == "Updated"sv );
+      REQUIRE( v.find( "score" ) == v.end() );
+      REQUIRE( v["nested"]["value"].get_int64().value == 10 );
+      REQUIRE( v["nested"]["other"].get_bool().value );
+      REQUIRE( v["nested"].get_document().view().find( "text" ) == v["nested"].get_document().view().end() );
+      REQUIRE( v["added"]["value"].get_int32().value == 1 );
+      REQUIRE( v["tags"].type() == bsoncxx::type::k_array );
+    }
+
+    AND_WHEN( "Updating with plain fields" )
+    {
+      const auto updated = update( doc.view(), document{} << "_id" << bsoncxx::oid{} << "count" << int32_t{ 6 } << finalize );
+      REQUIRE( updated.view()["_id"].get_oid().value == oid );
+      REQUIRE( updated.view()["count"].get_int32().value == 6 );
+      REQUIRE( updated.view()["name"].get_string().value == "Test"sv );
+    }
+
+    AND_WHEN( "Updating with unsupported operators" )
+    {
+      REQUIRE_THROWS_AS( update( doc.view(), document{} << "$inc" << open_document << "count" << 1 << close_document << finalize ), std::invalid_argument );
+    }
+  }
+
+  GIVEN( "Projections for the document" )
+  {
+    WHEN( "Including fields" )
+    {
+      const auto projected = project( doc.view(), document{} << "name" << 1 << finalize );
+      REQUIRE( projected.view().find( "_id" ) != projected.view().end() );
+      REQUIRE( projected.view().find( "name" ) != projected.view().end() );
+      REQUIRE( projected.view().find( "count" ) == projected.view().end() );
+    }
+
+    AND_WHEN( "Excluding fields" )
+    {
+      const auto projected = project( doc.view(), document{} << "_id" << 0 << "tags" << 0 << finalize );
+      REQUIRE( projected.view().find( "_id" ) == projected.view().end() );
+      REQUIRE( projected.view().find( "tags" ) == projected.view().end() );
+      REQUIRE( projected.view().find( "name" ) != projected.view().end() );
+    }
+
+    AND_WHEN( "Mixing inclusion and exclusion" )
+    {
+      REQUIRE_THROWS_AS( project( doc.view(), document{} << "name" << 1 << "tags" << 0 << finalize ), std::invalid_argument );
+    }
+  }
+
+  GIVEN( "Documents to sort" )
+  {
+    const auto first = document{} << "name" << "a" << "count" << int32_t{ 2 } << finalize;
+    const auto second = document{} << "name" << "b" << "count" << int32_t{ 1 } << finalize;
+    const auto missing = document{} << "name" << "c" << finalize;
+
+    WHEN( "Sorting ascending and descending" )
+    {
+      REQUIRE( less( first.view(), second.view(), document{} << "name" << 1 << finalize ) );
+      REQUIRE( less( second.view(), first.view(), document{} << "count" << 1 << finalize ) );
+      REQUIRE( less( second.view(), first.view(), document{} << "name" << -1 << finalize ) );
+      REQUIRE( less( missing.view(), second.view(), document{} << "count" << 1 << finalize ) );
+      REQUIRE_FALSE( less( first.view(), first.view(), document{} << "name" << 1 << finalize ) );
+    }
+  }
+}
@@ -0,0 +1,94 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "../../src/common/util/histogram.hpp"
+
+#include <cmath>
+#include <limits>
+#include <catch2/catch_test_macros.hpp>
+
+using spt::util::Histogram;
+
+SCENARIO( "Histogram test suite", "[histogram]" )
+{
+  GIVEN( "A log-linear histogram" )
+  {
+    WHEN( "No values are recorded" )
+    {
+      auto h = Histogram{};
+      CHECK( h.count() == 0 );
+      CHECK( h.min() == 0 );
+      CHECK( h.max() == 0 );
+      CHECK( h.percentile( 99.0 ) == 0 );
+    }
+
+    AND_WHEN( "Small values are recorded" )
+    {
+      auto h = Histogram{};
+      for ( auto i = 1; i <= 50; ++i ) h.record( i );
+      CHECK( h.count() == 50 );
+      CHECK( h.min() == 1 );
+      CHECK( h.max() == 50 );
+      CHECK( h.percentile( 50.0 ) == 25 );
+      CHECK( h.percentile( 100.0 ) == 50 );
+    }
+
+    AND_WHEN( "Large values are recorded" )
+    {
+      auto h = Histogram{};
+      for ( auto i = 1; i <= 1000; ++i ) h.record( i * 1000 );
+      CHECK( h.count() == 1000 );
+      CHECK( std::abs( h.percentile( 50.0 ) - 500'000 ) < 500'000 * 0.04 );
+      CHECK( std::abs( h.percentile( 99.0 ) - 990'000 ) < 990'000 * 0.04 );
+      CHECK( h.percentile( 100.0 ) == 1'000'000 );
+      CHECK( h.mean() == 500'500.0 );
+    }
+
+    AND_WHEN( "Bucket indices are contiguous and within range" )
+    {
+      CHECK( Histogram::index( 0 ) == 0 );
+      CHECK( Histogram::index( 2 * Histogram::SubBuckets - 1 ) + 1 == Histogram::index( 2 * Histogram::SubBuckets ) );
+      CHECK( Histogram::index( Histogram::MaxValue ) == Histogram::Buckets - 1 );
+    }
+
+    AND_WHEN( "Values out of range are clamped" )
+    {
+      auto h = Histogram{};
+      h.record( -10 );
+      h.record( std::numeric_limits<int64_t>::max() );
+      CHECK( h.min() == 0 );
+      CHECK( h.max() == static_cast<int64_t>( Histogram::MaxValue ) );
+    }
+
+    AND_WHEN( "Merging histograms" )
+    {
+      auto h1 = Histogram{};
+      auto h2 = Histogram{};
+      for ( auto i = 1; i <= 10; ++i ) h1.record( i );
+      for ( auto i = 11; i <= 20; ++i ) h2.record( i );
+      h1.merge( h2 );
+      CHECK( h1.count() == 20 );
+      CHECK( h1.min() == 1 );
+      CHECK( h1.max() == 20 );
+
+      h1.reset();
+      CHECK( h1.count() == 0 );
+    }
+
+    AND_WHEN( "Draining an atomic histogram" )
+    {
+      auto ah = spt::util::AtomicHistogram{};
+      for ( auto i = 1; i <= 1000; ++i ) ah.record( i * 1000 );
+
+      auto h = Histogram{};
+      ah.drain( h );
+      CHECK( h.count() == 1000 );
+      CHECK( std::abs( h.percentile( 99.0 ) - 990'000 ) < 990'000 * 0.04 );
+
+      auto empty = Histogram{};
+      ah.drain( empty );
+      CHECK( empty.count() == 0 );
+    }
+  }
+}
@@ -3,8 +3,11 @@
 //
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include "../../src/ilp/builder.hpp"
 
+#include <format>
+
 using std::operator""sv;
 using namespace std::literals::chrono_literals;
 
@@ -240,3 +243,177 @@ m2,foo=bar x="second" 1602841605822792000
     }
   }
 }
+
+SCENARIO( "ILP Builder buffer reuse" )
+{
+  GIVEN( "ILP Builder instance" )
+  {
+    auto builder = spt::ilp::Builder{};
+
+    WHEN( "Reusing the builder after clear" )
+    {
+      builder.
+        startRecord( "m1"sv ).
+          addTag( "tag1"sv, "val1"sv ).
+          addValue( "x"sv, int64_t{ 1 } ).
+          timestamp( 1602841605822791506ns ).
+        endRecord();
+      REQUIRE( builder.view() == "m1,tag1=val1 x=1i 1602841605822791506\n" );
+
+      builder.clear();
+      REQUIRE( builder.size() == 0 );
+
+      auto str = builder.
+        startRecord( "m2"sv ).
+          addValue( "y"sv, 2.5 ).
+          addTag( "tag2"sv, "a b"sv ).
+          timestamp( 1602841605822792000ns ).
+        endRecord().
+        finish();
+      REQUIRE( str == "m2,tag2=a\\ b y=2.5 1602841605822792000\n" );
+    }
+
+    AND_WHEN( "Constructing a builder with a previously used buffer" )
+    {
+      auto str = builder.startRecord( "m1"sv ).addValue( "x"sv, true ).timestamp( 1ns ).endRecord().finish();
+      REQUIRE( str == "m1 x=true 1\n" );
+
+      auto reused = spt::ilp::Builder{ std::move( str ) };
+      REQUIRE( reused.size() == 0 );
+      auto next = reused.startRecord( "m2"sv ).addValue( "x"sv, false ).timestamp( 2ns ).endRecord().finish();
+      REQUIRE( next == "m2 x=false 2\n" );
+    }
+  }
+}
+
+SCENARIO( "ILP Builder benchmark", "[.][benchmark]" )
+{
+  GIVEN( "A batch of metric like records" )
+  {
+    constexpr auto count = 1000;
+
+    const auto build = []( spt::ilp::Builder& builder )
+    {
+      for ( auto i = 0; i < count; ++i )
+      {
+        builder.startRecord( "metrics"sv ).
+          addTag( "action"sv, "retrieve"sv ).
+          addTag( "database"sv, "itest"sv ).
+          addTag( "collection"sv, "test, with space"sv ).
+          addValue( "duration"sv, int64_t{ 123456789 } + i ).
+          addValue( "size"sv, uint64_t{ 4096 } ).
+          addValue( "ratio"sv, 0.125 * i ).
+          addValue( "id"sv, "5f0e4d2a9c1b3a0017b4c9d1"sv ).
+          timestamp( 1602841605822791506ns ).
+          endRecord();
+      }
+    };
+
+    WHEN( "Building batches" )
+    {
+      BENCHMARK( "std::format concatenation" )
+      {
+        auto value = std::string{};
+        for ( auto i = 0; i < count; ++i )
+        {
+          auto tags = std::format( "{}={},{}={},{}={}", "action", "retrieve", "database", "itest", "collection", "test\\,\\ with\\ space" );
+          auto fields = std::format( "{}={}i,{}={}u,{}={},{}=\"{}\"", "duration", int64_t{ 123456789 } + i, "size", uint64_t{ 4096 }, "ratio", 0.125 * i, "id", "5f0e4d2a9c1b3a0017b4c9d1" );
+          value.append( std::format( "{},{} {} {}\n", "metrics", tags, fields, 1602841605822791506 ) );
+        }
+        return value;
+      };
+
+      BENCHMARK( "Builder new buffer per batch" )
+      {
+        auto builder = spt::ilp::Builder{};
+        build( builder );
+        return builder.finish();
+      };
+
+      auto builder = spt::ilp::Builder{};
+      BENCHMARK( "Builder reused buffer" )
+      {
+        builder.clear();
+        build( builder );
+        return builder.size();
+      };
+    }
+  }
+}
+
+SCENARIO( "APMRecord source location test suite" )
+{
+  GIVEN( "An APM record with processes created at known source locations" )
+  {
+    auto record = spt::ilp::APMRecord{ "abc123" };
+    record.application = "unit test";
+    record.values.try_emplace( "zeta", int64_t{ 1 } );
+
+    WHEN( "Adding processes and calling functions" )
+    {
+      const auto loc = std::source_location::current();
+      spt::ilp::addCurrentFunction( record, loc );
+
+      auto& p = spt::ilp::addProcess( record, spt::ilp::APMRecord::Process::Type::Step, loc );
+      p.values.try_emplace( "process", "unit test" );
+      spt::ilp::addCurrentFunction( p, loc );
+
+      for ( auto i = 0; i < 100; ++i ) spt::ilp::addProcess( record, spt::ilp::APMRecord::Process::Type::Other, loc );
+      REQUIRE( &p == &record.processes.front() );
+      REQUIRE( record.processes.size() == 101 );
+
+      auto builder = spt::ilp::Builder{};
+      builder.add( "apm", record );
+      const auto str = builder.finish();
+      const auto first = std::string_view{ str }.substr( 0, str.find( '\n' ) + 1 );
+      const auto second = std::string_view{ str }.substr( first.size(), str.find( '\n', first.size() ) + 1 - first.size() );
+
+      const auto expected = std::format(
+        "apm,application=unit\\ test id=\"abc123\",duration=0i,end_timestamp={}t,caller_file=\"{}\",caller_function=\"{}\",caller_line={}u,zeta=1i {}\n",
+        std::chrono::duration_cast<std::chrono::microseconds>( record.timestamp.time_since_epoch() ).count(),
+        loc.file_name(), loc.function_name(), loc.line(),
+        std::chrono::duration_cast<std::chrono::nanoseconds>( record.timestamp.time_since_epoch() ).count() );
+      CHECK( first == expected );
+
+      const auto& process = record.processes.front();
+      const auto pexpected = std::format(
+        "apm,application=unit\\ test,type=step id=\"abc123\",duration=0i,end_timestamp={}t,caller_file=\"{}\",caller_function=\"{}\",caller_line={}u,file=\"{}\",function=\"{}\",line={}u,process=\"unit test\" {}\n",
+        std::chrono::duration_cast<std::chrono::microseconds>( process.timestamp.time_since_epoch() ).count(),
+        loc.file_name(), loc.function_name(), loc.line(),
+        loc.file_name(), loc.function_name(), loc.line(),
+        std::chrono::duration_cast<std::chrono::nanoseconds>( process.timestamp.time_since_epoch() ).count() );
+      CHECK( second == pexpected );
+    }
+
+    AND_WHEN( "Overriding source location values in the values map" )
+    {
+      const auto loc = std::source_location::current();
+      auto& p = spt::ilp::addProcess( record, spt::ilp::APMRecord::Process::Type::Function, loc );
+      p.values["line"] = uint64_t{ 42 };
+      p.values["function"] = std::string{ "override" };
+      record.values["caller_line"] = uint64_t{ 7 };
+      spt::ilp::addCurrentFunction( record, loc );
+
+      auto builder = spt::ilp::Builder{};
+      builder.add( "apm", record );
+      const auto str = builder.finish();
+      const auto first = std::string_view{ str }.substr( 0, str.find( '\n' ) + 1 );
+      const auto second = std::string_view{ str }.substr( first.size() );
+
+      // Same output as when source locations were stored as values at the time the process was added
+      const auto expected = std::format(
+        "apm,application=unit\\ test id=\"abc123\",duration=0i,end_timestamp={}t,caller_file=\"{}\",caller_function=\"{}\",caller_line=7u,zeta=1i {}\n",
+        std::chrono::duration_cast<std::chrono::microseconds>( record.timestamp.time_since_epoch() ).count(),
+        loc.file_name(), loc.function_name(),
+        std::chrono::duration_cast<std::chrono::nanoseconds>( record.timestamp.time_since_epoch() ).count() );
+      CHECK( first == expected );
+
+      const auto pexpected = std::format(
+        "apm,application=unit\\ test,type=function id=\"abc123\",duration=0i,end_timestamp={}t,file=\"{}\",function=\"override\",line=42u {}\n",
+        std::chrono::duration_cast<std::chrono::microseconds>( p.timestamp.time_since_epoch() ).count(),
+        loc.file_name(),
+        std::chrono::duration_cast<std::chrono::nanoseconds>( p.timestamp.time_since_epoch() ).count() );
+      CHECK( second == pexpected );
+    }
+  }
+}
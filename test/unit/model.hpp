@@ -193,4 +193,14 @@ namespace spt::util::test::serial
     VISITABLE(std::vector<Property>, properties);
     END_VISITABLES;
   };
+
+  struct Views
+  {
+    BEGIN_VISITABLES(Views);
+    VISITABLE(std::string_view, name);
+    VISITABLE(bsoncxx::document::view, document);
+    VISITABLE(bsoncxx::array::view, items);
+    VISITABLE(int32_t, count);
+    END_VISITABLES;
+  };
 }
@@ -6,6 +6,7 @@
 #include "../../src/log/stacktrace.hpp"
 
 #include <ranges>
+#include <vector>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <bsoncxx/oid.hpp>
@@ -52,6 +53,23 @@ SCENARIO( "NanoLog test suite", "[nanolog]" )
     {
       LOG_DEBUG << "BSON object id value: " << bsoncxx::oid{};
     }
+
+    AND_WHEN( "NanoLog logging every n-th line" )
+    {
+      int evaluated = 0;
+      auto value = [&evaluated] { return ++evaluated; };
+      for ( int i = 0; i < 100; ++i ) LOG_WARN_EVERY_N( 10 ) << "Sampled value: " << value();
+      CHECK( evaluated == 10 );
+    }
+
+    AND_WHEN( "NanoLog logging rate limited lines" )
+    {
+      int evaluated = 0;
+      auto value = [&evaluated] { return ++evaluated; };
+      for ( int i = 0; i < 100; ++i ) LOG_WARN_RATE( 5 ) << "Rate limited value: " << value();
+      CHECK( evaluated >= 5 );
+      CHECK( evaluated <= 10 );
+    }
   }
 }
 
@@ -102,4 +120,4 @@ SCENARIO( "Stacktrace test suite", "[stacktrace]" )
       }
     }
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,58 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "../../src/api/impl/response.hpp"
+
+#include <cstring>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+SCENARIO( "Response buffer test suite", "[response]" )
+{
+  using spt::mongoservice::api::impl::responseBuffer;
+  using spt::mongoservice::api::impl::responseDocument;
+
+  GIVEN( "A BSON document received from the service" )
+  {
+    using bsoncxx::builder::basic::kvp;
+    const auto document = bsoncxx::builder::basic::make_document( kvp( "key", "value" ), kvp( "count", 5 ) );
+    const auto length = static_cast<uint32_t>( document.view().length() );
+
+    WHEN( "Reading the document into a response buffer" )
+    {
+      auto buffer = responseBuffer( length, 1024 );
+      REQUIRE( buffer );
+      CHECK( std::memcmp( buffer.get(), document.view().data(), sizeof(length) ) == 0 );
+
+      std::memcpy( buffer.get() + sizeof(length), document.view().data() + sizeof(length), length - sizeof(length) );
+      const auto data = buffer.get();
+      auto value = responseDocument( std::move( buffer ), length );
+      REQUIRE( value );
+      CHECK( value->view().data() == data );
+      CHECK( value->view() == document.view() );
+      CHECK( value->view()["key"].get_string().value == "value" );
+    }
+
+    AND_WHEN( "The document exceeds the maximum response size" )
+    {
+      CHECK_FALSE( responseBuffer( length, length - 1 ) );
+      CHECK( responseBuffer( length, length ) );
+    }
+
+    AND_WHEN( "The length is not a valid document length" )
+    {
+      CHECK_FALSE( responseBuffer( 0, 1024 ) );
+      CHECK_FALSE( responseBuffer( 4, 1024 ) );
+    }
+
+    AND_WHEN( "The buffer does not hold valid BSON" )
+    {
+      auto buffer = responseBuffer( length, 1024 );
+      REQUIRE( buffer );
+      std::memset( buffer.get() + sizeof(length), 0xff, length - sizeof(length) );
+      CHECK_FALSE( responseDocument( std::move( buffer ), length ) );
+    }
+  }
+}
@@ -0,0 +1,76 @@
+//
+// Created by Rakesh on 18/10/2026.
+//
+
+#include "../../src/common/util/ringbuffer.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+SCENARIO( "RingBuffer test suite", "[ringbuffer]" )
+{
+  GIVEN( "A bounded ring buffer" )
+  {
+    WHEN( "Capacity is rounded up to a power of two" )
+    {
+      auto rb = spt::util::RingBuffer<std::string>{ 100 };
+      CHECK( rb.capacity() == 128 );
+    }
+
+    AND_WHEN( "Values are pushed and popped in order" )
+    {
+      auto rb = spt::util::RingBuffer<std::string>{ 4 };
+      CHECK( rb.push( "one" ) );
+      CHECK( rb.push( "two" ) );
+      CHECK( rb.approximateSize() == 2 );
+
+      auto v = rb.pop();
+      REQUIRE( v );
+      CHECK( *v == "one" );
+      v = rb.pop();
+      REQUIRE( v );
+      CHECK( *v == "two" );
+      CHECK_FALSE( rb.pop() );
+    }
+
+    AND_WHEN( "Pushing into a full buffer" )
+    {
+      auto rb = spt::util::RingBuffer<int>{ 4 };
+      for ( auto i = 0; i < 4; ++i ) CHECK( rb.push( int{ i } ) );
+      CHECK_FALSE( rb.push( 5 ) );
+      CHECK( rb.pop() );
+      CHECK( rb.push( 5 ) );
+    }
+
+    AND_WHEN( "Multiple producers push concurrently" )
+    {
+      constexpr auto producers = 8;
+      constexpr auto count = 10'000;
+      auto rb = spt::util::RingBuffer<int>{ producers * count };
+
+      auto threads = std::vector<std::thread>{};
+      threads.reserve( producers );
+      for ( auto p = 0; p < producers; ++p )
+      {
+        threads.emplace_back( [&rb]
+        {
+          for ( auto i = 0; i < count; ++i ) rb.push( int{ i } );
+        } );
+      }
+      for ( auto& t : threads ) t.join();
+
+      auto total = 0;
+      int64_t sum = 0;
+      while ( auto v = rb.pop() )
+      {
+        ++total;
+        sum += *v;
+      }
+
+      CHECK( total == producers * count );
+      CHECK( sum == int64_t{ producers } * ( int64_t{ count } * ( count - 1 ) / 2 ) );
+    }
+  }
+}
@@ -4,13 +4,87 @@
 
 #include "model.hpp"
 
+#include <format>
+
 #include <boost/uuid/uuid_generators.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 
 using namespace spt::util;
 
+namespace
+{
+  namespace pserialise
+  {
+    using bsoncxx::builder::stream::finalize;
+
+    bsoncxx::types::bson_value::value nested( const test::serial::Full::Nested& model )
+    {
+      auto numbers = bsoncxx::builder::stream::array{};
+      for ( const auto number : model.numbers ) numbers << number;
+
+      return bsoncxx::types::b_document{ bsoncxx::builder::stream::document{} <<
+        "identifier" << model.identifier <<
+        "integer" << model.integer <<
+        "number" << model.number <<
+        "date" << bsoncxx::types::b_date{ model.date } <<
+        "numbers" << bsoncxx::types::b_array{ ( numbers << finalize ).view() } <<
+        "level" << magic_enum::enum_name( model.level ) <<
+        finalize };
+    }
+
+    // Build the document the way the previous implementation did, with each nested value in its own builder.
+    bsoncxx::document::value expected( const test::serial::Full& model )
+    {
+      auto nesteds = bsoncxx::builder::stream::array{};
+      for ( const auto& n : model.nesteds ) nesteds << nested( n );
+
+      auto strings = bsoncxx::builder::stream::array{};
+      for ( const auto& str : model.strings ) strings << str;
+
+      return bsoncxx::builder::stream::document{} <<
+        "notVisitable" << test::serial::bson( model.notVisitable ) <<
+        "customFields" << test::serial::bson( model.customFields ) <<
+        "identifier" << model.identifier <<
+        "nested" << nested( *model.nested ) <<
+        "nesteds" << bsoncxx::types::b_array{ ( nesteds << finalize ).view() } <<
+        "nestedp" << nested( *model.nestedp ) <<
+        "strings" << bsoncxx::types::b_array{ ( strings << finalize ).view() } <<
+        "ostring" << *model.ostring <<
+        "obool" << *model.obool <<
+        "time" << bsoncxx::types::b_date{ model.time } <<
+        "_id" << model.id <<
+        "boolean" << model.boolean <<
+        finalize;
+    }
+
+    test::serial::Full full()
+    {
+      using test::serial::Full;
+      auto obj = Full{};
+      obj.notVisitable.identifier = "xyz-987";
+      obj.notVisitable.integer = 456;
+      obj.customFields.id = "lmn-456";
+      obj.identifier = "abc-123"s;
+      obj.nested = Full::Nested{ .identifier = "nested-123"s, .integer = 1234, .number = 1.234, .date = std::chrono::system_clock::now(), .numbers = { 1.2, 2.3, 3.4 }, .level = Full::Level::Info };
+      obj.nesteds = {
+          Full::Nested{ .identifier = "nested-1"s, .integer = 1, .number = 1.1, .date = std::chrono::system_clock::now(), .numbers = { 1.1, 1.2, 1.3 }, .level = Full::Level::Critical },
+          Full::Nested{ .identifier = "nested-2"s, .integer = 2, .number = 2.1, .date = std::chrono::system_clock::now(), .numbers = { 2.1, 2.2, 2.3 }, .level = Full::Level::Warning },
+          Full::Nested{ .identifier = "nested-3"s, .integer = 3, .number = 3.1, .date = std::chrono::system_clock::now(), .numbers = { 3.1, 3.2, 3.3 }, .level = Full::Level::Debug }
+      };
+      obj.nestedp = std::make_shared<Full::Nested>( Full::Nested{ .identifier = "nested-p"s, .integer = 234, .number = 234.567, .date = std::chrono::system_clock::now(), .numbers = { 1.2, 2.3, 3.4 }, .level = Full::Level::Info } );
+      obj.strings = { "one"s, "two"s, "three"s };
+      obj.ostring = "some string value"s;
+      obj.obool = true;
+      obj.time = std::chrono::system_clock::now();
+      obj.boolean = true;
+      return obj;
+    }
+  }
+}
+
 SCENARIO( "Serialisation test suite", "[serialise]" )
 {
   GIVEN( "A fully visitable struct" )
@@ -332,3 +406,190 @@ SCENARIO( "Serialisation test suite", "[serialise]" )
     CHECK( uuid == uuid1 );
   }
 }
+
+SCENARIO( "Marshalling output compatibility test suite", "[serialise]" )
+{
+  GIVEN( "A fully visitable struct with nested structs and arrays" )
+  {
+    const auto obj = pserialise::full();
+
+    WHEN( "Marshalling the struct" )
+    {
+      const auto data = marshall( obj );
+      const auto expected = pserialise::expected( obj );
+
+      THEN( "Output is identical to building each nested value separately" )
+      {
+        CHECK( data.view().length() == expected.view().length() );
+        CHECK( data.view() == expected.view() );
+      }
+
+      AND_THEN( "Wrapped BSON value holds the same document" )
+      {
+        const auto value = bson( obj );
+        REQUIRE( value.view().type() == bsoncxx::type::k_document );
+        CHECK( value.view().get_document().value == data.view() );
+      }
+    }
+  }
+
+  GIVEN( "A partially visitable struct" )
+  {
+    auto obj = test::serial::Partial{};
+    obj.notVisitable.identifier = "lmn-456";
+    obj.customFields.id = "def-2389";
+    obj.identifier = "abc123"s;
+    obj.hidden = "hidden text";
+
+    WHEN( "Marshalling the struct" )
+    {
+      const auto data = marshall( obj );
+      const auto expected = bsoncxx::builder::stream::document{} <<
+        "notVisitable" << test::serial::bson( obj.notVisitable ) <<
+        "customFields" << test::serial::bson( obj.customFields ) <<
+        "identifier" << obj.identifier <<
+        "_id" << obj.id <<
+        "hidden" << obj.hidden <<
+        bsoncxx::builder::stream::finalize;
+
+      THEN( "Non-visitable fields are appended after the visitable fields" )
+      {
+        CHECK( data.view() == expected.view() );
+      }
+    }
+  }
+}
+
+SCENARIO( "Unmarshalling test suite", "[serialise]" )
+{
+  GIVEN( "A BSON document with fields in a different order to the model" )
+  {
+    const auto oid = bsoncxx::oid{};
+    const auto doc = bsoncxx::builder::stream::document{} <<
+      "unknown" << "skipped" <<
+      "_id" << oid <<
+      "hidden" << "hidden text" <<
+      "identifier" << "first" <<
+      "customFields" << bsoncxx::builder::stream::open_document << "identifier" << "cf" << bsoncxx::builder::stream::close_document <<
+      "identifier" << "second" <<
+      "another" << bsoncxx::builder::stream::open_document << "identifier" << "nested" << bsoncxx::builder::stream::close_document <<
+      bsoncxx::builder::stream::finalize;
+
+    WHEN( "Unmarshalling the document" )
+    {
+      const auto obj = unmarshall<test::serial::Partial>( doc.view() );
+
+      THEN( "Each field is set from the first matching element" )
+      {
+        CHECK( obj.id == oid );
+        CHECK_THAT( obj.identifier, Catch::Matchers::Equals( "first" ) );
+        CHECK_THAT( obj.customFields.id, Catch::Matchers::Equals( "cf" ) );
+        CHECK_THAT( obj.hidden, Catch::Matchers::Equals( "hidden text" ) );
+        CHECK( obj.notVisitable.identifier.empty() );
+      }
+    }
+  }
+
+  GIVEN( "A BSON document with both id and _id keys" )
+  {
+    const auto id = bsoncxx::oid{};
+    const auto doc = bsoncxx::builder::stream::document{} <<
+      "_id" << bsoncxx::oid{} <<
+      "id" << id <<
+      bsoncxx::builder::stream::finalize;
+
+    WHEN( "Unmarshalling the document" )
+    {
+      auto obj = test::serial::Partial{};
+      unmarshall( obj, doc.view() );
+
+      THEN( "The id key takes precedence" )
+      {
+        CHECK( obj.id == id );
+      }
+    }
+  }
+
+  GIVEN( "A model with view fields" )
+  {
+    const auto doc = bsoncxx::builder::stream::document{} <<
+      "name" << "view name" <<
+      "document" << bsoncxx::builder::stream::open_document << "key" << "value" << bsoncxx::builder::stream::close_document <<
+      "items" << bsoncxx::builder::stream::open_array << 1 << 2 << 3 << bsoncxx::builder::stream::close_array <<
+      "count" << 3 <<
+      bsoncxx::builder::stream::finalize;
+
+    WHEN( "Unmarshalling the document" )
+    {
+      const auto obj = unmarshall<test::serial::Views>( doc.view() );
+
+      THEN( "Views refer to the source document" )
+      {
+        CHECK( obj.name == "view name"sv );
+        CHECK( obj.name.data() > reinterpret_cast<const char*>( doc.view().data() ) );
+        CHECK( obj.name.data() < reinterpret_cast<const char*>( doc.view().data() + doc.view().length() ) );
+        CHECK( obj.document["key"].get_string().value == "value"sv );
+        CHECK( obj.document.data() == doc.view()["document"].get_document().value.data() );
+        CHECK( std::ranges::distance( obj.items ) == 3 );
+        CHECK( obj.count == 3 );
+      }
+
+      AND_THEN( "Marshalling the model produces the same document" )
+      {
+        CHECK( marshall( obj ).view() == doc.view() );
+      }
+    }
+  }
+}
+
+SCENARIO( "Serialisation benchmark", "[.][benchmark]" )
+{
+  GIVEN( "Models with nested structs and arrays" )
+  {
+    const auto full = pserialise::full();
+
+    auto partial = test::serial::Partial{};
+    partial.notVisitable.identifier = "lmn-456";
+    partial.customFields.id = "def-2389";
+    partial.identifier = "abc123"s;
+    partial.hidden = "hidden text";
+
+    auto properties = test::serial::Properties{};
+    for ( auto i = 0; i < 32; ++i )
+    {
+      properties.properties.push_back( test::serial::Property{ .name = std::format( "property-{}", i ), .value = boost::json::value( i ) } );
+    }
+
+    BENCHMARK( "Marshall full model" )
+    {
+      return marshall( full );
+    };
+
+    BENCHMARK( "Build full model with nested builders" )
+    {
+      return pserialise::expected( full );
+    };
+
+    BENCHMARK( "Marshall partial model" )
+    {
+      return marshall( partial );
+    };
+
+    BENCHMARK( "Marshall properties" )
+    {
+      return marshall( properties );
+    };
+
+    const auto fullDoc = marshall( full );
+    BENCHMARK( "Unmarshall full model" )
+    {
+      return unmarshall<test::serial::Full>( fullDoc.view() );
+    };
+
+    const auto partialDoc = marshall( partial );
+    BENCHMARK( "Unmarshall partial model" )
+    {
+      return unmarshall<test::serial::Partial>( partialDoc.view() );
+    };
+  }
+}
@@ -4,9 +4,13 @@
 
 #include "model.hpp"
 
+#include <format>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 #include <bsoncxx/builder/list.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
 
 using namespace spt::util;
 
@@ -37,6 +41,56 @@ SCENARIO( "Content scanning test suite", "[scan]" )
       const auto data = "Test let name = retrieve('Last Name');"s;
       CHECK( spt::util::json::hasDangerousContent( data ) );
     }
+
+    AND_WHEN( "Scanning long strings with content at different offsets" )
+    {
+      const auto prefix = std::string( 45, 'x' );
+      CHECK( spt::util::json::hasDangerousContent( prefix + "<img src=x onerror=alert(1)>" + prefix ) );
+      CHECK( spt::util::json::hasDangerousContent( prefix + prefix + "<b>" ) );
+      CHECK( spt::util::json::hasDangerousContent( prefix + "<" + prefix + ">" + prefix ) );
+      CHECK( spt::util::json::hasDangerousContent( prefix + "const" + " " + prefix + "function " + prefix ) );
+      CHECK( spt::util::json::hasDangerousContent( prefix + "await" + prefix + "async " ) );
+      CHECK_FALSE( spt::util::json::hasDangerousContent( prefix + "<>" + prefix + "a > b" + prefix ) );
+      CHECK_FALSE( spt::util::json::hasDangerousContent( prefix + "function " + prefix + "console." + prefix ) );
+      CHECK_FALSE( spt::util::json::hasDangerousContent( prefix + "variable = value" + prefix ) );
+    }
+  }
+}
+
+SCENARIO( "Raw BSON validation test suite", "[invalid]" )
+{
+  GIVEN( "BSON documents in raw buffers" )
+  {
+    WHEN( "Validating a document with acceptable values" )
+    {
+      auto obj = bsoncxx::builder::list{
+          "string", "a string value",
+          "int", 12,
+          "object", bsoncxx::builder::list{ "nested", "a nested value", "password", "$@%^&*(!@$)(^@#" },
+          "array", bsoncxx::builder::list{ "first", "second", 3 }
+      };
+      const auto view = obj.view().get_document().value;
+      CHECK( spt::util::json::validateBson( "test", view.data(), view.length() ) );
+      CHECK( spt::util::json::validate( "test", view ) );
+    }
+
+    AND_WHEN( "Validating a document with invalid data in a nested array" )
+    {
+      auto obj = bsoncxx::builder::list{
+          "string", "a string value",
+          "array", bsoncxx::builder::list{ "first", bsoncxx::builder::list{ "specialChars", "$@%^&*(!@$)(^@#abc" } }
+      };
+      const auto view = obj.view().get_document().value;
+      CHECK_FALSE( spt::util::json::validateBson( "test", view.data(), view.length() ) );
+    }
+
+    AND_WHEN( "Validating a truncated document" )
+    {
+      auto obj = bsoncxx::builder::list{ "string", "a string value" };
+      const auto view = obj.view().get_document().value;
+      CHECK_FALSE( spt::util::json::validateBson( "test", view.data(), view.length() - 1 ) );
+      CHECK_FALSE( spt::util::json::validateBson( "test", view.data(), 4 ) );
+    }
   }
 }
 
@@ -100,4 +154,32 @@ SCENARIO( "Invalid data test suite", "[invalid]" )
       CHECK_FALSE( spt::util::json::validate( "test", obj ) );
     }
   }
-}
\ No newline at end of file
+}
+SCENARIO( "Content scanning benchmark", "[.][benchmark]" )
+{
+  GIVEN( "A large text value" )
+  {
+    auto text = std::string{};
+    text.reserve( 65'600 );
+    while ( text.size() < 65'536 ) text.append( "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor. " );
+
+    BENCHMARK( std::format( "Scanning {} bytes for dangerous content", text.size() ) )
+    {
+      return spt::util::json::hasDangerousContent( text );
+    };
+
+    BENCHMARK( std::format( "Validating {} bytes for special characters", text.size() ) )
+    {
+      return spt::util::json::validate( "text", text );
+    };
+
+    auto builder = bsoncxx::builder::basic::document{};
+    for ( auto i = 0; i < 256; ++i ) builder.append( bsoncxx::builder::basic::kvp( std::format( "field{}", i ), text.substr( 0, 256 ) ) );
+    const auto document = builder.extract();
+
+    BENCHMARK( std::format( "Validating BSON document of {} bytes", document.view().length() ) )
+    {
+      return spt::util::json::validate( "document", document.view() );
+    };
+  }
+}